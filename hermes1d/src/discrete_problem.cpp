@@ -13,6 +13,7 @@
 
 //  Solvers
 #include "../../hermes_common/solver/solver.h"
+#include "../../hermes_common/solver/matrix_free.h"
 
 
 static int _precalculated = 0;
@@ -487,6 +488,22 @@ int DiscreteProblem::get_num_dofs() { return space->get_num_dofs(); };
   
 bool DiscreteProblem::is_matrix_free() { return false; };
 
+void DiscreteProblem::apply(scalar* coeff_in, scalar* coeff_out)
+{
+  set_zero(coeff_out, get_num_dofs());
+  MatrixFreeOperator op;
+  op.set_vectors(coeff_in, coeff_out);
+  assemble(NULL, &op);
+}
+
+void DiscreteProblem::get_diagonal(scalar* diag)
+{
+  set_zero(diag, get_num_dofs());
+  MatrixFreeOperator op;
+  op.set_vectors(NULL, NULL, diag);
+  assemble(NULL, &op);
+}
+
 // Signature of this function is identical in H1D, H2D, H3D, but it is currently unused in H1D.
 void DiscreteProblem::create_sparse_structure(SparseMatrix* matrix, Vector* rhs,
                                               bool force_diagonal_blocks, Table* block_weights) { return; };
@@ -40,6 +40,13 @@ public:
                                bool force_diagonal_blocks = false, Table* block_weights = NULL);
                                
   void invalidate_matrix() { return; }
+
+  // Matrix-free application of the Jacobian at the current coefficients of the 
+  // elements: coeff_out = J coeff_in.
+  void apply(scalar* coeff_in, scalar* coeff_out);
+
+  // Diagonal of the Jacobian at the current coefficients of the elements.
+  void get_diagonal(scalar* diag);
 private:
   WeakForm* wf;
   Space* space;
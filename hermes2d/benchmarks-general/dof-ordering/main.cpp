@@ -0,0 +1,106 @@
+#define HERMES_REPORT_WARN
+#define HERMES_REPORT_INFO
+#include "hermes2d.h"
+
+using namespace WeakFormsH1;
+
+//  This benchmark compares the orderings of DOF numbers (see Space::set_dof_ordering())
+//  on the L-shaped domain "domain.mesh" refined towards the re-entrant corner, so that
+//  the ids of nodes are scattered over the mesh as after many adaptive refinements.
+//  The Poisson problem is discretized with H1 elements of degree P_INIT and for every
+//  ordering the benchmark reports
+//    - the bandwidth and the profile (sum of distances of the first nonzero of each
+//      column from the diagonal) of the matrix,
+//    - the number of nonzeros of the LU factors computed by UMFPACK and the time of the
+//      factorization and solution (if UMFPACK is available),
+//    - the time of NUM_SPMV matrix-vector products.
+//
+//  Usage: dof-ordering [p_init] [refinements towards the corner]
+
+int P_INIT = 4;                                   // Uniform polynomial degree of mesh elements.
+int CORNER_REF_NUM = 12;                          // Number of refinements towards the re-entrant corner.
+const int INIT_REF_NUM = 3;                       // Number of initial uniform mesh refinements.
+const int NUM_SPMV = 100;                         // Number of matrix-vector products.
+
+int main(int argc, char* argv[])
+{
+  if (argc > 1) P_INIT = atoi(argv[1]);
+  if (argc > 2) CORNER_REF_NUM = atoi(argv[2]);
+
+  // Load and refine the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("domain.mesh", &mesh);
+  for (int i = 0; i < INIT_REF_NUM; i++)
+    mesh.refine_all_elements();
+  mesh.refine_towards_vertex(0, CORNER_REF_NUM);
+
+  DefaultWeakFormPoisson wf(HERMES_ANY, HERMES_ONE, HERMES_ONE);
+  DefaultEssentialBCConst bc_essential("Bdy", 0.0);
+  EssentialBCs bcs(&bc_essential);
+
+  const char* names[3] = { "natural", "RCM", "Hilbert" };
+  EDofOrdering orderings[3] = { HERMES_DOF_ORDERING_NATURAL, HERMES_DOF_ORDERING_RCM, HERMES_DOF_ORDERING_HILBERT };
+
+  printf("%8s %8s %10s %12s %12s %12s %12s\n", "ordering", "ndof", "bandwidth", "profile", "LU nnz",
+         "solve [s]", "spmv [s]");
+  for (int k = 0; k < 3; k++)
+  {
+    H1Space space(&mesh, &bcs, P_INIT);
+    TimePeriod timer;
+    space.set_dof_ordering(orderings[k]);
+    int ndof = space.assign_dofs();
+    timer.tick();
+    info("%s ordering: DOFs assigned in %g s.", names[k], timer.last());
+
+    DiscreteProblem dp(&wf, &space);
+    UMFPackMatrix mat;
+    UMFPackVector rhs;
+    dp.assemble(&mat, &rhs);
+
+    // Bandwidth and profile of the (symmetric) matrix.
+    int* Ap = mat.get_Ap();
+    int* Ai = mat.get_Ai();
+    long bandwidth = 0, profile = 0;
+    for (int j = 0; j < ndof; j++)
+    {
+      int first = j;
+      for (int p = Ap[j]; p < Ap[j + 1]; p++)
+      {
+        bandwidth = std::max(bandwidth, (long) std::abs(Ai[p] - j));
+        first = std::min(first, Ai[p]);
+      }
+      profile += j - first;
+    }
+
+    // Factorization and solution.
+    char solve_time[32] = "-", lu_nnz[32] = "-";
+#ifdef WITH_UMFPACK
+    UMFPackLinearSolver solver(&mat, &rhs);
+    timer.tick(HERMES_SKIP);
+    if (solver.solve())
+    {
+      sprintf(solve_time, "%.4f", timer.tick().last());
+      sprintf(lu_nnz, "%d", solver.get_lu_nnz());
+    }
+#endif
+
+    // Matrix-vector products.
+    scalar* x = new scalar[ndof];
+    scalar* y = new scalar[ndof];
+    for (int i = 0; i < ndof; i++)
+      x[i] = 1.0 / (i + 1);
+    timer.tick(HERMES_SKIP);
+    for (int i = 0; i < NUM_SPMV; i++)
+      mat.multiply_with_vector(x, y);
+    timer.tick();
+
+    printf("%8s %8d %10ld %12ld %12s %12s %12.4f\n", names[k], ndof, bandwidth, profile, lu_nnz,
+           solve_time, timer.last());
+
+    delete [] x;
+    delete [] y;
+  }
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+#define HERMES_REPORT_ALL
+#define HERMES_REPORT_FILE "application.log"
+#include "../01-analytic-solution/definitions.h"
+#ifndef _MSC_VER
+  #include <sys/resource.h>
+#endif
+
+//  This benchmark compares the built-in Krylov solver with UMFPACK on the matrices
+//  of the NIST benchmark 01 (Poisson problem with a known polynomial solution on the
+//  unit square, see ../01-analytic-solution). The problem is assembled on a uniformly
+//  refined mesh, then one linear solver is run and its time, number of iterations,
+//  growth of the peak resident memory and the exact error of the solution are printed.
+//
+//  Usage: nist-linear-solvers <solver> [precond] [init_ref_num] [p_init]
+//    solver  ... umfpack | cg | bicgstab | gmres
+//    precond ... none | jacobi | ilu0 | block-jacobi (ignored for umfpack)
+//
+//  Only one solver is run per process so that the peak memory of one solver does
+//  not hide the one of the other; see the script "run" for a comparison.
+
+int INIT_REF_NUM = 5;                             // Number of initial uniform mesh refinements.
+int P_INIT = 4;                                   // Initial polynomial degree of all mesh elements.
+double EXACT_SOL_P = 10;                          // The exact solution is a polynomial of degree 2*EXACT_SOL_P.
+const double TOLERANCE = 1e-10;                   // Relative residual required from the Krylov solver.
+
+// Peak resident set size of the process in kB.
+static long peak_memory()
+{
+#ifndef _MSC_VER
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+#else
+  return 0;
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2) error("Usage: %s <umfpack|cg|bicgstab|gmres> [precond] [init_ref_num] [p_init]", argv[0]);
+  const char* method = argv[1];
+  const char* precond = (argc > 2) ? argv[2] : "ilu0";
+  if (argc > 3) INIT_REF_NUM = atoi(argv[3]);
+  if (argc > 4) P_INIT = atoi(argv[4]);
+  bool direct = (strcasecmp(method, "umfpack") == 0);
+  MatrixSolverType matrix_solver = direct ? SOLVER_UMFPACK : SOLVER_KRYLOV;
+
+  // Instantiate a class with global functions.
+  Hermes2D hermes2d;
+
+  // Load the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("../01-analytic-solution/square_quad.mesh", &mesh);
+
+  // Perform initial mesh refinements.
+  for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements();
+
+  // Set exact solution.
+  CustomExactSolution exact(&mesh, EXACT_SOL_P);
+
+  // Define function f.
+  CustomFunction f(EXACT_SOL_P);
+
+  // Initialize the weak formulation.
+  HermesFunction lambda(1.0);
+  WeakFormsH1::DefaultWeakFormPoisson wf(HERMES_ANY, &lambda, &f);
+
+  // Initialize boundary conditions
+  DefaultEssentialBCNonConst bc_essential("Bdy", &exact);
+  EssentialBCs bcs(&bc_essential);
+
+  // Create an H1 space with default shapeset.
+  H1Space space(&mesh, &bcs, P_INIT);
+  int ndof = Space::get_num_dofs(&space);
+
+  // Set up the solver, matrix, and rhs according to the solver selection.
+  SparseMatrix* matrix = create_matrix(matrix_solver);
+  Vector* rhs = create_vector(matrix_solver);
+  Solver* solver = create_linear_solver(matrix_solver, matrix, rhs);
+  if (!direct) {
+    KrylovSolver* krylov = static_cast<KrylovSolver*>(solver);
+    krylov->set_solver(method);
+    krylov->set_precond(precond);
+    krylov->set_tolerance(TOLERANCE);
+  }
+
+  // Assemble the linear system J(0) x = -F(0).
+  DiscreteProblem dp(&wf, &space);
+  scalar* coeff_vec = new scalar[ndof];
+  memset(coeff_vec, 0, ndof * sizeof(scalar));
+  dp.assemble(coeff_vec, matrix, rhs);
+  rhs->change_sign();
+
+  // Solve it and measure how much the peak memory grows.
+  long mem_before = peak_memory();
+  TimePeriod cpu_time;
+  bool ok = solver->solve();
+  cpu_time.tick();
+  long mem_after = peak_memory();
+  if (!ok) warn("Matrix solver failed.");
+
+  // Exact error of the solution.
+  Solution sln;
+  Solution::vector_to_solution(solver->get_solution(), &space, &sln);
+  double err_exact_rel = hermes2d.calc_rel_error(&sln, &exact, HERMES_H1_NORM) * 100;
+
+  printf("solver: %s%s%s, ndof: %d, nnz: %d, time: %g s, iterations: %d, peak memory growth: %ld kB",
+         method, direct ? "" : "/", direct ? "" : precond, ndof, (int) static_cast<CSCMatrix*>(matrix)->get_nnz(),
+         cpu_time.accumulated(), direct ? 0 : static_cast<KrylovSolver*>(solver)->get_num_iters(), mem_after - mem_before);
+  if (!direct) printf(", solver data: %lu kB", (unsigned long) (static_cast<KrylovSolver*>(solver)->get_memory_usage() / 1024));
+  printf(", err_exact_rel: %g%%\n", err_exact_rel);
+
+  // Clean up.
+  delete [] coeff_vec;
+  delete solver;
+  delete matrix;
+  delete rhs;
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+#define HERMES_REPORT_ALL
+#define HERMES_REPORT_FILE "application.log"
+#include "../04-exponential-peak/definitions.h"
+
+//  This benchmark measures the effect of the order in which Traverse visits the base
+//  elements (see Mesh::set_sfc_traversal()) on the mesh of the NIST benchmark 04 (see
+//  ../04-exponential-peak). The base mesh is a BASE_N x BASE_N grid of quads numbered
+//  row by row, as a mesh generator would number it, and it is h-adapted towards the
+//  exponential peak by refining the elements where diam^2 * |f| exceeds REF_TOL (no
+//  linear solver is needed for that). The space has the uniform degree P_INIT. For
+//  each variant the benchmark reports
+//    - the mean distance between the centroids of consecutive active elements,
+//    - the time of the assembling of the matrix and the right-hand side,
+//    - the time of Adapt::calc_err_est() between two solutions with all coefficients
+//      equal to one on the space and on its reference space,
+//    - the time of the Linearizer on the exact solution.
+//  The variants are the order of ids, the Hilbert curve, and the Hilbert curve together
+//  with the Hilbert DOF ordering (Space::set_dof_ordering()).
+//
+//  Usage: nist-sfc-traversal [base_n] [p_init]
+
+int BASE_N = 16;                                  // Number of base elements in each direction.
+int P_INIT = 3;                                   // Uniform polynomial degree of mesh elements.
+const double REF_TOL = 1e-2;                      // Refinement threshold for diam^2 * |f|.
+const int MAX_REF_STEPS = 10;                     // Maximum number of refinement steps.
+const int NUM_REPEAT = 3;                         // Number of repetitions of each measurement.
+
+// Problem parameters.
+double alpha = 1000;
+double x_loc = 0.5;
+double y_loc = 0.5;
+
+// Writes the grid of BASE_N x BASE_N quads on the unit square to the file 'filename'.
+static void write_grid_mesh(const char* filename)
+{
+  FILE* f = fopen(filename, "w");
+  if (f == NULL) error("Could not create %s.", filename);
+  fprintf(f, "vertices = [\n");
+  for (int j = 0; j <= BASE_N; j++)
+    for (int i = 0; i <= BASE_N; i++)
+      fprintf(f, "  [ %.17g, %.17g ]%s\n", (double) i / BASE_N, (double) j / BASE_N,
+              (i == BASE_N && j == BASE_N) ? "" : ",");
+  fprintf(f, "]\n\nelements = [\n");
+  for (int j = 0; j < BASE_N; j++)
+    for (int i = 0; i < BASE_N; i++)
+    {
+      int v = j * (BASE_N + 1) + i;
+      fprintf(f, "  [ %d, %d, %d, %d, \"Mat\" ]%s\n", v, v + 1, v + BASE_N + 2, v + BASE_N + 1,
+              (i == BASE_N - 1 && j == BASE_N - 1) ? "" : ",");
+    }
+  fprintf(f, "]\n\nboundaries = [\n");
+  for (int i = 0; i < BASE_N; i++)
+  {
+    int b = i, r = i * (BASE_N + 1) + BASE_N, t = BASE_N * (BASE_N + 1) + i, l = i * (BASE_N + 1);
+    fprintf(f, "  [ %d, %d, \"Bdy\" ],\n", b, b + 1);
+    fprintf(f, "  [ %d, %d, \"Bdy\" ],\n", r, r + BASE_N + 1);
+    fprintf(f, "  [ %d, %d, \"Bdy\" ],\n", t, t + 1);
+    fprintf(f, "  [ %d, %d, \"Bdy\" ]%s\n", l, l + BASE_N + 1, (i == BASE_N - 1) ? "" : ",");
+  }
+  fprintf(f, "]\n");
+  fclose(f);
+}
+
+// Returns the mean distance between the centroids of consecutive active elements
+// in the order of Traverse.
+static double mean_step(Mesh* mesh)
+{
+  Traverse trav;
+  trav.begin(1, &mesh);
+  Element** ee;
+  double sum = 0.0, px = 0.0, py = 0.0;
+  int n = 0;
+  while ((ee = trav.get_next_state(NULL, NULL)) != NULL)
+  {
+    double x = 0.0, y = 0.0;
+    for (unsigned int i = 0; i < ee[0]->nvert; i++)
+    {
+      x += ee[0]->vn[i]->x / ee[0]->nvert;
+      y += ee[0]->vn[i]->y / ee[0]->nvert;
+    }
+    if (n++ > 0) sum += sqrt(sqr(x - px) + sqr(y - py));
+    px = x;
+    py = y;
+  }
+  trav.finish();
+  return sum / std::max(n - 1, 1);
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 1) BASE_N = atoi(argv[1]);
+  if (argc > 2) P_INIT = atoi(argv[2]);
+
+  // Create the base mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  write_grid_mesh("grid.mesh");
+  mloader.load("grid.mesh", &mesh);
+  remove("grid.mesh");
+
+  // Refine towards the peak.
+  CustomFunction f(alpha, x_loc, y_loc);
+  for (int step = 0; step < MAX_REF_STEPS; step++)
+  {
+    std::vector<int> ids;
+    Element* e;
+    for_all_active_elements(e, &mesh)
+    {
+      double x = 0.0, y = 0.0;
+      for (unsigned int i = 0; i < e->nvert; i++)
+      {
+        x += e->vn[i]->x / e->nvert;
+        y += e->vn[i]->y / e->nvert;
+      }
+      if (sqr(e->get_diameter()) * fabs(f.value(x, y)) > REF_TOL)
+        ids.push_back(e->id);
+    }
+    if (ids.empty()) break;
+    for (unsigned int i = 0; i < ids.size(); i++)
+      mesh.refine_element_id(ids[i]);
+  }
+  info("Adapted mesh: %d base elements, %d active elements.", mesh.get_num_base_elements(),
+       mesh.get_num_active_elements());
+
+  CustomExactSolution exact(&mesh, alpha, x_loc, y_loc);
+  HermesFunction lambda(1.0);
+  WeakFormsH1::DefaultWeakFormPoisson wf(HERMES_ANY, &lambda, &f);
+  DefaultEssentialBCNonConst bc("Bdy", &exact);
+  EssentialBCs bcs(&bc);
+
+  const char* names[3] = { "ids", "sfc", "sfc+dofs" };
+  printf("%9s %8s %10s %14s %14s %14s %12s\n", "order", "ndof", "mean step",
+         "assemble [s]", "err_est [s]", "linearize [s]", "err_est");
+  for (int k = 0; k < 3; k++)
+  {
+    Mesh variant_mesh;
+    variant_mesh.copy(&mesh);
+    variant_mesh.set_sfc_traversal(k > 0);
+
+    H1Space space(&variant_mesh, &bcs, P_INIT);
+    if (k == 2) space.set_dof_ordering(HERMES_DOF_ORDERING_HILBERT);
+    int ndof = space.assign_dofs();
+    Space* ref_space = Space::construct_refined_space(&space);
+    int ndof_ref = Space::get_num_dofs(ref_space);
+
+    // Assembling; the first run creates the sparse structure and is not counted.
+    DiscreteProblem dp(&wf, &space);
+    CSCMatrix matrix;
+    UMFPackVector rhs;
+    dp.assemble(&matrix, &rhs);
+    TimePeriod timer;
+    for (int i = 0; i < NUM_REPEAT; i++)
+      dp.assemble(&matrix, &rhs);
+    double t_assemble = timer.tick().last() / NUM_REPEAT;
+
+    // Error estimation between two solutions with all coefficients equal to one, which
+    // do not depend on the DOF ordering (the higher-order parts make them differ).
+    scalar* coeffs = new scalar[ndof];
+    scalar* ref_coeffs = new scalar[ndof_ref];
+    for (int i = 0; i < ndof; i++) coeffs[i] = 1.0;
+    for (int i = 0; i < ndof_ref; i++) ref_coeffs[i] = 1.0;
+    Solution sln, ref_sln;
+    Solution::vector_to_solution(coeffs, &space, &sln);
+    Solution::vector_to_solution(ref_coeffs, ref_space, &ref_sln);
+    double err_est = 0.0;
+    timer.tick(HERMES_SKIP);
+    for (int i = 0; i < NUM_REPEAT; i++)
+    {
+      Adapt adaptivity(&space);
+      err_est = adaptivity.calc_err_est(&sln, &ref_sln);
+    }
+    double t_err_est = timer.tick().last() / NUM_REPEAT;
+
+    // Linearization of the exact solution on the mesh of the variant.
+    CustomExactSolution variant_exact(&variant_mesh, alpha, x_loc, y_loc);
+    timer.tick(HERMES_SKIP);
+    for (int i = 0; i < NUM_REPEAT; i++)
+    {
+      Linearizer lin;
+      lin.process_solution(&variant_exact);
+    }
+    double t_linearize = timer.tick().last() / NUM_REPEAT;
+
+    printf("%9s %8d %10.3e %14.4f %14.4f %14.4f %12.6e\n", names[k], ndof, mean_step(&variant_mesh),
+           t_assemble, t_err_est, t_linearize, err_est);
+
+    delete [] coeffs;
+    delete [] ref_coeffs;
+    delete ref_space->get_mesh();
+    delete ref_space;
+  }
+
+  return 0;
+}
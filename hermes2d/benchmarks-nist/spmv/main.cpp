@@ -0,0 +1,95 @@
+#define HERMES_REPORT_ALL
+#define HERMES_REPORT_FILE "application.log"
+#include "../01-analytic-solution/definitions.h"
+
+//  This microbenchmark measures the matrix-vector products of CSCMatrix on the matrices
+//  of the NIST benchmark 01 (see ../01-analytic-solution), assembled on uniformly refined
+//  meshes for a range of polynomial degrees. For each matrix it reports the time of one
+//  product and the achieved memory bandwidth of
+//    - the serial column-wise product (CSCMatrix::set_row_storage(false)),
+//    - the row-wise product (multithreaded if Hermes was built WITH_OPENMP),
+//    - the transposed product.
+//  The bandwidth is computed from the minimal memory traffic of one product: the values
+//  and indices of the matrix, the row (column) pointers, one read of the input vector
+//  and one write of the output vector.
+//
+//  Usage: nist-spmv [init_ref_num] [num_products]
+
+int INIT_REF_NUM = 5;                             // Number of initial uniform mesh refinements.
+int NUM_PRODUCTS = 50;                            // Number of products per measurement.
+double EXACT_SOL_P = 10;                          // Parameter of the exact solution.
+
+// Returns the time of one product in seconds.
+static double measure(CSCMatrix* matrix, scalar* x, scalar* y, bool transposed)
+{
+  // The first product also creates the row-wise copy, do not count it.
+  if (transposed) matrix->multiply_with_vector_transposed(x, y);
+  else matrix->multiply_with_vector(x, y);
+
+  TimePeriod timer;
+  for (int i = 0; i < NUM_PRODUCTS; i++) {
+    if (transposed) matrix->multiply_with_vector_transposed(x, y);
+    else matrix->multiply_with_vector(x, y);
+  }
+  timer.tick();
+  return timer.accumulated() / NUM_PRODUCTS;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 1) INIT_REF_NUM = atoi(argv[1]);
+  if (argc > 2) NUM_PRODUCTS = atoi(argv[2]);
+
+  // Load the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("../01-analytic-solution/square_quad.mesh", &mesh);
+
+  // Perform initial mesh refinements.
+  for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements();
+
+  // Set exact solution and the weak formulation.
+  CustomExactSolution exact(&mesh, EXACT_SOL_P);
+  CustomFunction f(EXACT_SOL_P);
+  HermesFunction lambda(1.0);
+  WeakFormsH1::DefaultWeakFormPoisson wf(HERMES_ANY, &lambda, &f);
+  DefaultEssentialBCNonConst bc_essential("Bdy", &exact);
+  EssentialBCs bcs(&bc_essential);
+
+  printf("%8s %4s %10s %10s   %-23s %-23s %-23s\n", "ndof", "p", "nnz", "MB",
+         "column-wise serial", "row-wise", "transposed");
+  for (int p = 1; p <= 6; p++) {
+    H1Space space(&mesh, &bcs, p);
+    int ndof = Space::get_num_dofs(&space);
+
+    // Assemble the matrix.
+    CSCMatrix matrix;
+    UMFPackVector rhs;
+    DiscreteProblem dp(&wf, &space);
+    dp.assemble(&matrix, &rhs);
+    unsigned int nnz = matrix.get_nnz();
+
+    scalar* x = new scalar[ndof];
+    scalar* y = new scalar[ndof];
+    for (int i = 0; i < ndof; i++) x[i] = 1.0 + (double) i / ndof;
+
+    // Minimal memory traffic of one product in bytes.
+    double bytes = (double) nnz * (sizeof(scalar) + sizeof(int)) + (ndof + 1) * sizeof(int)
+                   + 2.0 * ndof * sizeof(scalar);
+
+    matrix.set_row_storage(false);
+    double t_csc = measure(&matrix, x, y, false);
+    matrix.set_row_storage(true);
+    double t_csr = measure(&matrix, x, y, false);
+    double t_trans = measure(&matrix, x, y, true);
+
+    printf("%8d %4d %10u %10.1f   %9.3g s %6.2f GB/s %9.3g s %6.2f GB/s %9.3g s %6.2f GB/s\n",
+           ndof, p, nnz, bytes / 1e6,
+           t_csc, bytes / t_csc / 1e9, t_csr, bytes / t_csr / 1e9, t_trans, bytes / t_trans / 1e9);
+
+    delete [] x;
+    delete [] y;
+  }
+
+  return 0;
+}
@@ -28,6 +28,9 @@
 #include "../views/order_view.h"
 #include "../../../hermes_common/matrix.h"
 #include "../../../hermes_common/common_time_period.h"
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
 
 using namespace std;
 
@@ -37,7 +40,8 @@ Adapt::Adapt(Hermes::vector<Space *> spaces,
     num_act_elems(-1),
     have_errors(false),
     have_coarse_solutions(false),
-    have_reference_solutions(false)
+    have_reference_solutions(false),
+    num_threads(1)
 {
   // sanity check
   if (proj_norms.size() > 0 && spaces.size() != proj_norms.size())
@@ -82,7 +86,8 @@ Adapt::Adapt(Space* space, ProjNormType proj_norm) :
     num_act_elems(-1),
     have_errors(false),
     have_coarse_solutions(false),
-    have_reference_solutions(false)
+    have_reference_solutions(false),
+    num_threads(1)
 {
   spaces.push_back(space);
 
@@ -121,8 +126,43 @@ Adapt::~Adapt()
         delete error_form[i][j];
 }
 
+void Adapt::set_num_threads(int num_threads)
+{
+  if (num_threads < 1)
+    error("The number of threads has to be positive in Adapt::set_num_threads().");
+#ifndef _OPENMP
+  if (num_threads > 1)
+    warn("Hermes2D was built without OpenMP (WITH_OPENMP), the errors will be calculated serially.");
+#endif
+  this->num_threads = num_threads;
+}
+
 //// adapt /////////////////////////////////////////////////////////////////////////////////////////
 
+// Returns true if the adaptivity loop of Adapt::adapt() ends at a regular element with a given error.
+static bool is_adaptivity_loop_finished(int strat, double thr, double to_be_processed, double errors_squared_sum,
+                                        double err_squared, double err0_squared, double processed_error_squared,
+                                        double error_squared_threshod)
+{
+  // first refinement strategy:
+  // refine elements until prescribed amount of error is processed
+  // if more elements have similar error refine all to keep the mesh symmetric
+  if ((strat == 0) && (processed_error_squared > sqrt(thr) * errors_squared_sum)
+                   && fabs((err_squared - err0_squared)/err0_squared) > 1e-3) return true;
+
+  // second refinement strategy:
+  // refine all elements whose error is bigger than some portion of maximal error
+  if ((strat == 1) && (err_squared < error_squared_threshod)) return true;
+
+  if ((strat == 2) && (err_squared < thr)) return true;
+
+  if ((strat == 3) &&
+    ( (err_squared < error_squared_threshod) ||
+    ( processed_error_squared > 1.5 * to_be_processed )) ) return true;
+
+  return false;
+}
+
 bool Adapt::adapt(Hermes::vector<RefinementSelectors::Selector *> refinement_selectors, double thr, int strat,
             int regularize, double to_be_processed)
 {
@@ -168,6 +208,21 @@ bool Adapt::adapt(Hermes::vector<RefinementSelectors::Selector *> refinement_sel
 
   bool first_regular_element = true; //true if first regular element was not processed yet
   int inx_regular_element = 0;
+
+  // With several threads, the refinements of the elements of the regular queue are selected in advance
+  // (see select_refinements_parallel()) for the elements that are predicted to be examined. The selected
+  // refinements are then processed in the order of the queue, so the result does not depend on the number of threads.
+  bool parallel_selection = (num_threads > 1);
+  std::vector<signed char> ignored; //1 if an element of the regular queue should be ignored, -1 if not known yet
+  std::vector<ElementToRefine> selected_refinements; //refinements selected in advance, valid for the indices below inx_selected_end
+  std::vector<char> selected_refined; //1 if a refinement selected in advance was proposed
+  int inx_selected_end = 0;
+  if (parallel_selection) {
+    ignored.assign(num_act_elems, -1);
+    selected_refinements.resize(num_act_elems);
+    selected_refined.assign(num_act_elems, 0);
+  }
+
   while (inx_regular_element < num_act_elems || !priority_queue.empty())
   {
     int id, comp, inx_element;
@@ -193,7 +248,17 @@ bool Adapt::adapt(Hermes::vector<RefinementSelectors::Selector *> refinement_sel
     Mesh* mesh = meshes[comp];
     Element* e = mesh->get_element(id);
 
-    if (!should_ignore_element(inx_element, mesh, e)) {
+    //the answer may be known from the prediction of examined elements
+    bool ignore;
+    if (inx_element >= 0 && !ignored.empty() && ignored[inx_element] >= 0)
+      ignore = (ignored[inx_element] != 0);
+    else {
+      ignore = should_ignore_element(inx_element, mesh, e);
+      if (inx_element >= 0 && !ignored.empty())
+        ignored[inx_element] = ignore ? 1 : 0;
+    }
+
+    if (!ignore) {
       //check if adaptivity loop should end
       if (inx_element >= 0) {
         //prepare error threshold for strategy 1
@@ -202,28 +267,48 @@ bool Adapt::adapt(Hermes::vector<RefinementSelectors::Selector *> refinement_sel
           first_regular_element = false;
         }
 
-        // first refinement strategy:
-        // refine elements until prescribed amount of error is processed
-        // if more elements have similar error refine all to keep the mesh symmetric
-        if ((strat == 0) && (processed_error_squared > sqrt(thr) * errors_squared_sum)
-                         && fabs((err_squared - err0_squared)/err0_squared) > 1e-3) break;
-
-        // second refinement strategy:
-        // refine all elements whose error is bigger than some portion of maximal error
-        if ((strat == 1) && (err_squared < error_squared_threshod)) break;
-
-        if ((strat == 2) && (err_squared < thr)) break;
+        if (is_adaptivity_loop_finished(strat, thr, to_be_processed, errors_squared_sum, err_squared,
+                                        err0_squared, processed_error_squared, error_squared_threshod)) break;
+
+        //select refinements of the elements that will be examined by several threads
+        if (parallel_selection && inx_element >= inx_selected_end) {
+          //predict the examined elements assuming that all of them will be refined
+          double pred_err0_squared = err0_squared, pred_processed_error_squared = processed_error_squared;
+          int inx_last = inx_element;
+          while (inx_last < num_act_elems) {
+            int pred_id = regular_queue[inx_last].id, pred_comp = regular_queue[inx_last].comp;
+            if (ignored[inx_last] < 0)
+              ignored[inx_last] = should_ignore_element(inx_last, meshes[pred_comp], meshes[pred_comp]->get_element(pred_id)) ? 1 : 0;
+            if (!ignored[inx_last]) {
+              double pred_err_squared = errors[pred_comp][pred_id];
+              if (is_adaptivity_loop_finished(strat, thr, to_be_processed, errors_squared_sum, pred_err_squared,
+                                              pred_err0_squared, pred_processed_error_squared, error_squared_threshod)) break;
+              pred_err0_squared = pred_err_squared;
+              pred_processed_error_squared += pred_err_squared;
+            }
+            inx_last++;
+          }
 
-        if ((strat == 3) &&
-          ( (err_squared < error_squared_threshod) ||
-          ( processed_error_squared > 1.5 * to_be_processed )) ) break;
+          if (select_refinements_parallel(refinement_selectors, inx_element, inx_last, ignored,
+                                          selected_refinements, selected_refined))
+            inx_selected_end = inx_last;
+          else
+            parallel_selection = false;
+        }
       }
 
       // get refinement suggestion
       ElementToRefine elem_ref(id, comp);
-      int current = this->spaces[comp]->get_element_order(id);
-      // rsln[comp] may be unset if refinement_selectors[comp] == HOnlySelector or POnlySelector
-      bool refined = refinement_selectors[comp]->select_refinement(e, current, rsln[comp], elem_ref);
+      bool refined;
+      if (inx_element >= 0 && inx_element < inx_selected_end) {
+        elem_ref = selected_refinements[inx_element];
+        refined = (selected_refined[inx_element] != 0);
+      }
+      else {
+        int current = this->spaces[comp]->get_element_order(id);
+        // rsln[comp] may be unset if refinement_selectors[comp] == HOnlySelector or POnlySelector
+        refined = refinement_selectors[comp]->select_refinement(e, current, rsln[comp], elem_ref);
+      }
 
       //add to a list of elements that are going to be refined
       if (can_refine_element(mesh, e, refined, elem_ref) ) {
@@ -315,6 +400,95 @@ bool Adapt::adapt(RefinementSelectors::Selector* refinement_selector, double thr
   return adapt(refinement_selectors, thr, strat, regularize, to_be_processed);
 }
 
+// Data private to one thread of the parallel selection of refinements.
+struct ParallelSelectionWorker
+{
+  std::map<RefinementSelectors::Selector*, RefinementSelectors::Selector*> selectors; // clones of the selectors
+  std::map<Solution*, Solution*> rslns; // copies of the reference solutions
+};
+
+bool Adapt::select_refinements_parallel(Hermes::vector<RefinementSelectors::Selector *>& refinement_selectors,
+                                        int inx_first, int inx_last, const std::vector<signed char>& ignored,
+                                        std::vector<ElementToRefine>& refinements, std::vector<char>& refined)
+{
+  _F_
+#ifdef _OPENMP
+  // Every thread needs its own copy of the reference solutions.
+  for (int j = 0; j < this->num; j++)
+    if (rsln[j] != NULL && rsln[j]->get_type() != HERMES_SLN && rsln[j]->get_type() != HERMES_CONST) {
+      verbose("Parallel selection of refinements supports only reference solutions of type HERMES_SLN and HERMES_CONST, selecting serially.");
+      return false;
+    }
+
+  // Create the workers. A selector or a reference solution used by several components is copied once.
+  std::vector<ParallelSelectionWorker> workers(num_threads);
+  bool clonable = true;
+  for (int t = 0; t < num_threads && clonable; t++) {
+    ParallelSelectionWorker& w = workers[t];
+    for (int j = 0; j < this->num && clonable; j++) {
+      if (w.selectors.find(refinement_selectors[j]) == w.selectors.end()) {
+        RefinementSelectors::Selector* clone = refinement_selectors[j]->clone();
+        if (clone != NULL)
+          w.selectors[refinement_selectors[j]] = clone;
+        else
+          clonable = false;
+      }
+      if (rsln[j] != NULL && w.rslns.find(rsln[j]) == w.rslns.end()) {
+        Solution* copy = new Solution;
+        copy->copy(rsln[j], true);
+        copy->set_private_refmap_shapeset();
+        copy->enable_transform(false);
+        w.rslns[rsln[j]] = copy;
+      }
+    }
+  }
+
+  if (clonable) {
+    // The selectors examine the sons of the element in the reference mesh, calculate the orders of the inverse
+    // reference maps (cached in the elements) here so that the workers only read them.
+    RefMap refmap;
+    for (int i = inx_first; i < inx_last; i++) {
+      int comp = regular_queue[i].comp;
+      if (ignored[i] || rsln[comp] == NULL)
+        continue;
+      Element* base_element = rsln[comp]->get_mesh()->get_element(regular_queue[i].id);
+      if (base_element->active)
+        continue;
+      for (int son = 0; son < H2D_MAX_ELEMENT_SONS; son++)
+        if (base_element->sons[son] != NULL && base_element->sons[son]->iro_cache == -1)
+          refmap.set_active_element(base_element->sons[son]);
+    }
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+    for (int i = inx_first; i < inx_last; i++) {
+      if (ignored[i])
+        continue;
+      ParallelSelectionWorker& w = workers[omp_get_thread_num()];
+      int id = regular_queue[i].id, comp = regular_queue[i].comp;
+      Element* e = this->spaces[comp]->get_mesh()->get_element(id);
+      Solution* rs = (rsln[comp] != NULL) ? w.rslns.find(rsln[comp])->second : NULL;
+      ElementToRefine elem_ref(id, comp);
+      int current = this->spaces[comp]->get_element_order(id);
+      refined[i] = w.selectors.find(refinement_selectors[comp])->second->select_refinement(e, current, rs, elem_ref) ? 1 : 0;
+      refinements[i] = elem_ref;
+    }
+  }
+  else {
+    verbose("A refinement selector does not support a concurrent selection, selecting serially.");
+  }
+
+  for (int t = 0; t < num_threads; t++) {
+    for (std::map<RefinementSelectors::Selector*, RefinementSelectors::Selector*>::iterator it = workers[t].selectors.begin(); it != workers[t].selectors.end(); it++)
+      delete it->second;
+    for (std::map<Solution*, Solution*>::iterator it = workers[t].rslns.begin(); it != workers[t].rslns.end(); it++)
+      delete it->second;
+  }
+  return clonable;
+#else
+  return false;
+#endif
+}
+
 void Adapt::fix_shared_mesh_refinements(Mesh** meshes, Hermes::vector<ElementToRefine>& elems_to_refine,
                                         int** idx, Hermes::vector<RefinementSelectors::Selector *> refinement_selectors) {
   int num_elem_to_proc = elems_to_refine.size();
@@ -685,6 +859,137 @@ double Adapt::eval_error_norm(Adapt::MatrixFormVolError* form,
   return std::abs(res);
 }
 
+bool Adapt::is_parallel_error_calculation_possible(const Hermes::vector<Solution *>& slns)
+{
+#ifdef _OPENMP
+  // Every thread needs its own copy of the solutions.
+  for (unsigned int i = 0; i < slns.size(); i++)
+    if (slns[i]->get_type() != HERMES_SLN && slns[i]->get_type() != HERMES_CONST) {
+      verbose("Parallel error calculation supports only solutions of type HERMES_SLN and HERMES_CONST, calculating serially.");
+      return false;
+    }
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Data private to one thread of the parallel error calculation.
+struct ParallelErrorWorker
+{
+  Quad2DStd* quad;
+  std::map<Solution*, Solution*> copies;
+};
+
+void Adapt::eval_errors_parallel(Mesh** meshes, std::vector<int>& state_ids,
+                                 std::vector<double>& state_errors, std::vector<double>& state_norms)
+{
+  _F_
+#ifdef _OPENMP
+  int nfns = 2 * num;
+  Solution* fns[2 * H2D_MAX_COMPONENTS];
+  for (int i = 0; i < num; i++) {
+    fns[i] = sln[i];
+    fns[i + num] = rsln[i];
+  }
+
+  // Traverse the meshes with plain Transformables in place of the solutions,
+  // and record all states. The solutions are set up later by the workers.
+  Transformable* trav_fns = new Transformable[nfns];
+  Transformable** trav_fn_ptrs = new Transformable*[nfns];
+  for (int i = 0; i < nfns; i++)
+    trav_fn_ptrs[i] = trav_fns + i;
+
+  std::vector<Element*> state_fn_e;
+  std::vector<uint64_t> state_sub_idx;
+  std::vector<int> state_mode;
+  RefMap refmap;
+  Traverse trav;
+  Element** ee;
+  trav.begin(nfns, meshes, trav_fn_ptrs);
+  while ((ee = trav.get_next_state(NULL, NULL)) != NULL) {
+    for (int i = 0; i < nfns; i++) {
+      state_fn_e.push_back(trav_fns[i].get_active_element());
+      state_sub_idx.push_back(trav_fns[i].get_transform());
+
+      // The order of the inverse reference map is cached in the element,
+      // calculate it here so that the workers only read it.
+      if (ee[i]->iro_cache == -1)
+        refmap.set_active_element(ee[i]);
+    }
+    for (int i = 0; i < num; i++)
+      state_ids.push_back(ee[i]->id);
+    state_mode.push_back(ee[0]->get_mode());
+  }
+  trav.finish();
+  delete [] trav_fn_ptrs;
+  delete [] trav_fns;
+
+  int num_states = state_ids.size() / num;
+  state_errors.assign(num_states * num * num, 0.0);
+  state_norms.assign(num_states * num * num, 0.0);
+
+  // Create the workers. A solution used by several components is copied once.
+  std::vector<ParallelErrorWorker> workers(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    ParallelErrorWorker& w = workers[t];
+    w.quad = new Quad2DStd;
+    for (int i = 0; i < nfns; i++) {
+      if (w.copies.find(fns[i]) != w.copies.end())
+        continue;
+      Solution* copy = new Solution;
+      copy->copy(fns[i], true);
+      copy->set_private_refmap_shapeset();
+      copy->set_quad_2d(w.quad);
+      w.copies[fns[i]] = copy;
+    }
+  }
+
+  // The limit table is shared by all threads, evaluate the states of each mode separately.
+  for (int mode = 0; mode < 2; mode++) {
+    std::vector<int> bucket;
+    for (int s = 0; s < num_states; s++)
+      if (state_mode[s] == mode)
+        bucket.push_back(s);
+    if (bucket.empty())
+      continue;
+
+    update_limit_table(mode);
+
+    int nb = bucket.size();
+#pragma omp parallel for schedule(dynamic, 8) num_threads(num_threads)
+    for (int k = 0; k < nb; k++) {
+      ParallelErrorWorker& w = workers[omp_get_thread_num()];
+      int s = bucket[k];
+
+      // Replay the state on the solutions of the worker.
+      Solution* fn[2 * H2D_MAX_COMPONENTS];
+      for (int i = 0; i < nfns; i++) {
+        fn[i] = w.copies.find(fns[i])->second;
+        Element* fe = state_fn_e[s * nfns + i];
+        uint64_t sub_idx = state_sub_idx[s * nfns + i];
+        if (fn[i]->get_active_element() != fe || sub_idx == 0)
+          fn[i]->set_active_element(fe);
+        fn[i]->set_transform(sub_idx);
+      }
+
+      for (int i = 0; i < num; i++)
+        for (int j = 0; j < num; j++)
+          if (error_form[i][j] != NULL) {
+            state_errors[(s * num + i) * num + j] = eval_error(error_form[i][j], fn[i], fn[j], fn[i + num], fn[j + num]);
+            state_norms[(s * num + i) * num + j] = eval_error_norm(error_form[i][j], fn[i + num], fn[j + num]);
+          }
+    }
+  }
+
+  for (int t = 0; t < num_threads; t++) {
+    for (std::map<Solution*, Solution*>::iterator it = workers[t].copies.begin(); it != workers[t].copies.end(); it++)
+      delete it->second;
+    delete workers[t].quad;
+  }
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 double Adapt::calc_err_internal(Hermes::vector<Solution *> slns, Hermes::vector<Solution *> rslns,
                                 Hermes::vector<double>* component_errors, bool solutions_for_adapt, unsigned int error_flags)
@@ -744,27 +1049,58 @@ double Adapt::calc_err_internal(Hermes::vector<Solution *> slns, Hermes::vector<
   double total_error = 0.0;
 
   // Calculate error.
-  Element **ee;
-  trav.begin(2 * num, meshes, tr);
-  while ((ee = trav.get_next_state(NULL, NULL)) != NULL) {
-    for (i = 0; i < num; i++) {
-      for (j = 0; j < num; j++) {
-        if (error_form[i][j] != NULL) {
-          double err, nrm;
-          err = eval_error(error_form[i][j], sln[i], sln[j], rsln[i], rsln[j]);
-          nrm = eval_error_norm(error_form[i][j], rsln[i], rsln[j]);
-
-          norms[i] += nrm;
-          total_norm  += nrm;
-          total_error += err;
-          errors_components[i] += err;
-          if(solutions_for_adapt)
-            this->errors[i][ee[i]->id] += err;
+  Hermes::vector<Solution *> all_slns = slns;
+  all_slns.insert(all_slns.end(), rslns.begin(), rslns.end());
+  if (num_threads > 1 && is_parallel_error_calculation_possible(all_slns)) {
+    // Sum up the errors of the states in the order of the serial traversal.
+    std::vector<int> state_ids;
+    std::vector<double> state_errors, state_norms;
+    eval_errors_parallel(meshes, state_ids, state_errors, state_norms);
+    int num_states = state_ids.size() / num;
+    for (int s = 0; s < num_states; s++) {
+      for (i = 0; i < num; i++) {
+        for (j = 0; j < num; j++) {
+          if (error_form[i][j] != NULL) {
+            double err = state_errors[(s * num + i) * num + j];
+            double nrm = state_norms[(s * num + i) * num + j];
+
+            norms[i] += nrm;
+            total_norm  += nrm;
+            total_error += err;
+            errors_components[i] += err;
+            if(solutions_for_adapt)
+              this->errors[i][state_ids[s * num + i]] += err;
+          }
         }
       }
     }
   }
-  trav.finish();
+  else {
+    Element **ee;
+    trav.begin(2 * num, meshes, tr);
+    while ((ee = trav.get_next_state(NULL, NULL)) != NULL) {
+      // Set maximum integration order for use in integrals, see limit_order()
+      update_limit_table(ee[0]->get_mode());
+
+      for (i = 0; i < num; i++) {
+        for (j = 0; j < num; j++) {
+          if (error_form[i][j] != NULL) {
+            double err, nrm;
+            err = eval_error(error_form[i][j], sln[i], sln[j], rsln[i], rsln[j]);
+            nrm = eval_error_norm(error_form[i][j], rsln[i], rsln[j]);
+
+            norms[i] += nrm;
+            total_norm  += nrm;
+            total_error += err;
+            errors_components[i] += err;
+            if(solutions_for_adapt)
+              this->errors[i][ee[i]->id] += err;
+          }
+        }
+      }
+    }
+    trav.finish();
+  }
 
   // Store the calculation for each solution component separately.
   if(component_errors != NULL) {
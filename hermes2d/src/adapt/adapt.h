@@ -278,6 +278,17 @@ public:
   /** \return A total number of active elements. If below 0, errors were not calculated yet, see set_solutions() */
   int get_total_active_elements() const { return num_act_elems; };
 
+  /// Sets the number of threads used to calculate the errors of elements and to select refinements (default 1, i.e. serial calculation).
+  /** Has effect only if Hermes was built with OpenMP (WITH_OPENMP). Every thread evaluates the error forms
+   *  on its own copies of the solutions, the errors are then summed up in the order of the serial
+   *  calculation, so the results do not depend on the number of threads. Solutions other than
+   *  ::HERMES_SLN and ::HERMES_CONST (e.g. exact solutions) are processed serially.
+   *  In adapt(), every thread selects refinements with its own clones of the selectors (see RefinementSelectors::Selector::clone()),
+   *  the refinements are then processed in the order of the serial selection. Selectors which cannot be cloned are used serially.
+   *  \param[in] num_threads A number of threads. */
+  void set_num_threads(int num_threads);
+  int get_num_threads() const { return num_threads; };
+
   /// Apply a single refienement.
   /** \param[in] A refinement to apply. */
   void apply_refinement(const ElementToRefine& elem_ref);
@@ -297,6 +308,7 @@ protected: //adaptivity
 
   /// Returns true if a given element should be ignored and not processed through refinement selection.
   /** Overload this method to omit some elements from processing.
+   *  If several threads are used (see set_num_threads()), the method is called in advance for the elements of the regular queue that are predicted to be examined.
    *  \param[in] inx_element An index of an element in the regular queue. -1 if the element cames from the priority queue.
    *  \param[in] mesh A mesh that contains the element.
    *  \parar[in] element A pointer to the element.
@@ -314,6 +326,20 @@ protected: //adaptivity
    *  \return True if the element should not be refined using the refinement. */
   virtual bool can_refine_element(Mesh* mesh, Element* e, bool refined, ElementToRefine& elem_ref) { return refined; };
 
+  /// Selects refinements of elements of the regular queue by several threads.
+  /** Elements Adapt::regular_queue[inx_first, inx_last) which are not ignored are processed. Every thread uses its own
+   *  clones of the selectors and its own copies of the reference solutions.
+   *  \param[in] refinement_selectors Selectors of components.
+   *  \param[in] inx_first An index of the first element in the regular queue.
+   *  \param[in] inx_last An index behind the last element in the regular queue.
+   *  \param[in] ignored Results of should_ignore_element() for the elements of the regular queue, indexing: [index in the regular queue].
+   *  \param[out] refinements Selected refinements, indexed as \a ignored.
+   *  \param[out] refined Results of RefinementSelectors::Selector::select_refinement(), indexed as \a ignored.
+   *  \return False if the refinements cannot be selected by several threads (e.g. a selector does not support it), nothing is selected then. */
+  bool select_refinements_parallel(Hermes::vector<RefinementSelectors::Selector *>& refinement_selectors,
+                                   int inx_first, int inx_last, const std::vector<signed char>& ignored,
+                                   std::vector<ElementToRefine>& refinements, std::vector<char>& refined);
+
   /// Fixes refinements of a mesh which is shared among multiple components of a multimesh.
   /** If a mesh is shared among components, it has to be refined similarly in order to avoid incosistency.
    *  \param[in] meshes An array of meshes of components.
@@ -342,6 +368,7 @@ protected: // spaces & solutions
   double  errors_squared_sum;           ///< Sum of errors in the array Adapt::errors_squared. Used by a method adapt() in some strategies.
 
   double error_time;                    ///< Time needed to calculate the error.
+  int num_threads;                      ///< A number of threads used to calculate the errors and to select refinements, see set_num_threads().
 
 protected: //forms and error evaluation
   static const unsigned char HERMES_TOTAL_ERROR_MASK = 0x0F;    ///< A mask which masks-out total error type. Used by Adapt::calc_err_internal(). \internal
@@ -391,6 +418,19 @@ protected: //forms and error evaluation
   virtual double eval_error_norm(Adapt::MatrixFormVolError* form,
                                  MeshFunction *rsln1, MeshFunction *rsln2);
 
+  /// Returns true if the errors of given solutions can be calculated by several threads.
+  /** \param[in] slns Solutions (both coarse and reference) the errors are calculated from. */
+  bool is_parallel_error_calculation_possible(const Hermes::vector<Solution *>& slns);
+
+  /// Evaluates the errors and the norms of all states of the traversal of coarse and reference meshes by several threads.
+  /** The solutions are taken from Adapt::sln and Adapt::rsln.
+   *  \param[in] meshes An array of 2 * num meshes: meshes of coarse solutions followed by meshes of reference solutions.
+   *  \param[out] state_ids IDs of elements of coarse solutions, indexing: [state * num + i].
+   *  \param[out] state_errors Results of eval_error(), indexing: [(state * num + i) * num + j].
+   *  \param[out] state_norms Results of eval_error_norm(), indexed as state_errors. */
+  void eval_errors_parallel(Mesh** meshes, std::vector<int>& state_ids,
+                            std::vector<double>& state_errors, std::vector<double>& state_norms);
+
   /// Builds an ordered queue of elements that are be examined.
   /** The method fills Adapt::standard_queue by elements sorted accordin to their error descending.
    *  The method assumes that Adapt::errors_squared contains valid values.
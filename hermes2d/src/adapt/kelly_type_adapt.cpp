@@ -1,4 +1,7 @@
 #include "kelly_type_adapt.h"
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
 
 // #ifdef KELLY_TYPE_ADAPT_H_IS_REWORKED
 
@@ -147,240 +150,104 @@ double KellyTypeAdapt::calc_err_internal(Hermes::vector<Solution *> slns,
         e->visited = false;
     }
   }
-  
-  //WARNING: AD HOC debugging parameter.
-  bool multimesh = false;
-
-  // Begin the multimesh traversal.
-  trav.begin(num, &(stage.meshes.front()), &(stage.fns.front()));
-  while ((ee = trav.get_next_state(bnd, surf_pos)) != NULL)
-  {   
-    // Go through all solution components.
-    for (int i = 0; i < num; i++)
-    {
-      if (ee[i] == NULL)
-        continue;
-      
-      // Set maximum integration order for use in integrals, see limit_order()
-      update_limit_table(ee[i]->get_mode());
 
-      RefMap *rm = sln[i]->get_refmap();
+  // Index of the first state in which each element was processed (-1 if not yet). An interface
+  // segment is skipped if it was already processed from the other side, i.e. in an earlier state.
+  int* first_state[H2D_MAX_COMPONENTS];
+  for (int i = 0; i < num; i++)
+  {
+    int max = stage.meshes[i]->get_max_element_id();
+    first_state[i] = new int[max];
+    for (int id = 0; id < max; id++)
+      first_state[i][id] = -1;
+  }
 
-      double err = 0.0;
+  // Determine the minimum mesh seq.
+  dp.min_dg_mesh_seq = 0;
+  for(int j = 0; j < num; j++)
+    if(stage.meshes[j]->get_seq() < dp.min_dg_mesh_seq || j == 0)
+      dp.min_dg_mesh_seq = stage.meshes[j]->get_seq();
 
-      // Go through all volumetric error estimators.
-      for (unsigned int iest = 0; iest < error_estimators_vol.size(); iest++)
+  if (num_threads > 1 && is_parallel_estimation_possible(slns))
+  {
+    // Sum up the estimates in the order of the serial traversal.
+    std::vector<ParallelEstimatorState> states;
+    eval_estimators_parallel(stage, first_state, calc_norm, states);
+    for (unsigned int s = 0; s < states.size(); s++)
+    {
+      ParallelEstimatorState& st = states[s];
+      for (unsigned int k = 0; k < st.interface_errors.size(); k++)
       {
-        // Skip current error estimator if it is assigned to a different component or geometric area
-        // different from that of the current active element.
-        if (error_estimators_vol[iest]->i != i)
-          continue;
-        /*
-        if (error_estimators_vol[iest].area != ee[i]->marker)
-          continue;
-          */
-        else if (error_estimators_vol[iest]->area != HERMES_ANY)
-          continue;
+        InterfaceErrorContribution& c = st.interface_errors[k];
+        errors_components[st.i] += c.central_err + c.neighb_err;
+        total_error += c.central_err + c.neighb_err;
+        errors[st.i][st.id] += c.central_err;
+        errors[st.i][c.neighb_id] += c.neighb_err;
+      }
 
-        err += eval_volumetric_estimator(error_estimators_vol[iest], rm);
+      if (calc_norm)
+      {
+        norms[st.i] += st.nrm;
+        total_norm += st.nrm;
       }
 
-      // Go through all surface error estimators (includes both interface and boundary est's).
-      for (unsigned int iest = 0; iest < error_estimators_surf.size(); iest++)
+      errors_components[st.i] += st.err;
+      total_error += st.err;
+      errors[st.i][st.id] += st.err;
+    }
+  }
+  else
+  {
+    std::vector<InterfaceErrorContribution> interface_errors;
+
+    // Begin the multimesh traversal.
+    int state = 0;
+    trav.begin(num, &(stage.meshes.front()), &(stage.fns.front()));
+    while ((ee = trav.get_next_state(bnd, surf_pos)) != NULL)
+    {
+      // Go through all solution components.
+      for (int i = 0; i < num; i++)
       {
-        if (error_estimators_surf[iest]->i != i)
+        if (ee[i] == NULL)
           continue;
 
-        for (int isurf = 0; isurf < ee[i]->get_num_surf(); isurf++)
-        {
-            /*
-          if (error_estimators_surf[iest].area > 0 &&
-              error_estimators_surf[iest].area != surf_pos[isurf].marker) continue;
-          */
-          if (bnd[isurf])   // Boundary
-          {
-            if (error_estimators_surf[iest]->area == H2D_DG_INNER_EDGE) continue;
-            
-            /*
-            if (boundary_markers_conversion.get_internal_marker(error_estimators_surf[iest].area) < 0 &&
-                error_estimators_surf[iest].area != HERMES_ANY) continue;
-            */    
-            
-            err += eval_boundary_estimator(error_estimators_surf[iest], rm, surf_pos);
-          }
-          else              // Interface
-          {
-            if (error_estimators_surf[iest]->area != H2D_DG_INNER_EDGE) continue;
+        // Set maximum integration order for use in integrals, see limit_order()
+        update_limit_table(ee[i]->get_mode());
 
-            /* BEGIN COPY FROM DISCRETE_PROBLEM.CPP */
-            
-            // 5 is for bits per page in the array.
-            LightArray<NeighborSearch*> neighbor_searches(5);
-            unsigned int num_neighbors = 0;
-            DiscreteProblem::NeighborNode* root;
-            int ns_index;
-            
-            dp.min_dg_mesh_seq = 0;
-            for(int j = 0; j < num; j++)
-              if(stage.meshes[j]->get_seq() < dp.min_dg_mesh_seq || j == 0)
-                dp.min_dg_mesh_seq = stage.meshes[j]->get_seq();
-            
-            ns_index = stage.meshes[i]->get_seq() - dp.min_dg_mesh_seq; // = 0 for single mesh
-            
-            // Determine the minimum mesh seq in this stage.
-            if (multimesh) 
-            {              
-              // Initialize the NeighborSearches.
-              dp.init_neighbors(neighbor_searches, stage, isurf);
-              
-              // Create a multimesh tree;
-              root = new DiscreteProblem::NeighborNode(NULL, 0);
-              dp.build_multimesh_tree(root, neighbor_searches);
-              
-              // Update all NeighborSearches according to the multimesh tree.
-              // After this, all NeighborSearches in neighbor_searches should have the same count 
-              // of neighbors and proper set of transformations
-              // for the central and the neighbor element(s) alike.
-              // Also check that every NeighborSearch has the same number of neighbor elements.
-              for(unsigned int j = 0; j < neighbor_searches.get_size(); j++)
-                if(neighbor_searches.present(j)) {
-                  NeighborSearch* ns = neighbor_searches.get(j);
-                  dp.update_neighbor_search(ns, root);
-                  if(num_neighbors == 0)
-                    num_neighbors = ns->n_neighbors;
-                  if(ns->n_neighbors != num_neighbors)
-                    error("Num_neighbors of different NeighborSearches not matching in KellyTypeAdapt::calc_err_internal.");
-                }
-            }
-            else
-            {
-              NeighborSearch *ns = new NeighborSearch(ee[i], stage.meshes[i]);
-              ns->original_central_el_transform = stage.fns[i]->get_transform();
-              ns->set_active_edge(isurf);
-              ns->clear_initial_sub_idx();
-              num_neighbors = ns->n_neighbors;
-              neighbor_searches.add(ns, ns_index);
-            }
-
-            // Go through all segments of the currently processed interface (segmentation is caused
-            // by hanging nodes on the other side of the interface).
-            for (unsigned int neighbor = 0; neighbor < num_neighbors; neighbor++)
-            {              
-              if (ignore_visited_segments) {
-                bool processed = true;
-                for(unsigned int j = 0; j < neighbor_searches.get_size(); j++)
-                  if(neighbor_searches.present(j))
-                    if(!neighbor_searches.get(j)->neighbors.at(neighbor)->visited) {
-                      processed = false;
-                      break;
-                    }
-                if (processed) continue;
-              }
-              
-              // Set the active segment in all NeighborSearches
-              for(unsigned int j = 0; j < neighbor_searches.get_size(); j++)
-                if(neighbor_searches.present(j)) {
-                  neighbor_searches.get(j)->active_segment = neighbor;
-                  neighbor_searches.get(j)->neighb_el = neighbor_searches.get(j)->neighbors[neighbor];
-                  neighbor_searches.get(j)->neighbor_edge = neighbor_searches.get(j)->neighbor_edges[neighbor];
-                }
-                
-              // Push all the necessary transformations to all functions of this stage.
-              // The important thing is that the transformations to the current subelement are already there.
-              // Also store the current neighbor element and neighbor edge in neighb_el, neighbor_edge.
-              if (multimesh) 
-              {
-                for(unsigned int fns_i = 0; fns_i < stage.fns.size(); fns_i++)
-                  for(unsigned int trf_i = 0; trf_i < neighbor_searches.get(stage.meshes[fns_i]->get_seq() - dp.min_dg_mesh_seq)->central_n_trans[neighbor]; trf_i++)
-                    stage.fns[fns_i]->push_transform(neighbor_searches.get(stage.meshes[fns_i]->get_seq() - dp.min_dg_mesh_seq)->central_transformations[neighbor][trf_i]);
-              }
-              else
-              {            
-                // Push the transformations only to the solution on the current mesh
-                for(unsigned int trf_i = 0; trf_i < neighbor_searches.get(ns_index)->central_n_trans[neighbor]; trf_i++)
-                  stage.fns[i]->push_transform(neighbor_searches.get(ns_index)->central_transformations[neighbor][trf_i]);
-              }
-              /* END COPY FROM DISCRETE_PROBLEM.CPP */
-              rm->force_transform(this->sln[i]->get_transform(), this->sln[i]->get_ctm());
-              
-              // The estimate is multiplied by 0.5 in order to distribute the error equally onto
-              // the two neighboring elements.
-              double central_err = 0.5 * eval_interface_estimator(error_estimators_surf[iest],
-                                                                  rm, surf_pos, neighbor_searches, 
-                                                                  ns_index);
-              double neighb_err = central_err;
-
-              // Scale the error estimate by the scaling function dependent on the element diameter
-              // (use the central element's diameter).
-              if (use_aposteriori_interface_scaling && interface_scaling_fns[i])
-                central_err *= interface_scaling_fns[i](ee[i]->get_diameter());
-
-              // In the case this edge will be ignored when calculating the error for the element on
-              // the other side, add the now computed error to that element as well.
-              if (ignore_visited_segments)
-              {
-                Element *neighb = neighbor_searches.get(i)->neighb_el;
-
-                // Scale the error estimate by the scaling function dependent on the element diameter
-                // (use the diameter of the element on the other side).
-                if (use_aposteriori_interface_scaling && interface_scaling_fns[i])
-                  neighb_err *= interface_scaling_fns[i](neighb->get_diameter());
-
-                errors_components[i] += central_err + neighb_err;
-                total_error += central_err + neighb_err;
-                errors[i][ee[i]->id] += central_err;
-                errors[i][neighb->id] += neighb_err;
-              }
-              else
-                err += central_err;
-              
-              /* BEGIN COPY FROM DISCRETE_PROBLEM.CPP */
-              
-              // Clear the transformations from the RefMaps and all functions.
-              if (multimesh)
-                for(unsigned int fns_i = 0; fns_i < stage.fns.size(); fns_i++)
-                  stage.fns[fns_i]->set_transform(neighbor_searches.get(stage.meshes[fns_i]->get_seq() - dp.min_dg_mesh_seq)->original_central_el_transform);
-              else
-                stage.fns[i]->set_transform(neighbor_searches.get(ns_index)->original_central_el_transform);
-
-              rm->set_transform(neighbor_searches.get(ns_index)->original_central_el_transform);
-
-              
-              /* END COPY FROM DISCRETE_PROBLEM.CPP */
-            }
-            
-            /* BEGIN COPY FROM DISCRETE_PROBLEM.CPP */
-            
-            if (multimesh)
-              // Delete the multimesh tree;
-              delete root;
-            
-            // Delete the neighbor_searches array.
-            for(unsigned int j = 0; j < neighbor_searches.get_size(); j++) 
-              if(neighbor_searches.present(j))
-                delete neighbor_searches.get(j);
-              
-            /* END COPY FROM DISCRETE_PROBLEM.CPP */
-            
-          }
+        interface_errors.clear();
+        double err = eval_element_estimators(i, state, ee, bnd, surf_pos, stage, sln, &dp, first_state,
+                                             interface_errors);
+        for (unsigned int k = 0; k < interface_errors.size(); k++)
+        {
+          InterfaceErrorContribution& c = interface_errors[k];
+          errors_components[i] += c.central_err + c.neighb_err;
+          total_error += c.central_err + c.neighb_err;
+          errors[i][ee[i]->id] += c.central_err;
+          errors[i][c.neighb_id] += c.neighb_err;
         }
-      }
 
-      if (calc_norm)
-      {
-        double nrm = eval_solution_norm(error_form[i][i], rm, sln[i]);
-        norms[i] += nrm;
-        total_norm += nrm;
-      }
+        if (calc_norm)
+        {
+          double nrm = eval_solution_norm(error_form[i][i], sln[i]->get_refmap(), sln[i]);
+          norms[i] += nrm;
+          total_norm += nrm;
+        }
 
-      errors_components[i] += err;
-      total_error += err;
-      errors[i][ee[i]->id] += err;
+        errors_components[i] += err;
+        total_error += err;
+        errors[i][ee[i]->id] += err;
 
-      ee[i]->visited = true;
+        ee[i]->visited = true;
+        if (first_state[i][ee[i]->id] < 0)
+          first_state[i][ee[i]->id] = state;
+      }
+      state++;
     }
+    trav.finish();
   }
-  trav.finish();
+
+  for (int i = 0; i < num; i++)
+    delete [] first_state[i];
 
   // Store the calculation for each solution component separately.
   if(component_errors != NULL)
@@ -442,6 +309,379 @@ double KellyTypeAdapt::calc_err_internal(Hermes::vector<Solution *> slns,
   }
 }
 
+double KellyTypeAdapt::eval_element_estimators(int i, int state, Element** ee, bool* bnd, SurfPos* surf_pos,
+                                               WeakForm::Stage& stage, Solution** slns, DiscreteProblem* neighbor_dp,
+                                               int** first_state,
+                                               std::vector<InterfaceErrorContribution>& interface_errors)
+{
+  //WARNING: AD HOC debugging parameter.
+  bool multimesh = false;
+
+  RefMap *rm = slns[i]->get_refmap();
+
+  double err = 0.0;
+
+  // Go through all volumetric error estimators.
+  for (unsigned int iest = 0; iest < error_estimators_vol.size(); iest++)
+  {
+    // Skip current error estimator if it is assigned to a different component or geometric area
+    // different from that of the current active element.
+    if (error_estimators_vol[iest]->i != i)
+      continue;
+    /*
+    if (error_estimators_vol[iest].area != ee[i]->marker)
+      continue;
+      */
+    else if (error_estimators_vol[iest]->area != HERMES_ANY)
+      continue;
+
+    err += eval_volumetric_estimator(error_estimators_vol[iest], rm, slns);
+  }
+
+  // Go through all surface error estimators (includes both interface and boundary est's).
+  for (unsigned int iest = 0; iest < error_estimators_surf.size(); iest++)
+  {
+    if (error_estimators_surf[iest]->i != i)
+      continue;
+
+    for (int isurf = 0; isurf < ee[i]->get_num_surf(); isurf++)
+    {
+        /*
+      if (error_estimators_surf[iest].area > 0 &&
+          error_estimators_surf[iest].area != surf_pos[isurf].marker) continue;
+      */
+      if (bnd[isurf])   // Boundary
+      {
+        if (error_estimators_surf[iest]->area == H2D_DG_INNER_EDGE) continue;
+        
+        /*
+        if (boundary_markers_conversion.get_internal_marker(error_estimators_surf[iest].area) < 0 &&
+            error_estimators_surf[iest].area != HERMES_ANY) continue;
+        */    
+        
+        err += eval_boundary_estimator(error_estimators_surf[iest], rm, surf_pos, slns);
+      }
+      else              // Interface
+      {
+        if (error_estimators_surf[iest]->area != H2D_DG_INNER_EDGE) continue;
+
+        /* BEGIN COPY FROM DISCRETE_PROBLEM.CPP */
+        
+        // 5 is for bits per page in the array.
+        LightArray<NeighborSearch*> neighbor_searches(5);
+        unsigned int num_neighbors = 0;
+        DiscreteProblem::NeighborNode* root;
+        int ns_index;
+        
+        ns_index = stage.meshes[i]->get_seq() - neighbor_dp->min_dg_mesh_seq; // = 0 for single mesh
+        
+        // Determine the minimum mesh seq in this stage.
+        if (multimesh) 
+        {              
+          // Initialize the NeighborSearches.
+          neighbor_dp->init_neighbors(neighbor_searches, stage, isurf);
+          
+          // Create a multimesh tree;
+          root = new DiscreteProblem::NeighborNode(NULL, 0);
+          neighbor_dp->build_multimesh_tree(root, neighbor_searches);
+          
+          // Update all NeighborSearches according to the multimesh tree.
+          // After this, all NeighborSearches in neighbor_searches should have the same count 
+          // of neighbors and proper set of transformations
+          // for the central and the neighbor element(s) alike.
+          // Also check that every NeighborSearch has the same number of neighbor elements.
+          for(unsigned int j = 0; j < neighbor_searches.get_size(); j++)
+            if(neighbor_searches.present(j)) {
+              NeighborSearch* ns = neighbor_searches.get(j);
+              neighbor_dp->update_neighbor_search(ns, root);
+              if(num_neighbors == 0)
+                num_neighbors = ns->n_neighbors;
+              if(ns->n_neighbors != num_neighbors)
+                error("Num_neighbors of different NeighborSearches not matching in KellyTypeAdapt::calc_err_internal.");
+            }
+        }
+        else
+        {
+          NeighborSearch *ns = new NeighborSearch(ee[i], stage.meshes[i]);
+          ns->original_central_el_transform = stage.fns[i]->get_transform();
+          ns->set_active_edge(isurf);
+          ns->clear_initial_sub_idx();
+          num_neighbors = ns->n_neighbors;
+          neighbor_searches.add(ns, ns_index);
+        }
+
+        // Go through all segments of the currently processed interface (segmentation is caused
+        // by hanging nodes on the other side of the interface).
+        for (unsigned int neighbor = 0; neighbor < num_neighbors; neighbor++)
+        {              
+          // Skip the segment if the element on the other side has been processed in an earlier state.
+          if (ignore_visited_segments) {
+            Element* neighb = neighbor_searches.get(ns_index)->neighbors.at(neighbor);
+            if (first_state[i][neighb->id] >= 0 && first_state[i][neighb->id] < state)
+              continue;
+          }
+          
+          // Set the active segment in all NeighborSearches
+          for(unsigned int j = 0; j < neighbor_searches.get_size(); j++)
+            if(neighbor_searches.present(j)) {
+              neighbor_searches.get(j)->active_segment = neighbor;
+              neighbor_searches.get(j)->neighb_el = neighbor_searches.get(j)->neighbors[neighbor];
+              neighbor_searches.get(j)->neighbor_edge = neighbor_searches.get(j)->neighbor_edges[neighbor];
+            }
+            
+          // Push all the necessary transformations to all functions of this stage.
+          // The important thing is that the transformations to the current subelement are already there.
+          // Also store the current neighbor element and neighbor edge in neighb_el, neighbor_edge.
+          if (multimesh) 
+          {
+            for(unsigned int fns_i = 0; fns_i < stage.fns.size(); fns_i++)
+              for(unsigned int trf_i = 0; trf_i < neighbor_searches.get(stage.meshes[fns_i]->get_seq() - neighbor_dp->min_dg_mesh_seq)->central_n_trans[neighbor]; trf_i++)
+                stage.fns[fns_i]->push_transform(neighbor_searches.get(stage.meshes[fns_i]->get_seq() - neighbor_dp->min_dg_mesh_seq)->central_transformations[neighbor][trf_i]);
+          }
+          else
+          {            
+            // Push the transformations only to the solution on the current mesh
+            for(unsigned int trf_i = 0; trf_i < neighbor_searches.get(ns_index)->central_n_trans[neighbor]; trf_i++)
+              stage.fns[i]->push_transform(neighbor_searches.get(ns_index)->central_transformations[neighbor][trf_i]);
+          }
+          /* END COPY FROM DISCRETE_PROBLEM.CPP */
+          rm->force_transform(slns[i]->get_transform(), slns[i]->get_ctm());
+          
+          // The estimate is multiplied by 0.5 in order to distribute the error equally onto
+          // the two neighboring elements.
+          double central_err = 0.5 * eval_interface_estimator(error_estimators_surf[iest],
+                                                              rm, surf_pos, neighbor_searches, 
+                                                              ns_index, slns, neighbor_dp);
+          double neighb_err = central_err;
+
+          // Scale the error estimate by the scaling function dependent on the element diameter
+          // (use the central element's diameter).
+          if (use_aposteriori_interface_scaling && interface_scaling_fns[i])
+            central_err *= interface_scaling_fns[i](ee[i]->get_diameter());
+
+          // In the case this edge will be ignored when calculating the error for the element on
+          // the other side, add the now computed error to that element as well.
+          if (ignore_visited_segments)
+          {
+            Element *neighb = neighbor_searches.get(i)->neighb_el;
+
+            // Scale the error estimate by the scaling function dependent on the element diameter
+            // (use the diameter of the element on the other side).
+            if (use_aposteriori_interface_scaling && interface_scaling_fns[i])
+              neighb_err *= interface_scaling_fns[i](neighb->get_diameter());
+
+            InterfaceErrorContribution c;
+            c.neighb_id = neighb->id;
+            c.central_err = central_err;
+            c.neighb_err = neighb_err;
+            interface_errors.push_back(c);
+          }
+          else
+            err += central_err;
+          
+          /* BEGIN COPY FROM DISCRETE_PROBLEM.CPP */
+          
+          // Clear the transformations from the RefMaps and all functions.
+          if (multimesh)
+            for(unsigned int fns_i = 0; fns_i < stage.fns.size(); fns_i++)
+              stage.fns[fns_i]->set_transform(neighbor_searches.get(stage.meshes[fns_i]->get_seq() - neighbor_dp->min_dg_mesh_seq)->original_central_el_transform);
+          else
+            stage.fns[i]->set_transform(neighbor_searches.get(ns_index)->original_central_el_transform);
+
+          rm->set_transform(neighbor_searches.get(ns_index)->original_central_el_transform);
+
+          
+          /* END COPY FROM DISCRETE_PROBLEM.CPP */
+        }
+        
+        /* BEGIN COPY FROM DISCRETE_PROBLEM.CPP */
+        
+        if (multimesh)
+          // Delete the multimesh tree;
+          delete root;
+        
+        // Delete the neighbor_searches array.
+        for(unsigned int j = 0; j < neighbor_searches.get_size(); j++) 
+          if(neighbor_searches.present(j))
+            delete neighbor_searches.get(j);
+          
+        /* END COPY FROM DISCRETE_PROBLEM.CPP */
+        
+      }
+    }
+  }
+
+  return err;
+}
+
+bool KellyTypeAdapt::is_parallel_estimation_possible(const Hermes::vector<Solution *>& slns)
+{
+#ifdef _OPENMP
+  // The external functions of the estimators are shared by all threads.
+  Hermes::vector<KellyTypeAdapt::ErrorEstimatorForm *> forms = error_estimators_vol;
+  forms.insert(forms.end(), error_estimators_surf.begin(), error_estimators_surf.end());
+  for (unsigned int i = 0; i < forms.size(); i++)
+    if (!forms[i]->ext.empty()) {
+      verbose("Parallel error estimation of estimators with external functions is not supported, estimating serially.");
+      return false;
+    }
+
+  return is_parallel_error_calculation_possible(slns);
+#else
+  return false;
+#endif
+}
+
+// Data private to one thread of the parallel error estimation.
+struct ParallelEstimatorWorker
+{
+  Quad2DStd* quad;
+  Solution* sln[H2D_MAX_COMPONENTS];
+  WeakForm::Stage stage;
+  DiscreteProblem* dp;
+};
+
+// One state of the traversal recorded for the parallel error estimation. The elements and
+// the sub-element transforms of the solutions are stored separately, per solution.
+struct ParallelEstimatorTraversalState
+{
+  bool bnd[4];
+  SurfPos surf_pos[4];
+};
+
+void KellyTypeAdapt::eval_estimators_parallel(WeakForm::Stage& stage, int** first_state, bool calc_norm,
+                                              std::vector<ParallelEstimatorState>& states)
+{
+  _F_
+#ifdef _OPENMP
+  // The order of the inverse reference map is cached in the element, calculate it
+  // here so that the workers only read it (also for the neighbors of the elements).
+  RefMap refmap;
+  for (int i = 0; i < num; i++)
+  {
+    Element* e;
+    for_all_active_elements(e, stage.meshes[i])
+      if (e->iro_cache == -1)
+        refmap.set_active_element(e);
+  }
+
+  // Traverse the meshes with plain Transformables in place of the solutions,
+  // and record all states. The solutions are set up later by the workers.
+  Transformable* trav_fns = new Transformable[num];
+  Transformable** trav_fn_ptrs = new Transformable*[num];
+  for (int i = 0; i < num; i++)
+    trav_fn_ptrs[i] = trav_fns + i;
+
+  std::vector<ParallelEstimatorTraversalState> trav_states;
+  std::vector<Element*> state_e, state_fn_e;
+  std::vector<uint64_t> state_sub_idx;
+  std::vector<int> state_mode;
+
+  Traverse trav;
+  ParallelEstimatorTraversalState ts;
+  Element** ee;
+  trav.begin(num, &(stage.meshes.front()), trav_fn_ptrs);
+  while ((ee = trav.get_next_state(ts.bnd, ts.surf_pos)) != NULL)
+  {
+    int state = trav_states.size();
+    trav_states.push_back(ts);
+    for (int i = 0; i < num; i++)
+    {
+      state_e.push_back(ee[i]);
+      state_fn_e.push_back(trav_fns[i].get_active_element());
+      state_sub_idx.push_back(trav_fns[i].get_transform());
+    }
+
+    for (int i = 0; i < num; i++)
+    {
+      if (ee[i] == NULL)
+        continue;
+
+      ParallelEstimatorState st;
+      st.state = state;
+      st.i = i;
+      st.id = ee[i]->id;
+      st.err = st.nrm = 0.0;
+      states.push_back(st);
+      state_mode.push_back(ee[i]->get_mode());
+
+      ee[i]->visited = true;
+      if (first_state[i][ee[i]->id] < 0)
+        first_state[i][ee[i]->id] = state;
+    }
+  }
+  trav.finish();
+  delete [] trav_fn_ptrs;
+  delete [] trav_fns;
+
+  // Create the workers.
+  std::vector<ParallelEstimatorWorker> workers(num_threads);
+  for (int t = 0; t < num_threads; t++)
+  {
+    ParallelEstimatorWorker& w = workers[t];
+    w.quad = new Quad2DStd;
+    w.dp = new DiscreteProblem;
+    w.dp->min_dg_mesh_seq = dp.min_dg_mesh_seq;
+    w.stage.meshes = stage.meshes;
+    for (int i = 0; i < num; i++)
+    {
+      w.sln[i] = new Solution;
+      w.sln[i]->copy(sln[i], true);
+      w.sln[i]->set_private_refmap_shapeset();
+      w.sln[i]->set_quad_2d(w.quad);
+      w.stage.fns.push_back(w.sln[i]);
+    }
+  }
+
+  // The limit table is shared by all threads, evaluate the elements of each mode separately.
+  for (int mode = 0; mode < 2; mode++)
+  {
+    std::vector<int> bucket;
+    for (unsigned int k = 0; k < states.size(); k++)
+      if (state_mode[k] == mode)
+        bucket.push_back(k);
+    if (bucket.empty())
+      continue;
+
+    update_limit_table(mode);
+
+    int nb = bucket.size();
+#pragma omp parallel for schedule(dynamic, 8) num_threads(num_threads)
+    for (int k = 0; k < nb; k++)
+    {
+      ParallelEstimatorWorker& w = workers[omp_get_thread_num()];
+      ParallelEstimatorState& st = states[bucket[k]];
+      int s = st.state;
+
+      // Replay the state on the solutions of the worker.
+      for (int i = 0; i < num; i++)
+      {
+        Element* fe = state_fn_e[s * num + i];
+        if (fe == NULL)
+          continue;
+        uint64_t sub_idx = state_sub_idx[s * num + i];
+        if (w.sln[i]->get_active_element() != fe || sub_idx == 0)
+          w.sln[i]->set_active_element(fe);
+        w.sln[i]->set_transform(sub_idx);
+      }
+
+      st.err = eval_element_estimators(st.i, s, &state_e[s * num], trav_states[s].bnd, trav_states[s].surf_pos,
+                                       w.stage, w.sln, w.dp, first_state, st.interface_errors);
+      if (calc_norm)
+        st.nrm = eval_solution_norm(error_form[st.i][st.i], w.sln[st.i]->get_refmap(), w.sln[st.i]);
+    }
+  }
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    for (int i = 0; i < num; i++)
+      delete workers[t].sln[i];
+    delete workers[t].dp;
+    delete workers[t].quad;
+  }
+#endif
+}
+
 double KellyTypeAdapt::eval_solution_norm(Adapt::MatrixFormVolError* form, RefMap *rm, MeshFunction* sln)
 {
   // determine the integration order
@@ -488,14 +728,15 @@ double KellyTypeAdapt::eval_solution_norm(Adapt::MatrixFormVolError* form, RefMa
   return std::abs(res);
 }
 
-double KellyTypeAdapt::eval_volumetric_estimator(KellyTypeAdapt::ErrorEstimatorForm* err_est_form, RefMap *rm)
+double KellyTypeAdapt::eval_volumetric_estimator(KellyTypeAdapt::ErrorEstimatorForm* err_est_form, RefMap *rm,
+                                                 Solution** slns)
 {
   // determine the integration order
-  int inc = (this->sln[err_est_form->i]->get_num_components() == 2) ? 1 : 0;
+  int inc = (slns[err_est_form->i]->get_num_components() == 2) ? 1 : 0;
 
   Func<Ord>** oi = new Func<Ord>* [num];
   for (int i = 0; i < num; i++)
-    oi[i] = init_fn_ord(this->sln[i]->get_fn_order() + inc);
+    oi[i] = init_fn_ord(slns[i]->get_fn_order() + inc);
 
   // Order of additional external functions.
   ExtData<Ord>* fake_ext = dp.init_ext_fns_ord(err_est_form->ext);
@@ -516,7 +757,7 @@ double KellyTypeAdapt::eval_volumetric_estimator(KellyTypeAdapt::ErrorEstimatorF
   delete fake_ext;
 
   // eval the form
-  Quad2D* quad = this->sln[err_est_form->i]->get_quad_2d();
+  Quad2D* quad = slns[err_est_form->i]->get_quad_2d();
   double3* pt = quad->get_points(order);
   int np = quad->get_num_points(order);
 
@@ -531,7 +772,7 @@ double KellyTypeAdapt::eval_volumetric_estimator(KellyTypeAdapt::ErrorEstimatorF
   Func<scalar>** ui = new Func<scalar>* [num];
   
   for (int i = 0; i < num; i++)
-    ui[i] = init_fn(this->sln[i], order);
+    ui[i] = init_fn(slns[i], order);
   
   ExtData<scalar>* ext = dp.init_ext_fns(err_est_form->ext, rm, order);
 
@@ -548,13 +789,14 @@ double KellyTypeAdapt::eval_volumetric_estimator(KellyTypeAdapt::ErrorEstimatorF
   return std::abs(res);
 }
 
-double KellyTypeAdapt::eval_boundary_estimator(KellyTypeAdapt::ErrorEstimatorForm* err_est_form, RefMap *rm, SurfPos* surf_pos)
+double KellyTypeAdapt::eval_boundary_estimator(KellyTypeAdapt::ErrorEstimatorForm* err_est_form, RefMap *rm, SurfPos* surf_pos,
+                                               Solution** slns)
 {
   // determine the integration order
-  int inc = (this->sln[err_est_form->i]->get_num_components() == 2) ? 1 : 0;
+  int inc = (slns[err_est_form->i]->get_num_components() == 2) ? 1 : 0;
   Func<Ord>** oi = new Func<Ord>* [num];
   for (int i = 0; i < num; i++)
-    oi[i] = init_fn_ord(this->sln[i]->get_edge_fn_order(surf_pos->surf_num) + inc);
+    oi[i] = init_fn_ord(slns[i]->get_edge_fn_order(surf_pos->surf_num) + inc);
 
   // Order of additional external functions.
   ExtData<Ord>* fake_ext = dp.init_ext_fns_ord(err_est_form->ext, surf_pos->surf_num);
@@ -575,7 +817,7 @@ double KellyTypeAdapt::eval_boundary_estimator(KellyTypeAdapt::ErrorEstimatorFor
   delete fake_ext;
 
   // eval the form
-  Quad2D* quad = this->sln[err_est_form->i]->get_quad_2d();
+  Quad2D* quad = slns[err_est_form->i]->get_quad_2d();
   int eo = quad->get_edge_points(surf_pos->surf_num, order);
   double3* pt = quad->get_points(eo);
   int np = quad->get_num_points(eo);
@@ -590,7 +832,7 @@ double KellyTypeAdapt::eval_boundary_estimator(KellyTypeAdapt::ErrorEstimatorFor
   // function values
   Func<scalar>** ui = new Func<scalar>* [num];
   for (int i = 0; i < num; i++)
-    ui[i] = init_fn(this->sln[i], eo);
+    ui[i] = init_fn(slns[i], eo);
   ExtData<scalar>* ext = dp.init_ext_fns(err_est_form->ext, rm, eo);
 
   scalar res = boundary_scaling_const *
@@ -610,15 +852,16 @@ double KellyTypeAdapt::eval_boundary_estimator(KellyTypeAdapt::ErrorEstimatorFor
 
 double KellyTypeAdapt::eval_interface_estimator(KellyTypeAdapt::ErrorEstimatorForm* err_est_form,
                                                 RefMap *rm, SurfPos* surf_pos,
-                                                LightArray<NeighborSearch*>& neighbor_searches, int neighbor_index)
+                                                LightArray<NeighborSearch*>& neighbor_searches, int neighbor_index,
+                                                Solution** slns, DiscreteProblem* neighbor_dp)
 {
   NeighborSearch* nbs = neighbor_searches.get(neighbor_index);
-  Hermes::vector<MeshFunction*> slns;
+  Hermes::vector<MeshFunction*> fns;
   for (int i = 0; i < num; i++)
-    slns.push_back(this->sln[i]);
+    fns.push_back(slns[i]);
   
   // Determine integration order.
-  ExtData<Ord>* fake_ui = dp.init_ext_fns_ord(slns, neighbor_searches);
+  ExtData<Ord>* fake_ui = neighbor_dp->init_ext_fns_ord(fns, neighbor_searches);
   
   // Order of additional external functions.
   // ExtData<Ord>* fake_ext = dp.init_ext_fns_ord(err_est_form->ext, nbs);
@@ -646,7 +889,7 @@ double KellyTypeAdapt::eval_interface_estimator(KellyTypeAdapt::ErrorEstimatorFo
   
   //delete fake_ext;
   
-  Quad2D* quad = this->sln[err_est_form->i]->get_quad_2d();
+  Quad2D* quad = slns[err_est_form->i]->get_quad_2d();
   int eo = quad->get_edge_points(surf_pos->surf_num, order);
   int np = quad->get_num_points(eo);
   double3* pt = quad->get_points(eo);
@@ -663,7 +906,7 @@ double KellyTypeAdapt::eval_interface_estimator(KellyTypeAdapt::ErrorEstimatorFo
                                               nbs->neighb_el->get_diameter());
     
   // function values
-  ExtData<scalar>* ui = dp.init_ext_fns(slns, neighbor_searches, order);
+  ExtData<scalar>* ui = neighbor_dp->init_ext_fns(fns, neighbor_searches, order);
   //ExtData<scalar>* ext = dp.init_ext_fns(err_est_form->ext, nbs);
 
   scalar res = interface_scaling_const *
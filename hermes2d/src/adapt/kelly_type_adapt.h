@@ -99,16 +99,22 @@ public:
     ///
     /// Functions used for evaluating the actual error estimator forms for an active element or edge segment.
     ///
+    /// The solution components are taken from \c slns (Adapt::sln or their copies in the parallel estimation).
+    ///
     double eval_volumetric_estimator(KellyTypeAdapt::ErrorEstimatorForm* err_est_form,
-                                    RefMap* rm);
+                                    RefMap* rm,
+                                    Solution** slns);
     double eval_boundary_estimator(KellyTypeAdapt::ErrorEstimatorForm* err_est_form,
                                    RefMap* rm,
-                                   SurfPos* surf_pos);
+                                   SurfPos* surf_pos,
+                                   Solution** slns);
     double eval_interface_estimator(KellyTypeAdapt::ErrorEstimatorForm* err_est_form,
                                     RefMap *rm,
                                     SurfPos* surf_pos,
                                     LightArray<NeighborSearch*>& neighbor_searches,
-                                    int neighbor_index);
+                                    int neighbor_index,
+                                    Solution** slns,
+                                    DiscreteProblem* neighbor_dp);
     double eval_solution_norm(Adapt::MatrixFormVolError* form,
                               RefMap* rm,
                               MeshFunction* sln);
@@ -149,6 +155,39 @@ public:
                                      Hermes::vector<double>* component_errors,
                                      unsigned int error_flags);
 
+    /// Error estimate of an interface segment shared by the central element and the element on the other
+    /// side (used when <c>ignore_visited_segments == true</c>).
+    struct InterfaceErrorContribution
+    {
+      int neighb_id;
+      double central_err, neighb_err;
+    };
+
+    /// Evaluates all estimators of the component \c i on its active element in the state \c state of the
+    /// traversal. Interface estimates to be shared with the element on the other side are appended to
+    /// \c interface_errors, the rest is returned. \c first_state holds the index of the first state
+    /// in which each element was processed, \c neighbor_dp provides the NeighborSearch methods.
+    double eval_element_estimators(int i, int state, Element** ee, bool* bnd, SurfPos* surf_pos,
+                                   WeakForm::Stage& stage, Solution** slns, DiscreteProblem* neighbor_dp,
+                                   int** first_state,
+                                   std::vector<InterfaceErrorContribution>& interface_errors);
+
+    /// Estimates of one active element of one component evaluated by the parallel estimation.
+    struct ParallelEstimatorState
+    {
+      int state, i, id;
+      double err, nrm;
+      std::vector<InterfaceErrorContribution> interface_errors;
+    };
+
+    /// Returns true if the error of given solutions can be estimated by several threads (see Adapt::set_num_threads()).
+    bool is_parallel_estimation_possible(const Hermes::vector<Solution *>& slns);
+
+    /// Evaluates the estimators of all active elements of all states of the traversal by several threads,
+    /// in the order of the serial traversal.
+    void eval_estimators_parallel(WeakForm::Stage& stage, int** first_state, bool calc_norm,
+                                  std::vector<ParallelEstimatorState>& states);
+
   public:
 
     /// Constructor.
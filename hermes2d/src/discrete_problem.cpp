@@ -22,6 +22,8 @@
 #include "shapeset/precalc.h"
 #include "../../hermes_common/matrix.h"
 #include "../../hermes_common/solver/umfpack_solver.h"
+#include "../../hermes_common/solver/bsr.h"
+#include "../../hermes_common/solver/matrix_free.h"
 #include "mesh/refmap.h"
 #include "function/solution.h"
 #include "config.h"
@@ -29,6 +31,9 @@
 #include "views/scalar_view.h"
 #include "views/base_view.h"
 #include "boundaryconditions/essential_bcs.h"
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
 
 DiscreteProblem::DiscreteProblem(WeakForm* wf, Hermes::vector<Space *> spaces) 
   : wf(wf), wf_seq(-1), spaces(spaces)
@@ -52,6 +57,10 @@ void DiscreteProblem::init()
   RungeKutta = false;
   RK_original_spaces_count = 0;
 
+  // Serial assembling by default.
+  num_threads = 1;
+  is_worker = false;
+
   // Sanity checks.
   if(wf == NULL)
     error("WeakForm* wf can not be NULL in DiscreteProblem::DiscreteProblem.");
@@ -68,6 +77,11 @@ void DiscreteProblem::init()
   matrix_buffer = NULL;
   matrix_buffer_dim = 0;
   have_matrix = false;
+  scatter_map_matrix = scatter_matrix = NULL;
+  scatter_Ax = NULL;
+  scatter_map_nnz = scatter_num_states = 0;
+  scatter_record = NULL;
+  scatter_pos = 0;
   values_changed = true;
   struct_changed = true;
 
@@ -105,6 +119,61 @@ void DiscreteProblem::init()
   delete tmp;
 }
 
+DiscreteProblem::DiscreteProblem(DiscreteProblem* master, Quad2D* quad)
+  : wf(master->wf), wf_seq(master->wf_seq), spaces(master->spaces)
+{
+  _F_
+  RungeKutta = master->RungeKutta;
+  RK_original_spaces_count = master->RK_original_spaces_count;
+  num_threads = 1;
+  is_worker = true;
+
+  // The spaces are shared with the master, the enumeration of DOFs must not be touched.
+  have_spaces = true;
+  ndof = master->ndof;
+  sp_seq = new int[wf->get_neq()];
+  memcpy(sp_seq, master->sp_seq, sizeof(int) * wf->get_neq());
+
+  matrix_buffer = NULL;
+  matrix_buffer_dim = 0;
+  have_matrix = master->have_matrix;
+  // The records of the states are set by the master, they are kept in its scatter map.
+  scatter_map_matrix = NULL;
+  scatter_map_nnz = scatter_num_states = 0;
+  scatter_matrix = master->scatter_matrix;
+  scatter_Ax = master->scatter_Ax;
+  scatter_record = NULL;
+  scatter_pos = 0;
+  values_changed = master->values_changed;
+  struct_changed = master->struct_changed;
+
+  // Own master precalc shapesets working with the quadrature of the worker.
+  pss = new PrecalcShapeset*[wf->get_neq()];
+  num_user_pss = 0;
+  for (unsigned int i = 0; i < wf->get_neq(); i++) {
+    pss[i] = new PrecalcShapeset(spaces[i]->get_shapeset());
+    pss[i]->set_quad_2d(quad);
+    num_user_pss++;
+  }
+
+  element_markers_conversion = master->element_markers_conversion;
+  boundary_markers_conversion = master->boundary_markers_conversion;
+
+  is_fvm = master->is_fvm;
+  vector_valued_forms = master->vector_valued_forms;
+  is_linear = master->is_linear;
+  geom_ord = master->geom_ord;
+
+  DG_matrix_forms_present = false;
+  DG_vector_forms_present = false;
+
+  // Start with the integration orders known to the master, and look up
+  // the shape function values in the caches of the master.
+  assembling_caches.cache_order = master->assembling_caches.cache_order;
+  assembling_caches.master = &master->assembling_caches;
+  assembling_caches.fn_curved_limit = master->assembling_caches.fn_curved_limit;
+}
+
 DiscreteProblem::~DiscreteProblem()
 {
   _F_
@@ -126,6 +195,18 @@ void DiscreteProblem::free()
   wf_seq = -1;
 }
 
+void DiscreteProblem::set_num_threads(int num_threads)
+{
+  _F_
+  if (num_threads < 1)
+    error("The number of threads has to be positive in DiscreteProblem::set_num_threads().");
+#ifndef _OPENMP
+  if (num_threads > 1)
+    warn("Hermes2D was built without OpenMP (WITH_OPENMP), the assembling will be serial.");
+#endif
+  this->num_threads = num_threads;
+}
+
 int DiscreteProblem::get_num_dofs()
 {
   _F_
@@ -146,6 +227,96 @@ scalar** DiscreteProblem::get_matrix_buffer(int n)
   return (matrix_buffer = new_matrix<scalar>(n, n));
 }
 
+void DiscreteProblem::update_scatter_map(SparseMatrix* mat)
+{
+  _F_
+  scatter_num_states = 0;
+  scatter_matrix = dynamic_cast<CSCMatrix*>(mat);
+  scatter_Ax = NULL;
+  if (scatter_matrix == NULL) 
+    return;
+  scatter_Ax = scatter_matrix->get_Ax();
+
+  // The positions are valid only for the sparse structure they were recorded in.
+  if (scatter_matrix != scatter_map_matrix || scatter_matrix->get_nnz() != scatter_map_nnz) {
+    scatter_map.clear();
+    scatter_map_matrix = scatter_matrix;
+    scatter_map_nnz = scatter_matrix->get_nnz();
+  }
+}
+
+void DiscreteProblem::set_scatter_record(std::vector<int>* record)
+{
+  _F_
+  // The previous state may have added fewer local matrices than recorded.
+  if (scatter_record != NULL && scatter_record->size() > scatter_pos)
+    scatter_record->resize(scatter_pos);
+  scatter_record = record;
+  scatter_pos = 0;
+}
+
+void DiscreteProblem::add_to_matrix(SparseMatrix* mat, unsigned int m, unsigned int n, 
+                                    scalar** local, int* rows, int* cols)
+{
+  _F_
+  if (scatter_record == NULL) {
+    mat->add(m, n, local, rows, cols);
+    return;
+  }
+
+  std::vector<int>& rec = *scatter_record;
+  scalar* Ax = scatter_Ax;
+  unsigned int len = 2 + m + n + m * n;
+
+  // Replay the record if it was made for the same local matrix.
+  bool match = (scatter_pos + len <= rec.size() && rec[scatter_pos] == (int) m && rec[scatter_pos + 1] == (int) n);
+  if (match) {
+    const int* rec_dofs = &rec[scatter_pos + 2];
+    for (unsigned int i = 0; i < m && match; i++)
+      match = (rec_dofs[i] == rows[i]);
+    for (unsigned int j = 0; j < n && match; j++)
+      match = (rec_dofs[m + j] == cols[j]);
+  }
+
+  if (match) {
+    const int* pos = &rec[scatter_pos + 2 + m + n];
+    for (unsigned int i = 0; i < m; i++, pos += n) {
+      scalar* row = local[i];
+      for (unsigned int j = 0; j < n; j++) {
+        if (pos[j] >= 0) 
+          Ax[pos[j]] += row[j];
+        else if (pos[j] == -2)
+          mat->add(rows[i], cols[j], row[j]);
+      }
+    }
+  }
+  else {
+    // Record the local matrix from here on, the rest of the old record is not valid.
+    // Dirichlet DOFs get position -1, entries missing in the sparse structure -2.
+    rec.resize(scatter_pos);
+    rec.push_back(m);
+    rec.push_back(n);
+    rec.insert(rec.end(), rows, rows + m);
+    rec.insert(rec.end(), cols, cols + n);
+    for (unsigned int i = 0; i < m; i++) {
+      for (unsigned int j = 0; j < n; j++) {
+        int pos = -1;
+        if (rows[i] >= 0 && cols[j] >= 0) {
+          pos = scatter_matrix->get_position(rows[i], cols[j]);
+          if (pos >= 0) 
+            Ax[pos] += local[i][j];
+          else {
+            pos = -2;
+            mat->add(rows[i], cols[j], local[i][j]);
+          }
+        }
+        rec.push_back(pos);
+      }
+    }
+  }
+  scatter_pos += len;
+}
+
 //// matrix structure precalculation /////////////////////////////////////////
 
 // This functions is identical in H2D and H3D.
@@ -175,12 +346,29 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
 {
   _F_
 
-  if (is_up_to_date())
+  // The matrix-free operator of apply() has no structure, and it does not count as the
+  // matrix whose structure is kept.
+  if (dynamic_cast<MatrixFreeOperator*>(mat) != NULL)
+  {
+    mat->prealloc(get_num_dofs());
+    if (rhs != NULL) rhs->alloc(get_num_dofs());
+    return;
+  }
+
+  // A block sparse matrix gets the DOFs of all equations at one node in one block.
+  bool use_block_map = (dynamic_cast<BSRMatrix*>(mat) != NULL && wf->get_neq() > 1);
+  bool unallocated = (mat != NULL && mat->get_size() != (unsigned int) get_num_dofs());
+
+  if (is_up_to_date() && !(unallocated && use_block_map && block_of_dof.empty()))
   {
     if (mat != NULL)
     {
       verbose("Reusing matrix sparse structure.");
-      mat->zero();
+      // A matrix that has not been allocated for these spaces yet.
+      if (unallocated && pattern.is_built())
+        alloc_matrix(mat);
+      else
+        mat->zero();
     }
     if (rhs != NULL) rhs->zero();
     return;
@@ -221,10 +409,20 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
   {
     // Spaces have changed: create the matrix from scratch.
     have_matrix = true;
+    scatter_map.clear();
+    scatter_map_matrix = NULL;
     mat->free();
-    mat->prealloc(ndof);
+    pattern.begin(ndof);
 
     AsmList* al = new AsmList[wf->get_neq()];
+    int* groups = new int[wf->get_neq()];
+    std::vector<int> block_slots;
+    block_of_dof.clear();
+    comp_of_dof.clear();
+    if (use_block_map) {
+      block_of_dof.resize(ndof, -1);
+      comp_of_dof.resize(ndof, -1);
+    }
     Mesh** meshes = new Mesh*[wf->get_neq()];
     bool **blocks = wf->get_blocks(force_diagonal_blocks);
 
@@ -240,8 +438,12 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
       // Obtain assembly lists for the element at all spaces.
       for (unsigned int i = 0; i < wf->get_neq(); i++) {
         // TODO: do not get the assembly list again if the element was not changed.
-        if (e[i] != NULL) spaces[i]->get_element_assembly_list(e[i], &(al[i]));
+        if (e[i] != NULL) {
+          spaces[i]->get_element_assembly_list(e[i], &(al[i]));
+          groups[i] = pattern.add_dofs(al[i].dof, al[i].cnt);
+        }
       }
+      if (use_block_map) add_to_block_map(e, al, block_slots);
 
       if(is_DG) {
         // Number of edges (= number of vertices).
@@ -291,22 +493,14 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
             for(int ed = 0; ed < num_edges; ed++) {
               for(int neigh = 0; neigh < neighbor_elems_counts[el][ed]; neigh++) {
                 if ((blocks[m][el] || blocks[el][m]) && e[m] != NULL)  {
-                  AsmList *am = &(al[m]);
                   AsmList *an = new AsmList;
                   spaces[el]->get_element_assembly_list(neighbor_elems_arrays[el][ed][neigh], an);
 
                   // pretend assembling of the element stiffness matrix
                   // register nonzero elements
-                  for (unsigned int i = 0; i < am->cnt; i++) {
-                    if (am->dof[i] >= 0) {
-                      for (unsigned int j = 0; j < an->cnt; j++) {
-                        if (an->dof[j] >= 0) {
-                          if(blocks[m][el]) mat->pre_add_ij(am->dof[i], an->dof[j]);
-                          if(blocks[el][m]) mat->pre_add_ij(an->dof[j], am->dof[i]);
-                        }
-                      }
-                    }
-                  }
+                  int neighbor_group = pattern.add_dofs(an->dof, an->cnt);
+                  if(blocks[m][el]) pattern.add_block(groups[m], neighbor_group);
+                  if(blocks[el][m]) pattern.add_block(neighbor_group, groups[m]);
                   delete an;
                 }
               }
@@ -342,21 +536,9 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
             }
           }
 
-          if (blocks[m][n] && e[m] != NULL && e[n] != NULL) {
-            AsmList *am = &(al[m]);
-            AsmList *an = &(al[n]);
-
-            // Pretend assembling of the element stiffness matrix.
-            for (unsigned int i = 0; i < am->cnt; i++) {
-              if (am->dof[i] >= 0) {
-                for (unsigned int j = 0; j < an->cnt; j++) {
-                  if (an->dof[j] >= 0) {
-                    mat->pre_add_ij(am->dof[i], an->dof[j]);
-                  }
-                }
-              }
-            }
-          }
+          // Pretend assembling of the element stiffness matrix.
+          if (blocks[m][n] && e[m] != NULL && e[n] != NULL)
+            pattern.add_block(groups[m], groups[n]);
         }
       }
     }
@@ -364,10 +546,21 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
     trav.finish();
 
     delete [] al;
+    delete [] groups;
     delete [] meshes;
     delete [] blocks;
 
-    mat->alloc();
+    // DOFs not paired with the DOFs of other spaces make blocks of their own.
+    int num_blocks = block_slots.size() / wf->get_neq();
+    for (unsigned int i = 0; i < block_of_dof.size(); i++)
+      if (block_of_dof[i] < 0) {
+        block_of_dof[i] = num_blocks++;
+        comp_of_dof[i] = 0;
+      }
+
+    // Sort out the structure (in parallel if possible) and allocate the matrix.
+    pattern.build();
+    alloc_matrix(mat);
   }
 
   // WARNING: unlike Matrix::alloc(), Vector::alloc(ndof) frees the memory occupied
@@ -382,6 +575,54 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
   struct_changed = true;
 }
 
+void DiscreteProblem::add_to_block_map(Element** e, AsmList* al, std::vector<int>& block_slots)
+{
+  _F_
+  // The assembly lists of the spaces are aligned only if all spaces have the same element here.
+  unsigned int neq = wf->get_neq(), max_cnt = 0;
+  for (unsigned int k = 0; k < neq; k++) {
+    if (e[k] == NULL || e[k]->id != e[0]->id) return;
+    max_cnt = std::max(max_cnt, al[k].cnt);
+  }
+
+  // The DOFs at the same position of the assembly lists belong to the same shape function
+  // of the element. They go to the block of one of them that already has a block, or to a
+  // new one; a DOF whose position in that block is taken gets a block of its own.
+  for (unsigned int i = 0; i < max_cnt; i++) {
+    int block = -1;
+    for (unsigned int k = 0; k < neq && block < 0; k++)
+      if (i < al[k].cnt && al[k].dof[i] >= 0) block = block_of_dof[al[k].dof[i]];
+
+    for (unsigned int k = 0; k < neq; k++) {
+      if (i >= al[k].cnt) continue;
+      int dof = al[k].dof[i];
+      if (dof < 0 || block_of_dof[dof] >= 0) continue;
+      int b = block;
+      if (b < 0 || block_slots[b * neq + k] >= 0) {
+        b = block_slots.size() / neq;
+        block_slots.resize(block_slots.size() + neq, -1);
+        if (block < 0) block = b;
+      }
+      block_slots[b * neq + k] = dof;
+      block_of_dof[dof] = b;
+      comp_of_dof[dof] = k;
+    }
+  }
+}
+
+void DiscreteProblem::alloc_matrix(SparseMatrix* mat)
+{
+  _F_
+  mat->free();
+  mat->set_pattern(&pattern);
+  BSRMatrix* bsr = dynamic_cast<BSRMatrix*>(mat);
+  if (bsr != NULL && !block_of_dof.empty()) {
+    int num_blocks = *std::max_element(block_of_dof.begin(), block_of_dof.end()) + 1;
+    bsr->set_block_map(wf->get_neq(), num_blocks, &block_of_dof[0], &comp_of_dof[0]);
+  }
+  mat->alloc();
+}
+
 //// assembly ////////////////////////////////////////////////////////////////////
 
 // Light version for linear problems.
@@ -460,6 +701,14 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat,
 
   // Creating matrix sparse structure.
   create_sparse_structure(mat, rhs, force_diagonal_blocks, block_weights);
+
+  // Drop integration orders cached for a different weak form or spaces, and shape 
+  // function values cached for curved elements of meshes that have changed since.
+  update_order_cache();
+  update_fn_cache();
+
+  // Reuse the positions of the local matrices in the matrix if it was assembled before.
+  update_scatter_map(mat);
  
   // Convert the coefficient vector 'coeff_vec' into solutions Hermes::vector 'u_ext'.
   Hermes::vector<Solution *> u_ext = Hermes::vector<Solution *>();
@@ -510,6 +759,13 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat,
   matrix_buffer = NULL;
   matrix_buffer_dim = 0;
 
+  // Drop the records of states that were not assembled this time.
+  if (scatter_matrix != NULL) {
+    set_scatter_record(NULL);
+    if (scatter_map.size() > scatter_num_states)
+      scatter_map.resize(scatter_num_states);
+  }
+
   // Deinitialize slave pss's, refmaps.
   for(std::vector<PrecalcShapeset *>::iterator it = spss.begin(); it != spss.end(); it++)
     delete *it;
@@ -519,6 +775,29 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat,
   // Delete the vector u_ext.
   for(std::vector<Solution *>::iterator it = u_ext.begin(); it != u_ext.end(); it++)
     delete *it;
+
+  verbose("Shape function cache: %u entries, %.1f%% hits, %.1f MB.", get_fn_cache_num_entries(), 
+          100.0 * get_fn_cache_hit_rate(), get_fn_cache_memory() / 1048576.0);
+}
+
+//// matrix-free operator ////////////////////////////////////////////////////////
+
+void DiscreteProblem::apply(scalar* coeff_vec, scalar* coeff_in, scalar* coeff_out)
+{
+  _F_
+  memset(coeff_out, 0, get_num_dofs() * sizeof(scalar));
+  MatrixFreeOperator op;
+  op.set_vectors(coeff_in, coeff_out);
+  assemble(coeff_vec, &op);
+}
+
+void DiscreteProblem::get_diagonal(scalar* coeff_vec, scalar* diag)
+{
+  _F_
+  memset(diag, 0, get_num_dofs() * sizeof(scalar));
+  MatrixFreeOperator op;
+  op.set_vectors(NULL, NULL, diag);
+  assemble(coeff_vec, &op);
 }
 
 void DiscreteProblem::assemble_one_stage(WeakForm::Stage& stage, 
@@ -536,14 +815,6 @@ void DiscreteProblem::assemble_one_stage(WeakForm::Stage& stage,
   // Info about the boundary edge.
   SurfPos surf_pos[4];
 
-  // Create the assembling states.
-  Traverse trav;
-  for (unsigned i = 0; i < stage.idx.size(); i++)
-    stage.fns[i] = pss[stage.idx[i]];
-  for (unsigned i = 0; i < stage.ext.size(); i++)
-    stage.ext[i]->set_quad_2d(&g_quad_2d_std);
-  trav.begin(stage.meshes.size(), &(stage.meshes.front()), &(stage.fns.front()));
-
   // Check that there is a DG form, so that the DG assembling procedure needs to be performed.
   DG_matrix_forms_present = false;
   DG_vector_forms_present = false;
@@ -573,24 +844,53 @@ void DiscreteProblem::assemble_one_stage(WeakForm::Stage& stage,
     }
   }
 
-  // Loop through all assembling states.
-  // Assemble each one.
-  Element** e;
-  while ((e = trav.get_next_state(bnd, surf_pos)) != NULL) {
-    // One state is a collection of (virtual) elements sharing 
-    // the same physical location on (possibly) different meshes.
-    // This is then the same element of the virtual union mesh. 
-    // The proper sub-element mappings to all the functions of
-    // this stage is supplied by the function Traverse::get_next_state() 
-    // called in the while loop.
-    assemble_one_state(stage, matrix, rhs, force_diagonal_blocks, 
-                       block_weights, spss, refmap, 
-                       u_ext, e, bnd, surf_pos, trav.get_base());
+  for (unsigned i = 0; i < stage.idx.size(); i++)
+    stage.fns[i] = pss[stage.idx[i]];
+  for (unsigned i = 0; i < stage.ext.size(); i++)
+    stage.ext[i]->set_quad_2d(&g_quad_2d_std);
+
+  if (num_threads > 1 && is_parallel_assembling_possible(stage, matrix, rhs)) {
+    assemble_one_stage_parallel(stage, matrix, rhs, force_diagonal_blocks, 
+                                block_weights, refmap, u_ext);
+  }
+  else {
+    // Create the assembling states.
+    Traverse trav;
+    trav.begin(stage.meshes.size(), &(stage.meshes.front()), &(stage.fns.front()));
+
+    // Loop through all assembling states.
+    // Assemble each one.
+    Element** e;
+    while ((e = trav.get_next_state(bnd, surf_pos)) != NULL) {
+      // Numbered are only states with an element in one of the spaces, as in the parallel assembling.
+      if (scatter_matrix != NULL) {
+        bool empty = true;
+        for (unsigned int i = 0; i < stage.idx.size(); i++)
+          if (e[i] != NULL) 
+            empty = false;
+        if (!empty) {
+          set_scatter_record(NULL);
+          if (scatter_map.size() <= scatter_num_states)
+            scatter_map.resize(scatter_num_states + 1);
+          set_scatter_record(&scatter_map[scatter_num_states++]);
+        }
+      }
+
+      // One state is a collection of (virtual) elements sharing 
+      // the same physical location on (possibly) different meshes.
+      // This is then the same element of the virtual union mesh. 
+      // The proper sub-element mappings to all the functions of
+      // this stage is supplied by the function Traverse::get_next_state() 
+      // called in the while loop.
+      assemble_one_state(stage, matrix, rhs, force_diagonal_blocks, 
+                         block_weights, spss, refmap, 
+                         u_ext, e, bnd, surf_pos, trav.get_base());
+    }
+    trav.finish();
   }
 
   if (matrix != NULL) matrix->finish();
   if (rhs != NULL) rhs->finish();
-  trav.finish();
 
   if(DG_matrix_forms_present || DG_vector_forms_present) {
     Element* element_to_set_nonvisited;
@@ -600,6 +900,278 @@ void DiscreteProblem::assemble_one_stage(WeakForm::Stage& stage,
   }
 }
 
+bool DiscreteProblem::is_parallel_assembling_possible(WeakForm::Stage& stage, SparseMatrix* mat, Vector* rhs)
+{
+  _F_
+#ifdef _OPENMP
+  // Concurrent additions to distinct entries are safe only for the plain CSC and BSR storage
+  // (and for the matrix-free operator, which adds to distinct entries of its vectors).
+  if (mat != NULL && dynamic_cast<CSCMatrix*>(mat) == NULL && dynamic_cast<BSRMatrix*>(mat) == NULL
+      && dynamic_cast<MatrixFreeOperator*>(mat) == NULL) {
+    verbose("Parallel assembling is supported for CSCMatrix, BSRMatrix and MatrixFreeOperator only, assembling serially.");
+    return false;
+  }
+  if (rhs != NULL && dynamic_cast<UMFPackVector*>(rhs) == NULL) {
+    verbose("Parallel assembling is supported for UMFPackVector only, assembling serially.");
+    return false;
+  }
+
+  // DG forms assemble across element edges, i.e. outside of the DOFs of one state.
+  if (DG_matrix_forms_present || DG_vector_forms_present) {
+    verbose("Parallel assembling of DG forms is not supported, assembling serially.");
+    return false;
+  }
+
+  // Adaptive quadrature transforms the external functions of the form directly.
+  Hermes::vector<WeakForm::Form*> forms;
+  forms.insert(forms.end(), stage.mfvol.begin(), stage.mfvol.end());
+  forms.insert(forms.end(), stage.mfsurf.begin(), stage.mfsurf.end());
+  forms.insert(forms.end(), stage.vfvol.begin(), stage.vfvol.end());
+  forms.insert(forms.end(), stage.vfsurf.begin(), stage.vfsurf.end());
+  forms.insert(forms.end(), stage.mfvol_mc.begin(), stage.mfvol_mc.end());
+  forms.insert(forms.end(), stage.mfsurf_mc.begin(), stage.mfsurf_mc.end());
+  forms.insert(forms.end(), stage.vfvol_mc.begin(), stage.vfvol_mc.end());
+  forms.insert(forms.end(), stage.vfsurf_mc.begin(), stage.vfsurf_mc.end());
+  for (unsigned int i = 0; i < forms.size(); i++)
+    if (forms[i]->adapt_eval) {
+      verbose("Parallel assembling of adaptively integrated forms is not supported, assembling serially.");
+      return false;
+    }
+
+  // Every thread needs its own copy of the external functions.
+  for (unsigned int i = 0; i < stage.ext.size(); i++) {
+    Solution* sln = dynamic_cast<Solution*>(stage.ext[i]);
+    if (sln == NULL || (sln->get_type() != HERMES_SLN && sln->get_type() != HERMES_CONST)) {
+      verbose("Parallel assembling supports only Solutions as external functions, assembling serially.");
+      return false;
+    }
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+// One assembling state recorded for the parallel assembling. The elements and the
+// sub-element transforms of the stage functions are stored separately, per function.
+struct ParallelAssemblingState
+{
+  bool bnd[4];
+  SurfPos surf_pos[4];
+  Element* trav_base;
+};
+
+// Data private to one thread of the parallel assembling.
+struct ParallelAssemblingWorker
+{
+  DiscreteProblem* dp;
+  Quad2DStd* quad;
+  Hermes::vector<PrecalcShapeset *> spss;
+  Hermes::vector<RefMap *> refmap;
+  Hermes::vector<Solution *> u_ext;
+  Hermes::vector<Solution *> ext;
+};
+
+void DiscreteProblem::assemble_one_stage_parallel(WeakForm::Stage& stage, 
+                                                  SparseMatrix* matrix, Vector* rhs,
+                                                  bool force_diagonal_blocks, Table* block_weights,
+                                                  Hermes::vector<RefMap *>& refmap, 
+                                                  Hermes::vector<Solution *>& u_ext)
+{
+  _F_
+#ifdef _OPENMP
+  unsigned int nfns = stage.fns.size();
+  unsigned int nidx = stage.idx.size();
+  int neq = wf->get_neq();
+
+  // Traverse the union mesh with plain Transformables in place of the stage functions,
+  // and record all states. The real functions are set up later by the workers.
+  Transformable* trav_fns = new Transformable[nfns];
+  Hermes::vector<Transformable *> trav_fn_ptrs;
+  for (unsigned int i = 0; i < nfns; i++)
+    trav_fn_ptrs.push_back(trav_fns + i);
+
+  std::vector<ParallelAssemblingState> states;
+  std::vector<Element*> state_e, state_fn_e;
+  std::vector<uint64_t> state_sub_idx;
+  std::vector<int> state_color, state_mode;
+
+  // Colors already used by each DOF, one bit per color.
+  const int max_colors = 64;
+  std::vector<uint64_t> dof_colors(get_num_dofs(), 0);
+  std::vector<int> dofs;
+  AsmList al;
+
+  Traverse trav;
+  ParallelAssemblingState st;
+  Element** e;
+  trav.begin(stage.meshes.size(), &(stage.meshes.front()), &(trav_fn_ptrs.front()));
+  while ((e = trav.get_next_state(st.bnd, st.surf_pos)) != NULL) {
+    Element* e0 = NULL;
+    for (unsigned int i = 0; i < nidx; i++)
+      if ((e0 = e[i]) != NULL) 
+        break;
+    if (e0 == NULL) 
+      continue;
+
+    st.trav_base = trav.get_base();
+    for (unsigned int i = 0; i < nfns; i++) {
+      state_e.push_back(e[i]);
+      state_fn_e.push_back(trav_fns[i].get_active_element());
+      state_sub_idx.push_back(trav_fns[i].get_transform());
+
+      // The order of the inverse reference map is cached in the element,
+      // calculate it here so that the workers only read it.
+      if (e[i] != NULL && e[i]->iro_cache == -1)
+        refmap[0]->set_active_element(e[i]);
+    }
+
+    // Greedy coloring: the state gets the lowest color not used by any of its DOFs.
+    dofs.clear();
+    for (unsigned int i = 0; i < nidx; i++) {
+      if (e[i] == NULL) 
+        continue;
+      spaces[stage.idx[i]]->get_element_assembly_list(e[i], &al);
+      for (unsigned int k = 0; k < al.cnt; k++)
+        if (al.dof[k] >= 0)
+          dofs.push_back(al.dof[k]);
+    }
+    uint64_t used = 0;
+    for (unsigned int k = 0; k < dofs.size(); k++)
+      used |= dof_colors[dofs[k]];
+    int color = -1;
+    for (int c = 0; c < max_colors; c++)
+      if (!(used & ((uint64_t) 1 << c))) {
+        color = c;
+        break;
+      }
+    if (color >= 0)
+      for (unsigned int k = 0; k < dofs.size(); k++)
+        dof_colors[dofs[k]] |= (uint64_t) 1 << color;
+
+    states.push_back(st);
+    state_color.push_back(color);
+    state_mode.push_back(e0->get_mode());
+  }
+  trav.finish();
+  delete [] trav_fns;
+
+  // Sort the states into buckets by color and element mode. States that could not be
+  // colored go to the last bucket, which is assembled by one thread. The buckets keep the
+  // order of the traversal, so with Mesh::set_sfc_traversal() the chunks taken by the
+  // threads are compact parts of the domain.
+  std::vector<std::vector<int> > buckets(2 * (max_colors + 1));
+  for (unsigned int s = 0; s < states.size(); s++) {
+    int color = (state_color[s] >= 0) ? state_color[s] : max_colors;
+    buckets[2 * color + state_mode[s]].push_back(s);
+  }
+
+  // Create the workers.
+  std::vector<ParallelAssemblingWorker> workers(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    ParallelAssemblingWorker& w = workers[t];
+    w.quad = new Quad2DStd;
+    w.dp = new DiscreteProblem(this, w.quad);
+    for (int i = 0; i < neq; i++) {
+      PrecalcShapeset* p = new PrecalcShapeset(w.dp->pss[i]);
+      p->set_quad_2d(w.quad);
+      w.spss.push_back(p);
+      RefMap* rm = new RefMap();
+      rm->set_private_shapeset();
+      rm->set_quad_2d(w.quad);
+      w.refmap.push_back(rm);
+    }
+    for (unsigned int i = 0; i < stage.ext.size(); i++) {
+      Solution* copy = new Solution;
+      copy->copy(static_cast<Solution*>(stage.ext[i]), true);
+      copy->set_private_refmap_shapeset();
+      copy->set_quad_2d(w.quad);
+      w.ext.push_back(copy);
+      w.dp->ext_copies[stage.ext[i]] = copy;
+    }
+    for (unsigned int i = 0; i < u_ext.size(); i++)
+      w.u_ext.push_back(u_ext[i] == NULL ? NULL : static_cast<Solution*>(w.dp->get_ext_fn(u_ext[i])));
+  }
+
+  // The states of this stage are recorded in the scatter map after those of the previous stages.
+  unsigned int scatter_first = scatter_num_states;
+  if (scatter_matrix != NULL) {
+    set_scatter_record(NULL);
+    scatter_num_states += states.size();
+    if (scatter_map.size() < scatter_num_states)
+      scatter_map.resize(scatter_num_states);
+  }
+
+  for (unsigned int b = 0; b < buckets.size(); b++) {
+    std::vector<int>& bucket = buckets[b];
+    if (bucket.empty())
+      continue;
+
+    // The limit table and the shapesets of the spaces are shared by all threads,
+    // all states of a bucket have the same element mode.
+    int mode = b % 2;
+    update_limit_table(mode);
+    for (int i = 0; i < neq; i++)
+      spaces[i]->get_shapeset()->set_mode(mode);
+
+    int bucket_threads = (b / 2 == (unsigned) max_colors) ? 1 : num_threads;
+    int nb = bucket.size();
+#pragma omp parallel for schedule(dynamic, 8) num_threads(bucket_threads)
+    for (int k = 0; k < nb; k++) {
+      ParallelAssemblingWorker& w = workers[omp_get_thread_num()];
+      int s = bucket[k];
+
+      // Replay the state on the functions of the worker.
+      for (unsigned int i = 0; i < nfns; i++) {
+        Element* fe = state_fn_e[s * nfns + i];
+        if (fe == NULL)
+          continue;
+        Transformable* fn;
+        if (i < nidx)
+          fn = w.dp->pss[stage.idx[i]];
+        else
+          fn = w.ext[i - nidx];
+        uint64_t sub_idx = state_sub_idx[s * nfns + i];
+        if (fn->get_active_element() != fe || sub_idx == 0)
+          fn->set_active_element(fe);
+        fn->set_transform(sub_idx);
+      }
+
+      if (scatter_matrix != NULL)
+        w.dp->set_scatter_record(&scatter_map[scatter_first + s]);
+
+      w.dp->assemble_one_state(stage, matrix, rhs, force_diagonal_blocks, 
+                               block_weights, w.spss, w.refmap, w.u_ext, 
+                               &state_e[s * nfns], states[s].bnd, states[s].surf_pos, 
+                               states[s].trav_base);
+    }
+  }
+
+  // Keep the integration orders and shape function values found by the workers,
+  // and delete the workers.
+  for (int t = 0; t < num_threads; t++) {
+    ParallelAssemblingWorker& w = workers[t];
+    assembling_caches.cache_order.insert(w.dp->assembling_caches.cache_order.begin(), 
+                                         w.dp->assembling_caches.cache_order.end());
+    assembling_caches.cache_fn_const.merge(w.dp->assembling_caches.cache_fn_const);
+    assembling_caches.cache_fn_curved.merge(w.dp->assembling_caches.cache_fn_curved);
+    limit_fn_cache();
+    w.dp->set_scatter_record(NULL);
+    for (unsigned int i = 0; i < w.ext.size(); i++)
+      delete w.ext[i];
+    for (int i = 0; i < neq; i++) {
+      delete w.spss[i];
+      delete w.refmap[i];
+    }
+    if (w.dp->matrix_buffer != NULL)
+      delete [] w.dp->matrix_buffer;
+    delete w.dp;
+    delete w.quad;
+  }
+#endif
+}
+
 Element* DiscreteProblem::init_state(WeakForm::Stage& stage, Hermes::vector<PrecalcShapeset *>& spss, 
   Hermes::vector<RefMap *>& refmap, Element** e, Hermes::vector<bool>& isempty, Hermes::vector<AsmList *>& al)
 {
@@ -613,7 +1185,9 @@ Element* DiscreteProblem::init_state(WeakForm::Stage& stage, Hermes::vector<Prec
     return NULL;
 
   // Set maximum integration order for use in integrals, see limit_order()
-  update_limit_table(e0->get_mode());
+  // (the workers of the parallel assembling have it set by the master thread).
+  if (!is_worker)
+    update_limit_table(e0->get_mode());
 
   // Obtain assembly lists for the element at all spaces of the stage, set appropriate mode for each pss.
   // NOTE: Active elements and transformations for external functions (including the solutions from previous
@@ -652,6 +1226,9 @@ void DiscreteProblem::assemble_one_state(WeakForm::Stage& stage,
       bool* bnd, SurfPos* surf_pos, Element* trav_base)
 {
   _F_
+  // The values cached for curved elements are not used by any state at this point.
+  limit_fn_cache();
+
   // Assembly list vector.
   Hermes::vector<AsmList *> al;
   for(unsigned int i = 0; i < wf->get_neq(); i++) 
@@ -751,46 +1328,55 @@ void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage,
     scalar **local_stiffness_matrix = NULL;
     local_stiffness_matrix = get_matrix_buffer(std::max(al[m]->cnt, al[n]->cnt));
 
-    for (unsigned int i = 0; i < al[m]->cnt; i++) {
-      if (!tra && al[m]->dof[i] < 0) continue;
-      spss[m]->set_active_shape(al[m]->idx[i]);
+    // Non-adaptive forms with a batched evaluation are evaluated for all shape function
+    // pairs at once, the others pair by pair.
+    if (!mfv->adapt_eval && mfv->has_value_batch()) {
+      if (mat != NULL)
+        eval_form_batch(mfv, u_ext, pss[n], spss[m], refmap[n], refmap[m], al[n], al[m],
+                        tra, sym, block_scaling_coeff, local_stiffness_matrix);
+    }
+    else {
+      for (unsigned int i = 0; i < al[m]->cnt; i++) {
+        if (!tra && al[m]->dof[i] < 0) continue;
+        spss[m]->set_active_shape(al[m]->idx[i]);
         
-      // Unsymmetric block.
-      if (!sym) {
-        for (unsigned int j = 0; j < al[n]->cnt; j++) {
-          pss[n]->set_active_shape(al[n]->idx[j]);
+        // Unsymmetric block.
+        if (!sym) {
+          for (unsigned int j = 0; j < al[n]->cnt; j++) {
+            pss[n]->set_active_shape(al[n]->idx[j]);
           
-          if (al[n]->dof[j] >= 0) {
-            if (mat != NULL) {
-              scalar val = 0;
-              // Numerical integration performed only if all 
-              // coefficients multiplying the form are nonzero.
-              if (std::abs(al[m]->coef[i]) > 1e-12 && std::abs(al[n]->coef[j]) > 1e-12) {
-                val = block_scaling_coeff * eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
-                                                      refmap[m]) * al[n]->coef[j] * al[m]->coef[i];
+            if (al[n]->dof[j] >= 0) {
+              if (mat != NULL) {
+                scalar val = 0;
+                // Numerical integration performed only if all 
+                // coefficients multiplying the form are nonzero.
+                if (std::abs(al[m]->coef[i]) > 1e-12 && std::abs(al[n]->coef[j]) > 1e-12) {
+                  val = block_scaling_coeff * eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
+                                                        refmap[m]) * al[n]->coef[j] * al[m]->coef[i];
+                }
+                local_stiffness_matrix[i][j] = val;
               }
-              local_stiffness_matrix[i][j] = val;
-	    }
-	  }
-	}
-      }
-      // Symmetric block.
-      else {
-        for (unsigned int j = 0; j < al[n]->cnt; j++) {
-          if (j < i && al[n]->dof[j] >= 0) continue;
+            }
+          }
+        }
+        // Symmetric block.
+        else {
+          for (unsigned int j = 0; j < al[n]->cnt; j++) {
+            if (j < i && al[n]->dof[j] >= 0) continue;
             
-          pss[n]->set_active_shape(al[n]->idx[j]);
+            pss[n]->set_active_shape(al[n]->idx[j]);
           
-          if (al[n]->dof[j] >= 0) { 
-            if (mat != NULL) {
-              scalar val = 0;
-              // Numerical integration performed only if all coefficients 
-              // multiplying the form are nonzero.
-              if (std::abs(al[m]->coef[i]) > 1e-12 && std::abs(al[n]->coef[j]) > 1e-12) {
-                val = block_scaling_coeff * eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
-                                                      refmap[m]) * al[n]->coef[j] * al[m]->coef[i];
+            if (al[n]->dof[j] >= 0) { 
+              if (mat != NULL) {
+                scalar val = 0;
+                // Numerical integration performed only if all coefficients 
+                // multiplying the form are nonzero.
+                if (std::abs(al[m]->coef[i]) > 1e-12 && std::abs(al[n]->coef[j]) > 1e-12) {
+                  val = block_scaling_coeff * eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
+                                                        refmap[m]) * al[n]->coef[j] * al[m]->coef[i];
+                }
+                local_stiffness_matrix[i][j] = local_stiffness_matrix[j][i] = val;
               }
-              local_stiffness_matrix[i][j] = local_stiffness_matrix[j][i] = val;
             }
           }
         }
@@ -799,7 +1385,7 @@ void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage,
 
     // Insert the local stiffness matrix into the global one.
     if (mat != NULL) {
-      mat->add(al[m]->cnt, al[n]->cnt, local_stiffness_matrix, al[m]->dof, al[n]->dof);
+      add_to_matrix(mat, al[m]->cnt, al[n]->cnt, local_stiffness_matrix, al[m]->dof, al[n]->dof);
     }
 
     // Insert also the off-diagonal (anti-)symmetric block, if required.
@@ -810,7 +1396,7 @@ void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage,
       transpose(local_stiffness_matrix, al[m]->cnt, al[n]->cnt);
 
       if (mat != NULL) {
-        mat->add(al[n]->cnt, al[m]->cnt, local_stiffness_matrix, al[n]->dof, al[m]->dof);
+        add_to_matrix(mat, al[n]->cnt, al[m]->cnt, local_stiffness_matrix, al[n]->dof, al[m]->dof);
       }
     }
   }
@@ -1621,7 +2207,7 @@ void DiscreteProblem::assemble_surface_matrix_forms(WeakForm::Stage& stage,
       }
     }
     if (mat != NULL) {
-      mat->add(al[m]->cnt, al[n]->cnt, local_stiffness_matrix, al[m]->dof, al[n]->dof);
+      add_to_matrix(mat, al[m]->cnt, al[n]->cnt, local_stiffness_matrix, al[m]->dof, al[n]->dof);
     }
   }
 }
@@ -1879,7 +2465,7 @@ void DiscreteProblem::assemble_DG_matrix_forms(WeakForm::Stage& stage,
       }
     }
     if (mat != NULL) {
-      mat->add(ext_asmlist_v->cnt, ext_asmlist_u->cnt, local_stiffness_matrix, ext_asmlist_v->dof, ext_asmlist_u->dof);
+      add_to_matrix(mat, ext_asmlist_v->cnt, ext_asmlist_u->cnt, local_stiffness_matrix, ext_asmlist_v->dof, ext_asmlist_u->dof);
     }
   }
 }
@@ -2066,12 +2652,20 @@ ExtData<Ord>* DiscreteProblem::init_ext_fns_ord(Hermes::vector<MeshFunction *> &
   fake_ext->nf = ext.size();
   Func<Ord>** fake_ext_fn = new Func<Ord>*[fake_ext->nf];
   for (int i = 0; i < fake_ext->nf; i++)
-    fake_ext_fn[i] = get_fn_ord(ext[i]->get_fn_order());
+    fake_ext_fn[i] = get_fn_ord(get_ext_fn(ext[i])->get_fn_order());
   fake_ext->fn = fake_ext_fn;
   
   return fake_ext;
 }
 
+MeshFunction* DiscreteProblem::get_ext_fn(MeshFunction* fn)
+{
+  if (ext_copies.empty())
+    return fn;
+  std::map<MeshFunction*, MeshFunction*>::iterator it = ext_copies.find(fn);
+  return (it != ext_copies.end()) ? it->second : fn;
+}
+
 // Initialize external functions (obtain values, derivatives,...)
 ExtData<scalar>* DiscreteProblem::init_ext_fns(Hermes::vector<MeshFunction *> &ext, 
                                                RefMap *rm, const int order)
@@ -2082,7 +2676,7 @@ ExtData<scalar>* DiscreteProblem::init_ext_fns(Hermes::vector<MeshFunction *> &e
   // Copy external functions.
   Func<scalar>** ext_fn = new Func<scalar>*[ext.size()];
   for (unsigned i = 0; i < ext.size(); i++) {
-    if (ext[i] != NULL) ext_fn[i] = init_fn(ext[i], order);
+    if (ext[i] != NULL) ext_fn[i] = init_fn(get_ext_fn(ext[i]), order);
     else ext_fn[i] = NULL;
   }
   ext_data->nf = ext.size();
@@ -2102,7 +2696,7 @@ ExtData<Ord>* DiscreteProblem::init_ext_fns_ord(Hermes::vector<MeshFunction *> &
   fake_ext->nf = ext.size();
   Func<Ord>** fake_ext_fn = new Func<Ord>*[fake_ext->nf];
   for (int i = 0; i < fake_ext->nf; i++)
-    fake_ext_fn[i] = get_fn_ord(ext[i]->get_edge_fn_order(edge));
+    fake_ext_fn[i] = get_fn_ord(get_ext_fn(ext[i])->get_edge_fn_order(edge));
   fake_ext->fn = fake_ext_fn;
 
   return fake_ext;
@@ -2147,33 +2741,46 @@ ExtData<Ord>* DiscreteProblem::init_ext_fns_ord(Hermes::vector<MeshFunction *> &
 Func<double>* DiscreteProblem::get_fn(PrecalcShapeset *fu, RefMap *rm, const int order)
 {
   _F_
-  if(rm->is_jacobian_const()) {
-    AssemblingCaches::KeyConst key(256 - fu->get_active_shape(), order, fu->get_transform(), fu->get_shapeset()->get_id(), rm->get_const_inv_ref_map());
-    if(rm->get_active_element()->get_mode() == HERMES_MODE_TRIANGLE) {
-      if(assembling_caches.const_cache_fn_triangles.find(key) == assembling_caches.const_cache_fn_triangles.end())
-        assembling_caches.const_cache_fn_triangles[key] = init_fn(fu, rm, order);
-      return assembling_caches.const_cache_fn_triangles[key];
-    }
-    else {
-      if(assembling_caches.const_cache_fn_quads.find(key) == assembling_caches.const_cache_fn_quads.end())
-        assembling_caches.const_cache_fn_quads[key] = init_fn(fu, rm, order);
-      return assembling_caches.const_cache_fn_quads[key];
-    }
+  AssemblingCaches::KeyFn key;
+  key.index = fu->get_active_shape();
+  key.order = order;
+  key.sub_idx = fu->get_transform();
+  key.shapeset_type = fu->get_shapeset()->get_id();
+  key.mode = rm->get_active_element()->get_mode();
+
+  bool is_const = rm->is_jacobian_const();
+  if (is_const) {
+    double2x2* m = rm->get_const_inv_ref_map();
+    key.element = NULL;
+    key.inv_ref_map[0][0] = (*m)[0][0];
+    key.inv_ref_map[0][1] = (*m)[0][1];
+    key.inv_ref_map[1][0] = (*m)[1][0];
+    key.inv_ref_map[1][1] = (*m)[1][1];
   }
   else {
-    AssemblingCaches::KeyNonConst key(256 - fu->get_active_shape(), order, 
-                                      fu->get_transform(), fu->get_shapeset()->get_id());
-    if(rm->get_active_element()->get_mode() == HERMES_MODE_TRIANGLE) {
-      if(assembling_caches.cache_fn_triangles.find(key) == assembling_caches.cache_fn_triangles.end())
-        assembling_caches.cache_fn_triangles[key] = init_fn(fu, rm, order);
-      return assembling_caches.cache_fn_triangles[key];
-    }
-    else {
-      if(assembling_caches.cache_fn_quads.find(key) == assembling_caches.cache_fn_quads.end())
-        assembling_caches.cache_fn_quads[key] = init_fn(fu, rm, order);
-      return assembling_caches.cache_fn_quads[key];
-    }
+    key.element = rm->get_active_element();
+    key.inv_ref_map[0][0] = key.inv_ref_map[0][1] = 0.0;
+    key.inv_ref_map[1][0] = key.inv_ref_map[1][1] = 0.0;
   }
+
+  AssemblingCaches::FnCache& cache = is_const ? assembling_caches.cache_fn_const 
+                                              : assembling_caches.cache_fn_curved;
+  Func<double>* fn = cache.find(key);
+
+  // Workers of the parallel assembling may also use the values of the master, 
+  // which are not modified while the workers run.
+  if (fn == NULL && assembling_caches.master != NULL)
+    fn = (is_const ? assembling_caches.master->cache_fn_const
+                   : assembling_caches.master->cache_fn_curved).find(key);
+
+  if (fn != NULL) {
+    cache.hits++;
+    return fn;
+  }
+  cache.misses++;
+  fn = init_fn(fu, rm, order);
+  cache.insert(key, fn);
+  return fn;
 }
 
 // Initialize shape function values and derivatives (fill in the cache)
@@ -2187,6 +2794,96 @@ Func<Ord>* DiscreteProblem::get_fn_ord(const int order)
   return assembling_caches.cache_fn_ord.get(cached_order);
 }
 
+void DiscreteProblem::update_order_cache()
+{
+  _F_
+  bool changed = (wf->get_seq() != assembling_caches.order_wf_seq) 
+                 || (assembling_caches.order_sp_seq.size() != wf->get_neq());
+  for (unsigned int i = 0; !changed && i < wf->get_neq(); i++)
+    if (spaces[i]->get_seq() != assembling_caches.order_sp_seq[i])
+      changed = true;
+  if (!changed) return;
+
+  assembling_caches.cache_order.clear();
+  assembling_caches.order_wf_seq = wf->get_seq();
+  assembling_caches.order_sp_seq.resize(wf->get_neq());
+  for (unsigned int i = 0; i < wf->get_neq(); i++)
+    assembling_caches.order_sp_seq[i] = spaces[i]->get_seq();
+}
+
+void DiscreteProblem::init_order_key(void* form, int u_order, int v_order, Hermes::vector<Solution *>& u_ext,
+                                     int u_ext_offset, int u_ext_edge, Hermes::vector<MeshFunction *>& ext,
+                                     int ext_edge, RefMap* rm)
+{
+  AssemblingCaches::KeyOrder& key = assembling_caches.order_key;
+  key.form = form;
+  key.orders.clear();
+  key.orders.push_back(rm->get_active_element()->get_mode());
+  key.orders.push_back(rm->get_inv_ref_order());
+  key.orders.push_back(u_order);
+  key.orders.push_back(v_order);
+  for (int i = u_ext_offset; i < (int) u_ext.size(); i++) {
+    if (u_ext[i] == NULL)
+      key.orders.push_back(0);
+    else
+      key.orders.push_back(u_ext_edge == -1 ? u_ext[i]->get_fn_order() : u_ext[i]->get_edge_fn_order(u_ext_edge));
+  }
+  for (unsigned int i = 0; i < ext.size(); i++) {
+    MeshFunction* fn = get_ext_fn(ext[i]);
+    key.orders.push_back(ext_edge == -1 ? fn->get_fn_order() : fn->get_edge_fn_order(ext_edge));
+  }
+}
+
+void DiscreteProblem::update_fn_cache()
+{
+  _F_
+  bool changed = (assembling_caches.fn_mesh_seq.size() != wf->get_neq());
+  for (unsigned int i = 0; !changed && i < wf->get_neq(); i++)
+    if (spaces[i]->get_mesh()->get_seq() != assembling_caches.fn_mesh_seq[i])
+      changed = true;
+  if (!changed) return;
+
+  assembling_caches.cache_fn_curved.clear();
+  assembling_caches.fn_mesh_seq.resize(wf->get_neq());
+  for (unsigned int i = 0; i < wf->get_neq(); i++)
+    assembling_caches.fn_mesh_seq[i] = spaces[i]->get_mesh()->get_seq();
+}
+
+void DiscreteProblem::limit_fn_cache()
+{
+  AssemblingCaches::FnCache& cache = assembling_caches.cache_fn_curved;
+  if (cache.get_num_entries() > 0 && cache.get_memory() > assembling_caches.fn_curved_limit)
+    cache.clear();
+}
+
+unsigned int DiscreteProblem::get_fn_cache_num_entries()
+{
+  return assembling_caches.cache_fn_const.get_num_entries() 
+         + assembling_caches.cache_fn_curved.get_num_entries();
+}
+
+double DiscreteProblem::get_fn_cache_hit_rate()
+{
+  double hits = assembling_caches.cache_fn_const.hits + assembling_caches.cache_fn_curved.hits;
+  double misses = assembling_caches.cache_fn_const.misses + assembling_caches.cache_fn_curved.misses;
+  return (hits + misses > 0) ? hits / (hits + misses) : 0.0;
+}
+
+size_t DiscreteProblem::get_fn_cache_memory()
+{
+  return assembling_caches.cache_fn_const.get_memory() + assembling_caches.cache_fn_curved.get_memory();
+}
+
+bool DiscreteProblem::find_cached_order(int& order)
+{
+  std::map<AssemblingCaches::KeyOrder, int, AssemblingCaches::CompareOrder>::const_iterator it 
+    = assembling_caches.cache_order.find(assembling_caches.order_key);
+  if (it == assembling_caches.cache_order.end())
+    return false;
+  order = it->second;
+  return true;
+}
+
 // Caching transformed values
 void DiscreteProblem::init_cache()
 {
@@ -2219,20 +2916,6 @@ void DiscreteProblem::delete_cache()
       delete [] cache_jwt[i];
     }
   }
-  
-  for (std::map<AssemblingCaches::KeyNonConst, Func<double>*, AssemblingCaches::CompareNonConst>::const_iterator it = assembling_caches.cache_fn_quads.begin();
-       it != assembling_caches.cache_fn_quads.end(); it++)
-  {
-    (it->second)->free_fn(); delete (it->second);
-  }
-  assembling_caches.cache_fn_quads.clear();
-
-  for (std::map<AssemblingCaches::KeyNonConst, Func<double>*, AssemblingCaches::CompareNonConst>::const_iterator it = assembling_caches.cache_fn_triangles.begin();
-       it != assembling_caches.cache_fn_triangles.end(); it++)
-  {
-    (it->second)->free_fn(); delete (it->second);
-  }
-  assembling_caches.cache_fn_triangles.clear();
 }
 
 DiscontinuousFunc<Ord>* DiscreteProblem::init_ext_fn_ord(NeighborSearch* ns, MeshFunction* fu)
@@ -2371,6 +3054,12 @@ int DiscreteProblem::calc_order_matrix_form_vol(WeakForm::MatrixFormVol *mfv, He
   if(is_fvm) 
     order = ru->get_inv_ref_order();
   else {
+    // The order depends only on the orders of the functions involved, 
+    // so the form does not have to be parsed if they were seen before.
+    init_order_key(mfv, fu->get_fn_order(), fv->get_fn_order(), u_ext, mfv->u_ext_offset, -1, mfv->ext, -1, ru);
+    if (find_cached_order(order))
+      return order;
+
     int u_ext_length = u_ext.size();      // Number of external solutions.
     int u_ext_offset = mfv->u_ext_offset; // External solutions will start with u_ext[u_ext_offset]
                                           // and there will be only u_ext_length - u_ext_offset of them.
@@ -2407,6 +3096,7 @@ int DiscreteProblem::calc_order_matrix_form_vol(WeakForm::MatrixFormVol *mfv, He
     order = ru->get_inv_ref_order();
     order += o.get_order();
     limit_order(order);
+    assembling_caches.cache_order[assembling_caches.order_key] = order;
     
     // Cleanup.
     delete [] oi;
@@ -2638,6 +3328,138 @@ scalar DiscreteProblem::eval_form_adaptive(int order_init, scalar result_init,
 }
 
 
+void DiscreteProblem::eval_form_batch(WeakForm::MatrixFormVol *mfv, 
+                                      Hermes::vector<Solution *> u_ext,
+                                      PrecalcShapeset *fu, PrecalcShapeset *fv, 
+                                      RefMap *ru, RefMap *rv, AsmList *alu, AsmList *alv,
+                                      bool tra, bool sym, double block_scaling_coeff,
+                                      scalar **local_matrix)
+{
+  _F_
+  int nu = alu->cnt;
+  int nv = alv->cnt;
+  if (nu == 0 || nv == 0) return;
+
+  // Find the shape functions of the highest order. Since the order of the form 
+  // only grows with the orders of the shape functions, parsing the form for 
+  // this pair yields an order sufficient for all the other pairs.
+  int u_max = 0, v_max = 0;
+  int u_max_order = -1, v_max_order = -1;
+  for (int j = 0; j < nu; j++) {
+    int o = fu->get_shapeset()->get_order(alu->idx[j]);
+    o = std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o));
+    if (o > u_max_order) { u_max_order = o; u_max = j; }
+  }
+  for (int i = 0; i < nv; i++) {
+    int o = fv->get_shapeset()->get_order(alv->idx[i]);
+    o = std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o));
+    if (o > v_max_order) { v_max_order = o; v_max = i; }
+  }
+  fu->set_active_shape(alu->idx[u_max]);
+  fv->set_active_shape(alv->idx[v_max]);
+  int order = calc_order_matrix_form_vol(mfv, u_ext, fu, fv, ru, rv);
+
+  Quad2D* quad = fu->get_quad_2d();
+  double3* pt = quad->get_points(order);
+  int np = quad->get_num_points(order);
+
+  // Init geometry and jacobian*weights.
+  if (cache_e[order] == NULL)
+  {
+    cache_e[order] = init_geom_vol(ru, order);
+    double* jac = NULL;
+    if(!ru->is_jacobian_const()) 
+      jac = ru->get_jacobian(order);
+    cache_jwt[order] = new double[np];
+    for(int i = 0; i < np; i++) {
+      if(ru->is_jacobian_const())
+        cache_jwt[order][i] = pt[i][2] * ru->get_const_jacobian();
+      else
+        cache_jwt[order][i] = pt[i][2] * jac[i];
+    }
+  }
+  Geom<double>* e = cache_e[order];
+  double* jwt = cache_jwt[order];
+
+  // Shape functions in quadrature points. Pairs that would be multiplied by a zero
+  // coefficient or that do not end up in the matrix are marked by NULL.
+  Func<double>** u = new Func<double>*[nu];
+  for (int j = 0; j < nu; j++) {
+    if (alu->dof[j] >= 0 && std::abs(alu->coef[j]) > 1e-12) {
+      fu->set_active_shape(alu->idx[j]);
+      u[j] = get_fn(fu, ru, order);
+    }
+    else
+      u[j] = NULL;
+  }
+  Func<double>** v = u;
+  if (!sym) {
+    v = new Func<double>*[nv];
+    for (int i = 0; i < nv; i++) {
+      if ((tra || alv->dof[i] >= 0) && std::abs(alv->coef[i]) > 1e-12) {
+        fv->set_active_shape(alv->idx[i]);
+        v[i] = get_fn(fv, rv, order);
+      }
+      else
+        v[i] = NULL;
+    }
+  }
+
+  // Values of the previous Newton iteration and external functions in quadrature points.
+  int prev_size = u_ext.size() - mfv->u_ext_offset;
+  if(RungeKutta)
+    prev_size = RK_original_spaces_count;
+
+  Func<scalar>** prev = new Func<scalar>*[prev_size];
+  if (u_ext != Hermes::vector<Solution *>())
+    for (int i = 0; i < prev_size; i++)
+      if (u_ext[i + mfv->u_ext_offset] != NULL)
+        prev[i] = init_fn(u_ext[i + mfv->u_ext_offset], order);
+      else 
+        prev[i] = NULL;
+  else
+    for (int i = 0; i < prev_size; i++) 
+      prev[i] = NULL;
+
+  ExtData<scalar>* ext = init_ext_fns(mfv->ext, rv, order);
+  
+  // Add the previous time level solution previously inserted at the back of ext.
+  if(RungeKutta)
+    for(unsigned int ext_i = 0; ext_i < this->RK_original_spaces_count; ext_i++)
+      prev[ext_i]->add(*ext->fn[mfv->ext.size() - this->RK_original_spaces_count + ext_i]);
+
+  // The actual calculation takes place here.
+  for (int i = 0; i < nv; i++)
+    memset(local_matrix[i], 0, nu * sizeof(scalar));
+  mfv->value_batch(np, jwt, prev, nu, u, nv, v, sym, e, ext, local_matrix);
+
+  for (int i = 0; i < nv; i++)
+    for (int j = 0; j < nu; j++) {
+      if (sym && j < i)
+        local_matrix[i][j] = local_matrix[j][i];
+      else
+        local_matrix[i][j] *= mfv->scaling_factor * block_scaling_coeff * alu->coef[j] * alv->coef[i];
+    }
+
+  // Clean up.
+  for(int i = 0; i < prev_size; i++)
+    if (prev[i] != NULL) { 
+      prev[i]->free_fn(); 
+      delete prev[i]; 
+    }
+  delete [] prev;
+
+  if (ext != NULL) {
+    ext->free(); 
+    delete ext;
+  }
+
+  if (v != u)
+    delete [] v;
+  delete [] u;
+}
+
+
 // Volume vector forms.
 
 scalar DiscreteProblem::eval_form(WeakForm::VectorFormVol *vfv, 
@@ -2753,6 +3575,12 @@ int DiscreteProblem::calc_order_vector_form_vol(WeakForm::VectorFormVol *vfv,
   if(is_fvm) 
     order = rv->get_inv_ref_order();
   else {
+    // The order depends only on the orders of the functions involved, 
+    // so the form does not have to be parsed if they were seen before.
+    init_order_key(vfv, -1, fv->get_fn_order(), u_ext, vfv->u_ext_offset, -1, vfv->ext, -1, rv);
+    if (find_cached_order(order))
+      return order;
+
     int u_ext_length = u_ext.size();      // Number of external solutions.
     int u_ext_offset = vfv->u_ext_offset; // External solutions will start with u_ext[u_ext_offset]
                                           // and there will be only u_ext_length - u_ext_offset of them.
@@ -2789,6 +3617,7 @@ int DiscreteProblem::calc_order_vector_form_vol(WeakForm::VectorFormVol *vfv,
     order = rv->get_inv_ref_order();
     order += o.get_order();
     limit_order(order);
+    assembling_caches.cache_order[assembling_caches.order_key] = order;
     
     // Cleanup.
     delete [] oi;
@@ -3123,6 +3952,13 @@ int DiscreteProblem::calc_order_matrix_form_surf(WeakForm::MatrixFormSurf *mfs,
   if(is_fvm)
     order = ru->get_inv_ref_order();
   else {
+    // The order depends only on the orders of the functions involved, 
+    // so the form does not have to be parsed if they were seen before.
+    init_order_key(mfs, fu->get_edge_fn_order(surf_pos->surf_num), fv->get_edge_fn_order(surf_pos->surf_num), 
+                   u_ext, mfs->u_ext_offset, surf_pos->surf_num, mfs->ext, surf_pos->surf_num, ru);
+    if (find_cached_order(order))
+      return order;
+
     int u_ext_length = u_ext.size();      // Number of external solutions.
     int u_ext_offset = mfs->u_ext_offset; // External solutions will start with u_ext[u_ext_offset]
                                           // and there will be only u_ext_length - u_ext_offset of them.
@@ -3159,6 +3995,7 @@ int DiscreteProblem::calc_order_matrix_form_surf(WeakForm::MatrixFormSurf *mfs,
     order = ru->get_inv_ref_order();
     order += o.get_order();
     limit_order(order);
+    assembling_caches.cache_order[assembling_caches.order_key] = order;
 
     // Cleanup.
     delete [] oi;
@@ -3489,6 +4326,13 @@ int DiscreteProblem::calc_order_vector_form_surf(WeakForm::VectorFormSurf *vfs,
   if(is_fvm) 
     order = rv->get_inv_ref_order();
   else {
+    // The order depends only on the orders of the functions involved, 
+    // so the form does not have to be parsed if they were seen before.
+    init_order_key(vfs, -1, fv->get_edge_fn_order(surf_pos->surf_num), u_ext, vfs->u_ext_offset, 
+                   surf_pos->surf_num, vfs->ext, -1, rv);
+    if (find_cached_order(order))
+      return order;
+
     int u_ext_length = u_ext.size();      // Number of external solutions.
     int u_ext_offset = vfs->u_ext_offset; // External solutions will start with u_ext[u_ext_offset]
                                           // and there will be only u_ext_length - u_ext_offset of them.
@@ -3501,7 +4345,7 @@ int DiscreteProblem::calc_order_vector_form_surf(WeakForm::VectorFormSurf *vfs,
     if (u_ext != Hermes::vector<Solution *>())
       for(int i = 0; i < u_ext_length - u_ext_offset; i++)
         if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i]->get_edge_fn_order(surf_pos->surf_num) + inc);
+          oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_edge_fn_order(surf_pos->surf_num) + inc);
         else
           oi[i] = get_fn_ord(0);
     else
@@ -3524,6 +4368,7 @@ int DiscreteProblem::calc_order_vector_form_surf(WeakForm::VectorFormSurf *vfs,
     order = rv->get_inv_ref_order();
     order += o.get_order();
     limit_order(order);
+    assembling_caches.cache_order[assembling_caches.order_key] = order;
     
     // Cleanup.
     delete [] oi;
@@ -4367,26 +5212,14 @@ unsigned int DiscreteProblem::NeighborNode::get_transformation()
 
 DiscreteProblem::AssemblingCaches::AssemblingCaches()
 {
-
+  order_wf_seq = -1;
+  master = NULL;
+  fn_curved_limit = H2D_DEFAULT_FN_CACHE_LIMIT;
 };
 
 DiscreteProblem::AssemblingCaches::~AssemblingCaches()
 {
   _F_
-  for (std::map<KeyConst, Func<double>*, CompareConst>::const_iterator it = const_cache_fn_triangles.begin();
-       it != const_cache_fn_triangles.end(); it++)
-  {
-    (it->second)->free_fn(); delete (it->second);
-  }
-  const_cache_fn_triangles.clear();
-
-  for (std::map<KeyConst, Func<double>*, CompareConst>::const_iterator it = const_cache_fn_quads.begin();
-       it != const_cache_fn_quads.end(); it++)
-  {
-    (it->second)->free_fn(); delete (it->second);
-  }
-  const_cache_fn_quads.clear();
-
   for(unsigned int i = 0; i < cache_fn_ord.get_size(); i++)
     if(cache_fn_ord.present(i)) {
       cache_fn_ord.get(i)->free_ord(); 
@@ -4394,6 +5227,147 @@ DiscreteProblem::AssemblingCaches::~AssemblingCaches()
     }
 };
 
+bool DiscreteProblem::AssemblingCaches::KeyFn::operator==(const KeyFn& other) const
+{
+  return index == other.index && order == other.order && sub_idx == other.sub_idx
+         && shapeset_type == other.shapeset_type && mode == other.mode && element == other.element
+         && memcmp(inv_ref_map, other.inv_ref_map, sizeof(inv_ref_map)) == 0;
+}
+
+DiscreteProblem::AssemblingCaches::FnCache::FnCache()
+{
+  hits = misses = 0;
+  capacity = 1024;
+  count = 0;
+  fn_memory = 0;
+  entries = new Entry[capacity];
+  for (unsigned int i = 0; i < capacity; i++)
+    entries[i].fn = NULL;
+}
+
+DiscreteProblem::AssemblingCaches::FnCache::~FnCache()
+{
+  clear();
+  delete [] entries;
+}
+
+unsigned int DiscreteProblem::AssemblingCaches::FnCache::hash(const KeyFn& key)
+{
+  uint64_t words[8];
+  words[0] = ((uint64_t) key.index << 32) | (unsigned int) key.order;
+  words[1] = key.sub_idx;
+  words[2] = ((uint64_t) key.shapeset_type << 32) | (unsigned int) key.mode;
+  words[3] = (uint64_t) (size_t) key.element;
+  memcpy(words + 4, key.inv_ref_map, 4 * sizeof(double));
+
+  // FNV-1a over the words followed by a final avalanche.
+  uint64_t h = 14695981039346656037ULL;
+  for (int i = 0; i < 8; i++) {
+    h ^= words[i];
+    h *= 1099511628211ULL;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return (unsigned int) h;
+}
+
+Func<double>* DiscreteProblem::AssemblingCaches::FnCache::find(const KeyFn& key) const
+{
+  unsigned int mask = capacity - 1;
+  for (unsigned int i = hash(key) & mask; entries[i].fn != NULL; i = (i + 1) & mask)
+    if (entries[i].key == key)
+      return entries[i].fn;
+  return NULL;
+}
+
+// Approximate size of the arrays held by fn.
+static size_t get_fn_memory(Func<double>* fn)
+{
+  int arrays = 0;
+  double* all[] = { fn->val, fn->dx, fn->dy, fn->val0, fn->val1, fn->dx0, fn->dx1, 
+                    fn->dy0, fn->dy1, fn->curl, fn->div };
+  for (unsigned int i = 0; i < sizeof(all) / sizeof(double*); i++)
+    if (all[i] != NULL) arrays++;
+#ifdef H2D_SECOND_DERIVATIVES_ENABLED
+  if (fn->laplace != NULL) arrays++;
+#endif
+  return sizeof(Func<double>) + arrays * fn->num_gip * sizeof(double);
+}
+
+void DiscreteProblem::AssemblingCaches::FnCache::insert(const KeyFn& key, Func<double>* fn)
+{
+  // Keep the load factor below 1/2.
+  if (2 * (count + 1) > capacity)
+    grow();
+  unsigned int mask = capacity - 1;
+  unsigned int i = hash(key) & mask;
+  while (entries[i].fn != NULL)
+    i = (i + 1) & mask;
+  entries[i].key = key;
+  entries[i].fn = fn;
+  count++;
+  fn_memory += get_fn_memory(fn);
+}
+
+void DiscreteProblem::AssemblingCaches::FnCache::grow()
+{
+  Entry* old_entries = entries;
+  unsigned int old_capacity = capacity;
+
+  capacity *= 2;
+  entries = new Entry[capacity];
+  for (unsigned int i = 0; i < capacity; i++)
+    entries[i].fn = NULL;
+
+  unsigned int mask = capacity - 1;
+  for (unsigned int j = 0; j < old_capacity; j++) {
+    if (old_entries[j].fn == NULL) continue;
+    unsigned int i = hash(old_entries[j].key) & mask;
+    while (entries[i].fn != NULL)
+      i = (i + 1) & mask;
+    entries[i] = old_entries[j];
+  }
+  delete [] old_entries;
+}
+
+void DiscreteProblem::AssemblingCaches::FnCache::merge(FnCache& other)
+{
+  for (unsigned int j = 0; j < other.capacity; j++) {
+    Entry& entry = other.entries[j];
+    if (entry.fn == NULL) continue;
+    if (find(entry.key) == NULL)
+      insert(entry.key, entry.fn);
+    else {
+      entry.fn->free_fn();
+      delete entry.fn;
+    }
+    entry.fn = NULL;
+  }
+  other.count = 0;
+  other.fn_memory = 0;
+  hits += other.hits;
+  misses += other.misses;
+  other.hits = other.misses = 0;
+}
+
+void DiscreteProblem::AssemblingCaches::FnCache::clear()
+{
+  for (unsigned int i = 0; i < capacity; i++)
+    if (entries[i].fn != NULL) {
+      entries[i].fn->free_fn();
+      delete entries[i].fn;
+      entries[i].fn = NULL;
+    }
+  count = 0;
+  fn_memory = 0;
+}
+
+size_t DiscreteProblem::AssemblingCaches::FnCache::get_memory() const
+{
+  return capacity * sizeof(Entry) + fn_memory;
+}
+
 double Hermes2D::get_l2_norm(Vector* vec) const 
 {
   _F_
@@ -4420,15 +5394,24 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
   }
 
   // The Newton's loop.
-  double residual_norm;
+  double residual_norm = 0, last_residual_norm = 0;
   int it = 1;
   while (1)
   {
     // Obtain the number of degrees of freedom.
     int ndof = dp->get_num_dofs();
 
+    // Whenever the Jacobian will be needed too, assemble it together with the residual
+    // in one pass through the mesh. This is always the case in the first iteration, later
+    // on unless the last rate of convergence predicts that the tolerance is reached now.
+    bool fused = jacobian_changed && (it == 1 || residual_norm * residual_norm >= newton_tol * last_residual_norm);
+    last_residual_norm = residual_norm;
+
     // Assemble the residual vector.
-    dp->assemble(coeff_vec, NULL, rhs); // NULL = we do not want the Jacobian.
+    if (fused) 
+      dp->assemble(coeff_vec, matrix, rhs);
+    else
+      dp->assemble(coeff_vec, NULL, rhs); // NULL = we do not want the Jacobian.
 
     // Measure the residual norm.
     if (residual_as_function) {
@@ -4468,8 +5451,8 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
     // of iteration has been reached, then quit.
     if ((residual_norm < newton_tol || it > newton_max_iter) && it > 1) break;
 
-    // If Jacobian changed, assemble the matrix.
-    if (jacobian_changed) dp->assemble(coeff_vec, matrix, NULL); // NULL = we do not want the rhs.
+    // If Jacobian changed and was not assembled with the residual, assemble the matrix.
+    if (jacobian_changed && !fused) dp->assemble(coeff_vec, matrix, NULL); // NULL = we do not want the rhs.
 
     // Multiply the residual vector with -1 since the matrix
     // equation reads J(Y^n) \deltaY^{n+1} = -F(Y^n).
@@ -4495,6 +5478,183 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
   return true;
 }
 
+// Krylov solver of J(Y) x = -F(Y) for the Newton's update x, with the products of the
+// Jacobian J(Y) and a vector approximated by finite differences of residuals,
+// J(Y) z = (F(Y + h z) - F(Y)) / h. The residual F(Y) is passed in 'res', the right-hand
+// side -F(Y) in 'minus_res'; 'rhs' is the vector the residuals are assembled into. If
+// 'precond' is not NULL, it holds a factorized approximation of the Jacobian, which the
+// GMRES of KrylovSolver applies from the right.
+class JacobianFreeSolver : public KrylovSolver
+{
+public:
+  JacobianFreeSolver(DiscreteProblem* dp, Solver* precond, Vector* rhs, scalar* coeff_vec,
+                     scalar* res, UMFPackVector* minus_res)
+    : KrylovSolver(NULL, minus_res), dp(dp), jacobian(precond), dp_rhs(rhs), 
+      coeff_vec(coeff_vec), res(res)
+  {
+    ndof = dp->get_num_dofs();
+    coeff_norm = 0;
+    for (int i = 0; i < ndof; i++) coeff_norm += std::abs(coeff_vec[i] * conj(coeff_vec[i]));
+    coeff_norm = sqrt(coeff_norm);
+    y_pert = new scalar[ndof];
+  }
+
+  virtual ~JacobianFreeSolver() { delete [] y_pert; }
+
+protected:
+  DiscreteProblem* dp;
+  Solver* jacobian;
+  Vector* dp_rhs;
+  scalar* coeff_vec;
+  scalar* res;
+  scalar* y_pert;
+  int ndof;
+  double coeff_norm;
+
+  virtual void setup_matrix() { n = ndof; }
+  virtual void setup_precond() { pc_valid = true; }
+  virtual void free_matrix() { n = 0; }
+
+  virtual void multiply(const scalar* z, scalar* y)
+  {
+    double z_norm = 0;
+    for (int i = 0; i < ndof; i++) z_norm += std::abs(z[i] * conj(z[i]));
+    z_norm = sqrt(z_norm);
+    if (z_norm == 0) {
+      memset(y, 0, ndof * sizeof(scalar));
+      return;
+    }
+    double step = sqrt(DBL_EPSILON) * (1.0 + coeff_norm) / z_norm;
+    for (int i = 0; i < ndof; i++) y_pert[i] = coeff_vec[i] + step * z[i];
+    dp->assemble(y_pert, NULL, dp_rhs);
+    for (int i = 0; i < ndof; i++) y[i] = (dp_rhs->get(i) - res[i]) / step;
+  }
+
+  virtual void apply_precond(const scalar* r, scalar* z)
+  {
+    if (jacobian == NULL) {
+      memcpy(z, r, ndof * sizeof(scalar));
+      return;
+    }
+    dp_rhs->zero();
+    for (int i = 0; i < ndof; i++) dp_rhs->set(i, r[i]);
+    if (!jacobian->solve()) error("Matrix solver failed.\n");
+    memcpy(z, jacobian->get_solution(), ndof * sizeof(scalar));
+  }
+};
+
+bool Hermes2D::solve_newton_reuse(scalar* coeff_vec, DiscreteProblem* dp, Solver* solver, SparseMatrix* matrix,
+                                  Vector* rhs, bool& jacobian_valid, double newton_tol, int newton_max_iter, 
+                                  bool verbose, double max_contraction, bool jacobian_free,
+                                  double max_allowed_residual_norm) const
+{
+  _F_
+  int ndof = dp->get_num_dofs();
+
+  // Whether the solver holds a factorization of a matrix with the current sparsity pattern.
+  bool have_factorization = jacobian_valid;
+
+  scalar* res = NULL;
+  if (jacobian_free) res = new scalar[ndof];
+
+  // The Newton's loop.
+  double residual_norm = 0, last_residual_norm = 0;
+  double forcing = 0.1;
+  int it = 1, num_assemblings = 0;
+  bool success = true;
+  while (1)
+  {
+    // A fresh Jacobian is needed if there is none: assemble it together with the residual.
+    bool fused = !jacobian_valid && !jacobian_free;
+    last_residual_norm = residual_norm;
+    if (fused) {
+      dp->assemble(coeff_vec, matrix, rhs);
+      num_assemblings++;
+    }
+    else
+      dp->assemble(coeff_vec, NULL, rhs);
+    residual_norm = get_l2_norm(rhs);
+
+    // Info for the user.
+    if (it == 1) {
+      if (verbose) info("---- Newton initial residual norm: %g", residual_norm);
+    }
+    else if (verbose) info("---- Newton iter %d, residual norm: %g", it-1, residual_norm);
+
+    // If maximum allowed residual norm is exceeded, fail.
+    if (residual_norm > max_allowed_residual_norm) {
+      if (verbose) {
+        info("Current residual norm: %g", residual_norm);
+        info("Maximum allowed residual norm: %g", max_allowed_residual_norm);
+        info("Newton solve not successful, returning false.");
+      }
+      success = false;
+      break;
+    }
+
+    // If residual norm is within tolerance, or the maximum number
+    // of iteration has been reached, then quit.
+    if ((residual_norm < newton_tol || it > newton_max_iter) && it > 1) break;
+
+    if (jacobian_free) {
+      // Inexact Newton's step: the forcing term follows Eisenstat and Walker (choice 2).
+      if (it > 1)
+        forcing = std::min(0.1, std::max(0.9 * sqr(residual_norm / last_residual_norm), 
+                                         newton_tol / residual_norm));
+      for (int i = 0; i < ndof; i++) res[i] = rhs->get(i);
+      if (jacobian_valid) solver->set_factorization_scheme(HERMES_REUSE_FACTORIZATION_COMPLETELY);
+      UMFPackVector minus_res(ndof);
+      for (int i = 0; i < ndof; i++) minus_res.set(i, -res[i]);
+      JacobianFreeSolver lin_solver(dp, jacobian_valid ? solver : NULL, rhs, coeff_vec, res, &minus_res);
+      lin_solver.set_tolerance(forcing);
+      lin_solver.set_max_iters(10 * ndof + 100);
+      if (lin_solver.solve() && verbose) 
+        info("---- Jacobian-free GMRES: %d iterations.", lin_solver.get_num_iters());
+      for (int i = 0; i < ndof; i++) coeff_vec[i] += lin_solver.get_solution()[i];
+    }
+    else {
+      // Reassemble and refactorize the Jacobian if the residual norm does not drop fast enough.
+      if (!fused && it > 1 && residual_norm > max_contraction * last_residual_norm) {
+        dp->assemble(coeff_vec, matrix, NULL); // NULL = we do not want the rhs.
+        num_assemblings++;
+        fused = true;
+      }
+      if (fused) {
+        solver->set_factorization_scheme(have_factorization ? HERMES_REUSE_MATRIX_REORDERING 
+                                                            : HERMES_FACTORIZE_FROM_SCRATCH);
+        have_factorization = true;
+        jacobian_valid = true;
+      }
+      else 
+        solver->set_factorization_scheme(HERMES_REUSE_FACTORIZATION_COMPLETELY);
+
+      // Multiply the residual vector with -1 since the matrix
+      // equation reads J(Y^n) \deltaY^{n+1} = -F(Y^n).
+      rhs->change_sign();
+
+      // Solve the linear system.
+      if(!solver->solve()) error ("Matrix solver failed.\n");
+
+      // Add \deltaY^{n+1} to Y^n.
+      for (int i = 0; i < ndof; i++) coeff_vec[i] += solver->get_solution()[i];
+    }
+
+    it++;
+  }
+
+  if (verbose && !jacobian_free) 
+    info("---- Newton: %d Jacobian assemblings in %d iterations.", num_assemblings, it - 1);
+
+  if (res != NULL) delete [] res;
+
+  if (success && it >= newton_max_iter) {
+    if (verbose) info("Maximum allowed number of Newton iterations exceeded, returning false.");
+    return false;
+  }
+
+  return success;
+}
+
 // Perform Picard's iteration.
 bool Hermes2D::solve_picard(WeakForm* wf, Space* space, Solution* sln_prev_iter,
                             MatrixSolverType matrix_solver, double picard_tol,
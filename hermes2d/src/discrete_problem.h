@@ -32,12 +32,17 @@
 #include "neighbor.h"
 #include "ref_selectors/selector.h"
 #include <map>
+#include <deque>
+
+/// Default memory limit of the shape function values cached for curved elements, in bytes.
+#define H2D_DEFAULT_FN_CACHE_LIMIT (256 * 1048576)
 
 class Space;
 class PrecalcShapeset;
 class WeakForm;
 class Matrix;
 class SparseMatrix;
+class CSCMatrix;
 class Vector;
 class Solver;
 
@@ -57,7 +62,8 @@ public:
   DiscreteProblem(WeakForm* wf, Space* space);
 
   /// Non-parameterized constructor (currently used only in KellyTypeAdapt to gain access to NeighborSearch methods).
-  DiscreteProblem() : wf(NULL), pss(NULL) {num_user_pss = 0; sp_seq = NULL;}
+  DiscreteProblem() : wf(NULL), pss(NULL) {num_user_pss = 0; sp_seq = NULL; num_threads = 1; is_worker = false;
+                                          scatter_map_matrix = scatter_matrix = NULL; scatter_Ax = NULL; scatter_record = NULL;}
 
   /// Init function. Common code for the constructors.
   void init();
@@ -88,6 +94,21 @@ public:
   /// Get info about presence of a matrix.
   bool is_matrix_free() { return wf->is_matrix_free(); }
 
+  /// Matrix-free application of the operator: coeff_out = A coeff_in, where A is the
+  /// matrix (the Jacobian for nonlinear problems, at the Newton vector coeff_vec) that
+  /// assemble() would create. The forms are evaluated element by element and the global
+  /// matrix is never stored (see MatrixFreeOperator).
+  void apply(scalar* coeff_vec, scalar* coeff_in, scalar* coeff_out);
+
+  /// Light version for linear problems.
+  void apply(scalar* coeff_in, scalar* coeff_out) { apply(NULL, coeff_in, coeff_out); }
+
+  /// Diagonal of the matrix that assemble() would create, without creating it.
+  void get_diagonal(scalar* coeff_vec, scalar* diag);
+
+  /// Light version for linear problems.
+  void get_diagonal(scalar* diag) { get_diagonal(NULL, diag); }
+
 
   /// Preassembling.
   /// Precalculate matrix sparse structure.
@@ -144,6 +165,16 @@ public:
                           Hermes::vector<PrecalcShapeset *>& spss, Hermes::vector<RefMap *>& refmap, 
                           Hermes::vector<Solution *>& u_ext);
 
+  /// Assemble one stage by several threads (see set_num_threads()).
+  /// The states of the stage are first collected and colored so that states of one
+  /// color do not share any DOF, then the states of each color are assembled in parallel.
+  void assemble_one_stage_parallel(WeakForm::Stage& stage, 
+                          SparseMatrix* mat, Vector* rhs, bool force_diagonal_blocks, Table* block_weights,
+                          Hermes::vector<RefMap *>& refmap, Hermes::vector<Solution *>& u_ext);
+
+  /// Returns true if the stage can be assembled by assemble_one_stage_parallel().
+  bool is_parallel_assembling_possible(WeakForm::Stage& stage, SparseMatrix* mat, Vector* rhs);
+
   /// Assemble one state.
   void assemble_one_state(WeakForm::Stage& stage, 
                           SparseMatrix* mat, Vector* rhs, bool force_diagonal_blocks, Table* block_weights,
@@ -251,7 +282,29 @@ public:
 
   void set_RK(int original_spaces_count) { this->RungeKutta = true; RK_original_spaces_count = original_spaces_count; }
 
+  /// Sets the number of threads used to assemble the elements (default 1, i.e. serial assembling).
+  /// Has effect only if Hermes was built with OpenMP (WITH_OPENMP). Stages that can not be
+  /// assembled in parallel (DG forms, adaptive integration, external functions that are not
+  /// Solutions, matrices other than CSCMatrix) are assembled serially.
+  void set_num_threads(int num_threads);
+  int get_num_threads() const { return num_threads; }
+
+  /// Statistics of the cache of shape function values on transformed elements,
+  /// which is kept between assemblings.
+  unsigned int get_fn_cache_num_entries();
+  double get_fn_cache_hit_rate();
+  size_t get_fn_cache_memory();
+
+  /// Sets the memory limit of the shape function values cached for curved elements (default
+  /// H2D_DEFAULT_FN_CACHE_LIMIT). Once the values exceed it, they are freed before the next
+  /// element is assembled, so 0 keeps them only while one element is assembled.
+  void set_fn_cache_limit(size_t bytes) { assembling_caches.fn_curved_limit = bytes; }
+
 protected:
+  /// Constructor of a worker used by assemble_one_stage_parallel(). The worker shares the weak
+  /// formulation and the spaces with master, but has its own shapesets, caches and buffers.
+  DiscreteProblem(DiscreteProblem* master, Quad2D* quad);
+
   /// Assembling.
   /// Experimental caching of vector valued (vector) forms.
   struct SurfVectorFormsKey
@@ -300,6 +353,34 @@ protected:
                             PrecalcShapeset *fu, PrecalcShapeset *fv, 
                             RefMap *ru, RefMap *rv);
 
+  // Clears the cached integration orders of forms if the weak form or the spaces changed.
+  void update_order_cache();
+
+  // Fills assembling_caches.order_key with the form and the orders of all functions
+  // the integration order of the form depends on. Edge orders of u_ext and ext are used 
+  // if u_ext_edge and ext_edge, respectively, are not -1.
+  void init_order_key(void* form, int u_order, int v_order, Hermes::vector<Solution *>& u_ext,
+                      int u_ext_offset, int u_ext_edge, Hermes::vector<MeshFunction *>& ext,
+                      int ext_edge, RefMap* rm);
+
+  // Looks up the integration order for assembling_caches.order_key.
+  bool find_cached_order(int& order);
+
+  // Drops shape function values of curved elements if a mesh of the spaces changed.
+  void update_fn_cache();
+  /// Frees the values cached for curved elements if they exceed the limit (see set_fn_cache_limit()).
+  void limit_fn_cache();
+
+  // Evaluates the non-adaptive form mfv with a batched evaluation (see 
+  // WeakForm::MatrixFormVol::has_value_batch()) for all pairs of basis functions from alu
+  // and test functions from alv on the current element at once, using the order of 
+  // the highest-order pair for all of them. The (scaled) values are stored into 
+  // local_matrix[i][j], i indexing alv and j indexing alu.
+  void eval_form_batch(WeakForm::MatrixFormVol *mfv, Hermes::vector<Solution *> u_ext,
+                       PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv,
+                       AsmList *alu, AsmList *alv, bool tra, bool sym, double block_scaling_coeff,
+                       scalar **local_matrix);
+
   // Vector volume forms. The functions provide the same functionality as the
   // parallel ones for matrix volume forms.
 
@@ -512,6 +593,39 @@ protected:
   int matrix_buffer_dim;                 // dimension of the matrix held by 'matrix_buffer'
   scalar** get_matrix_buffer(int n);
 
+  /// Scatter map: positions of the entries of the local matrices in the values of the CSC
+  /// matrix, one record per assembling state. A record is a sequence of local matrices,
+  /// each stored as [m, n, rows[m], cols[n], positions[m * n]]. It is created in the first
+  /// assembling into a sparse structure and replayed by the following ones; a local matrix
+  /// that does not match the record is added by searching and recorded again.
+  std::deque<std::vector<int> > scatter_map;
+  CSCMatrix* scatter_map_matrix;         // matrix the scatter map was recorded for
+  unsigned int scatter_map_nnz;          // number of nonzeros of that matrix
+  unsigned int scatter_num_states;       // states assembled so far in the current assembling
+  CSCMatrix* scatter_matrix;             // matrix being assembled (NULL if not a CSCMatrix)
+  scalar* scatter_Ax;                    // its values, taken by the master and shared with the workers
+  std::vector<int>* scatter_record;      // record of the current state
+  unsigned int scatter_pos;              // position in scatter_record
+
+  /// Drops the scatter map if it does not belong to the matrix 'mat'.
+  void update_scatter_map(SparseMatrix* mat);
+  /// Makes 'record' the record of the current state, truncates the previous one.
+  void set_scatter_record(std::vector<int>* record);
+  /// Adds a local matrix to 'mat', using the scatter map if possible.
+  void add_to_matrix(SparseMatrix* mat, unsigned int m, unsigned int n, scalar** local, int* rows, int* cols);
+
+  /// Sparsity pattern of the last matrix created by create_sparse_structure(), kept so that
+  /// further matrices for the same spaces get their structure without a new traversal.
+  SparsityPattern pattern;
+  /// Grouping of the DOFs of all spaces into blocks for BSRMatrix: the DOFs of the same
+  /// shape function on the same element are put into one block, at the position given
+  /// by the index of their space. Empty unless the last structure was created for a BSRMatrix.
+  std::vector<int> block_of_dof, comp_of_dof;
+  /// Adds the DOFs of the assembly lists of one traversal state to the block map.
+  void add_to_block_map(Element** e, AsmList* al, std::vector<int>& block_slots);
+  /// Allocates 'mat' from the kept pattern (and block map).
+  void alloc_matrix(SparseMatrix* mat);
+
   bool have_spaces;
   bool have_matrix;
 
@@ -539,140 +653,119 @@ protected:
     AssemblingCaches();
     ~AssemblingCaches();
 
-    /// Key for caching precalculated shapeset values on transformed elements with constant
-    /// jacobians.
-    struct KeyConst
+    /// Key for caching precalculated shapeset values on transformed elements. On elements 
+    /// with a constant jacobian of the reference mapping the values depend on the element 
+    /// only through the inverse reference map, otherwise the element itself is a part of 
+    /// the key.
+    struct KeyFn
     {
       int index;
       int order;
-#ifdef _MSC_VER
-      UINT64 sub_idx;
-#else
-      unsigned int sub_idx;
-#endif
+      uint64_t sub_idx;
       int shapeset_type;
-      double inv_ref_map[2][2];
-#ifdef _MSC_VER
-      KeyConst(int index, int order, UINT64 sub_idx, int shapeset_type, double2x2* inv_ref_map) {
-        this->index = index;
-        this->order = order;
-        this->sub_idx = sub_idx;
-        this->shapeset_type = shapeset_type;
-        this->inv_ref_map[0][0] = (*inv_ref_map)[0][0];
-        this->inv_ref_map[0][1] = (*inv_ref_map)[0][1];
-        this->inv_ref_map[1][0] = (*inv_ref_map)[1][0];
-        this->inv_ref_map[1][1] = (*inv_ref_map)[1][1];
-      }
-#else
-      KeyConst(int index, int order, unsigned int sub_idx, int shapeset_type, double2x2* inv_ref_map) {
-        this->index = index;
-        this->order = order;
-        this->sub_idx = sub_idx;
-        this->shapeset_type = shapeset_type;
-        this->inv_ref_map[0][0] = (*inv_ref_map)[0][0];
-        this->inv_ref_map[0][1] = (*inv_ref_map)[0][1];
-        this->inv_ref_map[1][0] = (*inv_ref_map)[1][0];
-        this->inv_ref_map[1][1] = (*inv_ref_map)[1][1];
-      }
-#endif
+      int mode;
+      Element* element;          ///< NULL for constant jacobians.
+      double inv_ref_map[2][2];  ///< Zero for non-constant jacobians.
+
+      bool operator==(const KeyFn& other) const;
     };
 
-    /// Functor that compares two above keys (needed e.g. to create a std::map indexed by these keys);
-    struct CompareConst {
-      bool operator()(KeyConst a, KeyConst b) const {
-        if(a.inv_ref_map[0][0] < b.inv_ref_map[0][0]) return true;
-        else if(a.inv_ref_map[0][0] > b.inv_ref_map[0][0]) return false;
-        else
-          if(a.inv_ref_map[0][1] < b.inv_ref_map[0][1]) return true;
-          else if(a.inv_ref_map[0][1] > b.inv_ref_map[0][1]) return false;
-          else
-            if(a.inv_ref_map[1][0] < b.inv_ref_map[1][0]) return true;
-            else if(a.inv_ref_map[1][0] > b.inv_ref_map[1][0]) return false;
-            else
-              if(a.inv_ref_map[1][1] < b.inv_ref_map[1][1]) return true;
-              else if(a.inv_ref_map[1][1] > b.inv_ref_map[1][1]) return false;
-              else
-                if (a.index < b.index) return true;
-                else if (a.index > b.index) return false;
-                else
-                  if (a.order < b.order) return true;
-                  else if (a.order > b.order) return false;
-                  else
-                    if (a.sub_idx < b.sub_idx) return true;
-                    else if (a.sub_idx > b.sub_idx) return false;
-                    else
-                      if (a.shapeset_type < b.shapeset_type) return true;
-                      else return false;
+    /// Open addressing (linear probing) hash table of precalculated shapeset values
+    /// on transformed elements. Owns the stored values.
+    class FnCache
+    {
+    public:
+      FnCache();
+      ~FnCache();
+
+      /// Returns the values stored for the key, or NULL.
+      Func<double>* find(const KeyFn& key) const;
+      /// Stores values for a key that is not in the table yet.
+      void insert(const KeyFn& key, Func<double>* fn);
+      /// Moves the entries of other that are not here into this table and frees the rest.
+      void merge(FnCache& other);
+      /// Frees all values.
+      void clear();
+
+      unsigned int get_num_entries() const { return count; }
+      /// Approximate memory taken by the table and the stored values, in bytes.
+      size_t get_memory() const;
+
+      /// Lookup statistics.
+      unsigned long hits, misses;
+
+    private:
+      struct Entry
+      {
+        KeyFn key;
+        Func<double>* fn;
       };
+      Entry* entries;
+      unsigned int capacity; ///< Always a power of two.
+      unsigned int count;
+      size_t fn_memory;
+
+      static unsigned int hash(const KeyFn& key);
+      void grow();
     };
 
-    /// PrecalcShapeset stored values for Elements with constant jacobian of the reference mapping.
-    /// For triangles.
-    std::map<KeyConst, Func<double>*, CompareConst> const_cache_fn_triangles;
-    /// For quads
-    std::map<KeyConst, Func<double>*, CompareConst> const_cache_fn_quads;
-    
-    /// The same setup for elements with non-constant jacobians.
-    /// This cache is deleted with every change of the state in assembling.
-    struct KeyNonConst {
-      int index;
-      int order;
-#ifdef _MSC_VER
-      UINT64 sub_idx;
-#else
-      unsigned int sub_idx;
-#endif
-      int shapeset_type;
-#ifdef _MSC_VER
-      KeyNonConst(int index, int order, UINT64 sub_idx, int shapeset_type) {
-        this->index = index;
-        this->order = order;
-        this->sub_idx = sub_idx;
-        this->shapeset_type = shapeset_type;
-      }
-#else
-      KeyNonConst(int index, int order, unsigned int sub_idx, int shapeset_type) {
-        this->index = index;
-        this->order = order;
-        this->sub_idx = sub_idx;
-        this->shapeset_type = shapeset_type;
-      }
-#endif
+    /// Values on elements with constant jacobians. Survive for the lifetime of the DiscreteProblem.
+    FnCache cache_fn_const;
+    /// Values on curved elements. Survive until a mesh of the spaces changes or until
+    /// they exceed fn_curved_limit.
+    FnCache cache_fn_curved;
+    /// Memory limit of cache_fn_curved in bytes, see DiscreteProblem::set_fn_cache_limit().
+    size_t fn_curved_limit;
+    /// Sequence numbers of the meshes the values in cache_fn_curved belong to.
+    std::vector<unsigned> fn_mesh_seq;
+
+    /// Caches of the master used (read-only) by a worker of the parallel assembling.
+    AssemblingCaches* master;
+
+    LightArray<Func<Ord>*> cache_fn_ord;
+
+    /// Key for caching integration orders of forms. Apart from the form itself, the order
+    /// depends only on the polynomial orders of the functions the form is evaluated with,
+    /// on the order of the reference mapping and on the element mode.
+    struct KeyOrder {
+      void* form;
+      std::vector<int> orders;
     };
 
-    /// Functor that compares two above keys (needed e.g. to create a std::map indexed by these keys);
-    struct CompareNonConst {
-      bool operator()(KeyNonConst a, KeyNonConst b) const {
-        if (a.index < b.index) return true;
-        else if (a.index > b.index) return false;
-        else {
-          if (a.order < b.order) return true;
-          else if (a.order > b.order) return false;
-          else {
-            if (a.sub_idx < b.sub_idx) return true;
-            else if (a.sub_idx > b.sub_idx) return false;
-            else {
-              if (a.shapeset_type < b.shapeset_type) return true;
-              else return false;
-            }
-          }
-        }
+    /// Functor that compares two above keys.
+    struct CompareOrder {
+      bool operator()(const KeyOrder& a, const KeyOrder& b) const {
+        if (a.form != b.form) return a.form < b.form;
+        return a.orders < b.orders;
       }
     };
-    
-    /// PrecalcShapeset stored values for Elements with constant jacobian of the reference mapping.
-    /// For triangles.
-    std::map<KeyNonConst, Func<double>*, CompareNonConst> cache_fn_triangles;
-    /// For quads
-    std::map<KeyNonConst, Func<double>*, CompareNonConst> cache_fn_quads;
 
-    LightArray<Func<Ord>*> cache_fn_ord;
+    /// Integration orders of forms. This cache survives between assemblings and is cleared
+    /// only when the weak form or the spaces change, see DiscreteProblem::update_order_cache().
+    std::map<KeyOrder, int, CompareOrder> cache_order;
+    /// Key being looked up (reused so that a lookup does not allocate memory).
+    KeyOrder order_key;
+    /// Sequence numbers of the weak form and spaces the cached orders belong to.
+    int order_wf_seq;
+    std::vector<int> order_sp_seq;
   };
   AssemblingCaches assembling_caches;
 
   bool RungeKutta;
   int RK_original_spaces_count;
 
+  /// Number of threads used in assembling.
+  int num_threads;
+
+  /// True for the workers created by assemble_one_stage_parallel().
+  bool is_worker;
+
+  /// Copies of the external functions private to a worker, indexed by the originals.
+  std::map<MeshFunction*, MeshFunction*> ext_copies;
+
+  /// Returns the copy of fn private to this worker, or fn itself.
+  MeshFunction* get_ext_fn(MeshFunction* fn);
+
   friend class Hermes2D;
 };
 
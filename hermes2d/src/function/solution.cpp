@@ -18,6 +18,15 @@
 #include "../../../hermes_common/matrix.h"
 #include "../shapeset/precalc.h"
 #include "../mesh/refmap.h"
+#ifndef _MSC_VER
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+#ifdef WITH_ZLIB
+  #include <zlib.h>
+#endif
 
 //// MeshFunction //////////////////////////////////////////////////////////////////////////////////
 
@@ -191,6 +200,7 @@ void Solution::init()
   own_mesh = false;
   num_components = 0;
   e_last = NULL;
+  grid_mesh = NULL;
   exact_mult = 1.0;
 
   for(int i = 0; i < 4; i++)
@@ -201,6 +211,9 @@ void Solution::init()
   elem_coefs[0] = elem_coefs[1] = NULL;
   elem_orders = NULL;
   dxdy_buffer = NULL;
+  file_data = NULL;
+  file_size = 0;
+  file_mapped = false;
   num_coefs = num_elems = 0;
   num_dofs = -1;
 
@@ -277,6 +290,9 @@ void Solution::assign(Solution* sln)
   elem_coefs[1] = sln->elem_coefs[1];  sln->elem_coefs[1] = NULL;
   elem_orders = sln->elem_orders;      sln->elem_orders = NULL;
   dxdy_buffer = sln->dxdy_buffer;      sln->dxdy_buffer = NULL;
+  file_data = sln->file_data;          sln->file_data = NULL;
+  file_size = sln->file_size;          sln->file_size = 0;
+  file_mapped = sln->file_mapped;      sln->file_mapped = false;
   num_coefs = sln->num_coefs;          sln->num_coefs = 0;
   num_elems = sln->num_elems;          sln->num_elems = 0;
 
@@ -290,16 +306,24 @@ void Solution::assign(Solution* sln)
 }
 
 
-void Solution::copy(const Solution* sln)
+void Solution::copy(const Solution* sln, bool share_mesh)
 {
   if (sln->sln_type == HERMES_UNDEF) error("Solution being copied is uninitialized.");
 
   free();
 
-  mesh = new Mesh;
-  //printf("Copying mesh from Solution and setting own_mesh = true.\n");
-  mesh->copy(sln->mesh);
-  own_mesh = true;
+  if (share_mesh)
+  {
+    mesh = sln->mesh;
+    own_mesh = false;
+  }
+  else
+  {
+    mesh = new Mesh;
+    //printf("Copying mesh from Solution and setting own_mesh = true.\n");
+    mesh->copy(sln->mesh);
+    own_mesh = true;
+  }
 
   sln_type = sln->sln_type;
   space_type = sln->get_space_type();
@@ -357,13 +381,15 @@ void Solution::free_tables()
 
 void Solution::free()
 {
-  if (mono_coefs  != NULL) { delete [] mono_coefs;   mono_coefs = NULL;  }
-  if (elem_orders != NULL) { delete [] elem_orders;  elem_orders = NULL; }
+  // arrays pointing into the loaded file are released together with it
+  if (mono_coefs  != NULL) { if (!in_file_data(mono_coefs))  delete [] mono_coefs;   mono_coefs = NULL;  }
+  if (elem_orders != NULL) { if (!in_file_data(elem_orders)) delete [] elem_orders;  elem_orders = NULL; }
   if (dxdy_buffer != NULL) { delete [] dxdy_buffer;  dxdy_buffer = NULL; }
 
   for (int i = 0; i < num_components; i++)
     if (elem_coefs[i] != NULL)
-      { delete [] elem_coefs[i];  elem_coefs[i] = NULL; }
+      { if (!in_file_data(elem_coefs[i])) delete [] elem_coefs[i];  elem_coefs[i] = NULL; }
+  free_file_data();
 
   if (own_mesh == true && mesh != NULL)
   {
@@ -373,6 +399,9 @@ void Solution::free()
   }
 
   e_last = NULL;
+  grid_mesh = NULL;
+  grid_start.clear();
+  grid_elems.clear();
 
   free_tables();
 
@@ -1180,95 +1209,330 @@ void Solution::precalculate(int order, int mask)
 
 //// save & load ///////////////////////////////////////////////////////////////////////////////////
 
-void Solution::save(const char* filename, bool compress)
+// Solution file format, version 2:
+//
+//   "H2DS" <int version = 2>
+//   chunk*
+//
+// where each chunk is a SlnChunkHeader followed by 'size' bytes of data, padded to
+// a multiple of 8 bytes. The chunks are INFO (sizeof(scalar), number of components,
+// number of elements, number of coefficients), MONO (monomial coefficients), ORDS
+// (element orders), COEF (element coefficient table, one chunk per component), MESH
+// (the mesh as written by Mesh::save_raw()) and END. Unknown chunks are skipped.
+// A chunk can be compressed with zlib; uncompressed arrays are used directly from
+// the memory-mapped file when the solution is loaded.
+
+struct SlnChunkHeader
 {
-  int i;
+  char tag[4];
+  int flags;          ///< H2DS_CHUNK_ZLIB if the data are compressed
+  uint64_t size;      ///< size of the stored data
+  uint64_t raw_size;  ///< size of the data after decompression
+};
+
+static const int H2DS_CHUNK_ZLIB = 1;
+
+static inline uint64_t chunk_padding(uint64_t size) { return (8 - size % 8) % 8; }
 
+static void write_chunk(FILE* f, const char* tag, const void* data, size_t size, bool compress)
+{
+  SlnChunkHeader ch;
+  memcpy(ch.tag, tag, 4);
+  ch.flags = 0;
+  ch.size = ch.raw_size = size;
+
+#ifdef WITH_ZLIB
+  std::vector<Bytef> packed;
+  if (compress && size > 0)
+  {
+    uLongf len = compressBound(size);
+    packed.resize(len);
+    if (compress2(&packed[0], &len, (const Bytef*) data, size, Z_BEST_SPEED) != Z_OK)
+      error("Could not compress the %.4s chunk.", tag);
+    if (len < size)
+    {
+      ch.flags = H2DS_CHUNK_ZLIB;
+      ch.size = len;
+      data = &packed[0];
+    }
+  }
+#endif
+
+  hermes_fwrite(&ch, sizeof(ch), 1, f);
+  if (ch.size > 0) hermes_fwrite(data, 1, ch.size, f);
+  static const char zeros[8] = { 0 };
+  hermes_fwrite(zeros, 1, chunk_padding(ch.size), f);
+}
+
+// Copies (or decompresses) the chunk data into 'dest', which must hold ch.raw_size bytes.
+static void read_chunk(const SlnChunkHeader& ch, const char* data, void* dest)
+{
+  if (ch.flags & H2DS_CHUNK_ZLIB)
+  {
+#ifdef WITH_ZLIB
+    uLongf len = ch.raw_size;
+    if (uncompress((Bytef*) dest, &len, (const Bytef*) data, ch.size) != Z_OK || len != ch.raw_size)
+      error("Corrupt solution file.");
+#else
+    error("The solution file is compressed, but Hermes2D was built without zlib.");
+#endif
+  }
+  else
+    memcpy(dest, data, ch.raw_size);
+}
+
+
+void Solution::save(const char* filename, bool compress)
+{
   if (sln_type == HERMES_EXACT) error("Exact solution cannot be saved to a file.");
   if (sln_type == HERMES_CONST)  error("Constant solution cannot be saved to a file.");
   if (sln_type == HERMES_UNDEF) error("Cannot save -- uninitialized solution.");
 
+#ifndef WITH_ZLIB
+  if (compress)
+  {
+    warn("Hermes2D was built without zlib, %s will not be compressed.", filename);
+    compress = false;
+  }
+#endif
+
   // open the stream
   std::string fname = filename;
   if (compress) fname += ".gz";
   FILE* f = fopen(fname.c_str(), "wb");
-  if (f == NULL) error("Could not open %s for writing.", filename);
-
-  if (compress)
-  {
-    fclose(f);
-    std::stringstream cmdline;
-    cmdline << "gzip > " << filename << ".gz";
-    f = popen(cmdline.str().c_str(), "w");
-    if (f == NULL) error("Could not create compressed stream (command line: %s).", cmdline.str().c_str());
-  }
+  if (f == NULL) error("Could not open %s for writing.", fname.c_str());
 
   // write header
-  hermes_fwrite("H2DS\001\000\000\000", 1, 8, f);
-  int ssize = sizeof(scalar);
-  hermes_fwrite(&ssize, sizeof(int), 1, f);
-  hermes_fwrite(&num_components, sizeof(int), 1, f);
-  hermes_fwrite(&num_elems, sizeof(int), 1, f);
-  hermes_fwrite(&num_coefs, sizeof(int), 1, f);
+  hermes_fwrite("H2DS\002\000\000\000", 1, 8, f);
+  int info[4] = { sizeof(scalar), num_components, num_elems, num_coefs };
+  write_chunk(f, "INFO", info, sizeof(info), false);
 
-  // write monomial coefficients
-  hermes_fwrite(mono_coefs, sizeof(scalar), num_coefs, f);
-
-  // write element orders
-  char* temp_orders = new char[num_elems];
-  for (i = 0; i < num_elems; i++) {
-    temp_orders[i] = elem_orders[i];
-  }
-  hermes_fwrite(temp_orders, sizeof(char), num_elems, f);
-  delete [] temp_orders;
-
-  // write element coef table
-  for (i = 0; i < num_components; i++)
-    hermes_fwrite(elem_coefs[i], sizeof(int), num_elems, f);
+  // write monomial coefficients, element orders and element coef table
+  write_chunk(f, "MONO", mono_coefs, sizeof(scalar) * num_coefs, compress);
+  write_chunk(f, "ORDS", elem_orders, sizeof(int) * num_elems, compress);
+  for (int i = 0; i < num_components; i++)
+    write_chunk(f, "COEF", elem_coefs[i], sizeof(int) * num_elems, compress);
 
   // write the mesh
-  mesh->save_raw(f);
+  std::vector<char> buf;
+  mesh->save_raw(buf);
+  write_chunk(f, "MESH", &buf[0], buf.size(), compress);
 
-  if (compress) pclose(f); else fclose(f);
+  write_chunk(f, "END ", NULL, 0, false);
+  fclose(f);
 }
 
 
 void Solution::load(const char* filename)
 {
-  int i;
-
   free();
   sln_type = HERMES_SLN;
 
-  int len = strlen(filename);
-  bool compressed = (len > 3 && !strcmp(filename + len - 3, ".gz"));
-
   // open the stream
   FILE* f = fopen(filename, "rb");
   if (f == NULL) error("Could not open %s", filename);
 
+  // files written by older versions were compressed by piping them through gzip
+  unsigned char magic[8];
+  size_t n = fread(magic, 1, 8, f);
+  bool compressed = (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b);
   if (compressed)
   {
     fclose(f);
     std::stringstream cmdline;
-    cmdline << "gunzip < " << filename << ".gz";
+    cmdline << "gunzip < " << filename;
     f = popen(cmdline.str().c_str(), "r");
     if (f == NULL) error("Could not read from compressed stream (command line: %s).", cmdline.str().c_str());
+    n = fread(magic, 1, 8, f);
   }
 
-  // load header
-  struct {
-    char magic[4];
-    int  ver, ss, nc, ne, nf;
-  } hdr;
-  hermes_fread(&hdr, sizeof(hdr), 1, f);
-
   // some checks
-  if (hdr.magic[0] != 'H' || hdr.magic[1] != '2' || hdr.magic[2] != 'D' || hdr.magic[3] != 'S')
+  int ver;
+  memcpy(&ver, magic + 4, sizeof(int));
+  if (n < 8 || magic[0] != 'H' || magic[1] != '2' || magic[2] != 'D' || magic[3] != 'S')
     error("Not a Hermes2D solution file.");
-  if (hdr.ver > 1)
+  if (ver < 1 || ver > 2 || (ver == 2 && compressed))
     error("Unsupported file version.");
 
+  if (ver == 1)
+    load_v1(f);
+  if (compressed) pclose(f); else fclose(f);
+  if (ver == 2)
+    load_v2(filename);
+
+  init_dxdy_buffer();
+}
+
+
+void Solution::load_v2(const char* filename)
+{
+  // map the file into memory, or read it if mapping is not available
+#ifndef _MSC_VER
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) error("Could not open %s", filename);
+  struct stat st;
+  if (fstat(fd, &st) != 0) error("Could not get the size of %s", filename);
+  file_size = st.st_size;
+  // private writable mapping: multiply() etc. may modify the coefficients in place
+  void* map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map != MAP_FAILED)
+  {
+    file_data = (char*) map;
+    file_mapped = true;
+  }
+  else
+#endif
+  {
+    FILE* f = fopen(filename, "rb");
+    if (f == NULL) error("Could not open %s", filename);
+    fseek(f, 0, SEEK_END);
+    file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    file_data = new char[file_size];
+    hermes_fread(file_data, 1, file_size, f);
+    fclose(f);
+    file_mapped = false;
+  }
+
+  if (file_size < 8) error("Corrupt solution file.");
+  const char* pos = file_data + 8;
+  const char* end = file_data + file_size;
+  int ss = 0, ncoef = 0;
+  bool have_info = false;
+  std::vector<char> tmp;
+
+  while (1)
+  {
+    SlnChunkHeader ch;
+    if ((size_t) (end - pos) < sizeof(ch)) error("Corrupt solution file.");
+    memcpy(&ch, pos, sizeof(ch));
+    pos += sizeof(ch);
+    if (ch.size > (uint64_t) (end - pos)) error("Corrupt solution file.");
+    char* data = (char*) pos;
+    pos += std::min(ch.size + chunk_padding(ch.size), (uint64_t) (end - pos));
+
+    // uncompressed arrays are used in place, without copying
+    bool in_place = !(ch.flags & H2DS_CHUNK_ZLIB);
+    std::string tag(ch.tag, 4);
+    if (tag == "END ")
+      break;
+    else if (tag == "INFO")
+    {
+      int info[4];
+      if (ch.raw_size != sizeof(info)) error("Corrupt solution file.");
+      read_chunk(ch, data, info);
+      ss = info[0];  num_components = info[1];  num_elems = info[2];  num_coefs = info[3];
+      if (num_components < 1 || num_components > 2) error("Corrupt solution file.");
+      have_info = true;
+    }
+    else if (!have_info)
+      error("Corrupt solution file.");
+    else if (tag == "MONO")
+    {
+      if (ch.raw_size != (uint64_t) ss * num_coefs) error("Corrupt solution file.");
+      if (ss == sizeof(scalar))
+      {
+        if (in_place)
+          mono_coefs = (scalar*) data;
+        else
+        {
+          mono_coefs = new scalar[num_coefs];
+          read_chunk(ch, data, mono_coefs);
+        }
+      }
+      else if (ss == sizeof(double) || ss == 2*sizeof(double))
+      {
+        tmp.resize(ch.raw_size);
+        read_chunk(ch, data, &tmp[0]);
+        const double* src = (const double*) &tmp[0];
+        mono_coefs = new scalar[num_coefs];
+        #ifndef H2D_COMPLEX
+          warn("Ignoring imaginary part of the complex solution since this is not H2D_COMPLEX code.");
+          for (int i = 0; i < num_coefs; i++)
+            mono_coefs[i] = src[2*i];
+        #else
+          for (int i = 0; i < num_coefs; i++)
+            mono_coefs[i] = src[i];
+        #endif
+      }
+      else
+        error("Corrupt solution file.");
+    }
+    else if (tag == "ORDS" || tag == "COEF")
+    {
+      if (ch.raw_size != sizeof(int) * (uint64_t) num_elems) error("Corrupt solution file.");
+      if (tag == "COEF" && ncoef >= num_components) error("Corrupt solution file.");
+      int*& arr = (tag == "ORDS") ? elem_orders : elem_coefs[ncoef++];
+      if (in_place)
+        arr = (int*) data;
+      else
+      {
+        arr = new int[num_elems];
+        read_chunk(ch, data, arr);
+      }
+    }
+    else if (tag == "MESH")
+    {
+      mesh = new Mesh;
+      own_mesh = true;
+      if (in_place)
+        mesh->load_raw(data, ch.raw_size);
+      else
+      {
+        tmp.resize(ch.raw_size);
+        read_chunk(ch, data, &tmp[0]);
+        mesh->load_raw(&tmp[0], tmp.size());
+      }
+    }
+    else
+    {
+      verbose("Skipping unknown chunk '%.4s' in %s.", ch.tag, filename);
+    }
+  }
+
+  if (mono_coefs == NULL || elem_orders == NULL || ncoef != num_components || mesh == NULL)
+    error("Incomplete solution file %s.", filename);
+
+  // release the file if nothing points into it (everything was compressed)
+  bool used = in_file_data(mono_coefs) || in_file_data(elem_orders);
+  for (int i = 0; i < num_components; i++)
+    used = used || in_file_data(elem_coefs[i]);
+  if (!used) free_file_data();
+}
+
+
+bool Solution::in_file_data(const void* ptr) const
+{
+  return file_data != NULL && (const char*) ptr >= file_data && (const char*) ptr < file_data + file_size;
+}
+
+
+void Solution::free_file_data()
+{
+  if (file_data == NULL) return;
+#ifndef _MSC_VER
+  if (file_mapped)
+    munmap(file_data, file_size);
+  else
+#endif
+    delete [] file_data;
+  file_data = NULL;
+  file_size = 0;
+  file_mapped = false;
+}
+
+
+void Solution::load_v1(FILE* f)
+{
+  int i;
+
+  // load the rest of the header (magic and version have been checked by load())
+  struct {
+    int ss, nc, ne, nf;
+  } hdr;
+  hermes_fread(&hdr, sizeof(hdr), 1, f);
+
   // load monomial coefficients
   num_coefs = hdr.nf;
   if (hdr.ss == sizeof(double))
@@ -1326,21 +1590,13 @@ void Solution::load(const char* filename)
   mesh->load_raw(f);
   //printf("Loading mesh from file and setting own_mesh = true.\n");
   own_mesh = true;
-
-  if (compressed) pclose(f); else fclose(f);
-
-  init_dxdy_buffer();
 }
 
 
 //// getting solution values in arbitrary points ///////////////////////////////////////////////////////////////
 
-scalar Solution::get_ref_value(Element* e, double xi1, double xi2, int component, int item)
+static inline scalar eval_mono(scalar* mono, int o, int mode, double xi1, double xi2)
 {
-  set_active_element(e);
-
-  int o = elem_orders[e->id];
-  scalar* mono = dxdy_coefs[component][item];
   scalar result = 0.0;
   int k = 0;
   for (int i = 0; i <= o; i++)
@@ -1353,6 +1609,12 @@ scalar Solution::get_ref_value(Element* e, double xi1, double xi2, int component
   return result;
 }
 
+scalar Solution::get_ref_value(Element* e, double xi1, double xi2, int component, int item)
+{
+  set_active_element(e);
+  return eval_mono(dxdy_coefs[component][item], elem_orders[e->id], mode, xi1, xi2);
+}
+
 
 static inline bool is_in_ref_domain(Element* e, double xi1, double xi2)
 {
@@ -1366,18 +1628,26 @@ static inline bool is_in_ref_domain(Element* e, double xi1, double xi2)
 
 scalar Solution::get_ref_value_transformed(Element* e, double xi1, double xi2, int a, int b)
 {
+  set_active_element(e);
+  return get_active_value_transformed(xi1, xi2, a, b);
+}
 
+
+scalar Solution::get_active_value_transformed(double xi1, double xi2, int a, int b)
+{
+  int o = elem_orders[element->id];
   if (num_components == 1)
   {
     if (b == 0)
-      return get_ref_value(e, xi1, xi2, a, b);
+      return eval_mono(dxdy_coefs[a][0], o, mode, xi1, xi2);
     if (b == 1 || b == 2)
     {
       double2x2 m;
       double xx, yy;
       refmap->inv_ref_map_at_point(xi1, xi2, xx, yy, m);
-      scalar dx = get_ref_value(e_last = e, xi1, xi2, a, 1);
-      scalar dy = get_ref_value(e, xi1, xi2, a, 2);
+      e_last = element;
+      scalar dx = eval_mono(dxdy_coefs[a][1], o, mode, xi1, xi2);
+      scalar dy = eval_mono(dxdy_coefs[a][2], o, mode, xi1, xi2);
       if (b == 1) return m[0][0]*dx + m[0][1]*dy; // H2D_FN_DX
       if (b == 2) return m[1][0]*dx + m[1][1]*dy; // H2D_FN_DY
     }
@@ -1391,8 +1661,8 @@ scalar Solution::get_ref_value_transformed(Element* e, double xi1, double xi2, i
       double2x2 m;
       double xx, yy;
       refmap->inv_ref_map_at_point(xi1, xi2, xx, yy, m);
-      scalar vx = get_ref_value(e, xi1, xi2, 0, 0);
-      scalar vy = get_ref_value(e, xi1, xi2, 1, 0);
+      scalar vx = eval_mono(dxdy_coefs[0][0], o, mode, xi1, xi2);
+      scalar vy = eval_mono(dxdy_coefs[1][0], o, mode, xi1, xi2);
       if (a == 0) return m[0][0]*vx + m[0][1]*vy; // H2D_FN_VAL_0
       if (a == 1) return m[1][0]*vx + m[1][1]*vy; // H2D_FN_VAL_1
     }
@@ -1403,15 +1673,169 @@ scalar Solution::get_ref_value_transformed(Element* e, double xi1, double xi2, i
   return 0;
 }
 
-scalar Solution::get_pt_value(double x, double y, int item)
-{
-  double xi1, xi2;
 
-  int a = 0, b = 0, mask = item; // a = component, b = val, dx, dy, dxx, dyy, dxy
+static void decode_pt_item(int num_components, int item, int& a, int& b)
+{
+  int mask = item;
+  a = 0; b = 0; // a = component, b = val, dx, dy, dxx, dyy, dxy
   if (num_components == 1) mask = mask & H2D_FN_COMPONENT_0;
   if ((mask & (mask - 1)) != 0) error("'item' is invalid. ");
   if (mask >= 0x40) { a = 1; mask >>= 6; }
   while (!(mask & 1)) { mask >>= 1; b++; }
+}
+
+
+void Solution::update_pt_grid()
+{
+  if (grid_mesh == mesh && grid_seq == mesh->get_seq()
+      && grid_nactive == mesh->get_num_active_elements()) return;
+
+  // bounding boxes of all active elements
+  int ne = mesh->get_num_active_elements();
+  if (ne == 0) error("Cannot locate points in an empty mesh.");
+  std::vector<Element*> elems;
+  std::vector<double> box;
+  elems.reserve(ne);
+  box.reserve(4*ne);
+
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    double x0 = e->vn[0]->x, x1 = x0, y0 = e->vn[0]->y, y1 = y0;
+    for (unsigned int i = 1; i < e->nvert; i++)
+    {
+      x0 = std::min(x0, e->vn[i]->x);  x1 = std::max(x1, e->vn[i]->x);
+      y0 = std::min(y0, e->vn[i]->y);  y1 = std::max(y1, e->vn[i]->y);
+    }
+
+    if (e->cm != NULL)
+    {
+      // sample the curved edges; the margin covers the arc between the samples
+      // (below 1% of the box size for a 90 degree arc)
+      static const double tri_ref[3][2]  = { {-1, -1}, {1, -1}, {-1, 1} };
+      static const double quad_ref[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+      const double (*ref)[2] = e->is_triangle() ? tri_ref : quad_ref;
+      const int ns = 8;
+      refmap->set_active_element(e);
+      for (unsigned int i = 0; i < e->nvert; i++)
+      {
+        const double* r0 = ref[i];
+        const double* r1 = ref[e->next_vert(i)];
+        for (int k = 1; k < ns; k++)
+        {
+          double t = (double) k / ns, px, py;
+          double2x2 m;
+          refmap->inv_ref_map_at_point(r0[0] + t*(r1[0] - r0[0]), r0[1] + t*(r1[1] - r0[1]), px, py, m);
+          x0 = std::min(x0, px);  x1 = std::max(x1, px);
+          y0 = std::min(y0, py);  y1 = std::max(y1, py);
+        }
+      }
+      double mx = 0.1 * (x1 - x0), my = 0.1 * (y1 - y0);
+      x0 -= mx;  x1 += mx;  y0 -= my;  y1 += my;
+    }
+
+    // points on element boundaries must not fall out due to round-off
+    double eps = 1e-8 * std::max(x1 - x0, y1 - y0);
+    elems.push_back(e);
+    box.push_back(x0 - eps);  box.push_back(x1 + eps);
+    box.push_back(y0 - eps);  box.push_back(y1 + eps);
+  }
+
+  double gx0 = box[0], gx1 = box[1], gy0 = box[2], gy1 = box[3];
+  for (int i = 1; i < ne; i++)
+  {
+    gx0 = std::min(gx0, box[4*i]);    gx1 = std::max(gx1, box[4*i+1]);
+    gy0 = std::min(gy0, box[4*i+2]);  gy1 = std::max(gy1, box[4*i+3]);
+  }
+
+  // about one element per cell, cells roughly square
+  double w = gx1 - gx0, h = gy1 - gy0;
+  grid_nx = std::max(1, std::min(4096, (int) ceil(sqrt(ne * w / h))));
+  grid_ny = std::max(1, std::min(4096, (int) ceil((double) ne / grid_nx)));
+  grid_x0 = gx0;  grid_hx = w / grid_nx;
+  grid_y0 = gy0;  grid_hy = h / grid_ny;
+
+  // two passes: count, then fill (compressed row storage of the cells)
+  int nc = grid_nx * grid_ny;
+  grid_start.assign(nc + 1, 0);
+  for (int pass = 0; pass < 2; pass++)
+  {
+    std::vector<int> fill;
+    if (pass == 1)
+    {
+      for (int c = 0; c < nc; c++) grid_start[c+1] += grid_start[c];
+      grid_elems.resize(grid_start[nc]);
+      fill.assign(grid_start.begin(), grid_start.end() - 1);
+    }
+    for (int k = 0; k < ne; k++)
+    {
+      int i0 = std::max(0, std::min(grid_nx - 1, (int) floor((box[4*k]   - gx0) / grid_hx)));
+      int i1 = std::max(0, std::min(grid_nx - 1, (int) floor((box[4*k+1] - gx0) / grid_hx)));
+      int j0 = std::max(0, std::min(grid_ny - 1, (int) floor((box[4*k+2] - gy0) / grid_hy)));
+      int j1 = std::max(0, std::min(grid_ny - 1, (int) floor((box[4*k+3] - gy0) / grid_hy)));
+      for (int j = j0; j <= j1; j++)
+        for (int i = i0; i <= i1; i++)
+        {
+          if (pass == 0) grid_start[j*grid_nx + i + 1]++;
+          else grid_elems[fill[j*grid_nx + i]++] = elems[k];
+        }
+    }
+  }
+
+  grid_mesh = mesh;
+  grid_seq = mesh->get_seq();
+  grid_nactive = ne;
+  verbose("Point location grid: %d x %d cells, %d entries.", grid_nx, grid_ny, (int) grid_elems.size());
+}
+
+
+Element* Solution::find_pt_element(double x, double y, double& xi1, double& xi2)
+{
+  // try the last visited element and its neighbours
+  if (e_last != NULL)
+  {
+    Element* elem[5];
+    elem[0] = e_last;
+    for (unsigned int i = 1; i <= e_last->nvert; i++)
+      elem[i] = e_last->get_neighbor(i-1);
+
+    for (unsigned int i = 0; i <= e_last->nvert; i++)
+      if (elem[i] != NULL)
+      {
+        refmap->set_active_element(elem[i]);
+        refmap->untransform(elem[i], x, y, xi1, xi2);
+        if (is_in_ref_domain(elem[i], xi1, xi2))
+          return e_last = elem[i];
+      }
+  }
+
+  // look up the candidates in the grid
+  update_pt_grid();
+  double fx = (x - grid_x0) / grid_hx, fy = (y - grid_y0) / grid_hy;
+  if (fx >= 0.0 && fx <= grid_nx && fy >= 0.0 && fy <= grid_ny)
+  {
+    int i = std::min(grid_nx - 1, (int) fx), j = std::min(grid_ny - 1, (int) fy);
+    int c = j*grid_nx + i;
+    for (int k = grid_start[c]; k < grid_start[c+1]; k++)
+    {
+      Element* e = grid_elems[k];
+      refmap->set_active_element(e);
+      refmap->untransform(e, x, y, xi1, xi2);
+      if (is_in_ref_domain(e, xi1, xi2))
+        return e_last = e;
+    }
+  }
+
+  return NULL;
+}
+
+
+scalar Solution::get_pt_value(double x, double y, int item)
+{
+  double xi1, xi2;
+
+  int a, b;
+  decode_pt_item(num_components, item, a, b);
 
   if (sln_type == HERMES_EXACT)
   {
@@ -1445,42 +1869,59 @@ scalar Solution::get_pt_value(double x, double y, int item)
           "the solution on its right-hand side.");
   }
 
-  // try the last visited element and its neighbours
-  if (e_last != NULL)
+  Element* e = find_pt_element(x, y, xi1, xi2);
+  if (e != NULL)
+    return get_ref_value_transformed(e, xi1, xi2, a, b);
+
+  warn("Point (%g, %g) does not lie in any element.", x, y);
+  return NAN;
+}
+
+
+void Solution::get_pt_values(const double* x, const double* y, int n, scalar* out, int item)
+{
+  if (sln_type != HERMES_SLN)
   {
-    Element* elem[5];
-    elem[0] = e_last;
-    for (unsigned int i = 1; i <= e_last->nvert; i++)
-      elem[i] = e_last->get_neighbor(i-1);
+    for (int i = 0; i < n; i++)
+      out[i] = get_pt_value(x[i], y[i], item);
+    return;
+  }
 
-    for (unsigned int i = 0; i <= e_last->nvert; i++)
-      if (elem[i] != NULL)
-      {
-        refmap->set_active_element(elem[i]);
-        refmap->untransform(elem[i], x, y, xi1, xi2);
-        if (is_in_ref_domain(elem[i], xi1, xi2))
-        {
-          e_last = elem[i];
-          return get_ref_value_transformed(elem[i], xi1, xi2, a, b);
-        }
-      }
+  int a, b;
+  decode_pt_item(num_components, item, a, b);
+
+  // locate the points; consecutive points usually lie in the same or neighbouring elements
+  std::vector<std::pair<int, int> > sorted;
+  std::vector<double> xi(2*n);
+  sorted.reserve(n);
+  int outside = 0;
+  for (int i = 0; i < n; i++)
+  {
+    Element* e = find_pt_element(x[i], y[i], xi[2*i], xi[2*i+1]);
+    if (e != NULL)
+      sorted.push_back(std::pair<int, int>(e->id, i));
+    else
+    {
+      out[i] = NAN;
+      outside++;
+    }
   }
 
-  // go through all elements
-  Element *e;
-  for_all_active_elements(e, mesh)
+  // evaluate element by element
+  std::sort(sorted.begin(), sorted.end());
+  for (unsigned int k = 0; k < sorted.size(); )
   {
-    refmap->set_active_element(e);
-    refmap->untransform(e, x, y, xi1, xi2);
-    if (is_in_ref_domain(e, xi1, xi2))
+    int id = sorted[k].first;
+    set_active_element(mesh->get_element(id));
+    for ( ; k < sorted.size() && sorted[k].first == id; k++)
     {
-      e_last = e;
-      return get_ref_value_transformed(e, xi1, xi2, a, b);
+      int i = sorted[k].second;
+      out[i] = get_active_value_transformed(xi[2*i], xi[2*i+1], a, b);
     }
   }
 
-  warn("Point (%g, %g) does not lie in any element.", x, y);
-  return NAN;
+  if (outside > 0)
+    warn("%d of %d points do not lie in any element.", outside, n);
 }
 
 
@@ -76,6 +76,8 @@ public:
     { ScalarFunction::force_transform(mf->get_transform(), mf->get_ctm()); }
   void update_refmap()
     { refmap->force_transform(sub_idx, ctm); }
+  void set_private_refmap_shapeset()
+    { refmap->set_private_shapeset(); }
   void force_transform(uint64_t sub_idx, Trf* ctm)
   {
     this->sub_idx = sub_idx;
@@ -108,7 +110,9 @@ public:
 
   void assign(Solution* sln);
   Solution& operator = (Solution& sln) { assign(&sln); return *this; }
-  void copy(const Solution* sln);
+  /// Makes a deep copy of sln. If share_mesh is true, the copy refers to the mesh
+  /// of sln instead of owning a copy of it.
+  void copy(const Solution* sln, bool share_mesh = false);
 
   int* get_element_orders() { return this->elem_orders;}
 
@@ -131,13 +135,20 @@ public:
   void enable_transform(bool enable = true);
 
   /// Saves the complete solution (i.e., including the internal copy of the mesh and
-  /// element orders) to a binary file. On Linux, if `compress` is true, the file is
-  /// compressed with gzip and a ".gz" suffix added to the file name.
+  /// element orders) to a binary file. If `compress` is true, the data are compressed
+  /// in-process with zlib and a ".gz" suffix is added to the file name; by default this
+  /// is done only if Hermes was built with zlib (WITH_ZLIB).
+  /// Uncompressed files can be loaded without copying the coefficients (see load()).
+#ifdef WITH_ZLIB
   void save(const char* filename, bool compress = true);
+#else
+  void save(const char* filename, bool compress = false);
+#endif
 
   /// Loads the solution from a file previously created by Solution::save(). This completely
-  /// restores the solution in the memory. The file name has to include the ".gz" suffix,
-  /// in which case the file is piped through gzip to decompress the data (Linux only).
+  /// restores the solution in the memory. Files in the current format are memory-mapped and
+  /// their uncompressed coefficient arrays are used in place. Files written by older versions
+  /// are read as before (gzipped ones are piped through gunzip, Linux only).
   void load(const char* filename);
 
   /// Returns solution value or derivatives at element e, in its reference domain point (xi1, xi2).
@@ -156,10 +167,17 @@ public:
   /// Returns solution value or derivatives at the physical domain point (x, y).
   /// 'item' controls the returned value: H2D_FN_VAL_0, H2D_FN_VAL_1, H2D_FN_DX_0, H2D_FN_DX_1, H2D_FN_DY_0,....
   /// NOTE: This function should be used for postprocessing only, it is not effective
-  /// enough for calculations. Since it searches for an element sequentinally, it is extremelly
-  /// slow. Prefer Solution::get_ref_value if possible.
+  /// enough for calculations. The element containing (x, y) is looked up in a uniform grid
+  /// over the element bounding boxes, which is built on the first call and rebuilt whenever
+  /// the mesh changes. Prefer Solution::get_ref_value if possible.
   virtual scalar get_pt_value(double x, double y, int item = H2D_FN_VAL_0);
 
+  /// Evaluates the solution at n physical points (x[i], y[i]) and stores the results in out[i].
+  /// The points are grouped by the element they fall into, so that each element is activated
+  /// only once. This is much faster than calling get_pt_value() repeatedly for large point
+  /// sets (probes, line plots, transfer to another mesh). Points outside the domain yield NAN.
+  void get_pt_values(const double* x, const double* y, int n, scalar* out, int item = H2D_FN_VAL_0);
+
   /// Returns the number of degrees of freedom of the solution.
   /// Returns -1 for exact or constant solutions.
   int get_num_dofs() const { return num_dofs; };
@@ -248,6 +266,37 @@ protected:
 
   Element* e_last; ///< last visited element when getting solution values at specific points
 
+  /// Contents of the file the solution was loaded from. Coefficient arrays that were stored
+  /// uncompressed point directly into it and must not be deleted separately.
+  char* file_data;
+  size_t file_size;
+  bool file_mapped;  ///< true if file_data was mmap()-ed, false if allocated with new[]
+
+  bool in_file_data(const void* ptr) const;
+  void free_file_data();
+  /// Loads the old record-by-record format; the magic and version are already read from f.
+  void load_v1(FILE* f);
+  /// Loads the chunked format (version 2).
+  void load_v2(const char* filename);
+
+  /// Uniform grid over the bounding boxes of the active elements, used to locate points.
+  /// Cell (i, j) lists the elements grid_elems[grid_start[c]..grid_start[c+1]-1], c = j*grid_nx + i.
+  Mesh* grid_mesh;       ///< mesh the grid was built for (NULL = no grid)
+  unsigned grid_seq;     ///< seq of grid_mesh at the time the grid was built
+  int grid_nactive;      ///< number of active elements at the time the grid was built
+  int grid_nx, grid_ny;
+  double grid_x0, grid_y0, grid_hx, grid_hy;
+  std::vector<int> grid_start;
+  std::vector<Element*> grid_elems;
+
+  /// (Re)builds the point location grid if the mesh has changed since the last call.
+  void update_pt_grid();
+  /// Finds the active element containing (x, y) and the reference coordinates of the point.
+  /// Returns NULL if the point does not lie in the domain.
+  Element* find_pt_element(double x, double y, double& xi1, double& xi2);
+  /// Same as get_ref_value_transformed(), but assumes e is already the active element.
+  scalar get_active_value_transformed(double xi1, double xi2, int a, int b);
+
 };
 
 
@@ -110,6 +110,21 @@ public:
                     bool residual_as_function = false,
                     double damping_coeff = 1.0, double max_allowed_residual_norm = 1e6) const;
 
+  /// Newton's method reusing the Jacobian and its factorization in the solver while the residual
+  /// norm drops at least by the factor max_contraction per iteration. When the convergence degrades,
+  /// the Jacobian is reassembled and refactorized with the reordering of the matrix reused.
+  /// jacobian_valid tells whether 'matrix' and 'solver' hold a factorized Jacobian of the current
+  /// spaces (e.g. from the last time step); it is updated, so the same variable can be passed
+  /// to the next call. Set it to false whenever the spaces change.
+  /// With jacobian_free == true, the Jacobian is never assembled: the Newton's steps are computed
+  /// by GMRES with Jacobian-vector products approximated by differences of residuals, preconditioned
+  /// by the factorized Jacobian in 'solver' if jacobian_valid is true.
+  bool solve_newton_reuse(scalar* coeff_vec, DiscreteProblem* dp, Solver* solver, SparseMatrix* matrix,
+                          Vector* rhs, bool& jacobian_valid, double NEWTON_TOL = 1e-8, 
+                          int NEWTON_MAX_ITER = 100, bool verbose = false, 
+                          double max_contraction = 0.5, bool jacobian_free = false, 
+                          double max_allowed_residual_norm = 1e6) const;
+
   bool solve_picard(WeakForm* wf, Space* space, Solution* sln_prev_iter, 
                     MatrixSolverType matrix_solver, double tol = 1e-8, 
                     int max_iter = 100, bool verbose = false) const;
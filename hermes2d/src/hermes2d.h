@@ -38,6 +38,9 @@
 #include "../hermes_common/solver/petsc.h"
 #include "../hermes_common/solver/umfpack_solver.h"
 #include "../hermes_common/solver/superlu.h"
+#include "../hermes_common/solver/krylov.h"
+#include "../hermes_common/solver/bsr.h"
+#include "../hermes_common/solver/matrix_free.h"
 
 // preconditioners
 #include "../hermes_common/solver/precond.h"
@@ -125,6 +125,8 @@ Mesh::Mesh() : HashTable()
 {
   nbase = nactive = ntopvert = ninitial = 0;
   seq = g_mesh_seq++;
+  sfc_traversal = false;
+  sfc_base_order_seq = 0;
 }
 
 Element* Mesh::get_element(int id) const
@@ -937,6 +939,57 @@ Nurbs* Mesh::reverse_nurbs(Nurbs* nurbs)
   return rev;
 }
 
+// position of the point (x, y) of the grid 2^bits x 2^bits on the Hilbert curve
+unsigned int hilbert_index(unsigned int x, unsigned int y, int bits)
+{
+  unsigned int n = 1u << bits, d = 0;
+  for (unsigned int s = n / 2; s > 0; s /= 2)
+  {
+    unsigned int rx = (x & s) > 0;
+    unsigned int ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+    if (ry == 0)
+    {
+      if (rx == 1) { x = n - 1 - x; y = n - 1 - y; }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+// indices of the elements sorted along the Hilbert curve through their centroids
+void hilbert_order(const std::vector<Element*>& elems, std::vector<int>& order)
+{
+  int n = elems.size();
+  std::vector<double> cx(n, 0.0), cy(n, 0.0);
+  double xmin = 1e300, xmax = -1e300, ymin = 1e300, ymax = -1e300;
+  for (int i = 0; i < n; i++)
+  {
+    Element* e = elems[i];
+    for (unsigned int j = 0; j < e->nvert; j++)
+    {
+      cx[i] += e->vn[j]->x;
+      cy[i] += e->vn[j]->y;
+    }
+    cx[i] /= e->nvert;
+    cy[i] /= e->nvert;
+    xmin = std::min(xmin, cx[i]);  xmax = std::max(xmax, cx[i]);
+    ymin = std::min(ymin, cy[i]);  ymax = std::max(ymax, cy[i]);
+  }
+
+  const int bits = 16;
+  double scale = ((1 << bits) - 1) / std::max(std::max(xmax - xmin, ymax - ymin), 1e-300);
+  std::vector< std::pair<unsigned int, int> > keys(n);
+  for (int i = 0; i < n; i++)
+    keys[i] = std::make_pair(hilbert_index((unsigned int) ((cx[i] - xmin) * scale),
+                                           (unsigned int) ((cy[i] - ymin) * scale), bits), i);
+  std::sort(keys.begin(), keys.end());
+
+  order.resize(n);
+  for (int i = 0; i < n; i++)
+    order[i] = keys[i].second;
+}
+
 // computing vector length
 double vector_length(double a_1, double a_2)
 {
@@ -1172,6 +1225,9 @@ void Mesh::copy(const Mesh* mesh)
   ntopvert = mesh->ntopvert;
   ninitial = mesh->ninitial;
   seq = mesh->seq;
+  sfc_traversal = mesh->sfc_traversal;
+  sfc_base_order = mesh->sfc_base_order;
+  sfc_base_order_seq = mesh->sfc_base_order_seq;
   boundary_markers_conversion = mesh->boundary_markers_conversion;
   element_markers_conversion = mesh->element_markers_conversion;
 }
@@ -1236,6 +1292,7 @@ void Mesh::copy_base(Mesh* mesh)
   nbase = nactive = ninitial = mesh->nbase;
   ntopvert = mesh->ntopvert;
   seq = g_mesh_seq++;
+  sfc_traversal = mesh->sfc_traversal;
 }
 
 
@@ -1253,6 +1310,48 @@ void Mesh::free()
 
   elements.free();
   HashTable::free();
+  sfc_base_order.clear();
+}
+
+
+//// space-filling curve order of base elements ///////////////////////////////////////////////////
+
+void Mesh::set_sfc_traversal(bool enable)
+{
+  if (enable == sfc_traversal) return;
+  sfc_traversal = enable;
+  seq = g_mesh_seq++;
+}
+
+const int* Mesh::get_sfc_base_order()
+{
+  // Traverse::begin() may be called by several threads at once
+#ifdef _OPENMP
+#pragma omp critical(mesh_sfc_base_order)
+#endif
+  {
+    if (sfc_base_order.empty() || sfc_base_order_seq != seq)
+    {
+      // the used base elements sorted by their position on the curve, unused ones go last
+      std::vector<Element*> used;
+      used.reserve(nbase);
+      for (int i = 0; i < nbase; i++)
+        if (get_element_fast(i)->used)
+          used.push_back(get_element_fast(i));
+      std::vector<int> order;
+      hilbert_order(used, order);
+
+      sfc_base_order.resize(nbase);
+      unsigned int k;
+      for (k = 0; k < order.size(); k++)
+        sfc_base_order[k] = used[order[k]]->id;
+      for (int i = 0; i < nbase; i++)
+        if (!get_element_fast(i)->used)
+          sfc_base_order[k++] = i;
+      sfc_base_order_seq = seq;
+    }
+  }
+  return sfc_base_order.empty() ? NULL : &sfc_base_order[0];
 }
 
 void Mesh::copy_converted(Mesh* mesh)
@@ -2001,7 +2100,32 @@ void Mesh::save(const char* filename)
 
 //// save_raw, load_raw ////////////////////////////////////////////////////////////////////////////
 
+// Version 1 of the format wrote the records below one by one with hermes_fwrite.
+// Version 2 stores exactly the same records, preceded by their total size, so that
+// the whole mesh can be written and read in one go (or parsed from memory).
+
 void Mesh::save_raw(FILE* f)
+{
+  std::vector<char> buf;
+  save_raw(buf);
+  hermes_fwrite(&buf[0], 1, buf.size(), f);
+}
+
+
+static inline void raw_append(std::vector<char>& buf, const void* data, size_t size)
+{
+  const char* p = (const char*) data;
+  buf.insert(buf.end(), p, p + size);
+}
+
+template<typename T>
+static inline void raw_append_value(std::vector<char>& buf, T value)
+{
+  raw_append(buf, &value, sizeof(T));
+}
+
+
+void Mesh::save_raw(std::vector<char>& buf)
 {
   int nn, mm;
   int null = -1;
@@ -2009,10 +2133,13 @@ void Mesh::save_raw(FILE* f)
   assert(sizeof(int) == 4);
   assert(sizeof(double) == 8);
 
-  hermes_fwrite("H2DM\001\000\000\000", 1, 8, f);
+  buf.clear();
+  raw_append(buf, "H2DM\002\000\000\000", 8);
+  uint64_t size = 0;
+  raw_append(buf, &size, sizeof(uint64_t));
 
   #define output(n, type) \
-    hermes_fwrite(&(n), sizeof(type), 1, f)
+    raw_append_value<type>(buf, n)
 
   output(nbase, int);
   output(ntopvert, int);
@@ -2085,26 +2212,97 @@ void Mesh::save_raw(FILE* f)
   // TODO: curved elements
 
   #undef output
+
+  size = buf.size() - 8 - sizeof(uint64_t);
+  memcpy(&buf[8], &size, sizeof(uint64_t));
 }
 
 
-void Mesh::load_raw(FILE* f)
+struct Mesh::RawInput
 {
-  int i, nv, mv, ne, me, id;
+  FILE* f;                ///< file to read from, or NULL
+  const char *pos, *end;  ///< memory buffer to read from (if f == NULL)
+
+  void read(void* data, size_t size)
+  {
+    if (f != NULL)
+      hermes_fread(data, 1, size, f);
+    else
+    {
+      if (size > (size_t) (end - pos)) error("Corrupt data.");
+      memcpy(data, pos, size);
+      pos += size;
+    }
+  }
+};
+
+
+struct RawMeshHeader { char magic[4]; int ver; };
+
+static void check_raw_mesh_header(const RawMeshHeader& hdr)
+{
+  if (hdr.magic[0] != 'H' || hdr.magic[1] != '2' || hdr.magic[2] != 'D' || hdr.magic[3] != 'M')
+    error("Not a Hermes2D raw mesh file.");
+  if (hdr.ver < 1 || hdr.ver > 2)
+    error("Unsupported file version.");
+}
+
 
+void Mesh::load_raw(FILE* f)
+{
   assert(sizeof(int) == 4);
   assert(sizeof(double) == 8);
 
   // check header
-  struct { char magic[4]; int ver; } hdr;
+  RawMeshHeader hdr;
   hermes_fread(&hdr, sizeof(hdr), 1, f);
-  if (hdr.magic[0] != 'H' || hdr.magic[1] != '2' || hdr.magic[2] != 'D' || hdr.magic[3] != 'M')
-    error("Not a Hermes2D raw mesh file.");
-  if (hdr.ver > 1)
-    error("Unsupported file version.");
+  check_raw_mesh_header(hdr);
+
+  if (hdr.ver == 1)
+  {
+    RawInput in = { f, NULL, NULL };
+    load_raw_data(in);
+  }
+  else
+  {
+    uint64_t size;
+    hermes_fread(&size, sizeof(uint64_t), 1, f);
+    std::vector<char> buf((size_t) size);
+    if (size > 0) hermes_fread(&buf[0], 1, (size_t) size, f);
+    RawInput in = { NULL, &buf[0], &buf[0] + buf.size() };
+    load_raw_data(in);
+  }
+}
+
+
+void Mesh::load_raw(const char* data, size_t size)
+{
+  assert(sizeof(int) == 4);
+  assert(sizeof(double) == 8);
+
+  RawMeshHeader hdr;
+  if (size < sizeof(hdr)) error("Corrupt data.");
+  memcpy(&hdr, data, sizeof(hdr));
+  check_raw_mesh_header(hdr);
+
+  RawInput in = { NULL, data + sizeof(hdr), data + size };
+  if (hdr.ver == 2)
+  {
+    uint64_t len;
+    in.read(&len, sizeof(uint64_t));
+    if (len > (uint64_t) (in.end - in.pos)) error("Corrupt data.");
+    in.end = in.pos + len;
+  }
+  load_raw_data(in);
+}
+
+
+void Mesh::load_raw_data(RawInput& in)
+{
+  int i, nv, mv, ne, me, id;
 
   #define input(n, type) \
-    hermes_fread(&(n), sizeof(type), 1, f)
+    in.read(&(n), sizeof(type))
 
   //printf("Calling Mesh::free() in Mesh::load_raw().\n");
   free();
@@ -276,10 +276,17 @@ public:
   void transform(double2x2 m, double2 t);
   void transform(void (*fn)(double* x, double* y));
 
-  /// Loads the entire internal state from a (binary) file. DEPRECATED
+  /// Loads the entire internal state from a (binary) file. Both the old record-by-record
+  /// format (version 1) and the current one (version 2) are accepted.
   void load_raw(FILE* f);
-  /// Saves the entire internal state to a (binary) file. DEPRECATED
+  /// Loads the entire internal state from a memory buffer holding the contents of a file
+  /// written by save_raw(). Used to restore meshes embedded in solution files.
+  void load_raw(const char* data, size_t size);
+  /// Saves the entire internal state to a (binary) file. The data are serialized into
+  /// memory first and written at once.
   void save_raw(FILE* f);
+  /// Serializes the entire internal state into 'buf' (same contents as save_raw(FILE*)).
+  void save_raw(std::vector<char>& buf);
 
   /// For internal use.
   int get_edge_sons(Element* e, int edge, int& son1, int& son2);
@@ -289,6 +296,16 @@ public:
   void set_seq(unsigned seq) { this->seq = seq; }
   /// For internal use.
   Element* get_element_fast(int id) const { return &(elements[id]);}
+
+  /// Makes Traverse visit the base elements in the order of the Hilbert curve through
+  /// their centroids instead of the order of their ids. The refinement tree of each base
+  /// element is still descended depth-first. Since the order of the assembling changes,
+  /// the mesh gets a new seq and spaces on it have to be updated by assign_dofs().
+  void set_sfc_traversal(bool enable);
+  bool get_sfc_traversal() const { return sfc_traversal; }
+  /// Returns the ids of all base elements in the order of the Hilbert curve (unused
+  /// base elements last). The order is computed once per mesh seq.
+  const int* get_sfc_base_order();
   /// Refines all triangle elements to quads.
   /// It can refine a triangle element into three quadrilaterals.
   /// Note: this function creates a base mesh.
@@ -324,6 +341,14 @@ protected:
   int nbase, ntopvert;
   int ninitial;
 
+  bool sfc_traversal;
+  std::vector<int> sfc_base_order;  ///< Base element ids on the Hilbert curve, see get_sfc_base_order().
+  unsigned sfc_base_order_seq;      ///< The seq for which sfc_base_order was computed.
+
+  /// Source of the raw data (a file or a memory buffer), see load_raw().
+  struct RawInput;
+  void load_raw_data(RawInput& in);
+
   void unrefine_element_internal(Element* e);
 
   Nurbs* reverse_nurbs(Nurbs* nurbs);
@@ -472,5 +497,7 @@ bool same_line(double p_1, double p_2, double q_1, double q_2, double r_1, doubl
 bool is_convex(double a_1, double a_2, double b_1, double b_2);
 void check_triangle(int i, Node *&v0, Node *&v1, Node *&v2);
 void check_quad(int i, Node *&v0, Node *&v1, Node *&v2, Node *&v3);
+unsigned int hilbert_index(unsigned int x, unsigned int y, int bits);
+void hilbert_order(const std::vector<Element*>& elems, std::vector<int>& order);
 
 #endif
@@ -29,16 +29,43 @@ RefMap::RefMap()
   num_tables = 0;
   cur_node = NULL;
   overflow = NULL;
+  shapeset = &ref_map_shapeset;
+  pss = &ref_map_pss;
+  own_shapeset = false;
   set_quad_2d(&g_quad_2d_std); // default quadrature
 }
 
 
+RefMap::~RefMap()
+{
+  free();
+  if (own_shapeset)
+  {
+    delete pss;
+    delete shapeset;
+  }
+}
+
+
+void RefMap::set_private_shapeset()
+{
+  if (own_shapeset) return;
+  free();
+  element = NULL;
+  shapeset = new H1ShapesetJacobi;
+  pss = new PrecalcShapeset(shapeset);
+  own_shapeset = true;
+  if (quad_2d != NULL)
+    pss->set_quad_2d(quad_2d);
+}
+
+
 
 void RefMap::set_quad_2d(Quad2D* quad_2d)
 {
   free();
   this->quad_2d = quad_2d;
-  ref_map_pss.set_quad_2d(quad_2d);
+  pss->set_quad_2d(quad_2d);
 }
 
 
@@ -46,7 +73,7 @@ void RefMap::set_active_element(Element* e)
 {
   if (e != element) free();
 
-  ref_map_pss.set_active_element(e);
+  pss->set_active_element(e);
   quad_2d->set_mode(e->get_mode());
   num_tables = quad_2d->get_num_tables();
   assert(num_tables <= H2D_MAX_TABLES);
@@ -63,7 +90,7 @@ void RefMap::set_active_element(Element* e)
   // prepare the shapes and coefficients of the reference map
   int j, k = 0;
   for (unsigned int i = 0; i < e->nvert; i++)
-    indices[k++] = ref_map_shapeset.get_vertex_index(i);
+    indices[k++] = shapeset->get_vertex_index(i);
 
   // straight-edged element
   if (e->cm == NULL)
@@ -81,11 +108,11 @@ void RefMap::set_active_element(Element* e)
     int o = e->cm->order;
     for (unsigned int i = 0; i < e->nvert; i++)
       for (j = 2; j <= o; j++)
-        indices[k++] = ref_map_shapeset.get_edge_index(i, 0, j);
+        indices[k++] = shapeset->get_edge_index(i, 0, j);
 
     if (e->is_quad()) o = H2D_MAKE_QUAD_ORDER(o, o);
-    memcpy(indices + k, ref_map_shapeset.get_bubble_indices(o),
-           ref_map_shapeset.get_num_bubbles(o) * sizeof(int));
+    memcpy(indices + k, shapeset->get_bubble_indices(o),
+           shapeset->get_num_bubbles(o) * sizeof(int));
 
     coeffs = e->cm->coeffs;
     nc = e->cm->nc;
@@ -128,13 +155,13 @@ void RefMap::calc_inv_ref_map(int order)
 
   double2x2* m = new double2x2[np];
   memset(m, 0, np * sizeof(double2x2));
-  ref_map_pss.force_transform(sub_idx, ctm);
+  pss->force_transform(sub_idx, ctm);
   for (i = 0; i < nc; i++)
   {
     double *dx, *dy;
-    ref_map_pss.set_active_shape(indices[i]);
-    ref_map_pss.set_quad_order(order);
-    ref_map_pss.get_dx_dy_values(dx, dy);
+    pss->set_active_shape(indices[i]);
+    pss->set_quad_order(order);
+    pss->get_dx_dy_values(dx, dy);
     for (j = 0; j < np; j++)
     {
       m[j][0][0] += coeffs[i][0] * dx[j];
@@ -175,15 +202,15 @@ void RefMap::calc_second_ref_map(int order)
 
   double3x2* k = new double3x2[np];
   memset(k, 0, np * sizeof(double3x2));
-  ref_map_pss.force_transform(sub_idx, ctm);
+  pss->force_transform(sub_idx, ctm);
   for (i = 0; i < nc; i++)
   {
     double *dxy, *dxx, *dyy;
-    ref_map_pss.set_active_shape(indices[i]);
-    ref_map_pss.set_quad_order(order, H2D_FN_ALL);
-    dxx = ref_map_pss.get_dxx_values();
-    dyy = ref_map_pss.get_dyy_values();
-    dxy = ref_map_pss.get_dxy_values();
+    pss->set_active_shape(indices[i]);
+    pss->set_quad_order(order, H2D_FN_ALL);
+    dxx = pss->get_dxx_values();
+    dyy = pss->get_dyy_values();
+    dxy = pss->get_dxy_values();
     for (j = 0; j < np; j++)
     {
       k[j][0][0] += coeffs[i][0] * dxx[j];
@@ -266,12 +293,12 @@ void RefMap::calc_phys_x(int order)
   int i, j, np = quad_2d->get_num_points(order);
   double* x = cur_node->phys_x[order] = new double[np];
   memset(x, 0, np * sizeof(double));
-  ref_map_pss.force_transform(sub_idx, ctm);
+  pss->force_transform(sub_idx, ctm);
   for (i = 0; i < nc; i++)
   {
-    ref_map_pss.set_active_shape(indices[i]);
-    ref_map_pss.set_quad_order(order);
-    double* fn = ref_map_pss.get_fn_values();
+    pss->set_active_shape(indices[i]);
+    pss->set_quad_order(order);
+    double* fn = pss->get_fn_values();
     for (j = 0; j < np; j++)
       x[j] += coeffs[i][0] * fn[j];
   }
@@ -284,12 +311,12 @@ void RefMap::calc_phys_y(int order)
   int i, j, np = quad_2d->get_num_points(order);
   double* y = cur_node->phys_y[order] = new double[np];
   memset(y, 0, np * sizeof(double));
-  ref_map_pss.force_transform(sub_idx, ctm);
+  pss->force_transform(sub_idx, ctm);
   for (i = 0; i < nc; i++)
   {
-    ref_map_pss.set_active_shape(indices[i]);
-    ref_map_pss.set_quad_order(order);
-    double* fn = ref_map_pss.get_fn_values();
+    pss->set_active_shape(indices[i]);
+    pss->set_quad_order(order);
+    double* fn = pss->get_fn_values();
     for (j = 0; j < np; j++)
       y[j] += coeffs[i][1] * fn[j];
   }
@@ -320,16 +347,16 @@ void RefMap::calc_tangent(int edge, int eo)
   else
   {
     // construct jacobi matrices of the direct reference map at integration points along the edge
-    static double2x2 m[15];
+    double2x2 m[15];
     assert(np <= 15);
     memset(m, 0, np*sizeof(double2x2));
-    ref_map_pss.force_transform(sub_idx, ctm);
+    pss->force_transform(sub_idx, ctm);
     for (i = 0; i < nc; i++)
     {
       double *dx, *dy;
-      ref_map_pss.set_active_shape(indices[i]);
-      ref_map_pss.set_quad_order(eo);
-      ref_map_pss.get_dx_dy_values(dx, dy);
+      pss->set_active_shape(indices[i]);
+      pss->set_quad_order(eo);
+      pss->get_dx_dy_values(dx, dy);
       for (j = 0; j < np; j++)
       {
         m[j][0][0] += coeffs[i][0] * dx[j];
@@ -340,8 +367,8 @@ void RefMap::calc_tangent(int edge, int eo)
     }
 
     // multiply them by the vector of the reference edge
-    double2* v1 = ref_map_shapeset.get_ref_vertex(a);
-    double2* v2 = ref_map_shapeset.get_ref_vertex(b);
+    double2* v1 = shapeset->get_ref_vertex(a);
+    double2* v2 = shapeset->get_ref_vertex(b);
     double ex = (*v2)[0] - (*v1)[0];
     double ey = (*v2)[1] - (*v1)[1];
     for (i = 0; i < np; i++)
@@ -411,12 +438,12 @@ void RefMap::inv_ref_map_at_point(double xi1, double xi2, double& x, double& y,
   x = y = 0;
   for (int i = 0; i < nc; i++)
   {
-    double val = ref_map_shapeset.get_fn_value(indices[i], xi1, xi2, 0);
+    double val = shapeset->get_fn_value(indices[i], xi1, xi2, 0);
     x += coeffs[i][0] * val;
     y += coeffs[i][1] * val;
 
-    double dx =  ref_map_shapeset.get_dx_value(indices[i], xi1, xi2, 0);
-    double dy =  ref_map_shapeset.get_dy_value(indices[i], xi1, xi2, 0);
+    double dx =  shapeset->get_dx_value(indices[i], xi1, xi2, 0);
+    double dy =  shapeset->get_dy_value(indices[i], xi1, xi2, 0);
     tmp[0][0] += coeffs[i][0] * dx;
     tmp[0][1] += coeffs[i][0] * dy;
     tmp[1][0] += coeffs[i][1] * dx;
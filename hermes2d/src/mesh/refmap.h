@@ -36,7 +36,7 @@ class HERMES_API RefMap : public Transformable
 public:
 
   RefMap();
-  ~RefMap() { free(); }
+  ~RefMap();
 
   /// Sets the quadrature points in which the reference map will be evaluated.
   /// \param quad_2d [in] The quadrature points.
@@ -48,6 +48,11 @@ public:
   /// Returns the 1D quadrature for use in surface integrals.
   const Quad1D* get_quad_1d() const { return &quad_1d; }
 
+  /// Makes the reference map evaluate the mapping with its own shapeset and
+  /// PrecalcShapeset instead of the ones shared by all instances. Needed when
+  /// reference maps are used concurrently by several threads.
+  void set_private_shapeset();
+
   /// Initializes the reference map for the specified element.
   /// Must be called prior to using all other functions in the class.
   virtual void set_active_element(Element* e);
@@ -165,6 +170,11 @@ protected:
   Quad2D* quad_2d;
   int num_tables;
 
+  /// Shapeset (and its precalculated values) the reference mapping is expressed in.
+  Shapeset* shapeset;
+  PrecalcShapeset* pss;
+  bool own_shapeset;
+
   bool is_const;
   int inv_ref_order;
 
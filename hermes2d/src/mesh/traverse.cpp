@@ -248,7 +248,7 @@ Element** Traverse::get_next_state(bool* bnd, SurfPos* surf_pos)
         for (i = 0; i < num; i++)
         {
 					// Retrieve the Element with this id on the i-th mesh.
-          s->e[i] = meshes[i]->get_element(id);
+          s->e[i] = meshes[i]->get_element(base_order != NULL ? base_order[id] : id);
           if (!s->e[i]->used)
 					{
 						s->e[i] = NULL;
@@ -502,6 +502,7 @@ void Traverse::begin(int n, Mesh** meshes, Transformable** fn)
   sons = new int4[num];
   subs = new uint64_t[num];
   id = 0;
+  base_order = meshes[0]->get_sfc_traversal() ? meshes[0]->get_sfc_base_order() : NULL;
 
 #ifndef H2D_DISABLE_MULTIMESH_TESTS
   // Test whether all master meshes have the same number of elements.
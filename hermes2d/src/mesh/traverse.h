@@ -50,6 +50,10 @@ struct UniData
 /// same base mesh it walks through all (pseudo-)elements of the union of all
 /// the N meshes.
 ///
+/// The base elements are visited in the order of their ids, or in the order of the
+/// Hilbert curve if the first mesh has Mesh::set_sfc_traversal() enabled. The parallel
+/// assembling distributes the states in chunks in this order, too.
+///
 class HERMES_API Traverse
 {
 public:
@@ -72,6 +76,7 @@ private:
   int top, size;
 
   int id;
+  const int* base_order;  ///< Ids of the base elements in the order of traversal, NULL for the natural order.
   bool tri;
   Element* base;
   int4* sons;
@@ -69,6 +69,8 @@ class HERMES_API Quad2D
 {
 public:
 
+  virtual ~Quad2D() {}
+
   void set_mode(int mode) { this->mode = mode; }
   int  get_mode() const { return mode; }
 
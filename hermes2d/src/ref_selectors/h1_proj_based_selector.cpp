@@ -11,7 +11,23 @@ namespace RefinementSelectors {
   const int H1ProjBasedSelector::H2DRS_MAX_H1_ORDER = H2DRS_MAX_ORDER;
 
   H1ProjBasedSelector::H1ProjBasedSelector(CandList cand_list, double conv_exp, int max_order, H1Shapeset* user_shapeset)
-    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? &default_shapeset : user_shapeset, Range<int>(1,1), Range<int>(2, H2DRS_MAX_H1_ORDER)) {}
+    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? &default_shapeset : user_shapeset, Range<int>(1,1), Range<int>(2, H2DRS_MAX_H1_ORDER))
+    , clone_shapeset(NULL) {}
+
+  H1ProjBasedSelector::~H1ProjBasedSelector() {
+    delete clone_shapeset;
+  }
+
+  Selector* H1ProjBasedSelector::clone() {
+    //a user shapeset cannot be copied and overrides of a derived class would be lost
+    if (shapeset != &default_shapeset || typeid(*this) != typeid(H1ProjBasedSelector))
+      return NULL;
+    H1Shapeset* ss = new H1Shapeset;
+    H1ProjBasedSelector* selector = new H1ProjBasedSelector(cand_list, conv_exp, max_order, ss);
+    selector->clone_shapeset = ss;
+    selector->init_clone(this);
+    return selector;
+  }
 
   void H1ProjBasedSelector::set_current_order_range(Element* element) {
     current_max_order = this->max_order;
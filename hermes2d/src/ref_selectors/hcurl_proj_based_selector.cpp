@@ -14,10 +14,22 @@ namespace RefinementSelectors {
 
   HcurlProjBasedSelector::HcurlProjBasedSelector(CandList cand_list, double conv_exp, int max_order, HcurlShapeset* user_shapeset)
     : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? &default_shapeset : user_shapeset, Range<int>(), Range<int>(0, H2DRS_MAX_HCURL_ORDER))
-    , precalc_rvals_curl(NULL) {}
+    , precalc_rvals_curl(NULL), clone_shapeset(NULL) {}
 
   HcurlProjBasedSelector::~HcurlProjBasedSelector() {
     delete[] precalc_rvals_curl;
+    delete clone_shapeset;
+  }
+
+  Selector* HcurlProjBasedSelector::clone() {
+    //a user shapeset cannot be copied and overrides of a derived class would be lost
+    if (shapeset != &default_shapeset || typeid(*this) != typeid(HcurlProjBasedSelector))
+      return NULL;
+    HcurlShapeset* ss = new HcurlShapeset;
+    HcurlProjBasedSelector* selector = new HcurlProjBasedSelector(cand_list, conv_exp, max_order, ss);
+    selector->clone_shapeset = ss;
+    selector->init_clone(this);
+    return selector;
   }
 
   void HcurlProjBasedSelector::set_current_order_range(Element* element) {
@@ -39,6 +39,11 @@ namespace RefinementSelectors {
     /// Destructor.
     virtual ~HcurlProjBasedSelector();
 
+    /// Creates a selector which can select refinements concurrently with this selector.
+    /** The clone uses its own instance of the default shapeset. A selector which uses a user shapeset
+     *  or an instance of a derived class is not cloned. For details, see Selector::clone(). */
+    virtual Selector* clone();
+
   protected: //overloads
     /// A function expansion of a function f used by this selector.
     enum LocalFuncExpansion {
@@ -84,6 +89,7 @@ namespace RefinementSelectors {
 
   protected: //defaults
     static HcurlShapeset default_shapeset; ///< A default shapeset.
+    HcurlShapeset* clone_shapeset; ///< A shapeset owned by a clone. NULL if this selector is not a clone, see clone().
   };
 }
 
@@ -11,7 +11,23 @@ namespace RefinementSelectors {
   const int L2ProjBasedSelector::H2DRS_MAX_L2_ORDER = H2DRS_MAX_ORDER;
 
   L2ProjBasedSelector::L2ProjBasedSelector(CandList cand_list, double conv_exp, int max_order, L2Shapeset* user_shapeset)
-    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? &default_shapeset : user_shapeset, Range<int>(1,1), Range<int>(0, H2DRS_MAX_L2_ORDER)) {}
+    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? &default_shapeset : user_shapeset, Range<int>(1,1), Range<int>(0, H2DRS_MAX_L2_ORDER))
+    , clone_shapeset(NULL) {}
+
+  L2ProjBasedSelector::~L2ProjBasedSelector() {
+    delete clone_shapeset;
+  }
+
+  Selector* L2ProjBasedSelector::clone() {
+    //a user shapeset cannot be copied and overrides of a derived class would be lost
+    if (shapeset != &default_shapeset || typeid(*this) != typeid(L2ProjBasedSelector))
+      return NULL;
+    L2Shapeset* ss = new L2Shapeset;
+    L2ProjBasedSelector* selector = new L2ProjBasedSelector(cand_list, conv_exp, max_order, ss);
+    selector->clone_shapeset = ss;
+    selector->init_clone(this);
+    return selector;
+  }
 
   void L2ProjBasedSelector::set_current_order_range(Element* element) {
     current_max_order = this->max_order;
@@ -33,6 +33,14 @@ namespace RefinementSelectors {
      *  \param[in] max_order A maximum order which considered. If ::H2DRS_DEFAULT_ORDER, a maximum order supported by the selector is used, see HcurlProjBasedSelector::H2DRS_MAX_L2_ORDER.
      *  \param[in] user_shapeset A shapeset. If NULL, it will use internal instance of the class L2Shapeset. */
     L2ProjBasedSelector(CandList cand_list = H2D_HP_ANISO, double conv_exp = 1.0, int max_order = H2DRS_DEFAULT_ORDER, L2Shapeset* user_shapeset = NULL);
+
+    /// Destructor.
+    virtual ~L2ProjBasedSelector();
+
+    /// Creates a selector which can select refinements concurrently with this selector.
+    /** The clone uses its own instance of the default shapeset. A selector which uses a user shapeset
+     *  or an instance of a derived class is not cloned. For details, see Selector::clone(). */
+    virtual Selector* clone();
   protected: //overloads
     /// A function expansion of a function f used by this selector.
     enum LocalFuncExpansion {
@@ -77,6 +85,7 @@ namespace RefinementSelectors {
 
   protected: //defaults
     static L2Shapeset default_shapeset; ///< A default shapeset.
+    L2Shapeset* clone_shapeset; ///< A shapeset owned by a clone. NULL if this selector is not a clone, see clone().
   };
 }
 
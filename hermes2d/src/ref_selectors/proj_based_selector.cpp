@@ -14,19 +14,12 @@ namespace RefinementSelectors {
           Range<int>& edge_bubble_order) :
       OptimumSelector(cand_list, conv_exp, max_order, shapeset, vertex_order, edge_bubble_order),
       warn_uniform_orders(false),
+      cache_kind(-1),
+      quad(&g_quad_2d_std),
       error_weight_h(H2DRS_DEFAULT_ERR_WEIGHT_H),
       error_weight_p(H2DRS_DEFAULT_ERR_WEIGHT_P),
       error_weight_aniso(H2DRS_DEFAULT_ERR_WEIGHT_ANISO)
   {
-    //clean svals initialization state
-    std::fill(cached_shape_vals_valid, cached_shape_vals_valid + H2D_NUM_MODES, false);
-
-    //clear matrix cache
-    for(int m = 0; m < H2D_NUM_MODES; m++)
-      for(int i = 0; i < H2DRS_MAX_ORDER+1; i++)
-        for(int k = 0; k < H2DRS_MAX_ORDER+1; k++)
-          proj_matrix_cache[m][i][k] = NULL;
-
     //allocate caches
     int max_inx = max_shape_inx[0];
     for(int i = 1; i < H2D_NUM_MODES; i++)
@@ -36,13 +29,361 @@ namespace RefinementSelectors {
   }
 
   ProjBasedSelector::~ProjBasedSelector() {
-    //delete matrix cache
-    for(int m = 0; m < H2D_NUM_MODES; m++)
-      for(int i = 0; i < H2DRS_MAX_ORDER+1; i++)
-        for(int k = 0; k < H2DRS_MAX_ORDER+1; k++) {
-          if (proj_matrix_cache[m][i][k] != NULL)
-            delete[] proj_matrix_cache[m][i][k];
+    //a clone owns its quadrature
+    if (quad != &g_quad_2d_std)
+      delete static_cast<Quad2DStd*>(quad);
+  }
+
+  void ProjBasedSelector::init_clone(ProjBasedSelector* master) {
+    opt_symmetric_mesh = master->opt_symmetric_mesh;
+    opt_apply_exp_dof = master->opt_apply_exp_dof;
+    set_error_weights(master->error_weight_h, master->error_weight_p, master->error_weight_aniso);
+    warn_uniform_orders = true; //the master warns
+    cache_kind = master->cache_kind;
+    quad = new Quad2DStd;
+  }
+
+  ProjBasedSelector::SharedCache ProjBasedSelector::shared_cache;
+
+  bool ProjBasedSelector::SharedCacheKey::operator<(const SharedCacheKey& other) const {
+    if (selector != other.selector) return selector < other.selector;
+    if (shapeset_id != other.shapeset_id) return shapeset_id < other.shapeset_id;
+    if (mode != other.mode) return mode < other.mode;
+    if (order_h != other.order_h) return order_h < other.order_h;
+    if (order_v != other.order_v) return order_v < other.order_v;
+    if (trf != other.trf) return trf < other.trf;
+    return ortho < other.ortho;
+  }
+
+  void ProjBasedSelector::SharedCache::clear() {
+    for(std::map<SharedCacheKey, ProjMatrixFactor*>::iterator it = proj_matrices.begin(); it != proj_matrices.end(); it++)
+      delete it->second;
+    proj_matrices.clear();
+    for(std::map<SharedCacheKey, std::vector<TrfShapeExp>*>::iterator it = shape_vals.begin(); it != shape_vals.end(); it++)
+      delete it->second;
+    shape_vals.clear();
+
+    //the kinds are kept, selectors remember their indices
+    for(int i = 0; i < H2DRS_MAX_CACHE_KINDS; i++) {
+      for(int mode = 0; mode < H2D_NUM_MODES; mode++)
+        delete tables[i].shape_vals[mode];
+      memset(&tables[i], 0, sizeof(SharedCacheTable));
+    }
+  }
+
+  void ProjBasedSelector::ProjMatrixFactor::factorize() {
+    if (try_choldc(matrix, num_shapes, diag))
+      return;
+
+    //the upper triangle still contains the matrix, restore the lower one and use LU
+    warn("A projection matrix of %d shapes is not positive definite, using LU decomposition.", num_shapes);
+    for(int i = 0; i < num_shapes; i++)
+      for(int j = 0; j < i; j++)
+        matrix[i][j] = matrix[j][i];
+    perm = new int[num_shapes];
+    double d;
+    ludcmp(matrix, num_shapes, perm, &d);
+  }
+
+  int ProjBasedSelector::get_cache_kind() {
+    if (cache_kind == -1) {
+      std::pair<std::string, int> key(typeid(*this).name(), shapeset->get_id());
+#pragma omp critical(proj_based_selector_cache)
+      {
+        std::map<std::pair<std::string, int>, int>::const_iterator found = shared_cache.kinds.find(key);
+        if (found != shared_cache.kinds.end())
+          cache_kind = found->second;
+        else if ((int)shared_cache.kinds.size() < H2DRS_MAX_CACHE_KINDS) {
+          cache_kind = (int)shared_cache.kinds.size();
+          shared_cache.kinds[key] = cache_kind;
+        }
+        else
+          cache_kind = -2; //the items are accessed through the maps only
+      }
+    }
+    return cache_kind;
+  }
+
+  void ProjBasedSelector::get_shared_shape_vals(int mode, const double3* gip_points, int num_gip_points, const Trf* trfs, int num_noni_trfs, std::vector<TrfShapeExp>* svals[H2D_TRF_NUM], std::vector<TrfShapeExp>* ortho_svals[H2D_TRF_NUM]) {
+    int kind = get_cache_kind();
+    const SharedShapeVals* cached = (kind >= 0) ? shared_cache.tables[kind].shape_vals[mode] : NULL;
+    SharedShapeVals found_vals;
+    if (cached != NULL) {
+      //pairs with the flush before the entry was published
+#pragma omp flush
+    }
+    else {
+      std::string selector_name = typeid(*this).name();
+      int shapeset_id = shapeset->get_id();
+#pragma omp critical(proj_based_selector_cache)
+      {
+        if (shared_cache.shape_vals.find(SharedCacheKey(selector_name, shapeset_id, mode, -1, -1, H2D_TRF_IDENTITY, false)) == shared_cache.shape_vals.end()) {
+          //calculate values and move them to the cache (TrfShapeExp cannot be copied)
+          TrfShape calc_svals, calc_ortho_svals;
+          precalc_ortho_shapes(gip_points, num_gip_points, trfs, num_noni_trfs, shape_indices[mode], max_shape_inx[mode], calc_ortho_svals);
+          precalc_shapes(gip_points, num_gip_points, trfs, num_noni_trfs, shape_indices[mode], max_shape_inx[mode], calc_svals);
+          for(int i = 0; i < H2D_TRF_NUM; i++) {
+            std::vector<TrfShapeExp>* vals = new std::vector<TrfShapeExp>();
+            vals->swap(calc_svals[i]);
+            shared_cache.shape_vals[SharedCacheKey(selector_name, shapeset_id, mode, -1, -1, i, false)] = vals;
+            std::vector<TrfShapeExp>* ortho_vals = new std::vector<TrfShapeExp>();
+            ortho_vals->swap(calc_ortho_svals[i]);
+            shared_cache.shape_vals[SharedCacheKey(selector_name, shapeset_id, mode, -1, -1, i, true)] = ortho_vals;
+          }
+        }
+
+        for(int i = 0; i < H2D_TRF_NUM; i++) {
+          found_vals.svals[i] = shared_cache.shape_vals[SharedCacheKey(selector_name, shapeset_id, mode, -1, -1, i, false)];
+          found_vals.ortho_svals[i] = shared_cache.shape_vals[SharedCacheKey(selector_name, shapeset_id, mode, -1, -1, i, true)];
         }
+
+        //publish the entry once it is complete
+        if (kind >= 0 && shared_cache.tables[kind].shape_vals[mode] == NULL) {
+          SharedShapeVals* entry = new SharedShapeVals(found_vals);
+#pragma omp flush
+          shared_cache.tables[kind].shape_vals[mode] = entry;
+        }
+      }
+      cached = &found_vals;
+    }
+
+    for(int i = 0; i < H2D_TRF_NUM; i++) {
+      svals[i] = cached->svals[i];
+      ortho_svals[i] = cached->ortho_svals[i];
+    }
+  }
+
+  const ProjBasedSelector::ProjMatrixFactor* ProjBasedSelector::get_shared_proj_matrix(int mode, int order_h, int order_v, double3* gip_points, int num_gip_points, const int* shape_inx, int num_shapes) {
+    int kind = get_cache_kind();
+    ProjMatrixFactor** entry = NULL;
+    if (kind >= 0 && order_h <= H2DRS_MAX_ORDER && order_v <= H2DRS_MAX_ORDER)
+      entry = &shared_cache.tables[kind].proj_matrices[mode][order_h][order_v];
+    ProjMatrixFactor* factor = (entry != NULL) ? *entry : NULL;
+    if (factor != NULL) {
+      //pairs with the flush before the entry was published
+#pragma omp flush
+    }
+    else {
+      SharedCacheKey key(typeid(*this).name(), shapeset->get_id(), mode, order_h, order_v, -1, false);
+#pragma omp critical(proj_based_selector_cache)
+      {
+        std::map<SharedCacheKey, ProjMatrixFactor*>::const_iterator found = shared_cache.proj_matrices.find(key);
+        if (found == shared_cache.proj_matrices.end()) {
+          double** proj_matrix = build_projection_matrix(gip_points, num_gip_points, shape_inx, num_shapes);
+          factor = new ProjMatrixFactor(num_shapes);
+          copy_matrix(factor->matrix, proj_matrix, num_shapes, num_shapes);
+          delete[] proj_matrix;
+          factor->factorize();
+          shared_cache.proj_matrices[key] = factor;
+        }
+        else
+          factor = found->second;
+
+        //publish the entry once it is complete
+        if (entry != NULL) {
+#pragma omp flush
+          *entry = factor;
+        }
+      }
+    }
+    error_if(factor->num_shapes != num_shapes, "A projection matrix of orders (H:%d,V:%d) in the cache has %d shapes but %d shapes requested.", order_h, order_v, factor->num_shapes, num_shapes);
+    return factor;
+  }
+
+  void ProjBasedSelector::precalc_shared_cache() {
+    for(int mode = 0; mode < H2D_NUM_MODES; mode++) {
+      //integration points and transformations
+      quad->set_mode(mode);
+      shapeset->set_mode(mode);
+      double3* gip_points = quad->get_points(H2DRS_INTR_GIP_ORDER);
+      int num_gip_points = quad->get_num_points(H2DRS_INTR_GIP_ORDER);
+      Trf* trfs = (mode == HERMES_MODE_TRIANGLE) ? tri_trf : quad_trf;
+      int num_noni_trfs = (mode == HERMES_MODE_TRIANGLE) ? H2D_TRF_TRI_NUM : H2D_TRF_QUAD_NUM;
+
+      //shape values
+      std::vector<TrfShapeExp>* svals[H2D_TRF_NUM];
+      std::vector<TrfShapeExp>* ortho_svals[H2D_TRF_NUM];
+      get_shared_shape_vals(mode, gip_points, num_gip_points, trfs, num_noni_trfs, svals, ortho_svals);
+
+      //range of orders
+      std::vector<ShapeInx>& full_shape_indices = shape_indices[mode];
+      if (full_shape_indices.empty())
+        continue;
+      int min_order = H2DRS_MAX_ORDER;
+      for(unsigned int i = 0; i < full_shape_indices.size(); i++)
+        min_order = std::min(min_order, std::max(full_shape_indices[i].order_h, full_shape_indices[i].order_v));
+      int max_order_mode = (max_order == H2DRS_DEFAULT_ORDER) ? H2DRS_MAX_ORDER : std::min(max_order, H2DRS_MAX_ORDER);
+
+      //projection matrices
+      int* shape_inxs = new int[full_shape_indices.size()];
+      for(int order_h = min_order; order_h <= max_order_mode; order_h++) {
+        for(int order_v = min_order; order_v <= max_order_mode; order_v++) {
+          if (mode == HERMES_MODE_TRIANGLE && order_h != order_v)
+            continue;
+          int num_shapes = 0;
+          for(unsigned int i = 0; i < full_shape_indices.size(); i++)
+            if (order_h >= full_shape_indices[i].order_h && order_v >= full_shape_indices[i].order_v)
+              shape_inxs[num_shapes++] = full_shape_indices[i].inx;
+          if (num_shapes > 0)
+            get_shared_proj_matrix(mode, order_h, order_v, gip_points, num_gip_points, shape_inxs, num_shapes);
+        }
+      }
+      delete[] shape_inxs;
+    }
+  }
+
+  /// Writes a key of the process-wide cache.
+  static void write_shared_cache_key(FILE* f, const std::string& selector, const int* key_ints) {
+    int len = (int)selector.size();
+    hermes_fwrite(&len, sizeof(int), 1, f);
+    hermes_fwrite(selector.c_str(), 1, len, f);
+    hermes_fwrite(key_ints, sizeof(int), 6, f);
+  }
+
+  /// Reads a key of the process-wide cache.
+  static void read_shared_cache_key(FILE* f, std::string& selector, int* key_ints) {
+    int len;
+    hermes_fread(&len, sizeof(int), 1, f);
+    if (len < 0 || len > 1024) error("Corrupted projection cache file.");
+    std::vector<char> chars(len + 1, '\0');
+    hermes_fread(&chars[0], 1, len, f);
+    selector = &chars[0];
+    hermes_fread(key_ints, sizeof(int), 6, f);
+  }
+
+  void ProjBasedSelector::save_shared_cache(const char* filename) {
+    FILE* f = fopen(filename, "wb");
+    if (f == NULL) error("Could not open %s for writing.", filename);
+
+#pragma omp critical(proj_based_selector_cache)
+    {
+      // write header
+      hermes_fwrite("H2DP\002\000\000\000", 1, 8, f);
+      int info[2] = { H2DRS_INTR_GIP_ORDER, H2D_TRF_NUM };
+      hermes_fwrite(info, sizeof(int), 2, f);
+
+      // write projection matrices
+      int num_matrices = (int)shared_cache.proj_matrices.size();
+      hermes_fwrite(&num_matrices, sizeof(int), 1, f);
+      for(std::map<SharedCacheKey, ProjMatrixFactor*>::const_iterator it = shared_cache.proj_matrices.begin(); it != shared_cache.proj_matrices.end(); it++) {
+        const SharedCacheKey& key = it->first;
+        int key_ints[6] = { key.shapeset_id, key.mode, key.order_h, key.order_v, key.trf, key.ortho ? 1 : 0 };
+        write_shared_cache_key(f, key.selector, key_ints);
+        ProjMatrixFactor* factor = it->second;
+        hermes_fwrite(&factor->num_shapes, sizeof(int), 1, f);
+        for(int i = 0; i < factor->num_shapes; i++)
+          hermes_fwrite(factor->matrix[i], sizeof(double), factor->num_shapes, f);
+        hermes_fwrite(factor->diag, sizeof(double), factor->num_shapes, f);
+        int lu = (factor->perm != NULL) ? 1 : 0;
+        hermes_fwrite(&lu, sizeof(int), 1, f);
+        if (lu)
+          hermes_fwrite(factor->perm, sizeof(int), factor->num_shapes, f);
+      }
+
+      // write shape values
+      int num_vals = (int)shared_cache.shape_vals.size();
+      hermes_fwrite(&num_vals, sizeof(int), 1, f);
+      for(std::map<SharedCacheKey, std::vector<TrfShapeExp>*>::const_iterator it = shared_cache.shape_vals.begin(); it != shared_cache.shape_vals.end(); it++) {
+        const SharedCacheKey& key = it->first;
+        int key_ints[6] = { key.shapeset_id, key.mode, key.order_h, key.order_v, key.trf, key.ortho ? 1 : 0 };
+        write_shared_cache_key(f, key.selector, key_ints);
+        std::vector<TrfShapeExp>& vals = *it->second;
+        int num_shapes = (int)vals.size();
+        hermes_fwrite(&num_shapes, sizeof(int), 1, f);
+        for(int i = 0; i < num_shapes; i++) {
+          int size[2] = { vals[i].get_num_expansion(), vals[i].get_num_gip() };
+          hermes_fwrite(size, sizeof(int), 2, f);
+          for(int k = 0; k < size[0]; k++)
+            hermes_fwrite(vals[i][k], sizeof(double), size[1], f);
+        }
+      }
+    }
+
+    fclose(f);
+  }
+
+  void ProjBasedSelector::load_shared_cache(const char* filename) {
+    FILE* f = fopen(filename, "rb");
+    if (f == NULL) error("Could not open %s", filename);
+
+    // some checks
+    char magic[8];
+    hermes_fread(magic, 1, 8, f);
+    if (memcmp(magic, "H2DP", 4) != 0)
+      error("Not a Hermes2D projection cache file.");
+    int version = magic[4];
+    if (version != 1 && version != 2)
+      error("Unsupported file version.");
+    int info[2];
+    hermes_fread(info, sizeof(int), 2, f);
+    if (info[0] != H2DRS_INTR_GIP_ORDER || info[1] != H2D_TRF_NUM)
+      error("The projection cache file %s was created with a different integration order or transformations.", filename);
+
+    std::string selector;
+    int key_ints[6];
+#pragma omp critical(proj_based_selector_cache)
+    {
+      // read projection matrices
+      int num_matrices;
+      hermes_fread(&num_matrices, sizeof(int), 1, f);
+      for(int m = 0; m < num_matrices; m++) {
+        read_shared_cache_key(f, selector, key_ints);
+        int num_shapes;
+        hermes_fread(&num_shapes, sizeof(int), 1, f);
+        if (num_shapes <= 0) error("Corrupted projection cache file.");
+        ProjMatrixFactor* factor = new ProjMatrixFactor(num_shapes);
+        for(int i = 0; i < num_shapes; i++)
+          hermes_fread(factor->matrix[i], sizeof(double), num_shapes, f);
+        hermes_fread(factor->diag, sizeof(double), num_shapes, f);
+        int lu = 0; //version 1 contains Cholesky factorizations only
+        if (version >= 2)
+          hermes_fread(&lu, sizeof(int), 1, f);
+        if (lu) {
+          factor->perm = new int[num_shapes];
+          hermes_fread(factor->perm, sizeof(int), num_shapes, f);
+        }
+
+        SharedCacheKey key(selector, key_ints[0], key_ints[1], key_ints[2], key_ints[3], key_ints[4], key_ints[5] != 0);
+        if (shared_cache.proj_matrices.find(key) == shared_cache.proj_matrices.end())
+          shared_cache.proj_matrices[key] = factor;
+        else
+          delete factor; //items are never replaced
+      }
+
+      // read shape values
+      int num_vals;
+      hermes_fread(&num_vals, sizeof(int), 1, f);
+      for(int m = 0; m < num_vals; m++) {
+        read_shared_cache_key(f, selector, key_ints);
+        int num_shapes;
+        hermes_fread(&num_shapes, sizeof(int), 1, f);
+        if (num_shapes < 0) error("Corrupted projection cache file.");
+        std::vector<TrfShapeExp>* vals = new std::vector<TrfShapeExp>(num_shapes);
+        for(int i = 0; i < num_shapes; i++) {
+          int size[2];
+          hermes_fread(size, sizeof(int), 2, f);
+          if (size[0] < 0 || size[1] < 0) error("Corrupted projection cache file.");
+          if (size[0] > 0) {
+            (*vals)[i].allocate(size[0], size[1]);
+            for(int k = 0; k < size[0]; k++)
+              hermes_fread((*vals)[i][k], sizeof(double), size[1], f);
+          }
+        }
+
+        SharedCacheKey key(selector, key_ints[0], key_ints[1], key_ints[2], key_ints[3], key_ints[4], key_ints[5] != 0);
+        if (shared_cache.shape_vals.find(key) == shared_cache.shape_vals.end())
+          shared_cache.shape_vals[key] = vals;
+        else
+          delete vals; //items are never replaced
+      }
+    }
+
+    fclose(f);
+  }
+
+  void ProjBasedSelector::clear_shared_cache() {
+#pragma omp critical(proj_based_selector_cache)
+    shared_cache.clear();
   }
 
   void ProjBasedSelector::set_error_weights(double weight_h, double weight_p, double weight_aniso) {
@@ -157,7 +498,6 @@ namespace RefinementSelectors {
     int mode = e->get_mode();
 
     // select quadrature, obtain integration points and weights
-    Quad2D* quad = &g_quad_2d_std;
     quad->set_mode(mode);
     rsln->set_quad_2d(quad);
     double3* gip_points = quad->get_points(H2DRS_INTR_GIP_ORDER);
@@ -195,29 +535,24 @@ namespace RefinementSelectors {
       num_noni_trfs = H2D_TRF_QUAD_NUM;
     }
 
-    // precalculate values of shape functions
-    TrfShape empty_shape_vals;
-    if (!cached_shape_vals_valid[mode]) {
-      precalc_ortho_shapes(gip_points, num_gip_points, trfs, num_noni_trfs, shape_indices[mode], max_shape_inx[mode], cached_shape_ortho_vals[mode]);
-      precalc_shapes(gip_points, num_gip_points, trfs, num_noni_trfs, shape_indices[mode], max_shape_inx[mode], cached_shape_vals[mode]);
-      cached_shape_vals_valid[mode] = true;
-
-      //issue a warning if ortho values are defined and the selected cand_list might benefit from that but it cannot because elements do not have uniform orders
-      if (!warn_uniform_orders && mode == HERMES_MODE_QUAD && !cached_shape_ortho_vals[mode][H2D_TRF_IDENTITY].empty()) {
-        warn_uniform_orders = true;
-        if (cand_list == H2D_H_ISO || cand_list == H2D_H_ANISO || cand_list == H2D_P_ISO || cand_list == H2D_HP_ISO || cand_list == H2D_HP_ANISO_H) {
-          warn_if(!info_h.uniform_orders || !info_aniso.uniform_orders || !info_p.uniform_orders, "Possible inefficiency: %s might be more efficient if the input mesh contains elements with uniform orders strictly.", get_cand_list_str(cand_list));
-        }
+    // obtain values of shape functions (shared by all selectors, see \ref s_shared_cache)
+    std::vector<TrfShapeExp>* svals[H2D_TRF_NUM];
+    std::vector<TrfShapeExp>* ortho_svals[H2D_TRF_NUM];
+    get_shared_shape_vals(mode, gip_points, num_gip_points, trfs, num_noni_trfs, svals, ortho_svals);
+
+    //issue a warning if ortho values are defined and the selected cand_list might benefit from that but it cannot because elements do not have uniform orders
+    if (!warn_uniform_orders && mode == HERMES_MODE_QUAD && !ortho_svals[H2D_TRF_IDENTITY]->empty()) {
+      warn_uniform_orders = true;
+      if (cand_list == H2D_H_ISO || cand_list == H2D_H_ANISO || cand_list == H2D_P_ISO || cand_list == H2D_HP_ISO || cand_list == H2D_HP_ANISO_H) {
+        warn_if(!info_h.uniform_orders || !info_aniso.uniform_orders || !info_p.uniform_orders, "Possible inefficiency: %s might be more efficient if the input mesh contains elements with uniform orders strictly.", get_cand_list_str(cand_list));
       }
     }
-    TrfShape& svals = cached_shape_vals[mode];
-    TrfShape& ortho_svals = cached_shape_ortho_vals[mode];
 
     //H-candidates
     if (!info_h.is_empty()) {
       Trf* p_trf_identity[1] = { &trfs[H2D_TRF_IDENTITY] };
-      std::vector<TrfShapeExp>* p_trf_svals[1] = { &svals[H2D_TRF_IDENTITY] };
-      std::vector<TrfShapeExp>* p_trf_ortho_svals[1] = { &ortho_svals[H2D_TRF_IDENTITY] };
+      std::vector<TrfShapeExp>* p_trf_svals[1] = { svals[H2D_TRF_IDENTITY] };
+      std::vector<TrfShapeExp>* p_trf_ortho_svals[1] = { ortho_svals[H2D_TRF_IDENTITY] };
       for(int son = 0; son < H2D_MAX_ELEMENT_SONS; son++) {
         scalar **sub_rval[1] = { rval[son] };
         calc_error_cand_element(mode, gip_points, num_gip_points
@@ -235,8 +570,8 @@ namespace RefinementSelectors {
         Trf* sub_trfs[2] = { &trfs[tr[version][0]], &trfs[tr[version][1]] };
         Element* sub_domains[2] = { base_element->sons[sons[version][0]], base_element->sons[sons[version][1]] };
         scalar **sub_rval[2] = { rval[sons[version][0]], rval[sons[version][1]] };
-        std::vector<TrfShapeExp>* sub_svals[2] = { &svals[tr[version][0]], &svals[tr[version][1]] };
-        std::vector<TrfShapeExp>* sub_ortho_svals[2] = { &ortho_svals[tr[version][0]], &ortho_svals[tr[version][1]] };
+        std::vector<TrfShapeExp>* sub_svals[2] = { svals[tr[version][0]], svals[tr[version][1]] };
+        std::vector<TrfShapeExp>* sub_ortho_svals[2] = { ortho_svals[tr[version][0]], ortho_svals[tr[version][1]] };
         calc_error_cand_element(mode, gip_points, num_gip_points
           , 2, sub_domains, sub_trfs, sub_rval
           , sub_svals, sub_ortho_svals
@@ -248,8 +583,8 @@ namespace RefinementSelectors {
     if (!info_p.is_empty()) {
       Trf* sub_trfs[4] = { &trfs[0], &trfs[1], &trfs[2], &trfs[3] };
       scalar **sub_rval[4] = { rval[0], rval[1], rval[2], rval[3] };
-      std::vector<TrfShapeExp>* sub_svals[4] = { &svals[0], &svals[1], &svals[2], &svals[3] };
-      std::vector<TrfShapeExp>* sub_ortho_svals[4] = { &ortho_svals[0], &ortho_svals[1], &ortho_svals[2], &ortho_svals[3] };
+      std::vector<TrfShapeExp>* sub_svals[4] = { svals[0], svals[1], svals[2], svals[3] };
+      std::vector<TrfShapeExp>* sub_ortho_svals[4] = { ortho_svals[0], ortho_svals[1], ortho_svals[2], ortho_svals[3] };
 
       calc_error_cand_element(mode, gip_points, num_gip_points
         , 4, base_element->sons, sub_trfs, sub_rval
@@ -269,10 +604,7 @@ namespace RefinementSelectors {
     int max_num_shapes = next_order_shape[mode][current_max_order];
     scalar* right_side = new scalar[max_num_shapes];
     int* shape_inxs = new int[max_num_shapes];
-    int* indx = new int[max_num_shapes]; //solver data
-    double* d = new double[max_num_shapes]; //solver data
-    double** proj_matrix = new_matrix<double>(max_num_shapes, max_num_shapes);
-    ProjMatrixCache& proj_matrices = proj_matrix_cache[mode];
+    const ProjMatrixFactor* proj_matrix = NULL;
     std::vector<ShapeInx>& full_shape_indices = shape_indices[mode];
 
     //check whether ortho-svals are available
@@ -315,12 +647,10 @@ namespace RefinementSelectors {
         std::vector< ValueCacheItem<scalar> >& rhs_cache = use_ortho ? ortho_rhs_cache : nonortho_rhs_cache;
         std::vector<TrfShapeExp>** sub_svals = use_ortho ? sub_ortho_svals : sub_nonortho_svals;
 
-        //calculate projection matrix iff no ortho is used
+        //obtain factorized projection matrix iff no ortho is used
         if (!use_ortho) {
           //error_if(!use_ortho, "Non-ortho"); //DEBUG
-          if (proj_matrices[order_h][order_v] == NULL)
-            proj_matrices[order_h][order_v] = build_projection_matrix(gip_points, num_gip_points, shape_inxs, num_shapes);
-          copy_matrix(proj_matrix, proj_matrices[order_h][order_v], num_shapes, num_shapes); //copy projection matrix because original matrix will be modified
+          proj_matrix = get_shared_proj_matrix(mode, order_h, order_v, gip_points, num_gip_points, shape_inxs, num_shapes);
         }
 
         //build right side (fill cache values that are missing)
@@ -351,8 +681,7 @@ namespace RefinementSelectors {
         //solve iff no ortho is used
         if (!use_ortho) {
           //error_if(!use_ortho, "Non-ortho"); //DEBUG
-          ludcmp(proj_matrix, num_shapes, indx, d);
-          lubksb<scalar>(proj_matrix, num_shapes, indx, right_side);
+          proj_matrix->solve<scalar>(right_side);
         }
 
         //calculate error
@@ -370,11 +699,8 @@ namespace RefinementSelectors {
     } while (order_perm.next());
 
     //clenaup
-    delete[] proj_matrix;
     delete[] right_side;
     delete[] shape_inxs;
-    delete[] indx;
-    delete[] d;
   }
 
 }
@@ -20,6 +20,8 @@
 #include "../../../hermes_common/matrix.h"
 #include "optimum_selector.h"
 
+class Quad2D;
+
 namespace RefinementSelectors {
   /// Error of an element of a candidate for various permutations of orders. \ingroup g_selectors
   /** If not noted otherwise, the first index is the horizontal order, the second index is the vertical order.
@@ -44,6 +46,17 @@ namespace RefinementSelectors {
    *  - build_projection_matrix()
    *  - evaluate_rhs_subdomain()
    *  - evaluate_error_squared_subdomain()
+   *
+   *  \section s_shared_cache Process-wide cache
+   *  Values of shape functions at integration points and factorizations of projection matrices
+   *  are stored in a cache which is shared by all selectors in the process. An item of the cache
+   *  is identified by the class of the selector, the ID of the shapeset, the mode, the orders (projection matrices),
+   *  and the transformation (shape values). Therefore, the results of precalc_shapes(), precalc_ortho_shapes(),
+   *  and build_projection_matrix() have to depend only on the class of the selector and on the shapeset.
+   *  Items are calculated when they are used for the first time and they are never modified later.
+   *  Items of the orders up to ::H2DRS_MAX_ORDER are also indexed by integers, so that a selector reads them without a lock.
+   *  The cache can be filled in advance (precalc_shared_cache()) and saved to a file (save_shared_cache())
+   *  which is loaded at startup (load_shared_cache()).
    */
   class HERMES_API ProjBasedSelector : public OptimumSelector {
   public: //API
@@ -63,6 +76,25 @@ namespace RefinementSelectors {
     double get_error_weight_p() { return error_weight_p; };
     double get_error_weight_aniso() { return error_weight_aniso; };
 
+  public: //process-wide cache
+    /// Calculates shape values and projection matrices of all orders allowed by this selector and stores them in the process-wide cache.
+    /** See \ref s_shared_cache. */
+    void precalc_shared_cache();
+
+    /// Saves the process-wide cache to a file.
+    /** See \ref s_shared_cache.
+     *  \param[in] filename A name of the file. */
+    static void save_shared_cache(const char* filename);
+
+    /// Loads items of the process-wide cache from a file created by save_shared_cache().
+    /** Items which are already present in the cache are kept. See \ref s_shared_cache.
+     *  \param[in] filename A name of the file. */
+    static void load_shared_cache(const char* filename);
+
+    /// Removes all items of the process-wide cache.
+    /** Selectors must not be selecting refinements while the cache is cleared. */
+    static void clear_shared_cache();
+
   protected: //evaluated shape basis
     /// A transform shaped function expansions.
     /** The contents of the class can be accessed through an array index operator.
@@ -108,6 +140,12 @@ namespace RefinementSelectors {
       /** \return True if the instance is empty, i.e., the method allocate() was not called yet. */
       inline bool empty() { return values == NULL; };
 
+      /// Returns a number of expansions.
+      inline int get_num_expansion() const { return num_expansion; };
+
+      /// Returns a number of integration points.
+      inline int get_num_gip() const { return num_gip; };
+
       /// Assignment operator. Prevent unauthorized copying of the pointer.
       /** This method prevents a user from copying allocated internal structures
        *  because C++ does not support garbage collection. */
@@ -121,10 +159,6 @@ namespace RefinementSelectors {
     /// Evaluated shapes for all possible transformations for all points. The first index is a transformation, the second index is an index of a shape function.
     typedef std::vector<TrfShapeExp> TrfShape[H2D_TRF_NUM];
 
-    bool cached_shape_vals_valid[H2D_NUM_MODES]; ///< True if shape values were already initialized.
-    TrfShape cached_shape_ortho_vals[H2D_NUM_MODES]; ///< Precalculated valus of orthogonalized shape functions.
-    TrfShape cached_shape_vals[H2D_NUM_MODES]; ///< Precalculate values of shape functions.
-
     /// Calculates values of shape function at GIP for all transformations.
     /** Override this method to supply a pre-calculated vales of shape function expansions
      *  at integration points. If override, the method has to supply precalculate expansions
@@ -164,7 +198,7 @@ namespace RefinementSelectors {
 
   protected:
     /// Constructor.
-    /** Intializes attributes, projection matrix cache (ProjBasedSelector::proj_matrix_cache), and allocates rhs cache (ProjBasedSelector::rhs_cache).
+    /** Intializes attributes and allocates rhs cache (ProjBasedSelector::rhs_cache).
      *  \param[in] cand_list A predefined list of candidates.
      *  \param[in] conv_exp A conversion exponent, see evaluate_cands_score().
      *  \param[in] max_order A maximum order which considered. If ::H2DRS_DEFAULT_ORDER, a maximum order supported by the selector is used.
@@ -181,6 +215,109 @@ namespace RefinementSelectors {
      *  order to gain efficiency. */
     bool warn_uniform_orders;
 
+  protected: //process-wide cache
+    /// A key of an item of the process-wide cache.
+    /** Items of projection matrices have \a trf equal to -1, items of shape values have \a order_h and \a order_v equal to -1. */
+    struct SharedCacheKey {
+      std::string selector; ///< A name of the class of the selector (typeid).
+      int shapeset_id; ///< An ID of the shapeset.
+      int mode; ///< A mode (see the enum ElementMode2D).
+      int order_h; ///< A horizontal order.
+      int order_v; ///< A vertical order.
+      int trf; ///< An index of the transformation.
+      bool ortho; ///< True if values of orthonormalized shape functions are stored.
+      SharedCacheKey(const std::string& selector, int shapeset_id, int mode, int order_h, int order_v, int trf, bool ortho)
+        : selector(selector), shapeset_id(shapeset_id), mode(mode), order_h(order_h), order_v(order_v), trf(trf), ortho(ortho) {};
+      bool operator<(const SharedCacheKey& other) const;
+    };
+
+    /// A factorization of a projection matrix.
+    /** The matrix is factorized by Cholesky. If it is not positive definite in the floating-point arithmetic,
+     *  it is factorized by LU with partial pivoting instead. */
+    struct ProjMatrixFactor {
+      int num_shapes; ///< A size of the matrix.
+      double** matrix; ///< The matrix. Cholesky: the lower triangle contains the factor (without the diagonal), the upper triangle contains the original matrix. LU: the output of ludcmp(). Allocated through new_matrix().
+      double* diag; ///< A diagonal of the Cholesky factor.
+      int* perm; ///< A row permutation of the LU factorization (see ludcmp()). NULL if the matrix is factorized by Cholesky.
+      ProjMatrixFactor(int num_shapes) : num_shapes(num_shapes), matrix(new_matrix<double>(num_shapes, num_shapes)), diag(new double[num_shapes]), perm(NULL) {};
+      ~ProjMatrixFactor() { delete[] matrix; delete[] diag; delete[] perm; };
+      void factorize(); ///< Factorizes the matrix which is stored in the upper triangle of \a matrix.
+      /// Solves the system with the factorized matrix, the solution overwrites \a right_side.
+      template<typename T>
+      void solve(T* right_side) const {
+        if (perm == NULL)
+          cholsl<T>(matrix, num_shapes, diag, right_side, right_side);
+        else
+          lubksb<T>(matrix, num_shapes, perm, right_side);
+      };
+    };
+
+    /// Values of shape functions of all transformations of one mode, see get_shared_shape_vals().
+    struct SharedShapeVals {
+      std::vector<TrfShapeExp>* svals[H2D_TRF_NUM]; ///< Values of shape functions.
+      std::vector<TrfShapeExp>* ortho_svals[H2D_TRF_NUM]; ///< Values of orthonormalized shape functions.
+    };
+
+#define H2DRS_MAX_CACHE_KINDS 16 ///< A maximum number of kinds of selectors (a class and a shapeset) whose items of the process-wide cache are indexed by integers. \ingroup g_selectors
+
+    /// Items of the process-wide cache of one kind of selectors (a class and a shapeset) indexed by integers.
+    /** An entry is written only once the item is complete and it is not modified until the cache is cleared,
+     *  therefore the entries are read without a lock, a reader only flushes after it finds an entry. The items are owned by SharedCache::proj_matrices and SharedCache::shape_vals. */
+    struct SharedCacheTable {
+      SharedShapeVals* shape_vals[H2D_NUM_MODES]; ///< Shape values (owned by the table, the vectors are not).
+      ProjMatrixFactor* proj_matrices[H2D_NUM_MODES][H2DRS_MAX_ORDER + 1][H2DRS_MAX_ORDER + 1]; ///< Projection matrices indexed by the mode and the orders.
+    };
+
+    /// The process-wide cache.
+    /** Maps are accessed in the critical section proj_based_selector_cache and their items are never modified after they were inserted.
+     *  The tables are read without a lock. */
+    class SharedCache {
+    public:
+      std::map<SharedCacheKey, ProjMatrixFactor*> proj_matrices; ///< Factorized projection matrices.
+      std::map<SharedCacheKey, std::vector<TrfShapeExp>*> shape_vals; ///< Values of shape functions at integration points.
+      std::map<std::pair<std::string, int>, int> kinds; ///< Indices of tables of kinds of selectors (a name of the class and an ID of the shapeset).
+      SharedCacheTable tables[H2DRS_MAX_CACHE_KINDS]; ///< Items indexed by integers, one table per a kind of selectors.
+      ~SharedCache() { clear(); };
+      void clear(); ///< Removes all items.
+    };
+    static SharedCache shared_cache; ///< The process-wide cache.
+
+    int cache_kind; ///< An index of the table of this selector in SharedCache::tables. -1 if not known yet, -2 if all tables are used by other kinds.
+
+    /// Returns an index of the table of this selector in SharedCache::tables, or -2 if no table is available.
+    int get_cache_kind();
+
+    /// Returns values of shape functions at integration points for all transformations. Missing values are calculated and stored in the process-wide cache.
+    /** \param[in] mode A mode (see the enum ElementMode2D).
+     *  \param[in] gip_points Integration points.
+     *  \param[in] num_gip_points A number of integration points.
+     *  \param[in] trfs Transformations. The array has ::H2D_TRF_NUM elements.
+     *  \param[in] num_noni_trfs A number of transformations which are not identity.
+     *  \param[out] svals Values of shape functions for every transformation. An array is empty if values are not available.
+     *  \param[out] ortho_svals Values of orthonormalized shape functions for every transformation. An array is empty if values are not available. */
+    void get_shared_shape_vals(int mode, const double3* gip_points, int num_gip_points, const Trf* trfs, int num_noni_trfs, std::vector<TrfShapeExp>* svals[H2D_TRF_NUM], std::vector<TrfShapeExp>* ortho_svals[H2D_TRF_NUM]);
+
+    /// Returns a factorized projection matrix. A missing matrix is calculated and stored in the process-wide cache.
+    /** \param[in] mode A mode (see the enum ElementMode2D).
+     *  \param[in] order_h A horizontal order.
+     *  \param[in] order_v A vertical order.
+     *  \param[in] gip_points Integration points.
+     *  \param[in] num_gip_points A number of integration points.
+     *  \param[in] shape_inx Indices of shape functions of the given orders.
+     *  \param[in] num_shapes A number of shape functions.
+     *  \return A factorized projection matrix. */
+    const ProjMatrixFactor* get_shared_proj_matrix(int mode, int order_h, int order_v, double3* gip_points, int num_gip_points, const int* shape_inx, int num_shapes);
+
+  protected: //concurrent selection
+    Quad2D* quad; ///< A quadrature used to evaluate errors. A clone has its own instance because the quadrature keeps a mode of the examined element.
+
+    /// Initializes a selector created by clone().
+    /** Copies options and error weights of a given selector. The process-wide cache (ProjBasedSelector::shared_cache)
+     *  is filled in a critical section. The remaining state (candidates, rhs caches, values of the reference solution) is private to every clone.
+     *  The clone has to use its own instance of the shapeset because the shapeset keeps a mode of the examined element.
+     *  \param[in] master A selector which is cloned. */
+    void init_clone(ProjBasedSelector* master);
+
   protected: //error evaluation
 #define H2DRS_VALCACHE_INVALID 0 ///< State of value cache: item contains undefined or invalid value. \ingroup g_selectors
 #define H2DRS_VALCACHE_VALID 1 ///< State of value cache: item contains a valid value. \ingroup g_selectors
@@ -213,18 +350,6 @@ namespace RefinementSelectors {
       T value; ///< A value stored in the item.
       int state; ///< A state of the image: ::H2DRS_VALCACHE_INVALID or ::H2DRS_VALCACHE_VALID or any other user-defined value. The first user defined state has to have number ::H2DRS_VALCACHE_USER.
     };
-    /// A projection matrix cache type.
-    /** Defines a cache of projection matrices for all possible permutations of orders. */
-    typedef double** ProjMatrixCache[H2DRS_MAX_ORDER+2][H2DRS_MAX_ORDER+2];
-
-    /// An array of projection matrices.
-    /** The first index is the mode (see the enum ElementMode2D). The second and the third index
-     *  is the horizontal and the vertical order respectively.
-     *
-     *  All matrices are square dense matrices and they have to be created through the function new_matrix().
-     *  If record is NULL, the corresponding matrix has to be calculated. */
-    ProjMatrixCache proj_matrix_cache[H2D_NUM_MODES];
-
     /// An array of cached right-hand side values.
     /** The first index is an index of the shape function.
      *
@@ -327,7 +452,8 @@ namespace RefinementSelectors {
      *  \param[in] num_gip_points A number of integration points.
      *  \param[in] shape_inx An array of shape indices.
      *  \param[in] num_shapes A number of shape indices in the array.
-     *  \return A projection matrix. The matrix has to be allocated trought new_matrix(). The size of the matrix has to be \a num_shapes x \a num_shapes. */
+     *  \return A projection matrix. The matrix has to be allocated trought new_matrix(). The size of the matrix has to be \a num_shapes x \a num_shapes.
+     *          The matrix has to be symmetric. It is factorized through choldc(), or through ludcmp() if it is not positive definite. */
     virtual double** build_projection_matrix(double3* gip_points, int num_gip_points, const int* shape_inx, const int num_shapes) = 0;
 
     /// Evaluates a value of the right-hande side in a subdomain.
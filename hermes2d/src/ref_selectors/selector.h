@@ -89,6 +89,13 @@ namespace RefinementSelectors {
      *  \param[out] tgt_quad_orders Generated encoded orders.
      *  \param[in] suggested_quad_orders Suggested encoded orders. If not NULL, the method should copy them to the output. If NULL, the method have to calculate orders. */
     virtual void generate_shared_mesh_orders(const Element* element, const int orig_quad_order, const int refinement, int tgt_quad_orders[H2D_MAX_ELEMENT_SONS], const int* suggested_quad_orders) = 0;
+
+    /// Creates a selector which can select refinements concurrently with this selector.
+    /** Used by Adapt::adapt() to select refinements by several threads, see Adapt::set_num_threads().
+     *  The returned selector has to select the same refinements as this selector. It may share data with this selector,
+     *  it is deleted by the caller before this selector.
+     *  \return A new selector. NULL if the selector does not support a concurrent selection, the refinements are then selected serially. */
+    virtual Selector* clone() { return NULL; };
   };
 
   /// A selector that selects H-refinements only. \ingroup g_selectors
@@ -105,6 +112,10 @@ namespace RefinementSelectors {
     /** If a parameter suggested_quad_orders is NULL, the method uses an encoded order in orig_quad_order.
      *  For details, see Selector::generate_shared_mesh_orders. */
     virtual void generate_shared_mesh_orders(const Element* element, const int orig_quad_order, const int refinement, int tgt_quad_orders[H2D_MAX_ELEMENT_SONS], const int* suggested_quad_orders);
+
+    /// Creates a selector which can select refinements concurrently with this selector.
+    /** For details, see Selector::clone(). */
+    virtual Selector* clone() { return new HOnlySelector(); };
   };
 
   /// A selector that increases order (i.e., it selects P-refinements only). \ingroup g_selectors
@@ -126,6 +137,10 @@ namespace RefinementSelectors {
     /** If a parameter suggested_quad_orders is NULL, the method uses an encoded order in orig_quad_order.
      *  For details, see Selector::generate_shared_mesh_orders. */
     virtual void generate_shared_mesh_orders(const Element* element, const int orig_quad_order, const int refinement, int tgt_quad_orders[H2D_MAX_ELEMENT_SONS], const int* suggested_quad_orders);
+
+    /// Creates a selector which can select refinements concurrently with this selector.
+    /** For details, see Selector::clone(). */
+    virtual Selector* clone() { return new POnlySelector(max_order, order_h_inc, order_v_inc); };
   };
 }
 
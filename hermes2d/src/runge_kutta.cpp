@@ -18,7 +18,8 @@
 
 RungeKutta::RungeKutta(DiscreteProblem* dp, ButcherTable* bt, MatrixSolverType matrix_solver, bool start_from_zero_K_vector, bool residual_as_vector) 
     : dp(dp), is_linear(dp->get_is_linear()), bt(bt), num_stages(bt->get_size()), stage_wf_right(bt->get_size() * dp->get_spaces().size()), 
-    stage_wf_left(dp->get_spaces().size()), start_from_zero_K_vector(start_from_zero_K_vector), residual_as_vector(residual_as_vector), iteration(0) 
+    stage_wf_left(dp->get_spaces().size()), stage_dp_left(NULL), stage_dp_right(NULL), stage_ndof(dp->get_num_dofs()), 
+    start_from_zero_K_vector(start_from_zero_K_vector), residual_as_vector(residual_as_vector), iteration(0) 
 {
   // Check for not implemented features.
   if (matrix_solver != SOLVER_UMFPACK)
@@ -40,6 +41,7 @@ RungeKutta::RungeKutta(DiscreteProblem* dp, ButcherTable* bt, MatrixSolverType m
 
 RungeKutta::~RungeKutta()
 {
+  delete_stage_context();
   delete solver;
   delete [] K_vector;
   delete [] u_ext_vec;
@@ -79,31 +81,11 @@ bool RungeKutta::rk_time_step(double current_time, double time_step, Hermes::vec
   if(error_fns != Hermes::vector<Solution*>() && bt->is_embedded() == false)
     error("rk_time_step(): R-K method must be embedded if temporal error estimate is requested.");
 
-  // All Spaces of the problem.
-  Hermes::vector<Space*> stage_spaces_vector;
-
-  // Create spaces for stage solutions K_i. This is necessary
-  // to define a num_stages x num_stages block weak formulation.
-  for (unsigned int i = 0; i < num_stages; i++)
-    for(unsigned int space_i = 0; space_i < dp->get_spaces().size(); space_i++)
-      stage_spaces_vector.push_back(dp->get_space(space_i)->dup(dp->get_space(space_i)->get_mesh()));
+  // Create or update the stage spaces, weak formulation, discrete problems and the mass matrix.
+  bool new_context = update_stage_context(current_time, time_step, slns_time_prev);
 
   int ndof = dp->get_num_dofs();
 
-  // Creates the stage weak formulation.
-  create_stage_wf(dp->get_spaces().size(), current_time, time_step, slns_time_prev);
-
-  // The tensor discrete problem is created in two parts. First, matrix_left is the Jacobian 
-  // matrix of the term coming from the left-hand side of the RK formula k_i = f(...). This is 
-  // a block-diagonal mass matrix. The corresponding part of the residual is obtained by multiplying
-  // this block mass matrix with the tensor vector K. Next, matrix_right and vector_right are the Jacobian 
-  // matrix and residula vector coming from the function f(...). Of course the RK equation is assumed
-  // in a form suitable for the Newton's method: k_i - f(...) = 0. At the end, matrix_left and vector_left
-  // are added to matrix_right and vector_right, respectively.
-  DiscreteProblem stage_dp_left(&stage_wf_left, dp->get_spaces());
-  DiscreteProblem stage_dp_right(&stage_wf_right, stage_spaces_vector);
-  stage_dp_right.set_RK(dp->get_spaces().size());
-
   // Prepare residuals of stage solutions.
   Hermes::vector<Solution*> residuals_vector;
   // A technical workabout.
@@ -115,18 +97,12 @@ bool RungeKutta::rk_time_step(double current_time, double time_step, Hermes::vec
     }
   }
 
-  // Zero utility vectors.
-  if(start_from_zero_K_vector || !iteration)
+  // Zero utility vectors (the last K_vector is of no use with new spaces).
+  if(start_from_zero_K_vector || !iteration || new_context)
     memset(K_vector, 0, num_stages * ndof * sizeof(scalar));
   memset(u_ext_vec, 0, num_stages * ndof * sizeof(scalar));
   memset(vector_left, 0, num_stages * ndof * sizeof(scalar));
 
-  // Assemble the block-diagonal mass matrix M of size ndof times ndof.
-  // The corresponding part of the global residual vector is obtained 
-  // just by multiplication with the stage vector K.
-  // FIXME: This should not be repeated if spaces have not changed.
-  stage_dp_left.assemble(&matrix_left, NULL);
-
   // The Newton's loop.
   double residual_norm;
   int it = 1;
@@ -142,7 +118,7 @@ bool RungeKutta::rk_time_step(double current_time, double time_step, Hermes::vec
     // can be added later.
     bool force_diagonal_blocks = true;
     bool add_dir_lift = false;
-    stage_dp_right.assemble(u_ext_vec, NULL, &vector_right, force_diagonal_blocks, add_dir_lift);
+    stage_dp_right->assemble(u_ext_vec, NULL, &vector_right, force_diagonal_blocks, add_dir_lift);
 
     // Finalizing the residual vector.
     vector_right.add_vector(vector_left);
@@ -157,7 +133,7 @@ bool RungeKutta::rk_time_step(double current_time, double time_step, Hermes::vec
       residual_norm = hermes2d.get_l2_norm(&vector_right);
     else {
       // Translate residual vector into residual functions.
-      Solution::vector_to_solutions(&vector_right, stage_dp_right.get_spaces(), residuals_vector, add_dir_lift);
+      Solution::vector_to_solutions(&vector_right, stage_dp_right->get_spaces(), residuals_vector, add_dir_lift);
       residual_norm = hermes2d.calc_norms(residuals_vector);
     }
 
@@ -188,7 +164,7 @@ bool RungeKutta::rk_time_step(double current_time, double time_step, Hermes::vec
       // Assemble the block Jacobian matrix of the stationary residual F
       // Diagonal blocks are created even if empty, so that matrix_left
       // can be added later.
-      stage_dp_right.assemble(u_ext_vec, &matrix_right, NULL, force_diagonal_blocks, add_dir_lift);
+      stage_dp_right->assemble(u_ext_vec, &matrix_right, NULL, force_diagonal_blocks, add_dir_lift);
 
       // Adding the block mass matrix M to matrix_right. This completes the 
       // resulting tensor Jacobian.
@@ -242,10 +218,6 @@ bool RungeKutta::rk_time_step(double current_time, double time_step, Hermes::vec
     Solution::vector_to_solutions(coeff_vec, dp->get_spaces(), error_fns, add_dir_lift);
   }
 
-  // Delete stage spaces.
-  for (unsigned int i = 0; i < num_stages; i++) 
-    delete stage_spaces_vector[i];
-
   // Delete all residuals.
   for (unsigned int i = 0; i < num_stages; i++) 
     delete residuals_vector[i];
@@ -282,6 +254,117 @@ bool RungeKutta::rk_time_step(double current_time, double time_step, Solution* s
     newton_damping_coeff, newton_max_allowed_residual_norm);
 }
 
+bool RungeKutta::update_stage_context(double current_time, double time_step, Hermes::vector<Solution*> slns_time_prev)
+{
+  // Reuse the context if neither the spaces nor their meshes have changed.
+  unsigned int num_spaces = dp->get_spaces().size();
+  bool up_to_date = (stage_dp_right != NULL && stage_ndof == dp->get_num_dofs()
+                     && stage_wf_seq == dp->get_weak_formulation()->get_seq());
+  for (unsigned int i = 0; i < num_spaces && up_to_date; i++)
+    if (dp->get_space(i)->get_seq() != stage_sp_seq[i] || dp->get_space(i)->get_mesh()->get_seq() != stage_mesh_seq[i])
+      up_to_date = false;
+
+  if (up_to_date) {
+    update_stage_wf(current_time, time_step, slns_time_prev);
+    return false;
+  }
+
+  delete_stage_context();
+
+  // Utility vectors of the new size.
+  int ndof = dp->get_num_dofs();
+  if (ndof != stage_ndof) {
+    delete [] K_vector;
+    delete [] u_ext_vec;
+    delete [] vector_left;
+    K_vector = new scalar[num_stages * ndof];
+    u_ext_vec = new scalar[num_stages * ndof];
+    vector_left = new scalar[num_stages * ndof];
+    stage_ndof = ndof;
+  }
+
+  // Create spaces for stage solutions K_i. This is necessary
+  // to define a num_stages x num_stages block weak formulation.
+  for (unsigned int i = 0; i < num_stages; i++)
+    for(unsigned int space_i = 0; space_i < num_spaces; space_i++)
+      stage_spaces_vector.push_back(dp->get_space(space_i)->dup(dp->get_space(space_i)->get_mesh()));
+
+  // Creates the stage weak formulation.
+  create_stage_wf(num_spaces, current_time, time_step, slns_time_prev);
+
+  // The tensor discrete problem is created in two parts. First, matrix_left is the Jacobian 
+  // matrix of the term coming from the left-hand side of the RK formula k_i = f(...). This is 
+  // a block-diagonal mass matrix. The corresponding part of the residual is obtained by multiplying
+  // this block mass matrix with the tensor vector K. Next, matrix_right and vector_right are the Jacobian 
+  // matrix and residula vector coming from the function f(...). Of course the RK equation is assumed
+  // in a form suitable for the Newton's method: k_i - f(...) = 0. At the end, matrix_left and vector_left
+  // are added to matrix_right and vector_right, respectively.
+  stage_dp_left = new DiscreteProblem(&stage_wf_left, dp->get_spaces());
+  stage_dp_right = new DiscreteProblem(&stage_wf_right, stage_spaces_vector);
+  stage_dp_right->set_RK(num_spaces);
+
+  // Assemble the block-diagonal mass matrix M of size ndof times ndof.
+  // The corresponding part of the global residual vector is obtained 
+  // just by multiplication with the stage vector K.
+  stage_dp_left->assemble(&matrix_left, NULL);
+
+  stage_wf_seq = dp->get_weak_formulation()->get_seq();
+  stage_sp_seq.clear();
+  stage_mesh_seq.clear();
+  for (unsigned int i = 0; i < num_spaces; i++) {
+    stage_sp_seq.push_back(dp->get_space(i)->get_seq());
+    stage_mesh_seq.push_back(dp->get_space(i)->get_mesh()->get_seq());
+  }
+  return true;
+}
+
+void RungeKutta::delete_stage_context()
+{
+  if (stage_dp_left != NULL) delete stage_dp_left;
+  if (stage_dp_right != NULL) delete stage_dp_right;
+  stage_dp_left = stage_dp_right = NULL;
+
+  // Delete stage spaces.
+  for (unsigned int i = 0; i < stage_spaces_vector.size(); i++) 
+    delete stage_spaces_vector[i];
+  stage_spaces_vector.clear();
+}
+
+void RungeKutta::update_stage_wf(double current_time, double time_step, Hermes::vector<Solution*> slns_time_prev)
+{
+  // The stage of a form is given by its block row, the previous 
+  // time level solutions are the last external functions.
+  unsigned int num_spaces = dp->get_spaces().size();
+  unsigned int num_prev = slns_time_prev.size();
+
+  for (unsigned int m = 0; m < stage_wf_right.mfvol.size(); m++) {
+    WeakForm::MatrixFormVol* mfv = stage_wf_right.mfvol[m];
+    mfv->scaling_factor = -time_step * bt->get_A(mfv->i / num_spaces, mfv->j / num_spaces);
+    mfv->set_current_stage_time(current_time + bt->get_C(mfv->i / num_spaces)*time_step);
+    for (unsigned int k = 0; k < num_prev; k++)
+      mfv->ext[mfv->ext.size() - num_prev + k] = slns_time_prev[k];
+  }
+  for (unsigned int m = 0; m < stage_wf_right.mfsurf.size(); m++) {
+    WeakForm::MatrixFormSurf* mfs = stage_wf_right.mfsurf[m];
+    mfs->scaling_factor = -time_step * bt->get_A(mfs->i / num_spaces, mfs->j / num_spaces);
+    mfs->set_current_stage_time(current_time + bt->get_C(mfs->i / num_spaces)*time_step);
+    for (unsigned int k = 0; k < num_prev; k++)
+      mfs->ext[mfs->ext.size() - num_prev + k] = slns_time_prev[k];
+  }
+  for (unsigned int m = 0; m < stage_wf_right.vfvol.size(); m++) {
+    WeakForm::VectorFormVol* vfv = stage_wf_right.vfvol[m];
+    vfv->set_current_stage_time(current_time + bt->get_C(vfv->i / num_spaces)*time_step);
+    for (unsigned int k = 0; k < num_prev; k++)
+      vfv->ext[vfv->ext.size() - num_prev + k] = slns_time_prev[k];
+  }
+  for (unsigned int m = 0; m < stage_wf_right.vfsurf.size(); m++) {
+    WeakForm::VectorFormSurf* vfs = stage_wf_right.vfsurf[m];
+    vfs->set_current_stage_time(current_time + bt->get_C(vfs->i / num_spaces)*time_step);
+    for (unsigned int k = 0; k < num_prev; k++)
+      vfs->ext[vfs->ext.size() - num_prev + k] = slns_time_prev[k];
+  }
+}
+
 void RungeKutta::create_stage_wf(unsigned int size, double current_time, double time_step, Hermes::vector<Solution*> slns_time_prev) 
 {
   // Clear the WeakForms.
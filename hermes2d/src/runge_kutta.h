@@ -55,10 +55,6 @@
 //     now, the sparsity structure is created expensively in each block 
 //     again.
 //
-// (7) If space does not change, the sparsity does not change. Right now 
-//     we discard everything at the end of every time step, we should not 
-//     do it.  
-//
 // (8) If the problem does not depend explicitly on time, then all the blocks 
 //     in the Jacobian matrix of the stationary residual are the same up 
 //     to a multiplicative constant. Thus they do not have to be aassembled 
@@ -128,6 +124,19 @@ protected:
   /// Below, "stage_wf_left" and "stage_wf_right" refer to the left-hand side
   /// and right-hand side of the equation, respectively.
   void create_stage_wf(unsigned int size, double current_time, double time_step, Hermes::vector<Solution*> slns_time_prev);
+
+  /// Sets the time step, the stage times and the previous time level solutions
+  /// in the forms of an existing stage weak formulation.
+  void update_stage_wf(double current_time, double time_step, Hermes::vector<Solution*> slns_time_prev);
+
+  /// Creates the stage spaces, weak formulations and discrete problems and assembles
+  /// the mass matrix if the spaces of dp have changed since the last time step (or
+  /// in the first one). Otherwise only updates the stage weak formulation. Returns true
+  /// if the context was created.
+  bool update_stage_context(double current_time, double time_step, Hermes::vector<Solution*> slns_time_prev);
+
+  /// Deletes the stage spaces and discrete problems.
+  void delete_stage_context();
   
   // Prepare u_ext_vec.
   void prepare_u_ext_vec(double time_step);
@@ -161,6 +170,15 @@ protected:
   WeakForm stage_wf_right;    // For the main part equation (written on the right),
                               // size num_stages*ndof times num_stages*ndof.
   WeakForm stage_wf_left;     // For the matrix M (size ndof times ndof).
+
+  /// Stage context, kept between time steps while the spaces do not change.
+  Hermes::vector<Space*> stage_spaces_vector;  // Copies of the spaces of dp for every stage.
+  DiscreteProblem* stage_dp_left;              // Mass matrix.
+  DiscreteProblem* stage_dp_right;             // Stage residual and Jacobian.
+  std::vector<int> stage_sp_seq;               // Sequence numbers of the spaces of dp
+  std::vector<unsigned> stage_mesh_seq;        // and of their meshes in the context.
+  int stage_wf_seq;                            // Sequence number of the weak form of dp.
+  int stage_ndof;                              // Number of DOFs in the context.
   
   bool start_from_zero_K_vector;
 
@@ -127,36 +127,55 @@ double* Shapeset::calculate_constrained_edge_combination(int order, int part, in
 double* Shapeset::get_constrained_edge_combination(int order, int part, int ori, int& nitems)
 {
   int index = 2*((max_order + 1 - ebias)*part + (order - ebias)) + ori;
+  nitems = order + 1 - ebias;
 
-  // allocate/reallocate the array if necessary
-  if (comb_table == NULL)
-  {
-    table_size = 1024;
-    while (table_size <= index) table_size *= 2;
-    comb_table = (double**) malloc(table_size * sizeof(double*));
-    memset(comb_table, 0, table_size * sizeof(double*));
-  }
-  else if (index >= table_size)
-  {
-    // adjust table_size to accommodate the required depth
-    int old_size = table_size;
-    while (index >= table_size) table_size *= 2;
-
-    // reallocate the table
-    verbose("Shapeset::get_constrained_edge_combination(): realloc to table_size=%d", table_size);
-    comb_table = (double**) realloc(comb_table, table_size * sizeof(double*));
-    memset(comb_table + old_size, 0,(table_size - old_size) * sizeof(double*));
-  }
+  // a published table is never modified except for filling its empty slots,
+  // so a cached combination can be returned without taking the lock
+  CombTable* table = comb_table;
+  if (table != NULL && index < table->size && table->comb[index] != NULL)
+    return table->comb[index];
 
-  // do we have the required linear combination yet?
-  if (comb_table[index] == NULL)
+  double* comb;
+#ifdef _OPENMP
+  #pragma omp critical (shapeset_comb_table)
+#endif
   {
-    // no, calculate it
-    comb_table[index] = calculate_constrained_edge_combination(order, part, ori);
+    // allocate a larger table if necessary
+    if (comb_table == NULL || index >= comb_table->size)
+    {
+      int old_size = (comb_table != NULL) ? comb_table->size : 0;
+      table = new CombTable;
+      table->size = (old_size > 0) ? old_size : 1024;
+      while (table->size <= index) table->size *= 2;
+      verbose("Shapeset::get_constrained_edge_combination(): table_size=%d", table->size);
+
+      table->comb = new double*[table->size];
+      memset(table->comb, 0, table->size * sizeof(double*));
+      if (comb_table != NULL)
+      {
+        memcpy(table->comb, comb_table->comb, old_size * sizeof(double*));
+        old_comb_tables.push_back(comb_table);
+      }
+#ifdef _OPENMP
+      #pragma omp flush
+#endif
+      comb_table = table;
+    }
+
+    // do we have the required linear combination yet?
+    comb = comb_table->comb[index];
+    if (comb == NULL)
+    {
+      // no, calculate it
+      comb = calculate_constrained_edge_combination(order, part, ori);
+#ifdef _OPENMP
+      #pragma omp flush
+#endif
+      comb_table->comb[index] = comb;
+    }
   }
 
-  nitems = order + 1 - ebias;
-  return comb_table[index];
+  return comb;
 }
 
 
@@ -165,11 +184,19 @@ void Shapeset::free_constrained_edge_combinations()
 {
   if (comb_table != NULL)
   {
-    for (int i = 0; i < table_size; i++)
-      if (comb_table[i] != NULL)
-        delete [] comb_table[i];
-
-    free(comb_table);
+    // older tables share their combinations with the current one
+    for (int i = 0; i < comb_table->size; i++)
+      if (comb_table->comb[i] != NULL)
+        delete [] comb_table->comb[i];
+    for (unsigned int i = 0; i < old_comb_tables.size(); i++)
+    {
+      delete [] old_comb_tables[i]->comb;
+      delete old_comb_tables[i];
+    }
+    old_comb_tables.clear();
+
+    delete [] comb_table->comb;
+    delete comb_table;
     comb_table = NULL;
   }
 }
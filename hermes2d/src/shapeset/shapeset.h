@@ -218,8 +218,16 @@ protected:
   int ebias; ///< 2 for H1 shapesets, 0 for H(curl) shapesets. It is the order of the
              ///< first edge function.
 
-  double** comb_table;
-  int table_size;
+  /// Cached constrained edge combinations. A full table is replaced by a larger copy and
+  /// the old one is kept in old_comb_tables, so that a cached combination can be read
+  /// without a lock by the assembling threads.
+  struct CombTable
+  {
+    int size;
+    double** comb;
+  };
+  CombTable* comb_table;
+  std::vector<CombTable*> old_comb_tables;
 
   double* calculate_constrained_edge_combination(int order, int part, int ori);
   double* get_constrained_edge_combination(int order, int part, int ori, int& nitems);
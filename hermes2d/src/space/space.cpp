@@ -31,6 +31,7 @@ Space::Space(Mesh* mesh, Shapeset* shapeset, EssentialBCs* essential_bcs, Ord2 p
   this->mesh_seq = -1;
   this->seq = 0;
   this->was_assigned = false;
+  this->dof_ordering = HERMES_DOF_ORDERING_NATURAL;
   this->ndof = 0;
 
   if(essential_bcs != NULL)
@@ -519,6 +520,8 @@ int Space::assign_dofs(int first_dof, int stride)
   assign_vertex_dofs();
   assign_edge_dofs();
   assign_bubble_dofs();
+  if (dof_ordering != HERMES_DOF_ORDERING_NATURAL)
+    renumber_dofs();
 
   free_extra_data();
   update_essential_bc_values();
@@ -532,6 +535,164 @@ int Space::assign_dofs(int first_dof, int stride)
   return this->ndof;
 }
 
+void Space::renumber_dofs()
+{
+  _F_
+  // Blocks of DOFs: regular nodes, then bubbles of active elements. At this point
+  // ndata[].dof of a node without DOFs is H2D_UNASSIGNED_DOF or H2D_CONSTRAINED_DOF.
+  std::vector<int*> block_dof;
+  std::vector<int> block_n;
+  std::vector<int> node_block(mesh->get_max_node_id(), -1);
+  for (int i = 0; i < mesh->get_max_node_id(); i++)
+  {
+    if (mesh->get_node(i)->used && ndata[i].dof >= first_dof)
+    {
+      node_block[i] = block_dof.size();
+      block_dof.push_back(&ndata[i].dof);
+      block_n.push_back(ndata[i].n);
+    }
+  }
+
+  // blocks of every active element
+  Element* e;
+  std::vector<Element*> elems;
+  std::vector<int> elem_blocks_start(1, 0), elem_blocks;
+  for_all_active_elements(e, mesh)
+  {
+    elems.push_back(e);
+    for (unsigned int i = 0; i < e->nvert; i++)
+    {
+      if (node_block[e->vn[i]->id] >= 0) elem_blocks.push_back(node_block[e->vn[i]->id]);
+      if (node_block[e->en[i]->id] >= 0) elem_blocks.push_back(node_block[e->en[i]->id]);
+    }
+    if (edata[e->id].bdof >= first_dof)
+    {
+      elem_blocks.push_back(block_dof.size());
+      block_dof.push_back(&edata[e->id].bdof);
+      block_n.push_back(edata[e->id].n);
+    }
+    elem_blocks_start.push_back(elem_blocks.size());
+  }
+  int nblocks = block_dof.size(), nelems = elems.size();
+
+  std::vector<int> order;
+  order.reserve(nblocks);
+  std::vector<bool> numbered(nblocks, false);
+  if (dof_ordering == HERMES_DOF_ORDERING_HILBERT)
+  {
+    // sort elements along the Hilbert curve through their centroids
+    std::vector<int> elem_order;
+    hilbert_order(elems, elem_order);
+
+    // number blocks as they are reached by the elements
+    for (int k = 0; k < nelems; k++)
+    {
+      int el = elem_order[k];
+      for (int j = elem_blocks_start[el]; j < elem_blocks_start[el + 1]; j++)
+        if (!numbered[elem_blocks[j]])
+        {
+          numbered[elem_blocks[j]] = true;
+          order.push_back(elem_blocks[j]);
+        }
+    }
+  }
+  else if (dof_ordering == HERMES_DOF_ORDERING_RCM)
+  {
+    // graph of blocks: two blocks are adjacent if they share an element
+    std::vector<int> block_elems_start(nblocks + 1, 0), block_elems(elem_blocks.size());
+    for (unsigned int j = 0; j < elem_blocks.size(); j++)
+      block_elems_start[elem_blocks[j] + 1]++;
+    for (int b = 0; b < nblocks; b++)
+      block_elems_start[b + 1] += block_elems_start[b];
+    std::vector<int> fill(block_elems_start.begin(), block_elems_start.end() - 1);
+    for (int k = 0; k < nelems; k++)
+      for (int j = elem_blocks_start[k]; j < elem_blocks_start[k + 1]; j++)
+        block_elems[fill[elem_blocks[j]]++] = k;
+
+    std::vector<int> adj_start(nblocks + 1, 0), adj;
+    std::vector<int> mark(nblocks, -1);
+    for (int b = 0; b < nblocks; b++)
+    {
+      for (int i = block_elems_start[b]; i < block_elems_start[b + 1]; i++)
+      {
+        int k = block_elems[i];
+        for (int j = elem_blocks_start[k]; j < elem_blocks_start[k + 1]; j++)
+          if (elem_blocks[j] != b && mark[elem_blocks[j]] != b)
+          {
+            mark[elem_blocks[j]] = b;
+            adj.push_back(elem_blocks[j]);
+          }
+      }
+      adj_start[b + 1] = adj.size();
+    }
+
+    // Cuthill-McKee: breadth-first search from a pseudo-peripheral block of every component,
+    // neighbors are visited in the order of increasing degree
+    std::vector<int> level(nblocks, -1);
+    for (int root = 0; root < nblocks; root++)
+    {
+      if (numbered[root]) continue;
+
+      // pseudo-peripheral block: move to the farthest block of the least degree
+      // as long as the eccentricity grows
+      int start = root, ecc = -1;
+      while (true)
+      {
+        std::vector<int> queue(1, start);
+        level[start] = 0;
+        for (unsigned int q = 0; q < queue.size(); q++)
+          for (int j = adj_start[queue[q]]; j < adj_start[queue[q] + 1]; j++)
+            if (level[adj[j]] < 0)
+            {
+              level[adj[j]] = level[queue[q]] + 1;
+              queue.push_back(adj[j]);
+            }
+        int start_ecc = level[queue.back()], far = queue.back();
+        for (int q = queue.size() - 1; q >= 0 && level[queue[q]] == start_ecc; q--)
+          if (adj_start[queue[q] + 1] - adj_start[queue[q]] < adj_start[far + 1] - adj_start[far])
+            far = queue[q];
+        for (unsigned int q = 0; q < queue.size(); q++)
+          level[queue[q]] = -1;
+        if (start_ecc <= ecc) break;
+        ecc = start_ecc;
+        start = far;
+      }
+
+      unsigned int q = order.size();
+      order.push_back(start);
+      numbered[start] = true;
+      for (; q < order.size(); q++)
+      {
+        std::vector< std::pair<int, int> > next;
+        for (int j = adj_start[order[q]]; j < adj_start[order[q] + 1]; j++)
+          if (!numbered[adj[j]])
+          {
+            numbered[adj[j]] = true;
+            next.push_back(std::make_pair(adj_start[adj[j] + 1] - adj_start[adj[j]], adj[j]));
+          }
+        std::sort(next.begin(), next.end());
+        for (unsigned int j = 0; j < next.size(); j++)
+          order.push_back(next[j].second);
+      }
+    }
+    std::reverse(order.begin(), order.end());
+  }
+  else
+    error("Unknown DOF ordering %d.", dof_ordering);
+
+  // blocks which do not belong to any active element keep their relative order at the end
+  for (int b = 0; b < nblocks; b++)
+    if (!numbered[b])
+      order.push_back(b);
+
+  next_dof = first_dof;
+  for (int i = 0; i < nblocks; i++)
+  {
+    *block_dof[order[i]] = next_dof;
+    next_dof += block_n[order[i]] * stride;
+  }
+}
+
 void Space::reset_dof_assignment()
 {
   _F_
@@ -757,6 +918,14 @@ int Space::assign_dofs(Hermes::vector<Space*> spaces)
   return ndof;
 }
 
+int Space::assign_dofs(Hermes::vector<Space*> spaces, EDofOrdering ordering)
+{
+  _F_
+  for (unsigned int i = 0; i < spaces.size(); i++)
+    spaces[i]->set_dof_ordering(ordering);
+  return assign_dofs(spaces);
+}
+
 // Performs uniform global refinement of a FE space.
 Hermes::vector<Space *>* Space::construct_refined_spaces(Hermes::vector<Space *> coarse, int order_increase)
 {
@@ -80,6 +80,13 @@
 ///
 class Ord2;
 
+/// Orderings of DOF numbers, see Space::set_dof_ordering().
+enum EDofOrdering {
+  HERMES_DOF_ORDERING_NATURAL = 0, ///< DOFs are numbered in the order of node and element ids (default).
+  HERMES_DOF_ORDERING_RCM = 1,     ///< Reverse Cuthill-McKee ordering of the graph of the matrix.
+  HERMES_DOF_ORDERING_HILBERT = 2  ///< DOFs are numbered along a Hilbert curve through element centroids.
+};
+
 class HERMES_API Space
 {
 public:
@@ -136,6 +143,15 @@ public:
   /// \return The number of basis functions contained in the space.
   virtual int assign_dofs(int first_dof = 0, int stride = 1);
 
+  /// \brief Sets the ordering of DOF numbers. It takes effect in the next call of assign_dofs().
+  /// \details After many adaptive refinements the ids of nodes are scattered over the mesh,
+  /// and so are the DOF numbers of the natural ordering. A locality-preserving ordering decreases
+  /// the bandwidth of the matrix, which improves the fill-in of direct solvers and the cache
+  /// behaviour of matrix-vector products. DOFs of one node (one element) stay consecutive.
+  /// The ordering is copied by dup().
+  void set_dof_ordering(EDofOrdering ordering) { dof_ordering = ordering; }
+  EDofOrdering get_dof_ordering() const { return dof_ordering; }
+
   /// \brief Returns the number of basis functions contained in the space.
   int get_num_dofs() { return ndof; }
   /// \brief Returns the DOF number of the last basis function.
@@ -182,6 +198,10 @@ public:
   /// \brief Assings the degrees of freedom to all Spaces in the Hermes::vector.
   static int assign_dofs(Hermes::vector<Space*> spaces);
 
+  /// \brief Sets the ordering of DOF numbers to all Spaces in the Hermes::vector and assigns
+  /// the degrees of freedom. Every space keeps a contiguous range of DOF numbers.
+  static int assign_dofs(Hermes::vector<Space*> spaces, EDofOrdering ordering);
+
 protected:
   static const int H2D_UNASSIGNED_DOF = -2; ///< DOF which was not assigned yet.
   static const int H2D_CONSTRAINED_DOF = -1; ///< DOF which is constrained.
@@ -200,6 +220,7 @@ protected:
   int stride;
   int seq, mesh_seq;
   bool was_assigned;
+  EDofOrdering dof_ordering;
 
   struct BaseComponent
   {
@@ -267,6 +288,11 @@ protected: //debugging support
   virtual void assign_edge_dofs() = 0;
   virtual void assign_bubble_dofs() = 0;
 
+  /// Renumbers DOFs assigned by assign_vertex_dofs(), assign_edge_dofs() and assign_bubble_dofs()
+  /// according to Space::dof_ordering. DOFs of a node (bubble DOFs of an element) form a block
+  /// which is moved as a whole. Called before the constraints are built.
+  void renumber_dofs();
+
   virtual void get_vertex_assembly_list(Element* e, int iv, AsmList* al) = 0;
   virtual void get_boundary_assembly_list_internal(Element* e, int surf_num, AsmList* al) = 0;
   virtual void get_bubble_assembly_list(Element* e, AsmList* al);
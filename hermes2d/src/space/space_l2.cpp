@@ -64,6 +64,7 @@ Space* L2Space::dup(Mesh* mesh, int order_increase) const
 {
   // FIXME - not tested
   L2Space* space = new L2Space(mesh, essential_bcs, 0, shapeset);
+  space->set_dof_ordering(dof_ordering);
   space->copy_orders(this, order_increase);
   return space;
 }
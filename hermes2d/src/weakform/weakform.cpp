@@ -64,6 +64,24 @@ Ord WeakForm::MatrixFormVol::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord
   return Ord();
 }
 
+void WeakForm::MatrixFormVol::value_batch(int n, double *wt, Func<scalar> *u_ext[], int nu, Func<double> **u,
+                                          int nv, Func<double> **v, bool sym, Geom<double> *e,
+                                          ExtData<scalar> *ext, scalar **result) const
+{
+  for (int i = 0; i < nv; i++) {
+    if (v[i] == NULL) continue;
+    for (int j = sym ? i : 0; j < nu; j++) {
+      if (u[j] == NULL) continue;
+      result[i][j] = value(n, wt, u_ext, u[j], v[i], e, ext);
+    }
+  }
+}
+
+bool WeakForm::MatrixFormVol::has_value_batch() const
+{
+  return false;
+}
+
 WeakForm::MatrixFormVol* WeakForm::MatrixFormVol::clone()
 {
   error("WeakForm::MatrixFormVol::clone() must be overridden.");
@@ -130,6 +130,20 @@ public:
                          Geom<double> *e, ExtData<scalar> *ext) const;
     virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
                     Geom<Ord> *e, ExtData<Ord> *ext) const;
+
+    /// Batched evaluation of the form on one element. Stores the value for the basis
+    /// function u[j] and the test function v[i] into result[i][j], for all i < nv, j < nu.
+    /// All functions are given in the same n integration points. Pairs with u[j] == NULL
+    /// or v[i] == NULL are not needed and must be left untouched. If sym is true, u and v
+    /// are the same functions and only the entries with j >= i need to be filled in.
+    /// The default implementation calls value() for every pair.
+    virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], int nu, Func<double> **u,
+                             int nv, Func<double> **v, bool sym, Geom<double> *e,
+                             ExtData<scalar> *ext, scalar **result) const;
+    /// Returns true if value_batch() is faster than calling value() for every pair. Only such
+    /// forms are assembled by value_batch(), with one integration order sufficient for all
+    /// pairs; the others are integrated pair by pair, each with its own order (default).
+    virtual bool has_value_batch() const;
   };
 
   class HERMES_API MatrixFormSurf : public Form
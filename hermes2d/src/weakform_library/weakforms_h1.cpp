@@ -2,6 +2,88 @@
 
 namespace WeakFormsH1 
 {
+  // Returns true if coeff is a plain constant HermesFunction (derived classes
+  // may override value() even if they do not reset the is_const flag).
+  static bool is_plain_constant(HermesFunction* coeff)
+  {
+    return typeid(*coeff) == typeid(HermesFunction);
+  }
+
+  // Integration weights of the given geometry type.
+  static double* geom_weights(int n, double *wt, Geom<double> *e, GeomType gt)
+  {
+    double* gwt = new double[n];
+    for (int k = 0; k < n; k++) {
+      if (gt == HERMES_PLANAR) gwt[k] = wt[k];
+      else if (gt == HERMES_AXISYM_X) gwt[k] = wt[k] * e->y[k];
+      else gwt[k] = wt[k] * e->x[k];
+    }
+    return gwt;
+  }
+
+  // Small dense matrix product used by the batched forms:
+  // result[i][j] += coeff * \sum_k wt[k] * a[i][k] * b[j][k]
+  // for all rows with a[i] != NULL and columns with b[j] != NULL (j >= i if sym).
+  // The rows are premultiplied by the weights and the columns are taken four at
+  // a time, so that the inner loops are contiguous dot products that the compiler
+  // vectorizes, and every loaded row value is reused four times.
+  static void add_weighted_products(int n, double *wt, int nv, double **a, int nu, double **b,
+                                    bool sym, scalar coeff, scalar **result)
+  {
+    double* wa = new double[n];
+    int* cols = new int[nu];
+    int num_cols = 0;
+    for (int j = 0; j < nu; j++)
+      if (b[j] != NULL) cols[num_cols++] = j;
+
+    int first = 0;
+    for (int i = 0; i < nv; i++) {
+      if (a[i] == NULL) continue;
+      if (sym)
+        while (first < num_cols && cols[first] < i) first++;
+
+      for (int k = 0; k < n; k++)
+        wa[k] = wt[k] * a[i][k];
+
+      int p = sym ? first : 0;
+      for (; p + 3 < num_cols; p += 4) {
+        double *b0 = b[cols[p]], *b1 = b[cols[p + 1]], *b2 = b[cols[p + 2]], *b3 = b[cols[p + 3]];
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (int k = 0; k < n; k++) {
+          s0 += wa[k] * b0[k];
+          s1 += wa[k] * b1[k];
+          s2 += wa[k] * b2[k];
+          s3 += wa[k] * b3[k];
+        }
+        result[i][cols[p]] += coeff * s0;
+        result[i][cols[p + 1]] += coeff * s1;
+        result[i][cols[p + 2]] += coeff * s2;
+        result[i][cols[p + 3]] += coeff * s3;
+      }
+      for (; p < num_cols; p++) {
+        double *b0 = b[cols[p]];
+        double s0 = 0;
+        for (int k = 0; k < n; k++)
+          s0 += wa[k] * b0[k];
+        result[i][cols[p]] += coeff * s0;
+      }
+    }
+
+    delete [] cols;
+    delete [] wa;
+  }
+
+  // Arrays of values (what = 0), x-derivatives (1) or y-derivatives (2) of the functions fn[].
+  static double** func_arrays(int cnt, Func<double> **fn, int what)
+  {
+    double** arr = new double*[cnt];
+    for (int i = 0; i < cnt; i++) {
+      if (fn[i] == NULL) arr[i] = NULL;
+      else arr[i] = (what == 0) ? fn[i]->val : (what == 1) ? fn[i]->dx : fn[i]->dy;
+    }
+    return arr;
+  }
+
   DefaultMatrixFormVol::DefaultMatrixFormVol
     (int i, int j, std::string area, HermesFunction* coeff, SymFlag sym, GeomType gt)
     : WeakForm::MatrixFormVol(i, j, area, sym), coeff(coeff), gt(gt)
@@ -75,6 +157,29 @@ namespace WeakFormsH1
     return result;
   }
 
+  bool DefaultMatrixFormVol::has_value_batch() const
+  {
+    return typeid(*this) == typeid(DefaultMatrixFormVol) && is_plain_constant(coeff);
+  }
+
+  void DefaultMatrixFormVol::value_batch(int n, double *wt, Func<scalar> *u_ext[], int nu, Func<double> **u,
+                                         int nv, Func<double> **v, bool sym, Geom<double> *e,
+                                         ExtData<scalar> *ext, scalar **result) const
+  {
+    if (!has_value_batch()) {
+      WeakForm::MatrixFormVol::value_batch(n, wt, u_ext, nu, u, nv, v, sym, e, ext, result);
+      return;
+    }
+
+    double* gwt = geom_weights(n, wt, e, gt);
+    double** u_val = func_arrays(nu, u, 0);
+    double** v_val = func_arrays(nv, v, 0);
+    add_weighted_products(n, gwt, nv, v_val, nu, u_val, sym, coeff->value(0.0, 0.0), result);
+    delete [] v_val;
+    delete [] u_val;
+    delete [] gwt;
+  }
+
   WeakForm::MatrixFormVol* DefaultMatrixFormVol::clone() 
   {
     return new DefaultMatrixFormVol(*this);
@@ -172,6 +277,33 @@ namespace WeakFormsH1
     return result;
   }
 
+  bool DefaultJacobianDiffusion::has_value_batch() const
+  {
+    // For a constant coefficient the term with its derivative vanishes.
+    return typeid(*this) == typeid(DefaultJacobianDiffusion) && is_plain_constant(coeff);
+  }
+
+  void DefaultJacobianDiffusion::value_batch(int n, double *wt, Func<scalar> *u_ext[], int nu, Func<double> **u,
+                                             int nv, Func<double> **v, bool sym, Geom<double> *e,
+                                             ExtData<scalar> *ext, scalar **result) const
+  {
+    if (!has_value_batch()) {
+      WeakForm::MatrixFormVol::value_batch(n, wt, u_ext, nu, u, nv, v, sym, e, ext, result);
+      return;
+    }
+
+    double* gwt = geom_weights(n, wt, e, gt);
+    scalar c = coeff->value(0.0, 0.0);
+    for (int d = 1; d <= 2; d++) {
+      double** u_der = func_arrays(nu, u, d);
+      double** v_der = func_arrays(nv, v, d);
+      add_weighted_products(n, gwt, nv, v_der, nu, u_der, sym, c, result);
+      delete [] v_der;
+      delete [] u_der;
+    }
+    delete [] gwt;
+  }
+
   WeakForm::MatrixFormVol* DefaultJacobianDiffusion::clone() 
   {
     return new DefaultJacobianDiffusion(*this);
@@ -239,6 +371,32 @@ namespace WeakFormsH1
     return matrix_form<Ord, Ord>(n, wt, u_ext, u, v, e, ext);
   }
 
+  bool DefaultJacobianAdvection::has_value_batch() const
+  {
+    // For constant coefficients the terms with their derivatives vanish.
+    return typeid(*this) == typeid(DefaultJacobianAdvection) && is_plain_constant(coeff1) 
+           && is_plain_constant(coeff2);
+  }
+
+  void DefaultJacobianAdvection::value_batch(int n, double *wt, Func<scalar> *u_ext[], int nu, Func<double> **u,
+                                             int nv, Func<double> **v, bool sym, Geom<double> *e,
+                                             ExtData<scalar> *ext, scalar **result) const
+  {
+    if (!has_value_batch()) {
+      WeakForm::MatrixFormVol::value_batch(n, wt, u_ext, nu, u, nv, v, sym, e, ext, result);
+      return;
+    }
+
+    double** v_val = func_arrays(nv, v, 0);
+    double** u_dx = func_arrays(nu, u, 1);
+    double** u_dy = func_arrays(nu, u, 2);
+    add_weighted_products(n, wt, nv, v_val, nu, u_dx, sym, coeff1->value(0.0, 0.0), result);
+    add_weighted_products(n, wt, nv, v_val, nu, u_dy, sym, coeff2->value(0.0, 0.0), result);
+    delete [] u_dy;
+    delete [] u_dx;
+    delete [] v_val;
+  }
+
   // This is to make the form usable in rk_time_step().
   WeakForm::MatrixFormVol* DefaultJacobianAdvection::clone() 
   {
@@ -43,6 +43,12 @@ namespace WeakFormsH1
     virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u,
                     Func<Ord> *v, Geom<Ord> *e, ExtData<Ord> *ext) const;
 
+    virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], int nu, Func<double> **u,
+                             int nv, Func<double> **v, bool sym, Geom<double> *e,
+                             ExtData<scalar> *ext, scalar **result) const;
+
+    virtual bool has_value_batch() const;
+
     virtual WeakForm::MatrixFormVol* clone();
 
     private:
@@ -74,6 +80,12 @@ namespace WeakFormsH1
     virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
                     Geom<Ord> *e, ExtData<Ord> *ext) const;
 
+    virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], int nu, Func<double> **u,
+                             int nv, Func<double> **v, bool sym, Geom<double> *e,
+                             ExtData<scalar> *ext, scalar **result) const;
+
+    virtual bool has_value_batch() const;
+
     virtual WeakForm::MatrixFormVol* clone();
 
     private:
@@ -115,6 +127,12 @@ namespace WeakFormsH1
     virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
                     Geom<Ord> *e, ExtData<Ord> *ext) const;
 
+    virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], int nu, Func<double> **u,
+                             int nv, Func<double> **v, bool sym, Geom<double> *e,
+                             ExtData<scalar> *ext, scalar **result) const;
+
+    virtual bool has_value_batch() const;
+
     virtual WeakForm::MatrixFormVol* clone();
 
     private:
@@ -0,0 +1,148 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+using namespace RefinementSelectors;
+
+// This test makes sure that the parallel calculation of errors (Adapt::set_num_threads())
+// gives the same errors of elements as the serial one, both the errors with respect to
+// a reference solution (Adapt) and the estimates of BasicKellyAdapt, and that Adapt::adapt()
+// selects the same refinements with one and several threads. The mesh contains curved
+// elements and hanging nodes and the polynomial degrees vary. The solutions are set from
+// fixed coefficient vectors, so no linear system is solved.
+
+const int NUM_THREADS = 4;                        // Number of threads of the parallel calculation.
+const double THRESHOLD = 0.3;                     // Parameters of Adapt::adapt().
+const int STRATEGY = 0;
+
+// Sets the solution on the space from the coefficient vector sin(1 + 0.37 i).
+void set_solution(Space* space, Solution* sln)
+{
+  int ndof = space->get_num_dofs();
+  scalar* coeff_vec = new scalar[ndof];
+  for (int i = 0; i < ndof; i++)
+    coeff_vec[i] = sin(1.0 + 0.37 * i);
+  Solution::vector_to_solution(coeff_vec, space, sln);
+  delete [] coeff_vec;
+}
+
+// Compares the errors of the active elements calculated serially and in parallel. The parallel
+// calculation sums up the contributions in the serial order, so the errors have to be identical.
+bool compare(const char* name, Adapt* adapt_serial, double err_serial, Adapt* adapt_parallel,
+             double err_parallel, Mesh* mesh)
+{
+  double max_diff = 0.0;
+  Element* e;
+  for_all_active_elements(e, mesh)
+    max_diff = std::max(max_diff, std::abs(adapt_serial->get_element_error_squared(0, e->id)
+                                           - adapt_parallel->get_element_error_squared(0, e->id)));
+  printf("%s: total error %g (serial), %g (parallel), max. difference of element errors %g\n",
+         name, err_serial, err_parallel, max_diff);
+  return (err_serial == err_parallel && max_diff == 0.0);
+}
+
+// Compares the refinements selected serially and in parallel, they have to be identical.
+bool compare_refinements(const std::vector<ElementToRefine>& refs_serial,
+                         const std::vector<ElementToRefine>& refs_parallel)
+{
+  printf("refinements: %d (serial), %d (parallel)\n", (int) refs_serial.size(), (int) refs_parallel.size());
+  if (refs_serial.size() != refs_parallel.size())
+    return false;
+  for (unsigned int k = 0; k < refs_serial.size(); k++)
+  {
+    const ElementToRefine& a = refs_serial[k];
+    const ElementToRefine& b = refs_parallel[k];
+    if (a.id != b.id || a.comp != b.comp || a.split != b.split)
+      return false;
+    for (int i = 0; i < a.get_num_sons(); i++)
+      if (a.p[i] != b.p[i])
+        return false;
+  }
+  return true;
+}
+
+// Sets varying polynomial degrees of the elements.
+void set_element_orders(Space* space)
+{
+  Element* e;
+  for_all_active_elements(e, space->get_mesh())
+  {
+    int p = 2 + e->id % 5;
+    space->set_element_order(e->id, e->is_triangle() ? p : H2D_MAKE_QUAD_ORDER(p, 2 + e->id % 3));
+  }
+  space->assign_dofs();
+}
+
+int main(int argc, char* argv[])
+{
+  // Load the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("domain.mesh", &mesh);
+
+  // Refine uniformly and then towards the re-entrant corner to get hanging nodes.
+  mesh.refine_all_elements();
+  mesh.refine_all_elements();
+  mesh.refine_towards_vertex(3, 3);
+
+  // Adapt::adapt() refines the mesh, the parallel one gets an identical copy.
+  Mesh mesh_parallel;
+  mesh_parallel.copy(&mesh);
+
+  // Initialize boundary conditions.
+  DefaultEssentialBCConst bc_essential(Hermes::vector<std::string>("Bottom", "Inner", "Left"), 20.0);
+  EssentialBCs bcs(&bc_essential);
+
+  // Create H1 spaces with varying polynomial degrees and their reference spaces.
+  H1Space space(&mesh, &bcs, 2);
+  set_element_orders(&space);
+  Space* ref_space = Space::construct_refined_space(&space);
+  H1Space space_parallel(&mesh_parallel, &bcs, 2);
+  set_element_orders(&space_parallel);
+  Space* ref_space_parallel = Space::construct_refined_space(&space_parallel);
+  info("ndof = %d, ndof_ref = %d", space.get_num_dofs(), ref_space->get_num_dofs());
+
+  Solution sln, ref_sln, sln_parallel, ref_sln_parallel;
+  set_solution(&space, &sln);
+  set_solution(ref_space, &ref_sln);
+  set_solution(&space_parallel, &sln_parallel);
+  set_solution(ref_space_parallel, &ref_sln_parallel);
+
+  // Errors with respect to the reference solution.
+  Adapt adapt_serial(&space);
+  double err_serial = adapt_serial.calc_err_est(&sln, &ref_sln);
+  Adapt adapt_parallel(&space_parallel);
+  adapt_parallel.set_num_threads(NUM_THREADS);
+  double err_parallel = adapt_parallel.calc_err_est(&sln_parallel, &ref_sln_parallel);
+  bool success = compare("Adapt", &adapt_serial, err_serial, &adapt_parallel, err_parallel, &mesh);
+
+  // Kelly-type estimates.
+  BasicKellyAdapt kelly_serial(&space);
+  err_serial = kelly_serial.calc_err_est(&sln);
+  BasicKellyAdapt kelly_parallel(&space);
+  kelly_parallel.set_num_threads(NUM_THREADS);
+  err_parallel = kelly_parallel.calc_err_est(&sln);
+  if (!compare("BasicKellyAdapt", &kelly_serial, err_serial, &kelly_parallel, err_parallel, &mesh))
+    success = false;
+
+  // Refinements.
+  H1ProjBasedSelector selector_serial(H2D_HP_ANISO);
+  H1ProjBasedSelector selector_parallel(H2D_HP_ANISO);
+  adapt_serial.adapt(&selector_serial, THRESHOLD, STRATEGY);
+  adapt_parallel.adapt(&selector_parallel, THRESHOLD, STRATEGY);
+  if (!compare_refinements(adapt_serial.get_last_refinements(), adapt_parallel.get_last_refinements()))
+    success = false;
+
+  delete ref_space->get_mesh();
+  delete ref_space;
+  delete ref_space_parallel->get_mesh();
+  delete ref_space_parallel;
+
+  if (success == true) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,118 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+// This test makes sure that the parallel assembling (DiscreteProblem::set_num_threads())
+// produces the same matrix and right-hand side as the serial one. The mesh contains
+// curved elements and hanging nodes and the polynomial degrees vary, so that the
+// constrained edge functions and the curvilinear reference maps are exercised as well.
+// The parallel assembling is repeated into the same matrix, where the workers add the
+// local matrices through the scatter map recorded by the first one.
+
+const int NUM_THREADS = 4;                        // Number of threads of the parallel assembling.
+const double TOLERANCE = 1e-12;                   // Relative tolerance of the comparison.
+
+// Weak form with volume and surface forms in both the matrix and the right-hand side.
+class CustomWeakForm : public WeakForm
+{
+public:
+  CustomWeakForm() : WeakForm(1)
+  {
+    add_matrix_form(new WeakFormsH1::DefaultJacobianDiffusion(0, 0, "Aluminum", new HermesFunction(236.0)));
+    add_matrix_form(new WeakFormsH1::DefaultJacobianDiffusion(0, 0, "Copper", new HermesFunction(386.0)));
+    add_matrix_form(new WeakFormsH1::DefaultMatrixFormVol(0, 0, HERMES_ANY, new HermesFunction(2.0)));
+    add_matrix_form_surf(new WeakFormsH1::DefaultMatrixFormSurf(0, 0, "Outer", new HermesFunction(5.0)));
+    add_vector_form(new WeakFormsH1::DefaultVectorFormVol(0, HERMES_ANY, new HermesFunction(-500.0)));
+    add_vector_form_surf(new WeakFormsH1::DefaultVectorFormSurf(0, "Outer", new HermesFunction(100.0)));
+  }
+};
+
+// Returns the largest difference of the two arrays relative to the largest entry of the first one.
+double rel_diff(scalar* a, scalar* b, int n)
+{
+  double max_val = 0.0, max_diff = 0.0;
+  for (int i = 0; i < n; i++)
+  {
+    max_val = std::max(max_val, std::abs(a[i]));
+    max_diff = std::max(max_diff, std::abs(a[i] - b[i]));
+  }
+  return (max_val > 0.0) ? max_diff / max_val : max_diff;
+}
+
+// Compares the serially and the parallel assembled matrices and right-hand sides.
+bool compare(UMFPackMatrix* mat_serial, UMFPackVector* rhs_serial, 
+             UMFPackMatrix* mat_parallel, UMFPackVector* rhs_parallel, int ndof)
+{
+  int nnz = mat_serial->get_nnz();
+  if (nnz != (int) mat_parallel->get_nnz()
+      || memcmp(mat_serial->get_Ap(), mat_parallel->get_Ap(), (ndof + 1) * sizeof(int)) != 0
+      || memcmp(mat_serial->get_Ai(), mat_parallel->get_Ai(), nnz * sizeof(int)) != 0)
+  {
+    printf("The sparse structures differ.\n");
+    return false;
+  }
+
+  double mat_diff = rel_diff(mat_serial->get_Ax(), mat_parallel->get_Ax(), nnz);
+  double rhs_diff = rel_diff(rhs_serial->get_c_array(), rhs_parallel->get_c_array(), ndof);
+  printf("relative difference: matrix %g, rhs %g\n", mat_diff, rhs_diff);
+  return (mat_diff <= TOLERANCE && rhs_diff <= TOLERANCE);
+}
+
+int main(int argc, char* argv[])
+{
+  // Load the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("domain.mesh", &mesh);
+
+  // Refine uniformly and then towards the re-entrant corner to get hanging nodes.
+  mesh.refine_all_elements();
+  mesh.refine_all_elements();
+  mesh.refine_towards_vertex(3, 3);
+
+  // Initialize boundary conditions.
+  DefaultEssentialBCConst bc_essential(Hermes::vector<std::string>("Bottom", "Inner", "Left"), 20.0);
+  EssentialBCs bcs(&bc_essential);
+
+  // Create an H1 space with varying polynomial degrees.
+  H1Space space(&mesh, &bcs, 2);
+  Element* e;
+  for_all_active_elements(e, &mesh)
+  {
+    int p = 2 + e->id % 5;
+    space.set_element_order(e->id, e->is_triangle() ? p : H2D_MAKE_QUAD_ORDER(p, 2 + e->id % 3));
+  }
+  space.assign_dofs();
+  int ndof = space.get_num_dofs();
+  info("ndof = %d", ndof);
+
+  // Assemble serially.
+  CustomWeakForm wf;
+  DiscreteProblem dp_serial(&wf, &space);
+  UMFPackMatrix mat_serial;
+  UMFPackVector rhs_serial;
+  dp_serial.assemble(&mat_serial, &rhs_serial);
+
+  // Assemble in parallel. A DiscreteProblem allocates the matrix only with a new sparse
+  // structure, so a second one is used.
+  DiscreteProblem dp_parallel(&wf, &space);
+  dp_parallel.set_num_threads(NUM_THREADS);
+  UMFPackMatrix mat_parallel;
+  UMFPackVector rhs_parallel;
+  dp_parallel.assemble(&mat_parallel, &rhs_parallel);
+
+  // Both assemblings use the same sparse structure, so the values can be compared directly.
+  bool success = compare(&mat_serial, &rhs_serial, &mat_parallel, &rhs_parallel, ndof);
+
+  // Assemble in parallel again, now through the scatter map.
+  dp_parallel.assemble(&mat_parallel, &rhs_parallel);
+  if (!compare(&mat_serial, &rhs_serial, &mat_parallel, &rhs_parallel, ndof)) success = false;
+
+  if (success == true) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,133 @@
+#define HERMES_REPORT_ALL
+#define HERMES_REPORT_FILE "application.log"
+#include "../definitions.h"
+
+//  This test makes sure that the Newton's method reusing the Jacobian and the
+//  Jacobian-free Newton's method (Hermes2D::solve_newton_reuse()) converge to the
+//  same solution of example 02-newton-analytic as the plain Newton's method.
+
+const int P_INIT = 2;                             // Initial polynomial degree.
+const double NEWTON_TOL = 1e-8;                   // Stopping criterion for the Newton's method.
+const int NEWTON_MAX_ITER = 50;                   // Maximum allowed number of Newton iterations.
+const int INIT_GLOB_REF_NUM = 3;                  // Number of initial uniform mesh refinements.
+const int INIT_BDY_REF_NUM = 4;                   // Number of initial refinements towards boundary.
+const double TOLERANCE = 1e-6;                    // Allowed relative difference of the solutions.
+MatrixSolverType matrix_solver = SOLVER_UMFPACK;  // Possibilities: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
+                                                  // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
+
+// Problem parameters.
+double alpha = 4.0;
+double heat_src = 1.0;
+
+// Returns the largest difference of the two vectors relative to the largest entry of the first one.
+double rel_diff(scalar* a, scalar* b, int n)
+{
+  double max_val = 0.0, max_diff = 0.0;
+  for (int i = 0; i < n; i++)
+  {
+    max_val = std::max(max_val, std::abs(a[i]));
+    max_diff = std::max(max_diff, std::abs(a[i] - b[i]));
+  }
+  return (max_val > 0.0) ? max_diff / max_val : max_diff;
+}
+
+int main(int argc, char* argv[])
+{
+  // Instantiate a class with global functions.
+  Hermes2D hermes2d;
+
+  // Load the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("../square.mesh", &mesh);
+
+  // Perform initial mesh refinements.
+  for(int i = 0; i < INIT_GLOB_REF_NUM; i++) mesh.refine_all_elements();
+  mesh.refine_towards_boundary("Bdy", INIT_BDY_REF_NUM);
+
+  // Initialize boundary conditions.
+  CustomEssentialBCNonConst bc_essential("Bdy");
+  EssentialBCs bcs(&bc_essential);
+
+  // Create an H1 space with default shapeset.
+  H1Space space(&mesh, &bcs, P_INIT);
+  int ndof = space.get_num_dofs();
+  info("ndof = %d", ndof);
+
+  // Initialize the weak formulation
+  CustomNonlinearity lambda(alpha);
+  HermesFunction src(-heat_src);
+  WeakFormsH1::DefaultWeakFormPoisson wf(HERMES_ANY, &lambda, &src);
+
+  // Initialize the FE problem.
+  DiscreteProblem dp(&wf, &space);
+
+  // Project the initial condition on the FE space to obtain the initial
+  // coefficient vector, which is shared by all methods.
+  info("Projecting to obtain initial vector for the Newton's method.");
+  scalar* coeff_init = new scalar[ndof];
+  CustomInitialCondition init_sln(&mesh);
+  OGProjection::project_global(&space, &init_sln, coeff_init, matrix_solver);
+
+  // Set up the solver, matrix, and rhs according to the solver selection.
+  SparseMatrix* matrix = create_matrix(matrix_solver);
+  Vector* rhs = create_vector(matrix_solver);
+  Solver* solver = create_linear_solver(matrix_solver, matrix, rhs);
+
+  // Plain Newton's method.
+  info("Plain Newton's method.");
+  scalar* coeff_newton = new scalar[ndof];
+  memcpy(coeff_newton, coeff_init, ndof * sizeof(scalar));
+  bool jacobian_changed = true;
+  if (!hermes2d.solve_newton(coeff_newton, &dp, solver, matrix, rhs, jacobian_changed,
+      NEWTON_TOL, NEWTON_MAX_ITER, true)) error("Newton's iteration failed.");
+
+  // Newton's method reusing the Jacobian, starting without a factorized Jacobian.
+  info("Newton's method reusing the Jacobian.");
+  scalar* coeff_reuse = new scalar[ndof];
+  memcpy(coeff_reuse, coeff_init, ndof * sizeof(scalar));
+  bool jacobian_valid = false;
+  if (!hermes2d.solve_newton_reuse(coeff_reuse, &dp, solver, matrix, rhs, jacobian_valid,
+      NEWTON_TOL, NEWTON_MAX_ITER, true)) error("Newton's iteration reusing the Jacobian failed.");
+
+  // Jacobian-free Newton's method, preconditioned by the Jacobian factorized above.
+  info("Jacobian-free Newton's method, preconditioned.");
+  scalar* coeff_jfnk = new scalar[ndof];
+  memcpy(coeff_jfnk, coeff_init, ndof * sizeof(scalar));
+  if (!hermes2d.solve_newton_reuse(coeff_jfnk, &dp, solver, matrix, rhs, jacobian_valid,
+      NEWTON_TOL, NEWTON_MAX_ITER, true, 0.5, true)) error("Jacobian-free Newton's iteration failed.");
+
+  // Jacobian-free Newton's method without a preconditioner.
+  info("Jacobian-free Newton's method, not preconditioned.");
+  scalar* coeff_jfnk_noprec = new scalar[ndof];
+  memcpy(coeff_jfnk_noprec, coeff_init, ndof * sizeof(scalar));
+  jacobian_valid = false;
+  if (!hermes2d.solve_newton_reuse(coeff_jfnk_noprec, &dp, solver, matrix, rhs, jacobian_valid,
+      NEWTON_TOL, NEWTON_MAX_ITER, true, 0.5, true)) error("Jacobian-free Newton's iteration failed.");
+
+  // Compare the solutions.
+  double diff_reuse = rel_diff(coeff_newton, coeff_reuse, ndof);
+  double diff_jfnk = rel_diff(coeff_newton, coeff_jfnk, ndof);
+  double diff_jfnk_noprec = rel_diff(coeff_newton, coeff_jfnk_noprec, ndof);
+  printf("relative difference from the plain Newton's method: reuse %g, jacobian-free %g, "
+         "jacobian-free without preconditioner %g\n", diff_reuse, diff_jfnk, diff_jfnk_noprec);
+
+  // Cleanup.
+  delete [] coeff_init;
+  delete [] coeff_newton;
+  delete [] coeff_reuse;
+  delete [] coeff_jfnk;
+  delete [] coeff_jfnk_noprec;
+  delete matrix;
+  delete rhs;
+  delete solver;
+
+  if (diff_reuse < TOLERANCE && diff_jfnk < TOLERANCE && diff_jfnk_noprec < TOLERANCE) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -13,7 +13,7 @@ using Hermes::EigenSolver;
 //
 //  Observe how eigenfunctions associated with eigenvalues of multiplicity greater than 
 //  one change from one step to another. The underlying operator is the Laplacian,
-//  in a square with zero boundary conditions. Python and Pysparse must be installed. 
+//  in a square with zero boundary conditions.
 //
 //  PDE: -Laplace u = lambda_k u,
 //  where lambda_0, lambda_1, ... are the eigenvalues.
@@ -27,10 +27,10 @@ using Hermes::EigenSolver;
 const int NUMBER_OF_EIGENVALUES = 6;              // Desired number of eigenvalues. Maximum is 6.
 int P_INIT = 2;                                   // Uniform polynomial degree of mesh elements.
 const int INIT_REF_NUM = 2;                       // Number of initial mesh refinements.
-double TARGET_VALUE = 2.0;                        // PySparse parameter: Eigenvalues in the vicinity of 
+double TARGET_VALUE = 2.0;                        // Eigensolver parameter: Eigenvalues in the vicinity of 
                                                   // this number will be computed. 
-double TOL = 1e-10;                               // Pysparse parameter: Error tolerance.
-int MAX_ITER = 1000;                              // PySparse parameter: Maximum number of iterations.
+double TOL = 1e-10;                               // Eigensolver parameter: Error tolerance.
+int MAX_ITER = 1000;                              // Eigensolver parameter: Maximum number of iterations.
 const double THRESHOLD = 0.3;                     // This is a quantitative parameter of the adapt(...) function and
                                                   // it has different meanings for various adaptive strategies (see below).
 const int STRATEGY = 0;                           // Adaptive strategy:
@@ -145,9 +145,9 @@ int main(int argc, char* argv[])
     cpu_time.tick();
 
     EigenSolver es(matrix_left, matrix_right);
-    info("Calling Pysparse...");
+    info("Calling the eigensolver...");
     es.solve(NUMBER_OF_EIGENVALUES, TARGET_VALUE, TOL, MAX_ITER);
-    info("Pysparse finished.");
+    info("Eigensolver finished.");
     es.print_eigenvalues();
 
     // Initializing solution vector, solution and ScalarView.
@@ -45,6 +45,8 @@ const char* preconditioner = "jacobi";            // Name of the preconditioner
                                                   // preconditioner from IFPACK (see solver/aztecoo.h).
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  // Possibilities: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
                                                   // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
+const int NUM_THREADS = 1;                         // Number of threads used in assembling (has effect only if 
+                                                  // Hermes was built with WITH_OPENMP).
 
 // Problem parameters.
 const double mu_r   = 1.0;
@@ -111,6 +113,7 @@ int main(int argc, char **args)
     // Initialize discrete problem.
     bool is_linear = true;
     DiscreteProblem dp(&wf, ref_space, is_linear);
+    dp.set_num_threads(NUM_THREADS);
 
     // Set up the solver, matrix, and rhs according to the solver selection.
     SparseMatrix* matrix = create_matrix(matrix_solver);
@@ -127,7 +130,10 @@ int main(int argc, char **args)
 
     // Assemble the reference problem.
     info("Assembling on reference mesh (ndof: %d).", Space::get_num_dofs(ref_space));
+    TimePeriod asm_time;
     dp.assemble(matrix, rhs);
+    asm_time.tick();
+    info("Assembling time: %g s (%d threads).", asm_time.last(), NUM_THREADS);
 
     // Time measurement.
     cpu_time.tick();
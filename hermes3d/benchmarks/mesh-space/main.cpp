@@ -0,0 +1,84 @@
+#define HERMES_REPORT_WARN
+#define HERMES_REPORT_INFO
+#include <hermes3d.h>
+#ifndef _MSC_VER
+  #include <sys/resource.h>
+#endif
+
+//  This benchmark measures the cost of the mesh and space data structures on a large
+//  hexahedral mesh. The mesh "hex4.mesh3d" (4 hexes) is refined uniformly INIT_REF_NUM
+//  times (every refinement multiplies the number of elements by 8, the default of 6
+//  refinements gives 1 048 576 active elements). The benchmark reports
+//    - the time to load and refine the mesh (construction of vertices, edges, facets
+//      and elements),
+//    - the time to create an H1 space on it (data tables, constraints and DOF numbering),
+//    - the time of one more call to assign_dofs() on the existing space,
+//    - the peak resident memory of the process after every phase.
+//
+//  Usage: mesh-space [init_ref_num] [p_init]
+
+int INIT_REF_NUM = 6;                             // Number of initial uniform mesh refinements.
+int P_INIT = 2;                                   // Polynomial degree of all mesh elements.
+
+// Peak resident set size of the process in kB.
+static long peak_memory()
+{
+#ifndef _MSC_VER
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+#else
+  return 0;
+#endif
+}
+
+BCType bc_types(int marker)
+{
+  return H3D_BC_ESSENTIAL;
+}
+
+scalar essential_bc_values(int ess_bdy_marker, double x, double y, double z)
+{
+  return 0.0;
+}
+
+int main(int argc, char **args)
+{
+  if (argc > 1) INIT_REF_NUM = atoi(args[1]);
+  if (argc > 2) P_INIT = atoi(args[2]);
+
+  // Load and refine the mesh.
+  TimePeriod timer;
+  Mesh mesh;
+  H3DReader mloader;
+  mloader.load("hex4.mesh3d", &mesh);
+  for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements(H3D_H3D_H3D_REFT_HEX_XYZ);
+  timer.tick();
+  double t_mesh = timer.last();
+  long mem_mesh = peak_memory();
+
+  printf("elements: %u active, %lu total\n", mesh.get_num_active_elements(),
+         (unsigned long) mesh.elements.size());
+  printf("facets: %lu, edges: %lu, vertices: %lu\n", (unsigned long) mesh.facets.size(),
+         (unsigned long) mesh.edges.size(), (unsigned long) mesh.vertices.size());
+
+  // Create the space (this assigns the DOFs).
+  timer.tick(HERMES_SKIP);
+  H1Space space(&mesh, bc_types, essential_bc_values, Ord3(P_INIT, P_INIT, P_INIT));
+  timer.tick();
+  double t_space = timer.last();
+  long mem_space = peak_memory();
+
+  // Assign the DOFs again.
+  timer.tick(HERMES_SKIP);
+  int ndof = space.assign_dofs();
+  timer.tick();
+  double t_assign = timer.last();
+
+  printf("ndof: %d\n", ndof);
+  printf("%-32s %10.3f s, peak memory %8ld MB\n", "mesh construction:", t_mesh, mem_mesh / 1024);
+  printf("%-32s %10.3f s, peak memory %8ld MB\n", "space construction:", t_space, mem_space / 1024);
+  printf("%-32s %10.3f s\n", "assign_dofs:", t_assign);
+
+  return 0;
+}
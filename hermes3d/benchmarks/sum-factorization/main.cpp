@@ -0,0 +1,110 @@
+#define HERMES_REPORT_WARN
+#define HERMES_REPORT_INFO
+#include <hermes3d.h>
+
+//  This benchmark compares the standard assembling of the diffusion-reaction form
+//
+//    a(u, v) = \int (K grad u . grad v + C u v)
+//
+//  with the sum factorization (WeakForm::add_matrix_form_diffusion(), see SumFactHex) on
+//  one (non-affine) hexahedron "hex1.mesh3d" for the polynomial degrees P_MIN, ..., P_MAX.
+//  For every degree the benchmark reports
+//    - the time to assemble the matrix with a user-defined form (every pair of shape
+//      functions is integrated separately) and with the diffusion form (sum factorization),
+//    - the time of NUM_APPLY products of the local matrix with a vector and of the same
+//      number of matrix-free products SumFactHex::apply().
+//
+//  Usage: sum-factorization [p_min] [p_max]
+
+int P_MIN = 4;                                    // Lowest polynomial degree.
+int P_MAX = 10;                                   // Highest polynomial degree.
+const int NUM_APPLY = 100;                        // Number of the matrix-vector products.
+
+const double K = 1.0;                             // Diffusion coefficient.
+const double C = 1.0;                             // Reaction coefficient.
+
+BCType bc_types(int marker)
+{
+  return H3D_BC_NATURAL;
+}
+
+template<typename Real, typename Scalar>
+Scalar bilinear_form(int n, double *wt, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v, Geom<Real> *e,
+                     ExtData<Scalar> *data)
+{
+  return K * int_grad_u_grad_v<Real, Scalar>(n, wt, u, v, e) + C * int_u_v<Real, Scalar>(n, wt, u, v, e);
+}
+
+// Assemble the matrix with the user-defined (sum_fact == false) or the diffusion form.
+double assemble(Space *space, bool sum_fact)
+{
+  WeakForm wf;
+  if (sum_fact) wf.add_matrix_form_diffusion(K, C);
+  else wf.add_matrix_form(callback(bilinear_form), HERMES_SYM);
+
+  CSCMatrix mat;
+  TimePeriod timer;
+  DiscreteProblem dp(&wf, space, true);
+  dp.assemble(&mat);
+  timer.tick();
+  return timer.last();
+}
+
+int main(int argc, char **args)
+{
+  if (argc > 1) P_MIN = atoi(args[1]);
+  if (argc > 2) P_MAX = atoi(args[2]);
+
+  Mesh mesh;
+  H3DReader mloader;
+  mloader.load("hex1.mesh3d", &mesh);
+  Element *e = mesh.elements[1];
+
+  printf("%3s %6s %14s %14s %8s %14s %14s %8s\n", "p", "ndof", "assemble [s]", "sum fact [s]", "speedup",
+         "mat-vec [s]", "apply [s]", "speedup");
+  for (int p = P_MIN; p <= P_MAX; p++) {
+    H1Space space(&mesh, bc_types, NULL, Ord3(p, p, p));
+    int ndof = space.get_num_dofs();
+
+    double t_asm = assemble(&space, false);
+    double t_sf = assemble(&space, true);
+
+    // Matrix-vector products on the element.
+    AsmList al;
+    space.get_element_assembly_list(e, &al);
+    RefMap refmap(&mesh);
+    refmap.set_active_element(e);
+    SumFactHex sum_fact;
+    sum_fact.set_functions(space.get_shapeset(), al.cnt, al.idx);
+    sum_fact.set_geometry(&refmap, refmap.get_inv_ref_order() + Ord3(2 * p, 2 * p, 2 * p), K, C);
+
+    scalar **mat = new_matrix<scalar>(al.cnt, al.cnt);
+    sum_fact.calc_matrix(mat);
+    scalar *x = new scalar[al.cnt];
+    scalar *y = new scalar[al.cnt];
+    for (int i = 0; i < al.cnt; i++) x[i] = 1.0 / (i + 1);
+
+    TimePeriod timer;
+    for (int k = 0; k < NUM_APPLY; k++)
+      for (int i = 0; i < al.cnt; i++) {
+        y[i] = 0.0;
+        for (int j = 0; j < al.cnt; j++) y[i] += mat[i][j] * x[j];
+      }
+    timer.tick();
+    double t_mv = timer.last();
+
+    timer.tick(HERMES_SKIP);
+    for (int k = 0; k < NUM_APPLY; k++) sum_fact.apply(x, y);
+    timer.tick();
+    double t_apply = timer.last();
+
+    printf("%3d %6d %14.4f %14.4f %8.1f %14.4f %14.4f %8.1f\n", p, ndof, t_asm, t_sf, t_asm / t_sf,
+           t_mv, t_apply, t_mv / t_apply);
+
+    delete [] mat;
+    delete [] x;
+    delete [] y;
+  }
+
+  return 0;
+}
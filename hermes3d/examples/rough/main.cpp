@@ -162,7 +162,7 @@ int main(int argc, char **args)
 	{
 		std::cout << "Performing Refinement Level: " << iter << std::endl ;
 		further = false ;
-	  for(std::map<unsigned int, Element*>::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++)
+	  for(ElementMap::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++)
       if ( it->second->used)
         if (it->second->active)
 		    {
@@ -217,10 +217,10 @@ int main(int argc, char **args)
 	}
 
 
-	for(std::map<unsigned int, Vertex*>::iterator it = mesh.vertices.begin(); it != mesh.vertices.end(); it++)
+	for(VertexMap::iterator it = mesh.vertices.begin(); it != mesh.vertices.end(); it++)
     if( std::abs(mesh.vertices[it->first]->z - 0.) < 1e-32 ) mesh.vertices[it->first]->z = r1.interpolate(mesh.vertices[it->first]->x,mesh.vertices[it->first]->y) ;	
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++)
+	for(ElementMap::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++)
 		if ( mesh.elements[it->first]->used) if (mesh.elements[it->first]->active)
 		{
 			std::vector<unsigned int> vtcs(mesh.elements[it->first]->get_num_vertices()) ;
@@ -94,7 +94,7 @@ int main(int argc, char* argv[])
   int io,ir=0;
   while(ir<REF_ORIGIN) {
     io=0;
-    for(std::map<unsigned int, Element*>::const_iterator it=mesh.elements.begin(); it != mesh.elements.end(); it++) {
+    for(ElementMap::const_iterator it=mesh.elements.begin(); it != mesh.elements.end(); it++) {
       Element *e=it->second;
       if (e->active) {
 	info("element id= %d",it->first);
@@ -967,7 +967,7 @@ double Adapt::calc_err_internal(Hermes::vector<Solution *> slns, Hermes::vector<
   {
     k = 0;
     for (i = 0; i < num; i++)
-      for(std::map<unsigned int, Element*>::iterator it = meshes[i]->elements.begin(); it != meshes[i]->elements.end(); it++)
+      for(ElementMap::iterator it = meshes[i]->elements.begin(); it != meshes[i]->elements.end(); it++)
 		    if (it->second->used)
 			    if (it->second->active) {
             Element *e = it->second;
@@ -25,8 +25,17 @@
 #include "space/space.h"
 #include "discrete_problem.h"
 #include "traverse.h"
+#include "solution.h"
+#include "sumfact.h"
+#include "integrals/h1.h"
 #include "../../hermes_common/error.h"
 #include "../../hermes_common/callstack.h"
+#include "../../hermes_common/solver/umfpack_solver.h"
+#include "../../hermes_common/solver/matrix_free.h"
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
 
 
 DiscreteProblem::FnCache::~FnCache()
@@ -79,6 +88,8 @@ DiscreteProblem::DiscreteProblem(WeakForm *wf, Hermes::vector<Space *> spaces, b
   struct_changed = true;
 
   have_matrix = false;
+  num_threads = 1;
+  sum_fact = NULL;
 
   this->spaces = Hermes::vector<Space *>();
   for (int i = 0; i < wf->neq; i++) this->spaces.push_back(spaces[i]);
@@ -107,6 +118,8 @@ DiscreteProblem::DiscreteProblem(WeakForm *wf, Space* space, bool is_linear)
   struct_changed = true;
 
   have_matrix = false;
+  num_threads = 1;
+  sum_fact = NULL;
 
   this->spaces = Hermes::vector<Space *>();
   for (int i = 0; i < wf->neq; i++) this->spaces.push_back(space);
@@ -116,6 +129,30 @@ DiscreteProblem::DiscreteProblem(WeakForm *wf, Space* space, bool is_linear)
   this->ndof = space->get_num_dofs();
 }
 
+DiscreteProblem::DiscreteProblem(DiscreteProblem *master)
+{
+  _F_
+  this->wf = master->wf;
+  this->spaces = master->spaces;
+  this->is_linear = master->is_linear;
+
+  sp_seq = new int[wf->neq];
+  memset(sp_seq, -1, sizeof(int) * wf->neq);
+  wf_seq = -1;
+
+  matrix_buffer = NULL;
+  matrix_buffer_dim = 0;
+
+  values_changed = true;
+  struct_changed = true;
+
+  have_matrix = false;
+  have_spaces = true;
+  num_threads = 1;
+  sum_fact = NULL;
+
+  this->ndof = master->ndof;
+}
 
 DiscreteProblem::~DiscreteProblem()
 {
@@ -123,6 +160,7 @@ DiscreteProblem::~DiscreteProblem()
   free();
   if (sp_seq != NULL) delete [] sp_seq;
   wf_seq = -1;
+  delete sum_fact;
 }
 
 void DiscreteProblem::free()
@@ -133,6 +171,18 @@ void DiscreteProblem::free()
   wf_seq = -1;
 }
 
+void DiscreteProblem::set_num_threads(int num_threads)
+{
+  _F_
+  if (num_threads < 1)
+    error("The number of threads has to be positive in DiscreteProblem::set_num_threads().");
+#ifndef _OPENMP
+  if (num_threads > 1)
+    warn("Hermes3D was built without OpenMP (WITH_OPENMP), the assembling will be serial.");
+#endif
+  this->num_threads = num_threads;
+}
+
 int DiscreteProblem::get_num_dofs()
 {
   _F_
@@ -188,6 +238,15 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix *mat, Vector* rhs,
 {
   _F_
 
+  // The matrix-free operator of apply() has no structure, and it does not count as the
+  // matrix whose structure is kept.
+  if (dynamic_cast<MatrixFreeOperator *>(mat) != NULL)
+  {
+    mat->prealloc(get_num_dofs());
+    if (rhs != NULL) rhs->alloc(get_num_dofs());
+    return;
+  }
+
   if (is_up_to_date())
   {
     if (mat != NULL) 
@@ -241,11 +300,7 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix *mat, Vector* rhs,
 
             // pretend assembling of the element stiffness matrix
             // register nonzero elements
-            for (int i = 0; i < am->cnt; i++)
-              if (am->dof[i] >= 0)
-                for (int j = 0; j < an->cnt; j++)
-                  if (an->dof[j] >= 0)
-                    mat->pre_add_ij(am->dof[i], an->dof[j]);
+            mat->pre_add_block(am->dof, am->cnt, an->dof, an->cnt);
           }
         }
       }
@@ -318,11 +373,9 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat, Vector* rhs
   AsmList *al = new AsmList[wf->neq];
   bool *nat = new bool[wf->neq];
   bool *isempty = new bool[wf->neq];
-  AsmList *am, *an;
 
   ShapeFunction *base_fn = new ShapeFunction[wf->neq];
   ShapeFunction *test_fn = new ShapeFunction[wf->neq];
-  ShapeFunction *fu, *fv;
   RefMap * refmap = new RefMap[wf->neq];
   for (int i = 0; i < wf->neq; i++) 
   {
@@ -352,305 +405,584 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat, Vector* rhs
   {
     WeakForm::Stage *s = &stages[ss];
     for (unsigned i = 0; i < s->idx.size(); i++) s->fns[i] = &base_fn[s->idx[i]];
-    trav.begin(s->meshes.size(), &(s->meshes.front()), &(s->fns.front()));
 
-    // assemble one stage
-    Element **e;
-    while ((e = trav.get_next_state(bnd, surf_pos)) != NULL) 
+    if (num_threads > 1 && is_parallel_assembling_possible(s, mat, rhs))
+      assemble_stage_parallel(s, mat, rhs, u_ext);
+    else
     {
-      // find a non-NULL e[i]
-      Element *e0;
-      for (unsigned int i = 0; i < s->idx.size(); i++)
-        if ((e0 = e[i]) != NULL) break;
-      if (e0 == NULL) continue;
-
-      // H2D has here:
-      /* update_limit_table(e0->get_mode()); */
-
-      // Obtain assembly lists for the element at all spaces of the stage, set appropriate mode for each pss.
-      // NOTE: Active elements and transformations for external functions (including the solutions from previous
-      // Newton's iteration) as well as basis functions (master PrecalcShapesets) have already been set in 
-      // trav.get_next_state(...).
-      memset(isempty, 0, sizeof(bool) * wf->neq);
-      for (unsigned int i = 0; i < s->idx.size(); i++)
-      {
-        int j = s->idx[i];
-        if (e[i] == NULL) 
-        { 
-          isempty[j] = true; 
-          continue; 
-        }
+      trav.begin(s->meshes.size(), &(s->meshes.front()), &(s->fns.front()));
 
-        // TODO: do not obtain again if the element was not changed.
-        spaces[j]->get_element_assembly_list(e[i], al + j);
+      // assemble one stage
+      Element **e;
+      while ((e = trav.get_next_state(bnd, surf_pos)) != NULL) 
+        assemble_state(s, mat, rhs, u_ext, e, bnd, surf_pos, trav.get_base(), base_fn, test_fn, 
+                       refmap, al, nat, isempty);
 
-        // This is different in H2D (PrecalcShapeset is used).
-        test_fn[j].set_active_element(e[i]);
-        test_fn[j].set_transform(base_fn + j);
+      trav.finish();
+    }
 
-        // This is different in H2D (PrecalcShapeset is used).
-        refmap[j].set_active_element(e[i]);
-        refmap[j].force_transform(base_fn[j].get_transform(), base_fn[j].get_ctm());
-      }
-      int marker = e0->marker;
+    if (mat != NULL) mat->finish();
+    if (rhs != NULL) rhs->finish();
+  }
+ 
+  // Cleaning up.
+  if (matrix_buffer != NULL) delete [] matrix_buffer;
+  matrix_buffer = NULL;
+  matrix_buffer_dim = 0;
+
+  // Delete temporary solutions.
+  for (int i = 0; i < wf->neq; i++) 
+  {
+    if (u_ext[i] != NULL) 
+    {
+      delete u_ext[i];
+      u_ext[i] = NULL;
+    }
+  }
+
+  // Clean up.
+  delete [] isempty;
+  delete [] nat;
+  delete [] al;
+  delete [] base_fn;
+  delete [] test_fn;
+  delete [] refmap;
+}
 
-      fn_cache.free();  // This is different in H2D.
+//// matrix-free operator ///////////////////////////////////////////////////////////////////////////
+
+void DiscreteProblem::apply(scalar* coeff_vec, scalar* coeff_in, scalar* coeff_out)
+{
+  _F_
+  memset(coeff_out, 0, get_num_dofs() * sizeof(scalar));
+  MatrixFreeOperator op;
+  op.set_vectors(coeff_in, coeff_out);
+  assemble(coeff_vec, &op);
+}
 
-      if (mat != NULL) 
+void DiscreteProblem::get_diagonal(scalar* coeff_vec, scalar* diag)
+{
+  _F_
+  memset(diag, 0, get_num_dofs() * sizeof(scalar));
+  MatrixFreeOperator op;
+  op.set_vectors(NULL, NULL, diag);
+  assemble(coeff_vec, &op);
+}
+
+void DiscreteProblem::assemble_state(WeakForm::Stage *s, SparseMatrix *mat, Vector *rhs, 
+                                     Hermes::vector<Solution *> &u_ext, Element **e, bool *bnd, 
+                                     SurfPos *surf_pos, Element *base, ShapeFunction *base_fn, 
+                                     ShapeFunction *test_fn, RefMap *refmap, AsmList *al, bool *nat, 
+                                     bool *isempty)
+{
+  _F_
+  AsmList *am, *an;
+  ShapeFunction *fu, *fv;
+
+  // find a non-NULL e[i]
+  Element *e0;
+  for (unsigned int i = 0; i < s->idx.size(); i++)
+    if ((e0 = e[i]) != NULL) break;
+  if (e0 == NULL) return;
+
+  // H2D has here:
+  /* update_limit_table(e0->get_mode()); */
+
+  // Obtain assembly lists for the element at all spaces of the stage, set appropriate mode for each pss.
+  // NOTE: Active elements and transformations for external functions (including the solutions from previous
+  // Newton's iteration) as well as basis functions (master PrecalcShapesets) have already been set in 
+  // trav.get_next_state(...).
+  memset(isempty, 0, sizeof(bool) * wf->neq);
+  for (unsigned int i = 0; i < s->idx.size(); i++)
+  {
+    int j = s->idx[i];
+    if (e[i] == NULL) 
+    { 
+      isempty[j] = true; 
+      continue; 
+    }
+
+    // TODO: do not obtain again if the element was not changed.
+    spaces[j]->get_element_assembly_list(e[i], al + j);
+
+    // This is different in H2D (PrecalcShapeset is used).
+    test_fn[j].set_active_element(e[i]);
+    test_fn[j].set_transform(base_fn + j);
+
+    // This is different in H2D (PrecalcShapeset is used).
+    refmap[j].set_active_element(e[i]);
+    refmap[j].force_transform(base_fn[j].get_transform(), base_fn[j].get_ctm());
+  }
+  int marker = e0->marker;
+
+  fn_cache.free();  // This is different in H2D.
+
+  if (mat != NULL) 
+  {
+    // assemble volume matrix forms //////////////////////////////////////
+    for (unsigned ww = 0; ww < s->mfvol.size(); ww++) 
+    {
+      WeakForm::MatrixFormVol *mfv = s->mfvol[ww];
+      if (isempty[mfv->i] || isempty[mfv->j]) continue;
+      if (mfv->area != HERMES_ANY_INT && !wf->is_in_area(marker, mfv->area)) continue;
+      int m = mfv->i; fv = test_fn + m; am = al + m;
+      int n = mfv->j; fu = base_fn + n; an = al + n;
+      bool tra = (m != n) && (mfv->sym != HERMES_NONSYM);
+      bool sym = (m == n) && (mfv->sym == HERMES_SYM);
+
+      /* BEGIN IDENTICAL CODE WITH H2D */
+
+      // matrix-free application of a diffusion form
+      MatrixFreeOperator *op = dynamic_cast<MatrixFreeOperator *>(mat);
+      if (mfv->fn == NULL && op != NULL && op->get_diagonal() == NULL && rhs == NULL
+          && apply_sum_fact(mfv, fu, fv, refmap + n, refmap + m, an, am, op))
+        continue;
+
+      // assemble the local stiffness matrix for the form mfv
+      scalar **local_stiffness_matrix = get_matrix_buffer(std::max(am->cnt, an->cnt));
+      if (mfv->fn == NULL && calc_sum_fact_matrix(mfv, fu, fv, refmap + n, refmap + m, an, am, local_stiffness_matrix))
       {
-        // assemble volume matrix forms //////////////////////////////////////
-        for (unsigned ww = 0; ww < s->mfvol.size(); ww++) 
-        {
-          WeakForm::MatrixFormVol *mfv = s->mfvol[ww];
-          if (isempty[mfv->i] || isempty[mfv->j]) continue;
-          if (mfv->area != HERMES_ANY_INT && !wf->is_in_area(marker, mfv->area)) continue;
-          int m = mfv->i; fv = test_fn + m; am = al + m;
-          int n = mfv->j; fu = base_fn + n; an = al + n;
-          bool tra = (m != n) && (mfv->sym != HERMES_NONSYM);
-          bool sym = (m == n) && (mfv->sym == HERMES_SYM);
-
-          /* BEGIN IDENTICAL CODE WITH H2D */
-
-          // assemble the local stiffness matrix for the form mfv
-          scalar **local_stiffness_matrix = get_matrix_buffer(std::max(am->cnt, an->cnt));
-          for (int i = 0; i < am->cnt; i++)
+        for (int i = 0; i < am->cnt; i++)
+          for (int j = 0; j < an->cnt; j++)
           {
-            if (!tra && am->dof[i] < 0) continue;
-            fv->set_active_shape(am->idx[i]);
+            local_stiffness_matrix[i][j] *= an->coef[j] * am->coef[i];
+            // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
+            if (rhs != NULL && this->is_linear && am->dof[i] >= 0 && an->dof[j] < 0)
+              rhs->add(am->dof[i], -local_stiffness_matrix[i][j]);
+          }
+      }
+      else
+      {
+        for (int i = 0; i < am->cnt; i++)
+        {
+          if (!tra && am->dof[i] < 0) continue;
+          fv->set_active_shape(am->idx[i]);
 
-            if (!sym) // unsymmetric block
+          if (!sym) // unsymmetric block
+          {
+            for (int j = 0; j < an->cnt; j++) 
             {
-              for (int j = 0; j < an->cnt; j++) 
+              fu->set_active_shape(an->idx[j]);
+              if (an->dof[j] < 0) 
               {
-                fu->set_active_shape(an->idx[j]);
-                if (an->dof[j] < 0) 
-                {
-                  // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
-                  if (rhs != NULL && this->is_linear) 
-                  {
-                    scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
-                    rhs->add(am->dof[i], -val);
-                  } 
-                }
-                else if (mat != NULL) 
+                // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
+                if (rhs != NULL && this->is_linear) 
                 {
                   scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
-                  local_stiffness_matrix[i][j] = val;
-                }
+                  rhs->add(am->dof[i], -val);
+                } 
+              }
+              else if (mat != NULL) 
+              {
+                scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
+                local_stiffness_matrix[i][j] = val;
               }
             }
-            else // symmetric block
+          }
+          else // symmetric block
+          {
+            for (int j = 0; j < an->cnt; j++) 
             {
-              for (int j = 0; j < an->cnt; j++) 
+              if (j < i && an->dof[j] >= 0) continue;
+              fu->set_active_shape(an->idx[j]);
+              if (an->dof[j] < 0) 
               {
-                if (j < i && an->dof[j] >= 0) continue;
-                fu->set_active_shape(an->idx[j]);
-                if (an->dof[j] < 0) 
-                {
-                  // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
-                  if (rhs != NULL && this->is_linear) 
-                  {
-                    scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
-                    rhs->add(am->dof[i], -val);
-                  }
-                } 
-                else if (mat != NULL) 
+                // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
+                if (rhs != NULL && this->is_linear) 
                 {
                   scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
-                  local_stiffness_matrix[i][j] = local_stiffness_matrix[j][i] = val;
+                  rhs->add(am->dof[i], -val);
                 }
+              } 
+              else if (mat != NULL) 
+              {
+                scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
+                local_stiffness_matrix[i][j] = local_stiffness_matrix[j][i] = val;
               }
             }
           }
+        }
+      }
 
-          // insert the local stiffness matrix into the global one
-          if (mat != NULL)
-            mat->add(am->cnt, an->cnt, local_stiffness_matrix, am->dof, an->dof);
+      // insert the local stiffness matrix into the global one
+      if (mat != NULL)
+        mat->add(am->cnt, an->cnt, local_stiffness_matrix, am->dof, an->dof);
 
-          // insert also the off-diagonal (anti-)symmetric block, if required
-          if (tra)
-          {
-            if (mfv->sym < 0) 
-              chsgn(local_stiffness_matrix, am->cnt, an->cnt);
-            
-            transpose(local_stiffness_matrix, am->cnt, an->cnt);
+      // insert also the off-diagonal (anti-)symmetric block, if required
+      if (tra)
+      {
+        if (mfv->sym < 0) 
+          chsgn(local_stiffness_matrix, am->cnt, an->cnt);
+        
+        transpose(local_stiffness_matrix, am->cnt, an->cnt);
 
-            if (mat != NULL) 
-              mat->add(an->cnt, am->cnt, local_stiffness_matrix, an->dof, am->dof);
+        if (mat != NULL) 
+          mat->add(an->cnt, am->cnt, local_stiffness_matrix, an->dof, am->dof);
 
-            // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
-            if (rhs != NULL && this->is_linear) 
+        // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
+        if (rhs != NULL && this->is_linear) 
+        {
+          for (int j = 0; j < am->cnt; j++) 
+          {
+            if (am->dof[j] < 0) 
             {
-              for (int j = 0; j < am->cnt; j++) 
+              for (int i = 0; i < an->cnt; i++) 
               {
-                if (am->dof[j] < 0) 
+                if (an->dof[i] >= 0) 
                 {
-                  for (int i = 0; i < an->cnt; i++) 
-                  {
-                    if (an->dof[i] >= 0) 
-                    {
-                      rhs->add(an->dof[i], -local_stiffness_matrix[i][j]);
-                    }
-                  }
+                  rhs->add(an->dof[i], -local_stiffness_matrix[i][j]);
                 }
               }
             }
           }
         }
       }
+    }
+  }
 
-      /* END IDENTICAL CODE WITH H2D
-         Assembling of volume vector forms below is almost identical, there
-         is only one line of difference that is highlighted below */
+  /* END IDENTICAL CODE WITH H2D
+     Assembling of volume vector forms below is almost identical, there
+     is only one line of difference that is highlighted below */
 
-      //// assemble volume vector forms ////////////////////////////////////////
-      if (rhs != NULL)
+  //// assemble volume vector forms ////////////////////////////////////////
+  if (rhs != NULL)
+  {
+    for (unsigned int ww = 0; ww < s->vfvol.size(); ww++)
+    {
+      WeakForm::VectorFormVol* vfv = s->vfvol[ww];
+      if (isempty[vfv->i]) continue;
+      if (vfv->area != HERMES_ANY_INT && !wf->is_in_area(marker, vfv->area)) continue;
+      int m = vfv->i;  
+      fv = test_fn + m;      // H2D uses fv = spss[m]
+      am = al + m;
+
+      for (int i = 0; i < am->cnt; i++)
       {
-        for (unsigned int ww = 0; ww < s->vfvol.size(); ww++)
-        {
-          WeakForm::VectorFormVol* vfv = s->vfvol[ww];
-          if (isempty[vfv->i]) continue;
-          if (vfv->area != HERMES_ANY_INT && !wf->is_in_area(marker, vfv->area)) continue;
-          int m = vfv->i;  
-          fv = test_fn + m;      // H2D uses fv = spss[m]
-          am = al + m;
-
-          for (int i = 0; i < am->cnt; i++)
-          {
-            if (am->dof[i] < 0) continue;
-            fv->set_active_shape(am->idx[i]);
-            scalar val = eval_form(vfv, u_ext, fv, refmap + m) * am->coef[i];
-            rhs->add(am->dof[i], val);
-          }
-        }
+        if (am->dof[i] < 0) continue;
+        fv->set_active_shape(am->idx[i]);
+        scalar val = eval_form(vfv, u_ext, fv, refmap + m) * am->coef[i];
+        rhs->add(am->dof[i], val);
       }
+    }
+  }
 
-      // assemble surface integrals now: loop through surfaces of the element
-      for (int isurf = 0; isurf < e0->get_num_surf(); isurf++)
-      {
-        fn_cache.free();  // This is not in H2D.
+  // assemble surface integrals now: loop through surfaces of the element
+  for (int isurf = 0; isurf < e0->get_num_surf(); isurf++)
+  {
+    fn_cache.free();  // This is not in H2D.
 
-        if (!bnd[isurf]) continue;
-        
-        int marker = surf_pos[isurf].marker;
+    if (!bnd[isurf]) continue;
+    
+    int marker = surf_pos[isurf].marker;
 
-        // obtain the list of shape functions which are nonzero on this surface
-        for (unsigned int i = 0; i < s->idx.size(); i++) 
-        {
-          if (e[i] == NULL) continue;
-          int j = s->idx[i];
-          if ((nat[j] = (spaces[j]->bc_type_callback(marker) == H3D_BC_NATURAL)))
-            spaces[j]->get_boundary_assembly_list(e[i], isurf, al + j);
-        }
+    // obtain the list of shape functions which are nonzero on this surface
+    for (unsigned int i = 0; i < s->idx.size(); i++) 
+    {
+      if (e[i] == NULL) continue;
+      int j = s->idx[i];
+      if ((nat[j] = (spaces[j]->bc_type_callback(marker) == H3D_BC_NATURAL)))
+        spaces[j]->get_boundary_assembly_list(e[i], isurf, al + j);
+    }
 
-        // assemble surface matrix forms ///////////////////////////////////
-        if (mat != NULL)
+    // assemble surface matrix forms ///////////////////////////////////
+    if (mat != NULL)
+    {
+      for (unsigned int ww = 0; ww < s->mfsurf.size(); ww++)
+      {
+        WeakForm::MatrixFormSurf* mfs = s->mfsurf[ww];
+        if (isempty[mfs->i] || isempty[mfs->j]) continue;
+        if (mfs->area != HERMES_ANY_INT && !wf->is_in_area(marker, mfs->area)) continue;
+        int m = mfs->i; 
+        int n = mfs->j; 
+        fu = base_fn + n;    // This is different in H2D.
+        fv = test_fn + m;    // This is different in H2D.
+        am = al + m;
+        an = al + n;
+
+        if (!nat[m] || !nat[n]) continue;
+        surf_pos[isurf].base = base;
+        surf_pos[isurf].space_v = spaces[m];
+        surf_pos[isurf].space_u = spaces[n];
+
+        scalar **local_stiffness_matrix = get_matrix_buffer(std::max(am->cnt, an->cnt));
+        for (int i = 0; i < am->cnt; i++)
         {
-          for (unsigned int ww = 0; ww < s->mfsurf.size(); ww++)
+          if (am->dof[i] < 0) continue;
+          fv->set_active_shape(am->idx[i]);
+          for (int j = 0; j < an->cnt; j++)
           {
-            WeakForm::MatrixFormSurf* mfs = s->mfsurf[ww];
-            if (isempty[mfs->i] || isempty[mfs->j]) continue;
-            if (mfs->area != HERMES_ANY_INT && !wf->is_in_area(marker, mfs->area)) continue;
-            int m = mfs->i; 
-            int n = mfs->j; 
-            fu = base_fn + n;    // This is different in H2D.
-            fv = test_fn + m;    // This is different in H2D.
-            am = al + m;
-            an = al + n;
-
-            if (!nat[m] || !nat[n]) continue;
-            surf_pos[isurf].base = trav.get_base();
-            surf_pos[isurf].space_v = spaces[m];
-            surf_pos[isurf].space_u = spaces[n];
-
-            scalar **local_stiffness_matrix = get_matrix_buffer(std::max(am->cnt, an->cnt));
-            for (int i = 0; i < am->cnt; i++)
+            fu->set_active_shape(an->idx[j]);
+            if (an->dof[j] < 0) 
             {
-              if (am->dof[i] < 0) continue;
-              fv->set_active_shape(am->idx[i]);
-              for (int j = 0; j < an->cnt; j++)
+              // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
+              if (rhs != NULL && this->is_linear) 
               {
-                fu->set_active_shape(an->idx[j]);
-                if (an->dof[j] < 0) 
-                {
-                  // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
-                  if (rhs != NULL && this->is_linear) 
-                  {
-                    scalar val = eval_form(mfs, u_ext, fu, fv, refmap + n, refmap + m, 
-                                           surf_pos + isurf) * an->coef[j] * am->coef[i];
-                    rhs->add(am->dof[i], -val);
-                  }
-                }
-                else if (mat != NULL) 
-                {
-                  scalar val = eval_form(mfs, u_ext, fu, fv, refmap + n, refmap + m, 
-                                         surf_pos + isurf) * an->coef[j] * am->coef[i];
-                  local_stiffness_matrix[i][j] = val;
-                } 
+                scalar val = eval_form(mfs, u_ext, fu, fv, refmap + n, refmap + m, 
+                                       surf_pos + isurf) * an->coef[j] * am->coef[i];
+                rhs->add(am->dof[i], -val);
               }
             }
-            if (mat != NULL) 
-              mat->add(am->cnt, an->cnt, local_stiffness_matrix, am->dof, an->dof);
+            else if (mat != NULL) 
+            {
+              scalar val = eval_form(mfs, u_ext, fu, fv, refmap + n, refmap + m, 
+                                     surf_pos + isurf) * an->coef[j] * am->coef[i];
+              local_stiffness_matrix[i][j] = val;
+            } 
           }
         }
+        if (mat != NULL) 
+          mat->add(am->cnt, an->cnt, local_stiffness_matrix, am->dof, an->dof);
+      }
+    }
 
-        // assemble surface vector forms /////////////////////////////////////
-        if (rhs != NULL)
+    // assemble surface vector forms /////////////////////////////////////
+    if (rhs != NULL)
+    {
+      for (unsigned int ww = 0; ww < s->vfsurf.size(); ww++)
+      {
+        WeakForm::VectorFormSurf* vfs = s->vfsurf[ww];
+        if (isempty[vfs->i]) continue;
+        if (vfs->area != HERMES_ANY_INT && !wf->is_in_area(marker, vfs->area)) continue;
+        int m = vfs->i; 
+        fv = test_fn + m;      // This is different from H2D.  
+        am = al + m;
+
+        if (!nat[m]) continue;
+        surf_pos[isurf].base = base;
+        surf_pos[isurf].space_v = spaces[m];
+
+        for (int i = 0; i < am->cnt; i++)
         {
-          for (unsigned int ww = 0; ww < s->vfsurf.size(); ww++)
-          {
-            WeakForm::VectorFormSurf* vfs = s->vfsurf[ww];
-            if (isempty[vfs->i]) continue;
-            if (vfs->area != HERMES_ANY_INT && !wf->is_in_area(marker, vfs->area)) continue;
-            int m = vfs->i; 
-            fv = test_fn + m;      // This is different from H2D.  
-            am = al + m;
-
-            if (!nat[m]) continue;
-            surf_pos[isurf].base = trav.get_base();
-            surf_pos[isurf].space_v = spaces[m];
-
-            for (int i = 0; i < am->cnt; i++)
-            {
-              if (am->dof[i] < 0) continue;
-              fv->set_active_shape(am->idx[i]);
-              scalar val = eval_form(vfs, u_ext, fv, refmap + m, surf_pos + isurf) * am->coef[i];
-              rhs->add(am->dof[i], val);
-            }
-          }
+          if (am->dof[i] < 0) continue;
+          fv->set_active_shape(am->idx[i]);
+          scalar val = eval_form(vfs, u_ext, fv, refmap + m, surf_pos + isurf) * am->coef[i];
+          rhs->add(am->dof[i], val);
         }
       }
-  
-      // H2D is deleting cache here.
     }
+  }
+}
 
-    if (mat != NULL) mat->finish();
-    if (rhs != NULL) rhs->finish();
-    trav.finish();
+bool DiscreteProblem::is_parallel_assembling_possible(WeakForm::Stage *s, SparseMatrix *mat, Vector *rhs)
+{
+  _F_
+#ifdef _OPENMP
+  // Concurrent additions to distinct entries are safe only for the plain CSC storage
+  // (and for the matrix-free operator, which adds to distinct entries of its vectors).
+  if (mat != NULL && dynamic_cast<CSCMatrix *>(mat) == NULL && dynamic_cast<MatrixFreeOperator *>(mat) == NULL) {
+    verbose("Parallel assembling is supported for CSCMatrix and MatrixFreeOperator only, assembling serially.");
+    return false;
+  }
+  if (rhs != NULL && dynamic_cast<UMFPackVector *>(rhs) == NULL) {
+    verbose("Parallel assembling is supported for UMFPackVector only, assembling serially.");
+    return false;
   }
- 
-  // Cleaning up.
-  if (matrix_buffer != NULL) delete [] matrix_buffer;
-  matrix_buffer = NULL;
-  matrix_buffer_dim = 0;
 
-  // Delete temporary solutions.
-  for (int i = 0; i < wf->neq; i++) 
-  {
-    if (u_ext[i] != NULL) 
-    {
-      delete u_ext[i];
-      u_ext[i] = NULL;
+  // Every thread needs its own copy of the external functions.
+  for (unsigned int i = 0; i < s->ext.size(); i++)
+    if (dynamic_cast<Solution *>(s->ext[i]) == NULL) {
+      verbose("Parallel assembling supports only Solutions as external functions, assembling serially.");
+      return false;
+    }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+// One state of the traversal recorded for the parallel assembling.
+struct ParallelAssemblingState
+{
+  Element *base;
+  unsigned int bnd;     // one bit per surface of the element
+  int surf_pos;         // index of the first surface position of the state, -1 if there is none
+};
+
+// Data private to one thread of the parallel assembling.
+struct ParallelAssemblingWorker
+{
+  DiscreteProblem *dp;
+  ShapeFunction *base_fn, *test_fn;
+  RefMap *refmap;
+  AsmList *al;
+  bool *nat, *isempty;
+  Hermes::vector<Solution *> u_ext;
+  std::vector<Solution *> ext;
+};
+
+void DiscreteProblem::assemble_stage_parallel(WeakForm::Stage *s, SparseMatrix *mat, Vector *rhs, 
+                                              Hermes::vector<Solution *> &u_ext)
+{
+  _F_
+#ifdef _OPENMP
+  unsigned int nfns = s->fns.size();
+  unsigned int nidx = s->idx.size();
+  int neq = wf->neq;
+
+  // Traverse the union mesh with plain Transformables in place of the stage functions,
+  // and record all states. The real functions are set up later by the workers.
+  Transformable *trav_fns = new Transformable[nfns];
+  std::vector<Transformable *> trav_fn_ptrs;
+  for (unsigned int i = 0; i < nfns; i++)
+    trav_fn_ptrs.push_back(trav_fns + i);
+
+  std::vector<ParallelAssemblingState> states;
+  std::vector<Element *> state_e;
+  std::vector<uint64> state_sub_idx;
+  std::vector<SurfPos> state_surf_pos;
+  std::vector<int> state_color;
+
+  // Colors already used by each DOF, one bit per color.
+  const int max_colors = 64;
+  std::vector<uint64> dof_colors(get_num_dofs(), 0);
+  std::vector<int> dofs;
+  AsmList al;
+
+  bool bnd[10];
+  SurfPos surf_pos[10];
+  Traverse trav;
+  Element **e;
+  trav.begin(s->meshes.size(), &(s->meshes.front()), &(trav_fn_ptrs.front()));
+  while ((e = trav.get_next_state(bnd, surf_pos)) != NULL) {
+    Element *e0 = NULL;
+    for (unsigned int i = 0; i < nidx; i++)
+      if ((e0 = e[i]) != NULL) break;
+    if (e0 == NULL) continue;
+
+    ParallelAssemblingState st;
+    st.base = trav.get_base();
+    st.bnd = 0;
+    st.surf_pos = -1;
+    for (int isurf = 0; isurf < e0->get_num_surf(); isurf++)
+      if (bnd[isurf]) st.bnd |= 1u << isurf;
+    if (st.bnd != 0) {
+      st.surf_pos = state_surf_pos.size();
+      state_surf_pos.insert(state_surf_pos.end(), surf_pos, surf_pos + e0->get_num_surf());
     }
+
+    for (unsigned int i = 0; i < nfns; i++) {
+      state_e.push_back(e[i]);
+      state_sub_idx.push_back(trav_fns[i].get_transform());
+    }
+
+    // Greedy coloring: the state gets the lowest color not used by any of its DOFs.
+    // The constrained shape functions of the state are prepared here, so that the 
+    // workers only read the tables of the shapesets.
+    dofs.clear();
+    for (unsigned int i = 0; i < nidx; i++) {
+      if (e[i] == NULL) continue;
+      Space *space = spaces[s->idx[i]];
+      space->get_element_assembly_list(e[i], &al);
+      for (int k = 0; k < al.cnt; k++) {
+        if (al.dof[k] >= 0) dofs.push_back(al.dof[k]);
+        if (al.idx[k] < 0) space->get_shapeset()->prepare_constrained_fn(al.idx[k]);
+      }
+    }
+    uint64 used = 0;
+    for (unsigned int k = 0; k < dofs.size(); k++)
+      used |= dof_colors[dofs[k]];
+    int color = max_colors;
+    for (int c = 0; c < max_colors; c++)
+      if (!(used & ((uint64) 1 << c))) {
+        color = c;
+        break;
+      }
+    if (color < max_colors)
+      for (unsigned int k = 0; k < dofs.size(); k++)
+        dof_colors[dofs[k]] |= (uint64) 1 << color;
+
+    states.push_back(st);
+    state_color.push_back(color);
+  }
+  trav.finish();
+  delete [] trav_fns;
+
+  // Sort the states into buckets by color. States that could not be colored go to 
+  // the last bucket, which is assembled by one thread.
+  std::vector<std::vector<int> > buckets(max_colors + 1);
+  for (unsigned int k = 0; k < states.size(); k++)
+    buckets[state_color[k]].push_back(k);
+
+  // Create the workers.
+  std::vector<ParallelAssemblingWorker> workers(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    ParallelAssemblingWorker &w = workers[t];
+    w.dp = new DiscreteProblem(this);
+    w.base_fn = new ShapeFunction[neq];
+    w.test_fn = new ShapeFunction[neq];
+    w.refmap = new RefMap[neq];
+    for (int i = 0; i < neq; i++) {
+      w.base_fn[i].set_shapeset(spaces[i]->get_shapeset());
+      w.test_fn[i].set_shapeset(spaces[i]->get_shapeset());
+      w.refmap[i].set_mesh(spaces[i]->get_mesh());
+      w.refmap[i].set_private_shapeset();
+    }
+    w.al = new AsmList[neq];
+    w.nat = new bool[neq];
+    w.isempty = new bool[neq];
+    for (unsigned int i = 0; i < s->ext.size(); i++) {
+      Solution *copy = new Solution(s->ext[i]->get_mesh());
+      copy->copy(static_cast<Solution *>(s->ext[i]));
+      copy->refmap->set_private_shapeset();
+      w.ext.push_back(copy);
+      w.dp->ext_copies[s->ext[i]] = copy;
+    }
+    for (unsigned int i = 0; i < u_ext.size(); i++)
+      w.u_ext.push_back(u_ext[i] == NULL ? NULL : static_cast<Solution *>(w.dp->get_ext_fn(u_ext[i])));
   }
 
-  // Clean up.
-  delete [] isempty;
-  delete [] nat;
-  delete [] al;
-  delete [] base_fn;
-  delete [] test_fn;
-  delete [] refmap;
+  for (unsigned int b = 0; b < buckets.size(); b++) {
+    std::vector<int> &bucket = buckets[b];
+    if (bucket.empty()) continue;
+
+    int bucket_threads = (b == (unsigned) max_colors) ? 1 : num_threads;
+    int nb = bucket.size();
+#pragma omp parallel for schedule(dynamic, 8) num_threads(bucket_threads)
+    for (int k = 0; k < nb; k++) {
+      ParallelAssemblingWorker &w = workers[omp_get_thread_num()];
+      int si = bucket[k];
+      ParallelAssemblingState &st = states[si];
+      Element **se = &state_e[si * nfns];
+
+      // Replay the state on the functions of the worker.
+      for (unsigned int i = 0; i < nfns; i++) {
+        if (se[i] == NULL) continue;
+        Transformable *fn;
+        if (i < nidx) fn = w.base_fn + s->idx[i];
+        else fn = w.ext[i - nidx];
+        fn->set_active_element(se[i]);
+        fn->set_transform(state_sub_idx[si * nfns + i]);
+      }
+
+      bool sbnd[10];
+      SurfPos ssurf_pos[10];
+      for (int isurf = 0; isurf < 10; isurf++) {
+        sbnd[isurf] = (st.bnd >> isurf) & 1;
+        if (sbnd[isurf]) ssurf_pos[isurf] = state_surf_pos[st.surf_pos + isurf];
+      }
+
+      w.dp->assemble_state(s, mat, rhs, w.u_ext, se, sbnd, ssurf_pos, st.base, w.base_fn, 
+                           w.test_fn, w.refmap, w.al, w.nat, w.isempty);
+    }
+  }
+
+  // Delete the workers.
+  for (int t = 0; t < num_threads; t++) {
+    ParallelAssemblingWorker &w = workers[t];
+    for (unsigned int i = 0; i < w.ext.size(); i++)
+      delete w.ext[i];
+    delete [] w.base_fn;
+    delete [] w.test_fn;
+    delete [] w.refmap;
+    delete [] w.al;
+    delete [] w.nat;
+    delete [] w.isempty;
+    if (w.dp->matrix_buffer != NULL) delete [] w.dp->matrix_buffer;
+    w.dp->matrix_buffer = NULL;
+    delete w.dp;
+  }
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -664,10 +996,11 @@ void DiscreteProblem::init_ext_fns(ExtData<scalar> &ext_data, std::vector<MeshFu
   mFunc **ext_fn = new mFunc * [ext_data.nf];
   for (int i = 0; i < ext_data.nf; i++) 
   {
-    fn_key_t key(ext[i]->seq, order, ext[i]->get_transform());
+    MeshFunction *fn = get_ext_fn(ext[i]);
+    fn_key_t key(fn->seq, order, fn->get_transform());
     if (fn_cache.ext.find(key) == fn_cache.ext.end()) 
     {
-      fn_cache.ext[key] = init_fn(ext[i], rm, np, pt);
+      fn_cache.ext[key] = init_fn(fn, rm, np, pt);
     }
     assert(fn_cache.ext[key] != NULL);
     ext_fn[i] = fn_cache.ext[key];
@@ -683,11 +1016,18 @@ void DiscreteProblem::init_ext_fns(ExtData<Ord> &fake_ext_data, std::vector<Mesh
   Func<Ord> **fake_ext_fn = new Func<Ord> *[fake_ext_data.nf];
   
   for (int i = 0; i < fake_ext_data.nf; i++) 
-    fake_ext_fn[i] = init_fn_ord(ext[i]->get_fn_order());
+    fake_ext_fn[i] = init_fn_ord(get_ext_fn(ext[i])->get_fn_order());
   
   fake_ext_data.fn = fake_ext_fn;
 }
 
+MeshFunction *DiscreteProblem::get_ext_fn(MeshFunction *fn)
+{
+  if (ext_copies.empty()) return fn;
+  std::map<MeshFunction *, MeshFunction *>::iterator it = ext_copies.find(fn);
+  return (it != ext_copies.end()) ? it->second : fn;
+}
+
 sFunc *DiscreteProblem::get_fn(ShapeFunction *fu, int order, RefMap *rm, const int np, const QuadPt3D *pt)
 {
   fn_key_t key(fu->get_active_shape(), order, fu->get_transform(), fu->get_shapeset()->id);
@@ -715,6 +1055,59 @@ mFunc *DiscreteProblem::get_fn(Solution *fu, int order, RefMap *rm, const int np
   return fn_cache.sln[key];
 }
 
+bool DiscreteProblem::init_sum_fact(WeakForm::MatrixFormVol *mfv, ShapeFunction *fu, ShapeFunction *fv,
+                                    RefMap *ru, RefMap *rv, AsmList *au, AsmList *av)
+{
+  _F_
+  Element *elem = fv->get_active_element();
+  if (elem->get_mode() != HERMES_MODE_HEX || fu->get_active_element() != elem) return false;
+  if (fu->get_transform() != 0 || fv->get_transform() != 0) return false;
+
+  if (sum_fact == NULL) sum_fact = new SumFactHex;
+  Shapeset *ssu = fu->get_shapeset(), *ssv = fv->get_shapeset();
+  if (!sum_fact->set_functions(ssv, av->cnt, av->idx, ssu, au->cnt, au->idx)) return false;
+
+  // The order for the pair of functions of the highest orders (see eval_form()).
+  int ou = 0, ov = 0;
+  for (int j = 0; j < au->cnt; j++) ou = std::max(ou, ssu->get_order(au->idx[j]).get_ord());
+  for (int i = 0; i < av->cnt; i++) ov = std::max(ov, ssv->get_order(av->idx[i]).get_ord());
+  Ord3 order = ru->get_inv_ref_order();
+  order += Ord3(ou + ov, ou + ov, ou + ov);
+  order.limit();
+
+  sum_fact->set_geometry(rv, order, mfv->diffusion, mfv->reaction);
+  return true;
+}
+
+bool DiscreteProblem::calc_sum_fact_matrix(WeakForm::MatrixFormVol *mfv, ShapeFunction *fu, ShapeFunction *fv,
+                                           RefMap *ru, RefMap *rv, AsmList *au, AsmList *av, scalar **mat)
+{
+  _F_
+  if (!init_sum_fact(mfv, fu, fv, ru, rv, au, av)) return false;
+  sum_fact->calc_matrix(mat);
+  return true;
+}
+
+bool DiscreteProblem::apply_sum_fact(WeakForm::MatrixFormVol *mfv, ShapeFunction *fu, ShapeFunction *fv,
+                                     RefMap *ru, RefMap *rv, AsmList *au, AsmList *av, MatrixFreeOperator *op)
+{
+  _F_
+  if (!init_sum_fact(mfv, fu, fv, ru, rv, au, av)) return false;
+
+  // The Dirichlet DOFs are not in the input vector (as in the assembled matrix).
+  const scalar *in = op->get_input();
+  scalar *out = op->get_output();
+  scalar *x = new scalar[au->cnt + av->cnt];
+  scalar *y = x + au->cnt;
+  for (int j = 0; j < au->cnt; j++)
+    x[j] = (au->dof[j] >= 0) ? in[au->dof[j]] * au->coef[j] : 0.0;
+  sum_fact->apply(x, y);
+  for (int i = 0; i < av->cnt; i++)
+    if (av->dof[i] >= 0) out[av->dof[i]] += y[i] * av->coef[i];
+  delete [] x;
+  return true;
+}
+
 scalar DiscreteProblem::eval_form(WeakForm::MatrixFormVol *mfv, Hermes::vector<Solution *> u_ext, ShapeFunction *fu,
                             ShapeFunction *fv, RefMap *ru, RefMap *rv)
 {
@@ -755,7 +1148,8 @@ scalar DiscreteProblem::eval_form(WeakForm::MatrixFormVol *mfv, Hermes::vector<S
   Geom<Ord> fake_e = init_geom(elem->marker);
 
   // Total order of the matrix form.
-  Ord o = mfv->ord(1, &fake_wt, oi, ou, ov, &fake_e, &fake_ext);
+  Ord o = (mfv->fn != NULL) ? mfv->ord(1, &fake_wt, oi, ou, ov, &fake_e, &fake_ext)
+                            : int_grad_u_grad_v<Ord, Ord>(1, &fake_wt, ou, ov, &fake_e);
 
   // Increase due to reference map.
   Ord3 order = ru->get_inv_ref_order();
@@ -815,7 +1209,10 @@ scalar DiscreteProblem::eval_form(WeakForm::MatrixFormVol *mfv, Hermes::vector<S
   ExtData<scalar> ext;
   init_ext_fns(ext, mfv->ext, ord_idx, rv, np, pt);
 
-  scalar res = mfv->fn(np, jwt, prev, u, v, &e, &ext);
+  scalar res;
+  if (mfv->fn != NULL) res = mfv->fn(np, jwt, prev, u, v, &e, &ext);
+  else res = mfv->diffusion * int_grad_u_grad_v<double, double>(np, jwt, u, v, &e) 
+             + mfv->reaction * int_u_v<double, double>(np, jwt, u, v, &e);
 
   // Clean up.
   delete [] prev;
@@ -33,6 +33,12 @@ class Space;
 class Matrix;
 class SparseMatrix;
 class Vector;
+class AsmList;
+class ShapeFunction;
+class RefMap;
+class Element;
+class SumFactHex;
+class MatrixFreeOperator;
 struct SurfPos;
 
 /// Discrete problem class
@@ -77,7 +83,31 @@ public:
   
   void invalidate_matrix() { have_matrix = false; }
 
+  // Matrix-free application of the operator: coeff_out = A coeff_in, where A is the matrix
+  // (the Jacobian for nonlinear problems, at the Newton vector coeff_vec) that assemble() 
+  // would create. The forms are evaluated element by element and the global matrix is never 
+  // stored. Diffusion forms on hexahedra are applied by sum factorization (SumFactHex::apply()).
+  void apply(scalar* coeff_vec, scalar* coeff_in, scalar* coeff_out);
+
+  // Light version for linear problems.
+  void apply(scalar* coeff_in, scalar* coeff_out) { apply(NULL, coeff_in, coeff_out); }
+
+  // Diagonal of the matrix that assemble() would create, without creating it.
+  void get_diagonal(scalar* coeff_vec, scalar* diag);
+
+  // Light version for linear problems.
+  void get_diagonal(scalar* diag) { get_diagonal(NULL, diag); }
+
+  // Set the number of threads used in assemble(). Has effect only if Hermes was built 
+  // with OpenMP (WITH_OPENMP). Stages with external functions that are not Solutions
+  // and matrices other than CSCMatrix are assembled serially.
+  void set_num_threads(int num_threads);
+  int get_num_threads() const { return num_threads; }
+
 protected:
+  // Worker of the parallel assembling, shares the weak form and the spaces with 'master'.
+  DiscreteProblem(DiscreteProblem *master);
+
 	WeakForm* wf;
 
         bool is_linear;
@@ -161,6 +191,40 @@ protected:
 	void init_ext_fns(ExtData<Ord> &fake_ud, std::vector<MeshFunction *> &ext);
 	void init_ext_fns(ExtData<scalar> &ud, std::vector<MeshFunction *> &ext, int order,
 	                  RefMap *rm, const int np, const QuadPt3D *pt);
+
+	// Assemble the forms of the stage 's' on one state of the traversal. The shape functions
+	// and the external functions have the element and the transformation of the state set.
+	void assemble_state(WeakForm::Stage *s, SparseMatrix *mat, Vector *rhs, 
+	                    Hermes::vector<Solution *> &u_ext, Element **e, bool *bnd, 
+	                    SurfPos *surf_pos, Element *base, ShapeFunction *base_fn, 
+	                    ShapeFunction *test_fn, RefMap *refmap, AsmList *al, bool *nat, 
+	                    bool *isempty);
+
+	// Assemble the stage 's' by several threads. The states of the stage are recorded 
+	// and colored so that states of one color do not share any DOF, then the states of 
+	// each color are assembled in parallel.
+	void assemble_stage_parallel(WeakForm::Stage *s, SparseMatrix *mat, Vector *rhs, 
+	                             Hermes::vector<Solution *> &u_ext);
+	bool is_parallel_assembling_possible(WeakForm::Stage *s, SparseMatrix *mat, Vector *rhs);
+
+	int num_threads;			/// number of threads used in assembling
+
+	// Diffusion forms (WeakForm::add_matrix_form_diffusion()) on hexahedra.
+	SumFactHex *sum_fact;
+	// Calculate the local matrix of the diffusion form 'mfv' by sum factorization.
+	// Returns false if it is not possible (other elements, constrained functions, transformations).
+	bool calc_sum_fact_matrix(WeakForm::MatrixFormVol *mfv, ShapeFunction *fu, ShapeFunction *fv,
+	                          RefMap *ru, RefMap *rv, AsmList *au, AsmList *av, scalar **mat);
+	// Apply the local matrix of the diffusion form 'mfv' to the input vector of the matrix-free
+	// operator 'op' by sum factorization. Returns false if it is not possible.
+	bool apply_sum_fact(WeakForm::MatrixFormVol *mfv, ShapeFunction *fu, ShapeFunction *fv,
+	                    RefMap *ru, RefMap *rv, AsmList *au, AsmList *av, MatrixFreeOperator *op);
+	bool init_sum_fact(WeakForm::MatrixFormVol *mfv, ShapeFunction *fu, ShapeFunction *fv,
+	                   RefMap *ru, RefMap *rv, AsmList *au, AsmList *av);
+
+	// Copies of the external functions private to a worker, indexed by the originals.
+	std::map<MeshFunction *, MeshFunction *> ext_copies;
+	MeshFunction *get_ext_fn(MeshFunction *fn);
 };
 
 HERMES_API bool solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solver, SparseMatrix* matrix,
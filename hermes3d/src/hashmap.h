@@ -0,0 +1,311 @@
+// This file is part of Hermes3D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes3D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes3D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes3D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef _HASHMAP_H_
+#define _HASHMAP_H_
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+/// Iterator over the items of IdMap and HashMap.
+///
+/// The iterator stores the position of the item in the contiguous storage of the map, so it
+/// stays valid when new items are inserted (as with std::map, the new items may or may not be
+/// visited by a running iteration).
+template<class MAP, class VALUE>
+class SlotIterator {
+public:
+  SlotIterator() : map(NULL), pos(0) { }
+  SlotIterator(MAP *map, size_t pos) : map(map), pos(pos) { skip(); }
+  /// Conversion from iterator to const_iterator.
+  template<class M, class V>
+  SlotIterator(const SlotIterator<M, V> &o) : map(o.map), pos(o.pos) { }
+
+  VALUE &operator*() const { return map->item(pos); }
+  VALUE *operator->() const { return &map->item(pos); }
+
+  SlotIterator &operator++() { pos++; skip(); return *this; }
+  SlotIterator operator++(int) { SlotIterator tmp = *this; pos++; skip(); return tmp; }
+
+  bool operator==(const SlotIterator &o) const { return pos == o.pos; }
+  bool operator!=(const SlotIterator &o) const { return pos != o.pos; }
+
+  MAP *map;
+  size_t pos;
+
+protected:
+  void skip() { while (pos < map->n_slots() && !map->is_live(pos)) pos++; }
+};
+
+
+/// Map with the interface of std::map for keys which are small dense ids (the ids of vertices,
+/// elements and boundaries are numbered from 1).
+///
+/// The items are stored in a contiguous array indexed directly by the id, so that the lookup is
+/// a single array access. The items are iterated in the increasing order of the ids (i.e. in the
+/// same order as in std::map).
+template<class T>
+class IdMap {
+public:
+  typedef unsigned int key_type;
+  typedef T mapped_type;
+  typedef std::pair<unsigned int, T> value_type;
+  typedef SlotIterator<IdMap, value_type> iterator;
+  typedef SlotIterator<const IdMap, const value_type> const_iterator;
+
+  IdMap() : n_items(0), free_id(1) { }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, items.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, items.size()); }
+
+  size_t size() const { return n_items; }
+  bool empty() const { return n_items == 0; }
+
+  iterator find(unsigned int id) { return is_live(id) ? iterator(this, id) : end(); }
+  const_iterator find(unsigned int id) const { return is_live(id) ? const_iterator(this, id) : end(); }
+  size_t count(unsigned int id) const { return is_live(id) ? 1 : 0; }
+
+  T &at(unsigned int id) {
+    if (!is_live(id)) throw std::out_of_range("IdMap::at");
+    return items[id].second;
+  }
+  const T &at(unsigned int id) const {
+    if (!is_live(id)) throw std::out_of_range("IdMap::at");
+    return items[id].second;
+  }
+
+  /// Returns the item with the id 'id', inserts a default one if there is none.
+  T &operator[](unsigned int id) { return insert(value_type(id, T())).first->second; }
+
+  std::pair<iterator, bool> insert(const value_type &v) {
+    unsigned int id = v.first;
+    if (is_live(id)) return std::make_pair(iterator(this, id), false);
+    if (id >= items.size()) {
+      items.resize(id + 1, value_type(0, T()));
+      live.resize(id + 1, 0);
+    }
+    items[id] = v;
+    live[id] = 1;
+    n_items++;
+    while (free_id < live.size() && live[free_id]) free_id++;
+    return std::make_pair(iterator(this, id), true);
+  }
+
+  size_t erase(unsigned int id) {
+    if (!is_live(id)) return 0;
+    items[id].second = T();
+    live[id] = 0;
+    n_items--;
+    if (id > 0 && id < free_id) free_id = id;
+    return 1;
+  }
+  void erase(iterator it) { erase(it->first); }
+
+  void clear() {
+    std::vector<value_type>().swap(items);
+    std::vector<char>().swap(live);
+    n_items = 0;
+    free_id = 1;
+  }
+
+  /// Preallocates the storage for the ids smaller than 'n'.
+  void reserve(size_t n) { items.reserve(n); live.reserve(n); }
+
+  /// Returns the smallest id (starting from 1) that is not used.
+  unsigned int get_free_id() const { return free_id; }
+
+  // Access to the storage (used by the iterators).
+  size_t n_slots() const { return items.size(); }
+  bool is_live(size_t pos) const { return pos < live.size() && live[pos]; }
+  value_type &item(size_t pos) { return items[pos]; }
+  const value_type &item(size_t pos) const { return items[pos]; }
+
+protected:
+  std::vector<value_type> items;
+  std::vector<char> live;
+  size_t n_items;
+  unsigned int free_id;      ///< All ids in [1, free_id) are used.
+};
+
+
+/// Map with the interface of std::map for keys which are not dense (Edge::Key, Facet::Key).
+///
+/// The items are stored in a contiguous array in the order of insertion, and they are looked up
+/// by an open-addressing hash table (linear probing) of indices into this array. The key type
+/// has to provide 'unsigned int hash() const' and 'operator =='. Erased items stay in the array
+/// (as tombstones of the hash table), and they are reused when the same key is inserted again.
+/// Once the erased items outnumber half of the live ones, the array is compacted. Unlike with
+/// std::map, erase() can therefore invalidate all iterators.
+template<class KEY, class T>
+class HashMap {
+public:
+  typedef KEY key_type;
+  typedef T mapped_type;
+  typedef std::pair<KEY, T> value_type;
+  typedef SlotIterator<HashMap, value_type> iterator;
+  typedef SlotIterator<const HashMap, const value_type> const_iterator;
+
+  HashMap() : n_items(0) { }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, items.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, items.size()); }
+
+  size_t size() const { return n_items; }
+  bool empty() const { return n_items == 0; }
+
+  iterator find(const KEY &key) {
+    size_t pos = lookup(key);
+    return is_live(pos) ? iterator(this, pos) : end();
+  }
+  const_iterator find(const KEY &key) const {
+    size_t pos = lookup(key);
+    return is_live(pos) ? const_iterator(this, pos) : end();
+  }
+  size_t count(const KEY &key) const { return is_live(lookup(key)) ? 1 : 0; }
+
+  T &at(const KEY &key) {
+    size_t pos = lookup(key);
+    if (!is_live(pos)) throw std::out_of_range("HashMap::at");
+    return items[pos].second;
+  }
+  const T &at(const KEY &key) const {
+    size_t pos = lookup(key);
+    if (!is_live(pos)) throw std::out_of_range("HashMap::at");
+    return items[pos].second;
+  }
+
+  /// Returns the item with the key 'key', inserts a default one if there is none.
+  /// Looking up an existing item does not modify the map (the map can be read this way
+  /// from several threads at once).
+  T &operator[](const KEY &key) {
+    size_t pos = lookup(key);
+    if (is_live(pos)) return items[pos].second;
+    return insert(value_type(key, T())).first->second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &v) {
+    // Keep the load factor (including tombstones) below 1/2.
+    if (2 * (items.size() + 1) > table.size()) rehash(table.empty() ? 16 : 2 * table.size());
+
+    size_t mask = table.size() - 1;
+    size_t h = v.first.hash() & mask;
+    while (table[h] != 0) {
+      size_t pos = table[h] - 1;
+      if (items[pos].first == v.first) {
+        if (live[pos]) return std::make_pair(iterator(this, pos), false);
+        items[pos].second = v.second;
+        live[pos] = 1;
+        n_items++;
+        return std::make_pair(iterator(this, pos), true);
+      }
+      h = (h + 1) & mask;
+    }
+
+    table[h] = items.size() + 1;
+    items.push_back(v);
+    live.push_back(1);
+    n_items++;
+    return std::make_pair(iterator(this, items.size() - 1), true);
+  }
+
+  size_t erase(const KEY &key) {
+    size_t pos = lookup(key);
+    if (!is_live(pos)) return 0;
+    items[pos].second = T();
+    live[pos] = 0;
+    n_items--;
+    size_t n_dead = items.size() - n_items;
+    if (n_dead >= 16 && 2 * n_dead > n_items) compact();
+    return 1;
+  }
+  void erase(iterator it) { erase(it->first); }
+
+  void clear() {
+    std::vector<value_type>().swap(items);
+    std::vector<char>().swap(live);
+    std::vector<unsigned int>().swap(table);
+    n_items = 0;
+  }
+
+  /// Preallocates the storage for 'n' items.
+  void reserve(size_t n) {
+    items.reserve(n);
+    live.reserve(n);
+    size_t sz = 16;
+    while (sz < 2 * n) sz *= 2;
+    if (sz > table.size()) rehash(sz);
+  }
+
+  // Access to the storage (used by the iterators).
+  size_t n_slots() const { return items.size(); }
+  bool is_live(size_t pos) const { return pos < live.size() && live[pos]; }
+  value_type &item(size_t pos) { return items[pos]; }
+  const value_type &item(size_t pos) const { return items[pos]; }
+
+protected:
+  std::vector<value_type> items;
+  std::vector<char> live;
+  std::vector<unsigned int> table;     ///< Index of the item + 1 (0 = empty).
+  size_t n_items;
+
+  /// Returns the position of the item with the key 'key' (or the number of items).
+  size_t lookup(const KEY &key) const {
+    if (table.empty()) return items.size();
+    size_t mask = table.size() - 1;
+    size_t h = key.hash() & mask;
+    while (table[h] != 0) {
+      size_t pos = table[h] - 1;
+      if (items[pos].first == key) return pos;
+      h = (h + 1) & mask;
+    }
+    return items.size();
+  }
+
+  /// Removes the erased items from the array (keeping the order of the rest) and rebuilds the hash table.
+  void compact() {
+    size_t n = 0;
+    for (size_t pos = 0; pos < items.size(); pos++) {
+      if (!live[pos]) continue;
+      if (n != pos) items[n] = items[pos];
+      n++;
+    }
+    items.erase(items.begin() + n, items.end());
+    live.assign(n, 1);
+    size_t sz = 16;
+    while (sz < 2 * (n + 1)) sz *= 2;
+    rehash(sz);
+  }
+
+  void rehash(size_t sz) {
+    table.assign(sz, 0);
+    size_t mask = sz - 1;
+    for (size_t pos = 0; pos < items.size(); pos++) {
+      size_t h = items[pos].first.hash() & mask;
+      while (table[h] != 0) h = (h + 1) & mask;
+      table[h] = pos + 1;
+    }
+  }
+};
+
+#endif
@@ -39,6 +39,9 @@
 #include "../../hermes_common/solver/solver.h"
 #include "../../hermes_common/solver/umfpack_solver.h"
 #include "../../hermes_common/solver/superlu.h"
+#include "../../hermes_common/solver/krylov.h"
+#include "../../hermes_common/solver/bsr.h"
+#include "../../hermes_common/solver/matrix_free.h"
 #include "../../hermes_common/solver/petsc.h"
 #include "../../hermes_common/solver/epetra.h"
 #include "../../hermes_common/solver/amesos.h"
@@ -105,6 +108,7 @@
 #include "filter.h"
 #include "weakform/weakform.h"
 #include "discrete_problem.h"
+#include "sumfact.h"
 
 // adapt
 #include "adapt/adapt.h"
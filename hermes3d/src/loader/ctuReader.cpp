@@ -364,7 +364,7 @@ bool CTUReader::save_as_h3d(const char *file_name, Mesh *mesh)
 	// save vertices
 	fprintf(file, "# vertices\n");
 	fprintf(file, "%lu\n", (unsigned long int)mesh->vertices.size());
-	for(std::map<unsigned int, Vertex*>::const_iterator it = mesh->vertices.begin(); it != mesh->vertices.end(); it++) {
+	for(VertexMap::const_iterator it = mesh->vertices.begin(); it != mesh->vertices.end(); it++) {
     Vertex *v = it->second;
 		fprintf(file, "%lf %lf %lf\n", v->x, v->y, v->z);
 	}
@@ -372,7 +372,7 @@ bool CTUReader::save_as_h3d(const char *file_name, Mesh *mesh)
 
 	// elements
 	std::map<unsigned int, Element *> tet, hex, pri;
-	for(std::map<unsigned int, Element*>::const_iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++) {
+	for(ElementMap::const_iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++) {
     Element *elem = it->second;
 		if (elem->active) {
 			switch (elem->get_mode()) {
@@ -415,7 +415,7 @@ bool CTUReader::save_as_h3d(const char *file_name, Mesh *mesh)
 
 	// boundaries
 	std::map<unsigned int, Facet *> tri_facets, quad_facets;
-  for(std::map<Facet::Key, Facet*>::iterator it = mesh->facets.begin(); it != mesh->facets.end(); it++) {
+  for(FacetMap::iterator it = mesh->facets.begin(); it != mesh->facets.end(); it++) {
     Facet *facet = it->second;
 		if(facet->type == Facet::OUTER && mesh->elements[facet->left]->active) {
 			switch (facet->type) {
@@ -318,7 +318,7 @@ bool H3DReader::load(const char *file_name, Mesh *mesh) {
 
 #ifdef HERMES_COMMON_CHECK_BOUNDARY_CONDITIONS
     // check if all "outer" faces have defined boundary condition
-    for (std::map<Facet::Key, Facet*>::const_iterator it = mesh->facets.begin(); it != mesh->facets.end(); it++) {
+    for (FacetMap::const_iterator it = mesh->facets.begin(); it != mesh->facets.end(); it++) {
       Facet *facet = it->second;
 
       if(((unsigned) facet->left == INVALID_IDX) || ((unsigned) facet->right == INVALID_IDX)) {
@@ -350,7 +350,7 @@ bool H3DReader::save(const char *file_name, Mesh *mesh) {
   // save vertices
   fprintf(file, "# vertices\n");
   fprintf(file, "%lu\n", (unsigned long int)mesh->vertices.size());
-  for(std::map<unsigned int, Vertex*>::const_iterator it = mesh->vertices.begin(); it != mesh->vertices.end(); it++) {
+  for(VertexMap::const_iterator it = mesh->vertices.begin(); it != mesh->vertices.end(); it++) {
     Vertex *v = it->second;
     fprintf(file, "%lf %lf %lf\n", v->x, v->y, v->z);
   }
@@ -358,7 +358,7 @@ bool H3DReader::save(const char *file_name, Mesh *mesh) {
 
   // elements
   std::map<unsigned int, Element *> tet, hex, pri;
-  for(std::map<unsigned int, Element*>::const_iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++) {
+  for(ElementMap::const_iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++) {
     Element *elem = it->second;
     if (elem->active) {
       switch (elem->get_mode()) {
@@ -401,7 +401,7 @@ bool H3DReader::save(const char *file_name, Mesh *mesh) {
 
   // boundaries
   std::map<unsigned int, Facet *> tri_facets, quad_facets;
-  for(std::map<Facet::Key, Facet*>::iterator it = mesh->facets.begin(); it != mesh->facets.end(); it++) {
+  for(FacetMap::iterator it = mesh->facets.begin(); it != mesh->facets.end(); it++) {
     Facet *facet = it->second;
     if(facet->type == Facet::OUTER && mesh->elements[facet->left]->active) {
       switch (facet->type) {
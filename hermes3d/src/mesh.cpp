@@ -724,23 +724,23 @@ Mesh::~Mesh() {
 
 void Mesh::free() {
 	_F_
-	for(std::map<unsigned int, Vertex*>::iterator it = vertices.begin(); it != vertices.end(); it++)
+	for(VertexMap::iterator it = vertices.begin(); it != vertices.end(); it++)
     delete it->second;
   vertices.clear();
 
-	for(std::map<unsigned int, Element*>::iterator it = elements.begin(); it != elements.end(); it++)
+	for(ElementMap::iterator it = elements.begin(); it != elements.end(); it++)
     delete it->second;
   elements.clear();
 
-	for(std::map<unsigned int, Boundary*>::iterator it = boundaries.begin(); it != boundaries.end(); it++)
+	for(BoundaryMap::iterator it = boundaries.begin(); it != boundaries.end(); it++)
     delete it->second;
   boundaries.clear();
 
-  for(std::map<Facet::Key, Facet*>::iterator it = facets.begin(); it != facets.end(); it++)
+  for(FacetMap::iterator it = facets.begin(); it != facets.end(); it++)
     delete it->second;
   facets.clear();
 
-  for(std::map<Edge::Key, Edge*>::iterator it = edges.begin(); it != edges.end(); it++)
+  for(EdgeMap::iterator it = edges.begin(); it != edges.end(); it++)
     delete it->second;
   edges.clear();
 
@@ -753,35 +753,35 @@ void Mesh::copy(const Mesh &mesh)
   if (&mesh == this) warning("Copying mesh into itself.");
   free();
 
-  for(std::map<unsigned int, Vertex*>::iterator it = vertices.begin(); it != vertices.end(); it++) delete it->second;
+  for(VertexMap::iterator it = vertices.begin(); it != vertices.end(); it++) delete it->second;
   vertices.clear();
 
-  for(std::map<unsigned int, Element*>::iterator it = elements.begin(); it != elements.end(); it++) delete it->second;
+  for(ElementMap::iterator it = elements.begin(); it != elements.end(); it++) delete it->second;
   elements.clear();
 
-  for(std::map<unsigned int, Boundary*>::iterator it = boundaries.begin(); it != boundaries.end(); it++) delete it->second;
+  for(BoundaryMap::iterator it = boundaries.begin(); it != boundaries.end(); it++) delete it->second;
   boundaries.clear();
 
-  for(std::map<Edge::Key, Edge*>::iterator it = edges.begin(); it != edges.end(); it++) delete it->second;
+  for(EdgeMap::iterator it = edges.begin(); it != edges.end(); it++) delete it->second;
   edges.clear();
 
-  for(std::map<Facet::Key, Facet*>::iterator it = facets.begin(); it != facets.end(); it++) delete it->second;
+  for(FacetMap::iterator it = facets.begin(); it != facets.end(); it++) delete it->second;
   facets.clear();
 
   midpoints.clear();
 
   // copy vertices
-  for(std::map<unsigned int, Vertex*>::const_iterator it = mesh.vertices.begin(); it != mesh.vertices.end(); it++)
+  for(VertexMap::const_iterator it = mesh.vertices.begin(); it != mesh.vertices.end(); it++)
     if(it->first != INVALID_IDX)
       this->vertices[it->first] = it->second->copy();
 
   // copy boundaries
-  for(std::map<unsigned int, Boundary*>::const_iterator it = mesh.boundaries.begin(); it != mesh.boundaries.end(); it++)
+  for(BoundaryMap::const_iterator it = mesh.boundaries.begin(); it != mesh.boundaries.end(); it++)
     if(it->first != INVALID_IDX)
       this->boundaries[it->first] = it->second->copy();
 
   // copy elements, midpoints, facets and edges
-  for(std::map<unsigned int, Element*>::const_iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++) {
+  for(ElementMap::const_iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++) {
     if(it->first == INVALID_IDX)
       continue;
     Element *e = it->second;
@@ -841,7 +841,7 @@ void Mesh::copy(const Mesh &mesh)
   }
 
   // facets
-  for(std::map<Facet::Key, Facet*>::const_iterator it = mesh.facets.begin(); it != mesh.facets.end(); it++) {
+  for(FacetMap::const_iterator it = mesh.facets.begin(); it != mesh.facets.end(); it++) {
     Facet *facet = it->second;
 
       unsigned int *face_idxs = new unsigned int[Quad::NUM_VERTICES]; // quad is shape with the largest number of vertices
@@ -873,7 +873,7 @@ void Mesh::copy_base(const Mesh &mesh) {
 
 	free();
 	// copy elements, facets and edges
-	for(std::map<unsigned int, Element*>::const_iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++) {
+	for(ElementMap::const_iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++) {
     if(it->first > mesh.nbase)
       continue;
     Element *e = it->second;
@@ -953,28 +953,28 @@ Edge::Key Mesh::get_edge_id(Element *e, int edge_num) const {
 void Mesh::dump() {
     _F_
     printf("Vertices (count = %lu)\n", (unsigned long int)vertices.size());
-    for(std::map<unsigned int, Vertex*>::iterator it = vertices.begin(); it != vertices.end(); it++) {
+    for(VertexMap::iterator it = vertices.begin(); it != vertices.end(); it++) {
 		Vertex *v = it->second;
     printf("  id = %d, ", it->first);
 		v->dump();
 	}
 
 	printf("Elements (count = %lu)\n", (unsigned long int)elements.size());
-  for(std::map<unsigned int, Element*>::iterator it = elements.begin(); it != elements.end(); it++) {
+  for(ElementMap::iterator it = elements.begin(); it != elements.end(); it++) {
 		Element *e = it->second;
 		printf("  ");
 		e->dump();
 	}
 
 	printf("Boundaries (count = %lu)\n", (unsigned long int)boundaries.size());
-  for(std::map<unsigned int, Boundary*>::iterator it = boundaries.begin(); it != boundaries.end(); it++) {
+  for(BoundaryMap::iterator it = boundaries.begin(); it != boundaries.end(); it++) {
 		Boundary *b = it->second;
 		printf("  ");
 		b->dump();
 	}
 
 	printf("Facets (count = %lu)\n", (unsigned long int)facets.size());
-  for(std::map<Facet::Key, Facet*>::iterator it = facets.begin(); it != facets.end(); it++) {
+  for(FacetMap::iterator it = facets.begin(); it != facets.end(); it++) {
     Facet *f = it->second;
     if(it->first.size > 0)
       printf("Vertices: \n");
@@ -995,10 +995,7 @@ Tetra *Mesh::create_tetra(unsigned int vtcs[]) {
 	Tetra *tetra = new Tetra(vtcs);
 	MEM_CHECK(tetra);
 	
-  unsigned int i;
-  for(i = 1; ; i++)
-    if(elements[i] == NULL)
-      break;
+  unsigned int i = elements.get_free_id();
   elements[i] = tetra;
 
 	tetra->id = i;
@@ -1040,10 +1037,7 @@ Hex *Mesh::create_hex(unsigned int vtcs[]) {
 	Hex *hex = new Hex(vtcs);
 	MEM_CHECK(hex);
 	
-  unsigned int i;
-  for(i = 1; ; i++)
-    if(elements[i] == NULL)
-      break;
+  unsigned int i = elements.get_free_id();
   elements[i] = hex;
 
 	hex->id = i;
@@ -1087,8 +1081,7 @@ Prism *Mesh::create_prism(unsigned int vtcs[])
   Prism *prism = new Prism(vtcs);
   MEM_CHECK(prism);
 
-  unsigned int i;
-  for(i = 1; ; i++) if(elements[i] == NULL) break;
+  unsigned int i = elements.get_free_id();
   elements[i] = prism;
 
   prism->id = i;
@@ -1132,10 +1125,7 @@ Boundary *Mesh::add_tri_boundary(unsigned int vtcs[], int marker) {
 		Boundary *bdr = new BoundaryTri(marker);
 		MEM_CHECK(bdr);
 
-    unsigned int i;
-    for(i = 1; ; i++)
-      if(boundaries[i] == NULL)
-        break;
+    unsigned int i = boundaries.get_free_id();
     boundaries[i] = bdr;
 
 		bdr->id = i;
@@ -1156,10 +1146,7 @@ Boundary *Mesh::add_quad_boundary(unsigned int vtcs[], int marker) {
 		Boundary *bdr = new BoundaryQuad(marker);
 		MEM_CHECK(bdr);
 
-    unsigned int i;
-    for(i = 1; ; i++)
-      if(boundaries[i] == NULL)
-        break;
+    unsigned int i = boundaries.get_free_id();
     boundaries[i] = bdr;
 
 		bdr->id = i;
@@ -1180,7 +1167,7 @@ void Mesh::ugh()
   nactive = nbase = elements.size();
 
   // set bnd flag for boundary edges
-  for(std::map<Facet::Key, Facet*>::iterator it = facets.begin(); it != facets.end(); it++) {
+  for(FacetMap::iterator it = facets.begin(); it != facets.end(); it++) {
     Facet *facet = it->second;
     if (facet->type == Facet::OUTER) {
       Element *elem = elements[facet->left];
@@ -2155,8 +2142,8 @@ Facet *Mesh::add_quad_facet(Facet::Type type, unsigned int left_elem, int left_i
 
 void Mesh::refine_all_elements(int refinement) {
 	_F_
-  std::map<unsigned int, Element*> local_elements = elements;
-	for(std::map<unsigned int, Element*>::iterator it = local_elements.begin(); it != local_elements.end(); it++)
+  ElementMap local_elements = elements;
+	for(ElementMap::iterator it = local_elements.begin(); it != local_elements.end(); it++)
 		if (it->second->used && it->second->active)
       refine_element(it->first, refinement);
 }
@@ -2195,11 +2182,8 @@ unsigned int Mesh::get_midpoint(unsigned int a, unsigned int b) {
 
 unsigned int Mesh::peek_midpoint(unsigned int a, unsigned int b) const {
 	_F_
-  MidPointKey key(a, b);
-	unsigned int idx = INVALID_IDX;
-  if(midpoints.find(key) != midpoints.end())
-    idx = midpoints.find(key)->second;
-	return idx;
+  HashMap<MidPointKey, unsigned int>::const_iterator it = midpoints.find(MidPointKey(a, b));
+  return (it != midpoints.end()) ? it->second : INVALID_IDX;
 }
 
 void Mesh::set_midpoint(unsigned int a, unsigned int b, unsigned int idx) {
@@ -2289,7 +2273,7 @@ void Mesh::regularize() {
 	// this parent facet) the same way. If it is active, we found hanging node of a  2. order and we refine this super parent.
 	// If it is inactive, hanging node of a higher order was found and we report an error.
 
-  for(std::map<unsigned int, Element*>::iterator it = elements.begin(); it != elements.end(); it++)
+  for(ElementMap::iterator it = elements.begin(); it != elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *elem = elements[it->first];
 		  for (int iface = 0; iface < elem->get_num_faces(); iface++) {
@@ -2344,8 +2328,8 @@ void Mesh::refine_towards_boundary(int marker, int depth) {
 	_F_
 
 	if (depth == 0) return;
-  std::map<unsigned int, Element*> local_elements = elements;
-	for(std::map<unsigned int, Element*>::iterator it = local_elements.begin(); it != local_elements.end(); it++)
+  ElementMap local_elements = elements;
+	for(ElementMap::iterator it = local_elements.begin(); it != local_elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = elements[it->first];
 
@@ -2378,7 +2362,7 @@ void Mesh::check_elem_oris()
 {
 	_F_
 	RefMap refmap(this);
-  for(std::map<unsigned int, Element*>::iterator it = elements.begin(); it != elements.end(); it++)
+  for(ElementMap::iterator it = elements.begin(); it != elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = it->second;
 		  refmap.set_active_element(e);
@@ -25,6 +25,7 @@ class MeshLoader;
 
 
 #include "h3d_common.h"
+#include "hashmap.h"
 
 // refinement type
 #define H3D_REFT_HEX_NONE							0x0000
@@ -52,6 +53,15 @@ class MeshLoader;
 #define H3D_H3D_SPLIT_HEX_YZ							H3D_SPLIT_HEX_Y | H3D_SPLIT_HEX_Z
 #define H3D_H3D_H3D_SPLIT_HEX_XYZ						H3D_SPLIT_HEX_X | H3D_SPLIT_HEX_Y | H3D_SPLIT_HEX_Z
 
+/// Hash value of a (sorted) list of vertex indices, used by the keys of edges and facets.
+inline unsigned int hash_vertices(const unsigned int *vtcs, unsigned int size)
+{
+  unsigned int h = size;
+  for (unsigned int i = 0; i < size; i++)
+    h = (h ^ vtcs[i]) * 0x9E3779B1u;
+  return h ^ (h >> 15);
+}
+
 /// Represents a vertex in 3D
 ///
 ///
@@ -96,20 +106,20 @@ public:
     return (*this);
   }
 
+  /// Key of an edge: the sorted indices of its vertices (stored in place, so that the keys can
+  /// be kept in contiguous arrays).
   struct Key
   {
-    unsigned int * vtcs;
+    unsigned int vtcs[NUM_VERTICES];
     unsigned int size;
     Key()
     {
-      vtcs = NULL;
       size = 0;
     }
-   Key(unsigned int vtcs_ [], unsigned int size_)
+    Key(unsigned int vtcs_ [], unsigned int size_)
     {
+      assert(size_ <= (unsigned int) NUM_VERTICES);
       this->size = size_;
-      if(size > 0)
-        this->vtcs = new unsigned int [size];
       for(unsigned int i = 0; i < size; i++) {
         unsigned int temp_place = i;
         for(unsigned int j = i + 1; j < size; j++)
@@ -119,30 +129,6 @@ public:
         vtcs_[temp_place] = vtcs_[i];
       }
     };
-    Key(const Key &b)
-    {
-      size = b.size;
-      if(size > 0)
-        this->vtcs = new unsigned int [size];
-      for(unsigned int i = 0; i < size; i++)
-        vtcs[i] = b.vtcs[i];
-    };
-    Key & operator =(const Key &b)
-    {
-      if(size > 0)
-        delete [] vtcs;
-      size = b.size;
-      if(size > 0)
-        this->vtcs = new unsigned int [size];
-      for(unsigned int i = 0; i < size; i++)
-        vtcs[i] = b.vtcs[i];
-      return *this;
-    };
-    ~Key()
-    {
-      if(size > 0)
-        delete [] vtcs;
-    };
     bool operator <(const Key & other) const
     {
       if(this->size < other.size)
@@ -160,17 +146,11 @@ public:
     };
     bool operator ==(const Key & other) const
     {
-      if(this->size < other.size)
-        return false;
-      else if(this->size > other.size)
+      if(this->size != other.size)
         return false;
-      else
-        for(unsigned int i = 0; i < this->size; i++)
-          if(this->vtcs[i] < other.vtcs[i])
-            return false;
-          else if(this->vtcs[i] > other.vtcs[i])
-            return false;
-
+      for(unsigned int i = 0; i < this->size; i++)
+        if(this->vtcs[i] != other.vtcs[i])
+          return false;
       return true;
     };
 
@@ -178,6 +158,12 @@ public:
     {
       return (!((*this)==other));
     };
+
+    /// Hash value for HashMap.
+    unsigned int hash() const
+    {
+      return hash_vertices(vtcs, size);
+    };
   };
   static Key invalid_key;
   Edge();
@@ -261,20 +247,20 @@ public:
 	unsigned ractive:1;			/// information for the right is active; 1 - active; 0 - inactive
 	unsigned ref_mask:2;		/// how is the facet divided (0 - not divived, 1 - horz, 2 - vert, 3 - both)
 
+  /// Key of a facet: the sorted indices of its vertices (stored in place, so that the keys can
+  /// be kept in contiguous arrays).
   struct Key
   {
-    unsigned int * vtcs;
+    unsigned int vtcs[Quad::NUM_VERTICES];
     unsigned int size;
     Key()
     {
-      vtcs = NULL;
       size = 0;
     }
     Key(unsigned int vtcs_ [], unsigned int size_)
     {
+      assert(size_ <= (unsigned int) Quad::NUM_VERTICES);
       this->size = size_;
-      if(size > 0)
-        this->vtcs = new unsigned int [size];
       for(unsigned int i = 0; i < size; i++) {
         unsigned int temp_place = i;
         for(unsigned int j = i + 1; j < size; j++)
@@ -284,30 +270,6 @@ public:
         vtcs_[temp_place] = vtcs_[i];
       }
     };
-    ~Key()
-    {
-      if(size > 0)
-        delete [] vtcs;
-    };
-    Key(const Key &b)
-    {
-      size = b.size;
-      if(size > 0)
-        this->vtcs = new unsigned int [size];
-      for(unsigned int i = 0; i < size; i++)
-        vtcs[i] = b.vtcs[i];
-    };
-    Key & operator =(const Key &b)
-    {
-      if(size > 0)
-        delete [] vtcs;
-      size = b.size;
-      if(size > 0)
-        this->vtcs = new unsigned int [size];
-      for(unsigned int i = 0; i < size; i++)
-        vtcs[i] = b.vtcs[i];
-      return *this;
-    };
     bool operator <(const Key & other) const
     {
       if(this->size < other.size)
@@ -325,16 +287,11 @@ public:
     };
     bool operator ==(const Key & other) const
     {
-      if(this->size < other.size)
-        return false;
-      else if(this->size > other.size)
+      if(this->size != other.size)
         return false;
-      else
-        for(unsigned int i = 0; i < this->size; i++)
-          if(this->vtcs[i] < other.vtcs[i])
-            return false;
-          else if(this->vtcs[i] > other.vtcs[i])
-            return false;
+      for(unsigned int i = 0; i < this->size; i++)
+        if(this->vtcs[i] != other.vtcs[i])
+          return false;
       return true;
     };
 
@@ -343,6 +300,11 @@ public:
       return (!(*this == other));
     };
 
+    /// Hash value for HashMap.
+    unsigned int hash() const
+    {
+      return hash_vertices(vtcs, size);
+    };
   };
   static Key invalid_key;
   
@@ -644,6 +606,13 @@ public:
 };
 
 
+/// Containers of the mesh entities (indexed by their ids or keys).
+typedef IdMap<Vertex *> VertexMap;
+typedef HashMap<Edge::Key, Edge *> EdgeMap;
+typedef IdMap<Element *> ElementMap;
+typedef IdMap<Boundary *> BoundaryMap;
+typedef HashMap<Facet::Key, Facet *> FacetMap;
+
 /// Represents the geometry of a mesh
 ///
 ///
@@ -670,7 +639,7 @@ public:
   unsigned int get_max_element_id() const 
   { 
     unsigned int temp_max = 0;
-    for(std::map<unsigned int, Element *>::const_iterator it = elements.begin(); it != elements.end(); it++)
+    for(ElementMap::const_iterator it = elements.begin(); it != elements.end(); it++)
       if(it->first > temp_max)
         temp_max = it->first;
       return temp_max;
@@ -763,11 +732,11 @@ public:
   void create_faces();
 
   // data
-  std::map<unsigned int, Vertex *>   vertices;
-	std::map<Edge::Key, Edge *>      edges;
-	std::map<unsigned int, Element *>  elements;
-	std::map<unsigned int, Boundary *> boundaries;
-  std::map<Facet::Key, Facet *> facets;
+  VertexMap   vertices;
+  EdgeMap     edges;
+  ElementMap  elements;
+  BoundaryMap boundaries;
+  FacetMap    facets;
 
 protected:
 
@@ -843,10 +812,17 @@ protected:
         else
           return false;
     };
+    bool operator==(const MidPointKey & other) const {
+      return this->a == other.a && this->b == other.b;
+    };
+    unsigned int hash() const {
+      unsigned int vtcs[2] = { a, b };
+      return hash_vertices(vtcs, 2);
+    };
   };
 
 	// midpoints
-	std::map<MidPointKey, unsigned int> midpoints;
+	HashMap<MidPointKey, unsigned int> midpoints;
 
 	/// Adds a midpoint as a vertex
 	/// @param[in] a index of the first vertex
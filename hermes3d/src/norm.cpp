@@ -66,7 +66,7 @@ double calc_norm(double (*fn)(MeshFunction*, int, QuadPt3D*), MeshFunction *sln)
 	double norm = 0.0;
 	Mesh *mesh = sln->get_mesh();
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		  sln->set_active_element(e);
@@ -417,7 +417,7 @@ void GmshOutputEngine::out(MeshFunction *fn, const char *name, int item/* = FN_V
 	// prepare
 	fprintf(this->out_file, "View \"%s\" {\n", name);
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 		  int mode = element->get_mode();
@@ -513,7 +513,7 @@ void GmshOutputEngine::out(MeshFunction *fn1, MeshFunction *fn2, MeshFunction *f
 	// prepare
 	fprintf(this->out_file, "View \"%s\" {\n", name);
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 		  int mode = element->get_mode();
@@ -605,7 +605,7 @@ void GmshOutputEngine::out(Mesh *mesh) {
 	// vertices
 	fprintf(this->out_file, "$Nodes\n");
 	fprintf(this->out_file, "%lu\n", (unsigned long int)mesh->vertices.size());
-  for(std::map<unsigned int, Vertex*>::iterator it = mesh->vertices.begin(); it != mesh->vertices.end(); it++) {
+  for(VertexMap::iterator it = mesh->vertices.begin(); it != mesh->vertices.end(); it++) {
     Vertex *v = mesh->vertices[it->first];
     fprintf(this->out_file, "%u %lf %lf %lf\n", it->first, v->x, v->y, v->z);
 	}
@@ -616,7 +616,7 @@ void GmshOutputEngine::out(Mesh *mesh) {
 	// elements
 	fprintf(this->out_file, "$Elements\n");
 	fprintf(this->out_file, "%u\n", mesh->get_num_active_elements());
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 
@@ -653,14 +653,14 @@ void GmshOutputEngine::out(Mesh *mesh) {
 	// TODO: do not include edges twice or more
 	fprintf(this->out_file, "$Elements\n");
 	fprintf(this->out_file, "%d\n", n_edges);
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used) {
       Element *element = mesh->elements[it->first];
 		  unsigned int vtcs[Edge::NUM_VERTICES];
 		  for (int iedge = 0; iedge < element->get_num_edges(); iedge++) {
 			  element->get_edge_vertices(iedge, vtcs);
         unsigned int i = 0;
-        std::map<Edge::Key, Edge*>::const_iterator it_inner = mesh->edges.begin();
+        EdgeMap::const_iterator it_inner = mesh->edges.begin();
         while(it_inner != mesh->edges.end() && it_inner->first != mesh->get_edge_id(vtcs[0], vtcs[1])) {
           it_inner++;
           i++;
@@ -674,7 +674,7 @@ void GmshOutputEngine::out(Mesh *mesh) {
 	// TODO: do not include faces twice
 	fprintf(this->out_file, "$Elements\n");
 	fprintf(this->out_file, "%d\n", n_faces);
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used) {
       Element *element = mesh->elements[it->first];
 		  for (int iface = 0; iface < element->get_num_faces(); iface++) {
@@ -682,7 +682,7 @@ void GmshOutputEngine::out(Mesh *mesh) {
 			  unsigned int *vtcs = new unsigned int[nv];
 			  element->get_face_vertices(iface, vtcs);
         unsigned int i = 0;
-        std::map<Facet::Key, Facet*>::const_iterator it_inner = mesh->facets.begin();
+        FacetMap::const_iterator it_inner = mesh->facets.begin();
         while(it_inner != mesh->facets.end() && it_inner->first != mesh->get_facet_id(element, iface)) {
           it_inner++;
           i++;
@@ -707,7 +707,7 @@ void GmshOutputEngine::out_bc_gmsh(Mesh *mesh, const char *name) {
 	// see Gmsh documentation on details (http://www.geuz.org/gmsh/doc/texinfo/gmsh-full.html)
 
 	int fc = 0; 		// number of outer facets
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 		  for (int iface = 0; iface < element->get_num_faces(); iface++) {
@@ -726,7 +726,7 @@ void GmshOutputEngine::out_bc_gmsh(Mesh *mesh, const char *name) {
 	// TODO: dump only vertices on the boundaries
 	fprintf(this->out_file, "$Nodes\n");
 	fprintf(this->out_file, "%lu\n", (unsigned long int)mesh->vertices.size());
-	for(std::map<unsigned int, Vertex*>::iterator it = mesh->vertices.begin(); it != mesh->vertices.end(); it++) {
+	for(VertexMap::iterator it = mesh->vertices.begin(); it != mesh->vertices.end(); it++) {
     Vertex *v = mesh->vertices[it->first];
     fprintf(this->out_file, "%u %lf %lf %lf\n", it->first, v->x, v->y, v->z);
 	}
@@ -735,7 +735,7 @@ void GmshOutputEngine::out_bc_gmsh(Mesh *mesh, const char *name) {
 	// elements
 	fprintf(this->out_file, "$Elements\n");
 	fprintf(this->out_file, "%d\n", fc);
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 
@@ -747,7 +747,7 @@ void GmshOutputEngine::out_bc_gmsh(Mesh *mesh, const char *name) {
 			  Facet *facet = mesh->facets[fid];
 			  if (facet->type == Facet::INNER) continue;
         unsigned int i = 0;
-        std::map<Facet::Key, Facet*>::const_iterator it_inner = mesh->facets.begin();
+        FacetMap::const_iterator it_inner = mesh->facets.begin();
         while(it_inner != mesh->facets.end() && it_inner->first != mesh->get_facet_id(element, iface)) {
           it_inner++;
           i++;
@@ -775,7 +775,7 @@ void GmshOutputEngine::out_bc_gmsh(Mesh *mesh, const char *name) {
 	fprintf(this->out_file, "$ElementNodeData \n");
 	fprintf(this->out_file, "1\n\"%s\"\n0\n3\n0\n1\n", name);
 	fprintf(this->out_file, "%d\n", fc);
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
 		  Element *element = mesh->elements[it->first];
 		  for (int iface = 0; iface < element->get_num_faces(); iface++) {
@@ -786,7 +786,7 @@ void GmshOutputEngine::out_bc_gmsh(Mesh *mesh, const char *name) {
 			  Boundary *bnd = mesh->boundaries[facet->right];
 			  int marker = bnd->marker;
         unsigned int i = 0;
-        std::map<Facet::Key, Facet*>::const_iterator it_inner = mesh->facets.begin();
+        FacetMap::const_iterator it_inner = mesh->facets.begin();
         while(it_inner != mesh->facets.end() && it_inner->first != mesh->get_facet_id(element, iface)) {
           it_inner++;
           i++;
@@ -827,7 +827,7 @@ void GmshOutputEngine::out_orders_gmsh(Space *space, const char *name) {
   std::map<PtsKey, unsigned int> ctr_pts;			// id of points in the center
 
 	// nodes
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 		  int nv = Hex::NUM_VERTICES;
@@ -899,7 +899,7 @@ void GmshOutputEngine::out_orders_gmsh(Space *space, const char *name) {
 	int id = 1;
 	fprintf(this->out_file, "$Elements\n");
 	fprintf(this->out_file, "%u\n", mesh->get_num_active_elements() * Hex::NUM_EDGES);
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 		  unsigned int *vtcs = new unsigned int[element->get_num_vertices()];
@@ -932,7 +932,7 @@ void GmshOutputEngine::out_orders_gmsh(Space *space, const char *name) {
 	fprintf(this->out_file, "1\n"); // 1 value per node
 	fprintf(this->out_file, "%u\n", mesh->get_num_active_elements() * Hex::NUM_EDGES);
 	id = 1;
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       assert(mesh->elements[it->first]->get_mode() == HERMES_MODE_HEX);			// HEX-specific
 		  // get order from the space
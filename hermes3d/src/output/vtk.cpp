@@ -503,7 +503,7 @@ void VtkOutputEngine::out(MeshFunction *fn, const char *name, int item)
 	Vtk::Linearizer l;
 	Mesh *mesh = fn->get_mesh();
 	// values
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
 		  Element *element = mesh->elements[it->first];
 		  fn->set_active_element(element);
@@ -620,7 +620,7 @@ void VtkOutputEngine::out(MeshFunction *fn1, MeshFunction *fn2, MeshFunction *fn
 	RefMap refmap;
 	refmap.set_mesh(mesh);
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		  // set active elements
@@ -723,7 +723,7 @@ void VtkOutputEngine::out(Mesh *mesh)
 	_F_
 	Vtk::Linearizer l;
 	// add cells
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 
@@ -767,7 +767,7 @@ void VtkOutputEngine::out_bc_vtk(Mesh *mesh, const char *name)
 	_F_
 	Vtk::Linearizer l;
 	// add cells
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 
@@ -816,7 +816,7 @@ void VtkOutputEngine::out_orders_vtk(Space *space, const char *name)
 	_F_
 	Vtk::Linearizer l;
 	Mesh *mesh = space->get_mesh();
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
 		  Ord3 ord = space->get_element_order(it->first);
 		  Element *element = mesh->elements[it->first];
@@ -888,7 +888,7 @@ void VtkOutputEngine::out_elem_markers(Mesh *mesh, const char *name)
 	_F_
 	Vtk::Linearizer l;
 	// add cells
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *element = mesh->elements[it->first];
 
@@ -4355,11 +4355,30 @@ QuadStdHex::QuadStdHex() {
 		vertex_table[i].z = vtx_pt[i].z;
 		vertex_table[i].w = 1.0;
 	}
+
+	// element and face points are calculated on the first use
+	hex_tables = new QuadPt3D *[H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS];
+	MEM_CHECK(hex_tables);
+	hex_face_tables = new QuadPt3D *[Hex::NUM_FACES * H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS];
+	MEM_CHECK(hex_face_tables);
+	memset(hex_tables, 0, H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS * sizeof(QuadPt3D *));
+	memset(hex_face_tables, 0, Hex::NUM_FACES * H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS * sizeof(QuadPt3D *));
+#else
+	hex_tables = NULL;
+	hex_face_tables = NULL;
 #endif
 }
 
 QuadStdHex::~QuadStdHex() {
 	_F_
+#ifdef WITH_HEX
+	for (int i = 0; i < H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS; i++)
+		delete [] hex_tables[i];
+	for (int i = 0; i < Hex::NUM_FACES * H3D_HEX_NUM_ORDERS * H3D_HEX_NUM_ORDERS; i++)
+		delete [] hex_face_tables[i];
+	delete [] hex_tables;
+	delete [] hex_face_tables;
+#endif
 	for(std::map<unsigned int, std::map<unsigned int, QuadPt3D *>*>::iterator it = edge_tables->begin(); it != edge_tables->end(); it++) {
     for(std::map<unsigned int, QuadPt3D *>::iterator it_inner = it->second->begin(); it_inner != it->second->end(); it_inner++)
       delete [] it_inner->second;
@@ -4369,40 +4388,38 @@ QuadStdHex::~QuadStdHex() {
     delete [] vertex_table;
 }
 
-void QuadStdHex::calc_table(const Ord3 &order) {
+QuadPt3D *QuadStdHex::calc_table(const Ord3 &order) {
 	_F_
 #ifdef WITH_HEX
 	assert(order.type == mode);
 	int idx = order.get_idx();
-	if((*tables)[idx] != NULL)
-    delete (*tables)[idx];
-  (*tables)[idx] = new QuadPt3D[(*np)[idx]];
-	MEM_CHECK((*tables)[idx]);
+	QuadPt3D *pts = new QuadPt3D[(*np)[idx]];
+	MEM_CHECK(pts);
 
 	int i = order.x, j = order.y, o = order.z;
 	for (int k = 0, n = 0; k < std_np_1d[i]; k++) {
 		for (int l = 0; l < std_np_1d[j]; l++) {
 			for (int p = 0; p < std_np_1d[o]; p++, n++) {
 				assert(n < (*np)[idx]);
-				(*tables)[idx][n].x = std_tables_1d[i][k].x;
-				(*tables)[idx][n].y = std_tables_1d[j][l].x;
-				(*tables)[idx][n].z = std_tables_1d[o][p].x;
-				(*tables)[idx][n].w = std_tables_1d[i][k].w * std_tables_1d[j][l].w * std_tables_1d[o][p].w;
+				pts[n].x = std_tables_1d[i][k].x;
+				pts[n].y = std_tables_1d[j][l].x;
+				pts[n].z = std_tables_1d[o][p].x;
+				pts[n].w = std_tables_1d[i][k].w * std_tables_1d[j][l].w * std_tables_1d[o][p].w;
 			}
 		}
 	}
+	return pts;
+#else
+	return NULL;
 #endif
 }
 
-void QuadStdHex::calc_face_table(int face, const Ord2 &order) {
+QuadPt3D *QuadStdHex::calc_face_table(int face, const Ord2 &order) {
 	_F_
 #ifdef WITH_HEX
 	int idx = order.get_idx();
-  if((*face_tables)[face] == NULL)
-    (*face_tables)[face] = new std::map<unsigned int, QuadPt3D *>;
-  if((*(*face_tables)[face])[idx] != NULL)
-    delete (*(*face_tables)[face])[idx];
-  (*(*face_tables)[face])[idx] = new QuadPt3D[(*np_face)[idx]];
+	QuadPt3D *pts = new QuadPt3D[(*np_face)[idx]];
+	MEM_CHECK(pts);
 	
 	int i = order.x, j = order.y;
 	switch (face) {
@@ -4411,10 +4428,10 @@ void QuadStdHex::calc_face_table(int face, const Ord2 &order) {
 			for (int k = 0, n = 0; k < std_np_1d[i]; k++) {
 				for (int l = 0; l < std_np_1d[j]; l++, n++) {
 					assert(n < (*np_face)[idx]);
-					(*(*face_tables)[face])[idx][n].x = (face == 0) ? -1 : 1;
-					(*(*face_tables)[face])[idx][n].y = std_tables_1d[i][k].x;
-					(*(*face_tables)[face])[idx][n].z = std_tables_1d[j][l].x;
-					(*(*face_tables)[face])[idx][n].w = std_tables_1d[i][k].w * std_tables_1d[j][l].w;
+					pts[n].x = (face == 0) ? -1 : 1;
+					pts[n].y = std_tables_1d[i][k].x;
+					pts[n].z = std_tables_1d[j][l].x;
+					pts[n].w = std_tables_1d[i][k].w * std_tables_1d[j][l].w;
 				}
 			}
 			break;
@@ -4424,10 +4441,10 @@ void QuadStdHex::calc_face_table(int face, const Ord2 &order) {
 			for (int k = 0, n = 0; k < std_np_1d[i]; k++) {
 				for (int l = 0; l < std_np_1d[j]; l++, n++) {
 					assert(n < (*np_face)[idx]);
-					(*(*face_tables)[face])[idx][n].x = std_tables_1d[i][k].x;
-					(*(*face_tables)[face])[idx][n].y = (face == 2) ? -1 : 1;
-					(*(*face_tables)[face])[idx][n].z = std_tables_1d[j][l].x;
-					(*(*face_tables)[face])[idx][n].w = std_tables_1d[i][k].w * std_tables_1d[j][l].w;
+					pts[n].x = std_tables_1d[i][k].x;
+					pts[n].y = (face == 2) ? -1 : 1;
+					pts[n].z = std_tables_1d[j][l].x;
+					pts[n].w = std_tables_1d[i][k].w * std_tables_1d[j][l].w;
 				}
 			}
 			break;
@@ -4437,10 +4454,10 @@ void QuadStdHex::calc_face_table(int face, const Ord2 &order) {
 			for (int k = 0, n = 0; k < std_np_1d[i]; k++) {
 				for (int l = 0; l < std_np_1d[j]; l++, n++) {
 					assert(n < (*np_face)[idx]);
-					(*(*face_tables)[face])[idx][n].x = std_tables_1d[i][k].x;
-					(*(*face_tables)[face])[idx][n].y = std_tables_1d[j][l].x;
-					(*(*face_tables)[face])[idx][n].z = (face == 4) ? -1 : 1;
-					(*(*face_tables)[face])[idx][n].w = std_tables_1d[i][k].w * std_tables_1d[j][l].w;
+					pts[n].x = std_tables_1d[i][k].x;
+					pts[n].y = std_tables_1d[j][l].x;
+					pts[n].z = (face == 4) ? -1 : 1;
+					pts[n].w = std_tables_1d[i][k].w * std_tables_1d[j][l].w;
 				}
 			}
 			break;
@@ -4449,6 +4466,9 @@ void QuadStdHex::calc_face_table(int face, const Ord2 &order) {
 			EXIT("Invalid face number %d. Can be 0 - 5.", face);
 			break;
 	}
+	return pts;
+#else
+	return NULL;
 #endif
 }
 
@@ -42,6 +42,9 @@ public:
 };
 
 
+/// Number of quadrature orders in one direction of a hexahedron.
+#define H3D_HEX_NUM_ORDERS (H3D_MAX_QUAD_ORDER + 1)
+
 /// Numerical quadrature for 3D hexahedron
 ///
 /// @ingroup quadrature
@@ -50,24 +53,66 @@ public:
 	QuadStdHex();
 	~QuadStdHex();
 
+	// The tables are calculated on the first use, possibly by several assembling threads.
+	// A table is published only after it has been filled, so looking up an existing one
+	// takes no lock, only a flush that pairs with the one before the publication.
 	virtual QuadPt3D *get_points(const Ord3 &order) {
 		CHECK_MODE;
-		if ((*tables)[order.get_idx()] == NULL) 
-      calc_table(order);
-		return (*tables)[order.get_idx()];
+		QuadPt3D *&slot = hex_tables[(order.z * H3D_HEX_NUM_ORDERS + order.y) * H3D_HEX_NUM_ORDERS + order.x];
+		QuadPt3D *pts = slot;
+		if (pts == NULL) {
+#ifdef _OPENMP
+#pragma omp critical (quad_std_hex)
+#endif
+			{
+				if (slot == NULL) {
+					QuadPt3D *tbl = calc_table(order);
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+					slot = tbl;
+				}
+				pts = slot;
+			}
+		}
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+		return pts;
 	}
 
 	virtual QuadPt3D *get_face_points(int face, const Ord2 &order) {
-		if ((*face_tables)[face] == NULL)
-      (*face_tables)[face] = new std::map<unsigned int, QuadPt3D *>;
-    if((*(*face_tables)[face])[order.get_idx()] == NULL) 
-      calc_face_table(face, order);
-		return (*(*face_tables)[face])[order.get_idx()];
+		QuadPt3D *&slot = hex_face_tables[(face * H3D_HEX_NUM_ORDERS + order.y) * H3D_HEX_NUM_ORDERS + order.x];
+		QuadPt3D *pts = slot;
+		if (pts == NULL) {
+#ifdef _OPENMP
+#pragma omp critical (quad_std_hex)
+#endif
+			{
+				if (slot == NULL) {
+					QuadPt3D *tbl = calc_face_table(face, order);
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+					slot = tbl;
+				}
+				pts = slot;
+			}
+		}
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+		return pts;
 	}
 
 protected:
-	void calc_table(const Ord3 &order);
-	void calc_face_table(int face, const Ord2 &order);
+	/// Tables of element points indexed by order (x fastest) and of face points indexed by
+	/// face and order, NULL until calculated.
+	QuadPt3D **hex_tables;
+	QuadPt3D **hex_face_tables;
+
+	QuadPt3D *calc_table(const Ord3 &order);
+	QuadPt3D *calc_face_table(int face, const Ord2 &order);
 	///
 	Ord3 lower_order_same_accuracy(const Ord3 &ord);
 };
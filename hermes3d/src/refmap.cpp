@@ -54,6 +54,7 @@
 // TODO: prisms
 
 static ShapeFunction *ref_map_pss[] = { H3D_REFMAP_PSS_TETRA, H3D_REFMAP_PSS_HEX, NULL };
+static Shapeset *ref_map_shapeset[] = { H3D_REFMAP_SHAPESET_TETRA, H3D_REFMAP_SHAPESET_HEX, NULL };
 
 // RefMap /////////////////////////////////////////////////////////////////////////////////////////
 
@@ -61,16 +62,32 @@ RefMap::RefMap() {
 	_F_
 	this->mesh = NULL;
 	this->pss = NULL;
+	for (int i = 0; i < 3; i++) own_pss[i] = NULL;
 }
 
 RefMap::RefMap(Mesh *mesh) {
 	_F_
 	this->mesh = mesh;
 	this->pss = NULL;
+	for (int i = 0; i < 3; i++) own_pss[i] = NULL;
 }
 
 RefMap::~RefMap() {
 	_F_
+	for (int i = 0; i < 3; i++) delete own_pss[i];
+}
+
+void RefMap::set_private_shapeset() {
+	_F_
+	// the reference map shapesets only return values of fixed shape functions, they can be
+	// shared, the precalculated values can not
+	for (int i = 0; i < 3; i++)
+		if (own_pss[i] == NULL && ref_map_shapeset[i] != NULL)
+			own_pss[i] = new ShapeFunction(ref_map_shapeset[i]);
+	if (pss != NULL && element != NULL) {
+		pss = own_pss[element->get_mode()];
+		pss->set_active_element(element);
+	}
 }
 
 void RefMap::set_active_element(Element *e) {
@@ -79,7 +96,7 @@ void RefMap::set_active_element(Element *e) {
 
 	ElementMode3D mode = e->get_mode();
 
-	pss = ref_map_pss[mode];
+	pss = (own_pss[mode] != NULL) ? own_pss[mode] : ref_map_pss[mode];
 	pss->set_active_element(e);
 
 	if (e == element) return;
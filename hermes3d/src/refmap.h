@@ -46,6 +46,11 @@ public:
 	/// @param mesh [in] Pointer to the mesh.
 	void set_mesh(Mesh *mesh) { this->mesh = mesh; }
 
+	/// Makes the reference map evaluate the mapping with its own shape functions instead of
+	/// the ones shared by all instances. Needed when reference maps are used by several
+	/// threads at once.
+	void set_private_shapeset();
+
 	/// Initializes the reference map for the specified element.
 	/// Must be called prior to using all other functions in the class.
 	/// @param[in] e - The element we want to work with
@@ -108,6 +113,9 @@ public:
 protected:
 	Mesh *mesh;
 	ShapeFunction *pss;
+	/// Private shape functions of the reference mapping (indexing: [mode]), NULL if the
+	/// shared ones are used.
+	ShapeFunction *own_pss[3];
 
 	bool      is_const_jacobian;
 	double    const_jacobian;
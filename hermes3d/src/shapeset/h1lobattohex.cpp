@@ -285,6 +285,25 @@ Ord3 H1ShapesetLobattoHex::get_dcmp(int index) const
 		return Ord3(-1);
 }
 
+bool H1ShapesetLobattoHex::get_oriented_dcmp(int index, int dcmp[3], double &sign) const
+{
+#ifdef WITH_HEX
+	if (index < 0) return false;
+
+	h1_hex_index_t idx(index);
+	int oris[3];
+	decompose(idx, dcmp, oris);
+
+	// l_i(-x) = (-1)^i l_i(x) for i >= 2 (only these functions can be flipped)
+	sign = 1.0;
+	for (int i = 0; i < 3; i++)
+		if (oris[i] == 1 && dcmp[i] % 2 == 1) sign = -sign;
+	return true;
+#else
+	return false;
+#endif
+}
+
 int H1ShapesetLobattoHex::get_shape_type(int index) const
 {
 	_F_
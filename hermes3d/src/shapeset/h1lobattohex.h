@@ -77,6 +77,8 @@ public:
 
 	virtual Ord3 get_dcmp(int index) const;
 
+	virtual bool get_oriented_dcmp(int index, int dcmp[3], double &sign) const;
+
 	virtual int get_shape_type(int index) const;
 
 	virtual void get_values(int n, int index, int np, QuadPt3D *pt, int component, double *vals) {
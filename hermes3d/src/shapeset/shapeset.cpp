@@ -217,6 +217,14 @@ CEDComb *Shapeset::get_ced_comb(const CEDKey &key) {
 	return ced_comb[key];
 }
 
+void Shapeset::prepare_constrained_fn(int index) {
+	_F_
+	assert(ced_key.find(-1 - index) != ced_key.end());
+	CEDKey key = ced_key[-1 - index];
+	get_ced_comb(key);
+	get_ced_indices(key);
+}
+
 int *Shapeset::get_ced_indices(const CEDKey &key) {
 	_F_
 	int *idx;
@@ -235,6 +235,12 @@ public:
 	/// Get function decomposition for product shapesets
 	virtual Ord3 get_dcmp(int index) const = 0;
 
+	/// Get function decomposition for product shapesets including the orientation of the function,
+	/// i.e. the function is sign * l_dcmp[0](x) * l_dcmp[1](y) * l_dcmp[2](z), where l_i are
+	/// the 1D Lobatto functions (lobatto_fn_tab_1d).
+	/// @return false if the function is not such a product (e.g. a constrained function)
+	virtual bool get_oriented_dcmp(int index, int dcmp[3], double &sign) const { return false; }
+
 	/// Get index of a constrained edge function.
 	/// @return The index of a constrained edge function.
 	/// @param[in] edge The local number of an edge.
@@ -259,6 +265,12 @@ public:
 	/// @param[in] part The 'part' of an face
 	virtual int get_constrained_face_index(int face, int ori, Ord2 order, Part part, int variant = 0);
 
+	/// Calculate the combination of a constrained function (and the index tables it uses).
+	/// The combinations are otherwise calculated on the first evaluation, this has to be
+	/// called before the constrained function is evaluated by several threads at once.
+	/// @param[in] index The (negative) index of a constrained function.
+	void prepare_constrained_fn(int index);
+
 	virtual int get_shape_type(int index) const = 0;
 
 	/// Evaluate function in the set of points
@@ -521,7 +521,7 @@ void Solution::set_coeff_vector(Space *space, scalar *vec, double dir) {
 
 	// obtain element orders, allocate mono_coefs
 	num_coefs = 0;
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
 		  Element *e = mesh->elements[it->first];
 		  int mode = e->get_mode();
@@ -539,7 +539,7 @@ void Solution::set_coeff_vector(Space *space, scalar *vec, double dir) {
 	ShapeFunction shfn(ss);
 	// express the solution on elements as a linear combination of monomials
 	scalar *mono = mono_coefs;
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		  int mode = e->get_mode();
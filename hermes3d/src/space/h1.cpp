@@ -117,11 +117,11 @@ int H1Space::get_element_ndofs(Ord3 order) {
 
 void H1Space::assign_dofs_internal() {
 	_F_
-	std::map<unsigned int, bool> init_vertices;
-	std::map<Edge::Key, bool> init_edges;
-	std::map<Facet::Key, bool> init_faces;
+	IdMap<bool> init_vertices;
+	HashMap<Edge::Key, bool> init_edges;
+	HashMap<Facet::Key, bool> init_faces;
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		  // vertex dofs
@@ -136,7 +136,7 @@ void H1Space::assign_dofs_internal() {
 		  }
 	  }
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		  // edge dofs
@@ -151,7 +151,7 @@ void H1Space::assign_dofs_internal() {
 		  }
 	  }
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		// face dofs
@@ -166,7 +166,7 @@ void H1Space::assign_dofs_internal() {
 		}
 	}
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active)
 		  assign_bubble_dofs(it->first);
 }
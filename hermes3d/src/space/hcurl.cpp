@@ -91,11 +91,11 @@ int HcurlSpace::get_element_ndofs(Ord3 order) {
 
 void HcurlSpace::assign_dofs_internal() {
 	_F_
-	std::map<Edge::Key, bool> init_edges;
-	std::map<Facet::Key, bool> init_faces;
+	HashMap<Edge::Key, bool> init_edges;
+	HashMap<Facet::Key, bool> init_faces;
 
 	// edge dofs
-  for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+  for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		  // edge dofs
@@ -110,7 +110,7 @@ void HcurlSpace::assign_dofs_internal() {
 		  }
 	  }
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		// face dofs
@@ -125,7 +125,7 @@ void HcurlSpace::assign_dofs_internal() {
 		}
 	}
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active)
 		  assign_bubble_dofs(it->first);
 }
@@ -132,7 +132,7 @@ Space::~Space() {
 	_F_
 	free_data_tables();
 
-  for(std::map<Facet::Key, FaceInfo*>::iterator it = fi_data.begin(); it != fi_data.end(); it++)
+  for(HashMap<Facet::Key, FaceInfo *>::iterator it = fi_data.begin(); it != fi_data.end(); it++)
 		delete it->second;
   fi_data.clear();
 }
@@ -141,7 +141,7 @@ void Space::init_data_tables() {
 	_F_
 	assert(mesh != NULL);
 
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       elm_data[it->first] = new ElementData;
       MEM_CHECK(elm_data[it->first]);
@@ -151,12 +151,12 @@ void Space::init_data_tables() {
 void Space::free_data_tables() {
 	_F_
 
-  for(std::map<unsigned int, VertexData*>::iterator it = vn_data.begin(); it != vn_data.end(); it++)
+  for(IdMap<VertexData *>::iterator it = vn_data.begin(); it != vn_data.end(); it++)
     if(it->second->ced)
       ::free(it->second->baselist);
   vn_data.clear();
 
-  for(std::map<Edge::Key, EdgeData*>::iterator it = en_data.begin(); it != en_data.end(); it++) {
+  for(HashMap<Edge::Key, EdgeData *>::iterator it = en_data.begin(); it != en_data.end(); it++) {
 		delete [] it->second->bc_proj;
     if (it->second->ced) {
 	    ::free(it->second->edge_baselist);
@@ -165,11 +165,11 @@ void Space::free_data_tables() {
   }
   en_data.clear();
 
-  for(std::map<Facet::Key, FaceData*>::iterator it = fn_data.begin(); it != fn_data.end(); it++)
+  for(HashMap<Facet::Key, FaceData *>::iterator it = fn_data.begin(); it != fn_data.end(); it++)
     delete [] it->second->bc_proj;
   fn_data.clear();
 
-  for(std::map<unsigned int, ElementData*>::iterator it = elm_data.begin(); it != elm_data.end(); it++)
+  for(IdMap<ElementData *>::iterator it = elm_data.begin(); it != elm_data.end(); it++)
 		delete it->second;
   elm_data.clear();
 
@@ -203,7 +203,7 @@ Ord3 Space::get_element_order(unsigned int eid) const
 
 void Space::set_uniform_order_internal(Ord3 order, int marker) {
   _F_
-  for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+  for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       assert(elm_data[it->first] != NULL);
       assert(mesh->elements[it->first]->get_mode() == order.type);
@@ -249,7 +249,7 @@ inline int LIMIT_ELEMENT_ORDER(int a) {
 void Space::copy_orders(const Space &space, int inc) {
 	_F_
 	Mesh *cmesh = space.get_mesh();
-	for(std::map<unsigned int, Element*>::iterator it = cmesh->elements.begin(); it != cmesh->elements.end(); it++)
+	for(ElementMap::iterator it = cmesh->elements.begin(); it != cmesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
 		  Ord3 oo = space.get_element_order(it->first);
 		  assert(cmesh->elements[it->first]->get_mode() == mesh->elements[it->first]->get_mode());
@@ -272,7 +272,7 @@ void Space::copy_orders(const Space &space, int inc) {
 
 void Space::enforce_minimum_rule() {
 	_F_
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *elem = mesh->elements[it->first];
 		  ElementData *elem_node = elm_data[it->first];
@@ -563,7 +563,7 @@ void Space::set_bc_info(NodeData *node, BCType bc, int marker) {
 
 void Space::set_bc_information() {
 	_F_
-    for(std::map<Facet::Key, Facet *>::iterator it = mesh->facets.begin(); it != mesh->facets.end(); it++) {
+    for(FacetMap::iterator it = mesh->facets.begin(); it != mesh->facets.end(); it++) {
       Facet *facet = it->second;
 		  assert(facet != NULL);
 
@@ -894,25 +894,25 @@ void Space::find_constraints()
 	face_ced.clear();
 
 	// modified breadth-first search
-	std::map<unsigned int, Facet::Key> open;
-	std::map<Facet::Key, bool> elms;
+	std::vector<Facet::Key> open;
+	HashMap<Facet::Key, bool> elms;
 
 	// first include all base elements
-  for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+  for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
     if(it->first <= mesh->get_num_base_elements())
       if (it->second->used) {
 		    Element *e = mesh->elements[it->first];
 		    for (int iface = 0; iface < e->get_num_faces(); iface++) {
 			    Facet::Key fid = mesh->get_facet_id(e, iface);
 			    if (!elms[fid]) {
-            open[open.size()] = fid;
+            open.push_back(fid);
 				    elms[fid] = true;
 			    }
 		    }
 	    }
 
-	for(std::map<unsigned int, Facet::Key>::iterator it = open.begin(); it != open.end(); it++) {
-    Facet::Key fid = it->second;
+	for(unsigned int k = 0; k < open.size(); k++) {
+    Facet::Key fid = open[k];
 		Facet *facet = mesh->facets[fid];
 
 		if ((unsigned) facet->left != INVALID_IDX) {
@@ -920,7 +920,7 @@ void Space::find_constraints()
 			for (int iface = 0; iface < e->get_num_faces(); iface++) {
 				Facet::Key fid = mesh->get_facet_id(e, iface);
 				if (!elms[fid]) {
-          open[open.size()] = fid;
+          open.push_back(fid);
 					elms[fid] = true;
 				}
 			}
@@ -931,7 +931,7 @@ void Space::find_constraints()
 			for (int iface = 0; iface < e->get_num_faces(); iface++) {
 				Facet::Key fid = mesh->get_facet_id(e, iface);
 				if (!elms[fid]) {
-          open[open.size()] = fid;
+          open.push_back(fid);
 					elms[fid] = true;
 				}
 			}
@@ -941,15 +941,15 @@ void Space::find_constraints()
 			Facet::Key son = facet->sons[i];
 			if (son != Facet::invalid_key) {
 				if (!elms[son]) {
-				  open[open.size()] = son;
+				  open.push_back(son);
 					elms[son] = true;
 				}
 			}
 		}
 	}
 
-	for(std::map<unsigned int, Facet::Key>::iterator it = open.begin(); it != open.end(); it++) {
-    Facet::Key fid = it->second;
+	for(unsigned int k = 0; k < open.size(); k++) {
+    Facet::Key fid = open[k];
 		Facet *facet = mesh->facets[fid];
 		assert(facet != NULL);
 
@@ -2258,12 +2258,12 @@ int Space::assign_dofs(int first_dof, int stride) {
 	this->stride = stride;
 
 	// free data
-	for(std::map<unsigned int, VertexData*>::iterator it = vn_data.begin(); it != vn_data.end(); it++)
+	for(IdMap<VertexData *>::iterator it = vn_data.begin(); it != vn_data.end(); it++)
     if(it->second->ced)
       ::free(it->second->baselist);
   vn_data.clear();
 
-  for(std::map<Edge::Key, EdgeData*>::iterator it = en_data.begin(); it != en_data.end(); it++) {
+  for(HashMap<Edge::Key, EdgeData *>::iterator it = en_data.begin(); it != en_data.end(); it++) {
 		delete [] it->second->bc_proj;
     if (it->second->ced) {
 	    ::free(it->second->edge_baselist);
@@ -2272,11 +2272,11 @@ int Space::assign_dofs(int first_dof, int stride) {
   }
   en_data.clear();
 
-  for(std::map<Facet::Key, FaceData*>::iterator it = fn_data.begin(); it != fn_data.end(); it++)
+  for(HashMap<Facet::Key, FaceData *>::iterator it = fn_data.begin(); it != fn_data.end(); it++)
     delete [] it->second->bc_proj;
   fn_data.clear();
 
-  for(std::map<Facet::Key, FaceInfo*>::iterator it = fi_data.begin(); it != fi_data.end(); it++)
+  for(HashMap<Facet::Key, FaceInfo *>::iterator it = fi_data.begin(); it != fi_data.end(); it++)
 		delete [] it->second;
   fi_data.clear();
 
@@ -2373,7 +2373,7 @@ void Space::update_constraints()
 	_F_
 	uc_deps.clear();
 	// first calc BC projs in all vertices
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
 		  Element *e = mesh->elements[it->first];
 		  for (int iface = 0; iface < e->get_num_faces(); iface++) {
@@ -2397,7 +2397,7 @@ void Space::update_constraints()
 	  }
 
 	// update constrains recursively
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active)
       uc_dep(it->first);
 }
@@ -2463,7 +2463,7 @@ void Space::copy_callbacks(const Space *space)
 void Space::calc_boundary_projections() 
 {
 	_F_
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 		  for (int iface = 0; iface < e->get_num_faces(); iface++) {
@@ -2486,7 +2486,7 @@ void Space::calc_boundary_projections()
 }
 
 void Space::dump() {
-	for(std::map<unsigned int, Element*>::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
+	for(ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++)
 		if (it->second->used && it->second->active) {
       Element *e = mesh->elements[it->first];
 
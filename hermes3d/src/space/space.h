@@ -255,10 +255,10 @@ protected:
     void dump(int id);
   };
 
-  std::map<unsigned int, VertexData *> vn_data;		/// Vertex node hash table
-  std::map<Edge::Key, EdgeData *> en_data;		/// Edge node hash table
-  std::map<Facet::Key, FaceData *> fn_data;		/// Face node hash table
-  std::map<unsigned int, ElementData *> elm_data;		/// Element node hash table
+  IdMap<VertexData *> vn_data;		/// Vertex node hash table
+  HashMap<Edge::Key, EdgeData *> en_data;		/// Edge node hash table
+  HashMap<Facet::Key, FaceData *> fn_data;		/// Face node hash table
+  IdMap<ElementData *> elm_data;		/// Element node hash table
 
   void set_order_recurrent(unsigned int eid, Ord3 order);
 
@@ -333,15 +333,15 @@ protected:
   void fc_face_right(Facet::Key fid);
   /// @param[in] idx - ID of the element
   void fc_element(unsigned int idx);
-  std::map<Facet::Key, bool> face_ced;
+  HashMap<Facet::Key, bool> face_ced;
 
   // update constraints
   void uc_element(unsigned int idx);
   void uc_face(unsigned int eid, int iface);
   void uc_dep(unsigned int eid);
-  std::map<unsigned int, bool> uc_deps;
+  IdMap<bool> uc_deps;
 
-  std::map<Facet::Key, FaceInfo *> fi_data;
+  HashMap<Facet::Key, FaceInfo *> fi_data;
 
   VertexData *create_vertex_node_data(unsigned int vid, bool ced);
   EdgeData *create_edge_node_data(Edge::Key eid, bool ced);
@@ -0,0 +1,407 @@
+// This file is part of Hermes3D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes3D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes3D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes3D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "h3d_common.h"
+#include "sumfact.h"
+#include "quad.h"
+#include "refmap.h"
+#include "shapeset/shapeset.h"
+#include "shapeset/lobatto.h"
+#include "../../hermes_common/error.h"
+#include "../../hermes_common/callstack.h"
+
+// number of tabulated 1D Lobatto functions (the stride of the 1D tables)
+#define H3D_SUMFACT_NUM_1D			12
+
+// terms of the form: the derivative of the test function, of the basis function (-1 = value)
+// and the coefficient
+static struct { int k, l, coef; } sumfact_terms[] = {
+	{ 0, 0, 0 }, { 1, 1, 1 }, { 2, 2, 2 },
+	{ 0, 1, 3 }, { 1, 0, 3 }, { 0, 2, 4 }, { 2, 0, 4 }, { 1, 2, 5 }, { 2, 1, 5 },
+	{ -1, -1, 6 }
+};
+
+// SumFactHex::Functions //////////////////////////////////////////////////////////////////////////
+
+bool SumFactHex::Functions::set(Shapeset *ss, int n, long int *idx)
+{
+	_F_
+	free();
+	this->n = n;
+	dcmp = new int[n][3]; MEM_CHECK(dcmp);
+	sign = new double[n]; MEM_CHECK(sign);
+
+	nb[0] = nb[1] = nb[2] = 0;
+	for (int i = 0; i < n; i++) {
+		if (!ss->get_oriented_dcmp(idx[i], dcmp[i], sign[i])) return false;
+		for (int d = 0; d < 3; d++) {
+			if (dcmp[i][d] >= H3D_SUMFACT_NUM_1D) return false;
+			nb[d] = std::max(nb[d], dcmp[i][d] + 1);
+		}
+	}
+	return true;
+}
+
+void SumFactHex::Functions::free()
+{
+	delete [] dcmp; dcmp = NULL;
+	delete [] sign; sign = NULL;
+	n = 0;
+}
+
+// SumFactHex /////////////////////////////////////////////////////////////////////////////////////
+
+SumFactHex::SumFactHex()
+{
+	_F_
+	for (int d = 0; d < 3; d++) {
+		fn[d] = der[d] = NULL;
+		nq[d] = nb[d] = 0;
+	}
+	for (int i = 0; i < 7; i++)
+		coef[i] = NULL;
+	np = 0;
+	has_diffusion = has_reaction = false;
+	mat_buffer = NULL;
+	mat_buffer_size = 0;
+	buffer = NULL;
+	buffer_size = 0;
+}
+
+SumFactHex::~SumFactHex()
+{
+	_F_
+	free_tables();
+	delete [] mat_buffer;
+	delete [] buffer;
+}
+
+void SumFactHex::free_tables()
+{
+	_F_
+	for (int d = 0; d < 3; d++) {
+		delete [] fn[d]; fn[d] = NULL;
+		delete [] der[d]; der[d] = NULL;
+	}
+	for (int i = 0; i < 7; i++) {
+		delete [] coef[i];
+		coef[i] = NULL;
+	}
+	order.invalid();
+}
+
+void SumFactHex::calc_tables(const Ord3 &order)
+{
+	_F_
+	free_tables();
+	this->order = order;
+
+	Quad1D *quad = get_quadrature_1d();
+	int ord[3] = { order.x, order.y, order.z };
+	for (int d = 0; d < 3; d++) {
+		nq[d] = quad->get_num_points(ord[d]);
+		QuadPt1D *pt = quad->get_points(ord[d]);
+
+		fn[d] = new double[nq[d] * H3D_SUMFACT_NUM_1D]; MEM_CHECK(fn[d]);
+		der[d] = new double[nq[d] * H3D_SUMFACT_NUM_1D]; MEM_CHECK(der[d]);
+		for (int q = 0; q < nq[d]; q++)
+			for (int a = 0; a < H3D_SUMFACT_NUM_1D; a++) {
+				fn[d][q * H3D_SUMFACT_NUM_1D + a] = lobatto_fn_tab_1d[a](pt[q].x);
+				der[d][q * H3D_SUMFACT_NUM_1D + a] = lobatto_der_tab_1d[a](pt[q].x);
+			}
+	}
+
+	np = nq[0] * nq[1] * nq[2];
+	for (int i = 0; i < 7; i++) {
+		coef[i] = new double[np];
+		MEM_CHECK(coef[i]);
+	}
+}
+
+double *SumFactHex::get_mat_buffer(int size)
+{
+	if (size > mat_buffer_size) {
+		delete [] mat_buffer;
+		mat_buffer = new double[size]; MEM_CHECK(mat_buffer);
+		mat_buffer_size = size;
+	}
+	return mat_buffer;
+}
+
+scalar *SumFactHex::get_buffer(int size)
+{
+	if (size > buffer_size) {
+		delete [] buffer;
+		buffer = new scalar[size]; MEM_CHECK(buffer);
+		buffer_size = size;
+	}
+	return buffer;
+}
+
+bool SumFactHex::set_functions(Shapeset *test_ss, int m, long int *test_idx, Shapeset *basis_ss, int n, long int *basis_idx)
+{
+	_F_
+	if (!test.set(test_ss, m, test_idx) || !basis.set(basis_ss, n, basis_idx)) return false;
+	for (int d = 0; d < 3; d++)
+		nb[d] = std::max(test.nb[d], basis.nb[d]);
+	return true;
+}
+
+void SumFactHex::set_geometry(RefMap *rm, const Ord3 &order, double diffusion, double reaction)
+{
+	_F_
+	assert(order.type == HERMES_MODE_HEX);
+	assert(rm->get_transform() == 0);
+	if (this->order != order) calc_tables(order);
+
+	has_diffusion = (diffusion != 0.0);
+	has_reaction = (reaction != 0.0);
+
+	QuadPt3D *pt = get_quadrature(HERMES_MODE_HEX)->get_points(order);
+	double *jwt = rm->get_jacobian(np, pt);
+	double3x3 *m = rm->get_inv_ref_map(np, pt);
+
+	// grad u . grad v = sum_kl (du/dxi_k) (dv/dxi_l) sum_i m[i][k] m[i][l]
+	static const int kl[6][2] = { { 0, 0 }, { 1, 1 }, { 2, 2 }, { 0, 1 }, { 0, 2 }, { 1, 2 } };
+	for (int q = 0; q < np; q++) {
+		for (int c = 0; c < 6; c++) {
+			int k = kl[c][0], l = kl[c][1];
+			coef[c][q] = diffusion * jwt[q] * (m[q][0][k] * m[q][0][l] + m[q][1][k] * m[q][1][l] + m[q][2][k] * m[q][2][l]);
+		}
+		coef[6][q] = reaction * jwt[q];
+	}
+
+	delete [] jwt;
+	delete [] m;
+}
+
+void SumFactHex::calc_matrix(scalar **mat)
+{
+	_F_
+	assert(!order.is_invalid());
+	const int S = H3D_SUMFACT_NUM_1D;
+	int nbx = nb[0], nby = nb[1], nbz = nb[2];
+	int nqx = nq[0], nqy = nq[1], nqz = nq[2];
+
+	// Every term is a sum over the quadrature points of coef(x, y, z) * X(x) * Y(y) * Z(z), where
+	// X, Y, Z are products of the 1D functions (or their derivatives) of the test and the basis
+	// function. The sums are done one direction after another, first over z, then over y for
+	// all pairs of 1D functions in z (T1, T2); the terms are then grouped by the kind of X (the
+	// derivative of the test and of the basis function in x), so that the last sum over x is
+	// done only 4 times for each entry of the matrix.
+	int t1_size = nqx * nqy * nbz * nbz;
+	int t2_size = nqx * nby * nby * nbz * nbz;
+	double *t1 = get_mat_buffer(t1_size + 4 * t2_size);
+	double *t2 = t1 + t1_size;
+	memset(t2, 0, 4 * t2_size * sizeof(double));
+
+	for (unsigned int t = 0; t < countof(sumfact_terms); t++) {
+		int k = sumfact_terms[t].k, l = sumfact_terms[t].l;
+		if ((k >= 0 && !has_diffusion) || (k < 0 && !has_reaction)) continue;
+		double *c = coef[sumfact_terms[t].coef];
+		double *zv = (k == 2) ? der[2] : fn[2], *zu = (l == 2) ? der[2] : fn[2];
+		double *yv = (k == 1) ? der[1] : fn[1], *yu = (l == 1) ? der[1] : fn[1];
+		double *t2k = t2 + (2 * (k == 0) + (l == 0)) * t2_size;
+
+		// T1[qx][qy][c][c'] = sum_qz Z_v[qz][c] Z_u[qz][c'] coef[qx][qy][qz]
+		for (int qxy = 0; qxy < nqx * nqy; qxy++) {
+			double *cq = c + qxy * nqz;
+			double *t1q = t1 + qxy * nbz * nbz;
+			for (int cv = 0; cv < nbz; cv++)
+				for (int cu = 0; cu < nbz; cu++) {
+					double sum = 0.0;
+					for (int qz = 0; qz < nqz; qz++)
+						sum += zv[qz * S + cv] * zu[qz * S + cu] * cq[qz];
+					t1q[cv * nbz + cu] = sum;
+				}
+		}
+
+		// T2[qx][b][b'][c][c'] += sum_qy Y_v[qy][b] Y_u[qy][b'] T1[qx][qy][c][c']
+		for (int qx = 0; qx < nqx; qx++)
+			for (int bv = 0; bv < nby; bv++)
+				for (int bu = 0; bu < nby; bu++) {
+					double *t2q = t2k + ((qx * nby + bv) * nby + bu) * nbz * nbz;
+					for (int qy = 0; qy < nqy; qy++) {
+						double yy = yv[qy * S + bv] * yu[qy * S + bu];
+						if (yy == 0.0) continue;
+						double *t1q = t1 + (qx * nqy + qy) * nbz * nbz;
+						for (int cc = 0; cc < nbz * nbz; cc++)
+							t2q[cc] += yy * t1q[cc];
+					}
+				}
+	}
+
+	// mat[i][j] = sum_kind sum_qx X_v[qx][a_i] X_u[qx][a_j] T2_kind[qx][b_i][b_j][c_i][c_j]
+	double *xv[4] = { fn[0], fn[0], der[0], der[0] };
+	double *xu[4] = { fn[0], der[0], fn[0], der[0] };
+	for (int i = 0; i < test.n; i++) {
+		int *di = test.dcmp[i];
+		for (int j = 0; j < basis.n; j++) {
+			int *dj = basis.dcmp[j];
+			int off = (di[1] * nby + dj[1]) * nbz * nbz + di[2] * nbz + dj[2];
+			double sum = 0.0;
+			for (int kind = 0; kind < 4; kind++) {
+				double *t2k = t2 + kind * t2_size + off;
+				for (int qx = 0; qx < nqx; qx++)
+					sum += xv[kind][qx * S + di[0]] * xu[kind][qx * S + dj[0]] * t2k[qx * nby * nby * nbz * nbz];
+			}
+			mat[i][j] = test.sign[i] * basis.sign[j] * sum;
+		}
+	}
+}
+
+void SumFactHex::interpolate(const scalar *in, scalar *val, scalar *dx, scalar *dy, scalar *dz)
+{
+	_F_
+	assert(!order.is_invalid());
+	const int S = H3D_SUMFACT_NUM_1D;
+	int nbx = nb[0], nby = nb[1], nbz = nb[2];
+	int nqx = nq[0], nqy = nq[1], nqz = nq[2];
+
+	scalar *u = get_buffer(nbx * nby * nbz + 2 * nbx * nby * nqz + 3 * nbx * nqy * nqz);
+	scalar *z0 = u + nbx * nby * nbz, *z1 = z0 + nbx * nby * nqz;
+	scalar *y00 = z1 + nbx * nby * nqz, *y10 = y00 + nbx * nqy * nqz, *y01 = y10 + nbx * nqy * nqz;
+
+	// coefficients of the products of 1D functions
+	memset(u, 0, nbx * nby * nbz * sizeof(scalar));
+	for (int j = 0; j < basis.n; j++) {
+		int *dj = basis.dcmp[j];
+		u[(dj[0] * nby + dj[1]) * nbz + dj[2]] += basis.sign[j] * in[j];
+	}
+
+	// z: Z0[a][b][qz] = sum_c l_c(z) U[a][b][c], Z1 with l_c'(z)
+	for (int ab = 0; ab < nbx * nby; ab++)
+		for (int qz = 0; qz < nqz; qz++) {
+			scalar s0 = 0.0, s1 = 0.0;
+			for (int c = 0; c < nbz; c++) {
+				s0 += fn[2][qz * S + c] * u[ab * nbz + c];
+				s1 += der[2][qz * S + c] * u[ab * nbz + c];
+			}
+			z0[ab * nqz + qz] = s0;
+			z1[ab * nqz + qz] = s1;
+		}
+
+	// y: Y00[a][qy][qz] from Z0 with l_b(y), Y10 from Z0 with l_b'(y), Y01 from Z1 with l_b(y)
+	for (int a = 0; a < nbx; a++)
+		for (int qy = 0; qy < nqy; qy++)
+			for (int qz = 0; qz < nqz; qz++) {
+				scalar s00 = 0.0, s10 = 0.0, s01 = 0.0;
+				for (int b = 0; b < nby; b++) {
+					int i = (a * nby + b) * nqz + qz;
+					s00 += fn[1][qy * S + b] * z0[i];
+					s10 += der[1][qy * S + b] * z0[i];
+					s01 += fn[1][qy * S + b] * z1[i];
+				}
+				int o = (a * nqy + qy) * nqz + qz;
+				y00[o] = s00; y10[o] = s10; y01[o] = s01;
+			}
+
+	// x
+	for (int qx = 0; qx < nqx; qx++)
+		for (int qyz = 0; qyz < nqy * nqz; qyz++) {
+			scalar v = 0.0, vx = 0.0, vy = 0.0, vz = 0.0;
+			for (int a = 0; a < nbx; a++) {
+				int i = a * nqy * nqz + qyz;
+				v  += fn[0][qx * S + a] * y00[i];
+				vx += der[0][qx * S + a] * y00[i];
+				vy += fn[0][qx * S + a] * y10[i];
+				vz += fn[0][qx * S + a] * y01[i];
+			}
+			int o = qx * nqy * nqz + qyz;
+			val[o] = v; dx[o] = vx; dy[o] = vy; dz[o] = vz;
+		}
+}
+
+void SumFactHex::integrate(const scalar *val, const scalar *dx, const scalar *dy, const scalar *dz, scalar *out)
+{
+	_F_
+	assert(!order.is_invalid());
+	const int S = H3D_SUMFACT_NUM_1D;
+	int nbx = nb[0], nby = nb[1], nbz = nb[2];
+	int nqx = nq[0], nqy = nq[1], nqz = nq[2];
+
+	scalar *r = get_buffer(nbx * nby * nbz + 2 * nbx * nby * nqz + 3 * nbx * nqy * nqz);
+	scalar *v0 = r + nbx * nby * nbz, *v1 = v0 + nbx * nby * nqz;
+	scalar *w00 = v1 + nbx * nby * nqz, *w10 = w00 + nbx * nqy * nqz, *w01 = w10 + nbx * nqy * nqz;
+
+	// x: W00[a][qy][qz] = sum_qx (l_a(x) val + l_a'(x) dx), W10 from dy, W01 from dz
+	for (int a = 0; a < nbx; a++)
+		for (int qyz = 0; qyz < nqy * nqz; qyz++) {
+			scalar s00 = 0.0, s10 = 0.0, s01 = 0.0;
+			for (int qx = 0; qx < nqx; qx++) {
+				int i = qx * nqy * nqz + qyz;
+				s00 += fn[0][qx * S + a] * val[i] + der[0][qx * S + a] * dx[i];
+				s10 += fn[0][qx * S + a] * dy[i];
+				s01 += fn[0][qx * S + a] * dz[i];
+			}
+			int o = a * nqy * nqz + qyz;
+			w00[o] = s00; w10[o] = s10; w01[o] = s01;
+		}
+
+	// y: V0[a][b][qz] = sum_qy (l_b(y) W00 + l_b'(y) W10), V1 from W01
+	for (int a = 0; a < nbx; a++)
+		for (int b = 0; b < nby; b++)
+			for (int qz = 0; qz < nqz; qz++) {
+				scalar s0 = 0.0, s1 = 0.0;
+				for (int qy = 0; qy < nqy; qy++) {
+					int i = (a * nqy + qy) * nqz + qz;
+					s0 += fn[1][qy * S + b] * w00[i] + der[1][qy * S + b] * w10[i];
+					s1 += fn[1][qy * S + b] * w01[i];
+				}
+				int o = (a * nby + b) * nqz + qz;
+				v0[o] = s0; v1[o] = s1;
+			}
+
+	// z: R[a][b][c] = sum_qz (l_c(z) V0 + l_c'(z) V1)
+	for (int ab = 0; ab < nbx * nby; ab++)
+		for (int c = 0; c < nbz; c++) {
+			scalar s = 0.0;
+			for (int qz = 0; qz < nqz; qz++)
+				s += fn[2][qz * S + c] * v0[ab * nqz + qz] + der[2][qz * S + c] * v1[ab * nqz + qz];
+			r[ab * nbz + c] = s;
+		}
+
+	for (int i = 0; i < test.n; i++) {
+		int *di = test.dcmp[i];
+		out[i] = test.sign[i] * r[(di[0] * nby + di[1]) * nbz + di[2]];
+	}
+}
+
+void SumFactHex::apply(const scalar *in, scalar *out)
+{
+	_F_
+	assert(!order.is_invalid());
+	int nbx = nb[0], nby = nb[1], nbz = nb[2];
+	int nqy = nq[1], nqz = nq[2];
+
+	// the point values follow the storage used by interpolate() and integrate()
+	int size = nbx * nby * nbz + 2 * nbx * nby * nqz + 3 * nbx * nqy * nqz;
+	scalar *val = get_buffer(size + 4 * np) + size;
+	scalar *dx = val + np, *dy = dx + np, *dz = dy + np;
+
+	interpolate(in, val, dx, dy, dz);
+	for (int q = 0; q < np; q++) {
+		scalar ux = dx[q], uy = dy[q], uz = dz[q];
+		dx[q] = coef[0][q] * ux + coef[3][q] * uy + coef[4][q] * uz;
+		dy[q] = coef[3][q] * ux + coef[1][q] * uy + coef[5][q] * uz;
+		dz[q] = coef[4][q] * ux + coef[5][q] * uy + coef[2][q] * uz;
+		val[q] *= coef[6][q];
+	}
+	integrate(val, dx, dy, dz, out);
+}
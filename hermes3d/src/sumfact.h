@@ -0,0 +1,122 @@
+// This file is part of Hermes3D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes3D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes3D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes3D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef _SUMFACT_H_
+#define _SUMFACT_H_
+
+#include "h3d_common.h"
+#include "order.h"
+
+class Shapeset;
+class RefMap;
+
+/// Sum factorization on hexahedra
+///
+/// The H1 shape functions on hexahedra are (up to a sign) products of 1D Lobatto functions
+/// l_a(x) l_b(y) l_c(z) and the standard quadrature on hexahedra is a product of 1D Gauss
+/// rules. The class uses this to evaluate the form
+///
+///   a(u, v) = \int_K (diffusion * grad u . grad v + reaction * u v)
+///
+/// on one element by applying the 1D tables along each axis instead of evaluating every
+/// shape function at every quadrature point:
+/// - calc_matrix() calculates the local matrix in O(p^7) operations (O(p^9) if done
+///   function by function),
+/// - apply() multiplies a vector by the local matrix without forming it in O(p^4)
+///   operations (O(p^6) for the matrix-vector product).
+///
+/// Usage: set_functions(), set_geometry() (for the active element of the reference map),
+/// then calc_matrix() or apply().
+///
+/// @ingroup assembling
+class HERMES_API SumFactHex {
+public:
+	SumFactHex();
+	~SumFactHex();
+
+	/// Set the test functions (rows of the local matrix) and the basis functions (columns).
+	/// @return false if some of the functions is not a product of 1D Lobatto functions (see
+	/// Shapeset::get_oriented_dcmp()), the sum factorization can not be used then
+	/// @param[in] test_ss, basis_ss - shapesets of the test and basis functions
+	/// @param[in] m, n - the number of test and basis functions
+	/// @param[in] test_idx, basis_idx - indices of the test and basis functions (e.g. from AsmList)
+	bool set_functions(Shapeset *test_ss, int m, long int *test_idx, Shapeset *basis_ss, int n, long int *basis_idx);
+
+	/// Set the same test and basis functions.
+	bool set_functions(Shapeset *ss, int n, long int *idx) { return set_functions(ss, n, idx, ss, n, idx); }
+
+	/// Set the quadrature order and calculate the coefficients of the form at the quadrature
+	/// points of the active element of 'rm' (with no sub-element transformation).
+	void set_geometry(RefMap *rm, const Ord3 &order, double diffusion, double reaction);
+
+	/// @return the number of quadrature points (ordered as in QuadStdHex)
+	int get_num_points() const { return np; }
+
+	/// Calculate the local matrix, mat[i][j] = a(basis_j, test_i).
+	void calc_matrix(scalar **mat);
+
+	/// Multiply the local matrix by the vector 'in' (coefficients of the basis functions).
+	/// @param[out] out - a(sum_j in[j] basis_j, test_i)
+	void apply(const scalar *in, scalar *out);
+
+	/// Values and reference derivatives of sum_j in[j] basis_j at the quadrature points.
+	void interpolate(const scalar *in, scalar *val, scalar *dx, scalar *dy, scalar *dz);
+
+	/// Integrate against the test functions, out[i] = sum_q (val[q] test_i + dx[q] dtest_i/dx +
+	/// dy[q] dtest_i/dy + dz[q] dtest_i/dz) at the quadrature points (weights not included).
+	void integrate(const scalar *val, const scalar *dx, const scalar *dy, const scalar *dz, scalar *out);
+
+protected:
+	// test and basis functions: their 1D functions and signs
+	struct Functions {
+		int n;
+		int (*dcmp)[3];
+		double *sign;
+		int nb[3];				// the number of 1D functions in each direction
+
+		Functions() : n(0), dcmp(NULL), sign(NULL) { }
+		~Functions() { free(); }
+		bool set(Shapeset *ss, int n, long int *idx);
+		void free();
+	} test, basis;
+
+	int nb[3];					// max. of the numbers of 1D functions of 'test' and 'basis'
+
+	Ord3 order;					// quadrature order
+	int nq[3];					// number of 1D quadrature points
+	int np;						// number of quadrature points
+	double *fn[3], *der[3];		// 1D tables of the Lobatto functions, indexing: [direction][point][function]
+
+	// coefficients of the form at the quadrature points: diffusion * |J| * w * J^-1 J^-T
+	// (xx, yy, zz, xy, xz, yz) and reaction * |J| * w
+	double *coef[7];
+	bool has_diffusion, has_reaction;
+
+	double *mat_buffer;			// temporary storage for calc_matrix()
+	int mat_buffer_size;
+	scalar *buffer;				// temporary storage for apply(), interpolate() and integrate()
+	int buffer_size;
+
+	void calc_tables(const Ord3 &order);
+	void free_tables();
+	double *get_mat_buffer(int size);
+	scalar *get_buffer(int size);
+};
+
+#endif
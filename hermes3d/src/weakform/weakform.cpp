@@ -50,7 +50,19 @@ void WeakForm::add_matrix_form(int i, int j, matrix_form_val_t fn, matrix_form_o
 	if (area != HERMES_ANY_INT && area < 0 && -area > (signed) areas.size()) error("Invalid area number.");
 	if (mfvol.size() > 100) warning("Large number of forms (> 100). Is this the intent?");
 
-        MatrixFormVol form = { i, j, sym, area, fn, ord, ext };
+        MatrixFormVol form = { i, j, sym, area, fn, ord, ext, 0.0, 0.0 };
+	mfvol.push_back(form);
+}
+
+void WeakForm::add_matrix_form_diffusion(int i, int j, double diffusion, double reaction, int area)
+{
+	_F_
+	if (i < 0 || i >= neq || j < 0 || j >= neq) error("Invalid equation number.");
+	if (area != HERMES_ANY_INT && area < 0 && -area > (signed) areas.size()) error("Invalid area number.");
+	if (mfvol.size() > 100) warning("Large number of forms (> 100). Is this the intent?");
+
+        MatrixFormVol form = { i, j, (i == j) ? HERMES_SYM : HERMES_NONSYM, area, NULL, NULL, 
+                               std::vector<MeshFunction *>(), diffusion, reaction };
 	mfvol.push_back(form);
 }
 
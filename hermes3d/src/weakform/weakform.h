@@ -71,6 +71,15 @@ public:
 	  add_matrix_form(0, 0, fn, ord, sym, area, ext);
 
         }
+	/// Add the form \int (diffusion * grad u . grad v + reaction * u v) with constant coefficients.
+	/// On hexahedra with H1 shape functions it is assembled by sum factorization (see SumFactHex).
+	void add_matrix_form_diffusion(int i, int j, double diffusion, double reaction = 0.0, int area = HERMES_ANY_INT);
+        // single equation case
+	void add_matrix_form_diffusion(double diffusion, double reaction = 0.0, int area = HERMES_ANY_INT)
+        {
+	  add_matrix_form_diffusion(0, 0, diffusion, reaction, area);
+        }
+
 	void add_matrix_form_surf(int i, int j, matrix_form_val_t fn, matrix_form_ord_t ord, int area = HERMES_ANY_INT,
 	                          Hermes::vector<MeshFunction*> ext = Hermes::vector<MeshFunction*> ());
         // single equation case
@@ -128,6 +137,7 @@ protected:
 		matrix_form_val_t fn; // callback for evaluating the form
 		matrix_form_ord_t ord; // callback to determine the integration order
 		std::vector<MeshFunction *> ext; // external functions
+		double diffusion, reaction; // coefficients of a diffusion form (fn == NULL)
 	};
 	struct MatrixFormSurf {
 		int i, j, area;
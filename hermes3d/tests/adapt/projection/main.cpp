@@ -176,7 +176,7 @@ int main(int argc, char **args)
   }
 
   unsigned int ne = mesh.get_num_base_elements();
-  for(std::map<unsigned int, Element*>::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++) {
+  for(ElementMap::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++) {
     // We are done with base elements.
     if(it->first > ne)
       break;
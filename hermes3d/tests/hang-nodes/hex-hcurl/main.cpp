@@ -401,7 +401,7 @@ int main(int argc, char **args)
 
     int num_points = 0;
     for (int order = 0; order < NUM_RULES; order++)
-      for(std::map<unsigned int, Element*>::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++)
+      for(ElementMap::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++)
         if (it->second->used && it->second->active)
           for (int iface = 0; iface < Hex::NUM_FACES; iface++)
             num_points += my_quad.get_face_num_points(iface, order);
@@ -412,7 +412,7 @@ int main(int argc, char **args)
 
   // Find points.
     for (int order = 0; order < NUM_RULES; order++) {
-      for(std::map<unsigned int, Element*>::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++)
+      for(ElementMap::iterator it = mesh.elements.begin(); it != mesh.elements.end(); it++)
         if (it->second->used && it->second->active) {
           Element *e = mesh.elements[it->first];
           ref_map.set_active_element(e);
@@ -452,7 +452,7 @@ int main(int argc, char **args)
   // Check, whether we tested points from all inner active facets
   // this is done only for testing of correctness of the test itself.
     int nonchecked_faces = 0;
-    for(std::map<Facet::Key, Facet*>::iterator it = mesh.facets.begin(); it != mesh.facets.end(); it++) {
+    for(FacetMap::iterator it = mesh.facets.begin(); it != mesh.facets.end(); it++) {
       bool ok = false;
       Facet *fac = it->second;
       if (fac->type == Facet::OUTER) continue;
@@ -0,0 +1,123 @@
+#define HERMES_REPORT_WARN
+#define HERMES_REPORT_INFO
+#define HERMES_REPORT_VERBOSE
+#include "config.h"
+#include <hermes3d.h>
+#include "../sumfact/problem.h"
+
+// Test of the matrix-free operator (DiscreteProblem::apply(), DiscreteProblem::get_diagonal()
+// and MatrixFreeKrylovSolver).
+//
+// The problem
+//
+//      -div(K grad u) + C u = f in \Omega, u = g on the boundary with marker 2,
+//
+// (the one of the sum factorization test, see sumfact/problem.h) is discretized with a user-defined
+// form (assembled pair by pair) or with the diffusion form (applied by sum factorization) on an
+// irregularly refined mesh. Then
+// 1. DiscreteProblem::apply() is compared with the product with the assembled matrix,
+// 2. DiscreteProblem::get_diagonal() is compared with the diagonal of the assembled matrix,
+// 3. the solution by MatrixFreeKrylovSolver is compared with the one by KrylovSolver.
+//
+// Usage: test-matrix-free <mesh file> <user | diffusion> <order> [<number of threads>]
+
+// The error should be smaller than this epsilon.
+#define EPS								1e-10
+#define EPS_SOLVE						1e-8
+
+// Relative difference of two vectors in the max. norm.
+double rel_diff(scalar *a, scalar *b, int n)
+{
+	double max = 0.0, diff = 0.0;
+	for (int i = 0; i < n; i++) {
+		max = std::max(max, std::abs(a[i]));
+		diff = std::max(diff, std::abs(a[i] - b[i]));
+	}
+	return (max > 0.0) ? diff / max : diff;
+}
+
+int main(int argc, char **args)
+{
+	if (argc < 4) error("Not enough parameters.");
+
+	bool sum_fact = (strcmp(args[2], "diffusion") == 0);
+	int o = atoi(args[3]);
+	int num_threads = (argc > 4) ? atoi(args[4]) : 1;
+
+	Mesh mesh;
+	H3DReader mloader;
+	if (!mloader.load(args[1], &mesh)) error("Loading mesh file '%s'.", args[1]);
+
+	// Refine one element to get hanging nodes.
+	mesh.refine_element(1, H3D_H3D_H3D_REFT_HEX_XYZ);
+
+	H1Space space(&mesh, bc_types, essential_bc_values, Ord3(o, o, o));
+	int ndof = space.get_num_dofs();
+	info("Number of DOFs: %d.", ndof);
+
+	WeakForm wf;
+	if (sum_fact) wf.add_matrix_form_diffusion(K, C);
+	else wf.add_matrix_form(callback(bilinear_form), HERMES_SYM);
+	wf.add_vector_form(callback(linear_form));
+
+	DiscreteProblem dp(&wf, &space, true);
+	dp.set_num_threads(num_threads);
+	CSCMatrix mat;
+	UMFPackVector rhs;
+	dp.assemble(&mat, &rhs);
+
+	bool ok = true;
+	scalar *x = new scalar[ndof];
+	scalar *y = new scalar[ndof];
+	scalar *y_ref = new scalar[ndof];
+	for (int i = 0; i < ndof; i++)
+		x[i] = sin(1.0 + i * 0.37);
+
+	// 1. apply()
+	mat.multiply_with_vector(x, y_ref);
+	dp.apply(x, y);
+	double diff = rel_diff(y_ref, y, ndof);
+	info("apply(): relative difference %g.", diff);
+	if (diff > EPS) ok = false;
+
+	// 2. get_diagonal()
+	for (int i = 0; i < ndof; i++)
+		y_ref[i] = mat.get(i, i);
+	dp.get_diagonal(y);
+	diff = rel_diff(y_ref, y, ndof);
+	info("get_diagonal(): relative difference %g.", diff);
+	if (diff > EPS) ok = false;
+
+	// 3. solving
+	KrylovSolver solver(&mat, &rhs);
+	solver.set_solver("cg");
+	solver.set_precond("jacobi");
+	solver.set_tolerance(1e-12);
+	MatrixFreeKrylovSolver mf_solver(&dp, &rhs);
+	mf_solver.set_solver("cg");
+	mf_solver.set_tolerance(1e-12);
+	if (!solver.solve() || !mf_solver.solve()) {
+		info("A solver did not converge.");
+		ok = false;
+	}
+	else {
+		info("Iterations: %d (assembled matrix), %d (matrix-free).", solver.get_num_iters(),
+		     mf_solver.get_num_iters());
+		diff = rel_diff(solver.get_solution(), mf_solver.get_solution(), ndof);
+		info("Solution: relative difference %g.", diff);
+		if (diff > EPS_SOLVE) ok = false;
+	}
+
+	delete [] x;
+	delete [] y;
+	delete [] y_ref;
+
+	if (ok) {
+		info("Success!");
+		return ERR_SUCCESS;
+	}
+	else {
+		info("Failure!");
+		return ERR_FAILURE;
+	}
+}
@@ -603,7 +603,7 @@ bool test_continuity(Shapeset *shapeset) {
 
 			// test continuity on inner factes
 			// since we have only 2 elements, there is only one such facet
-      for(std::map<Facet::Key, Facet*>::iterator it = mesh.facets.begin(); it != mesh.facets.end(); it++) {
+      for(FacetMap::iterator it = mesh.facets.begin(); it != mesh.facets.end(); it++) {
         Facet *facet = it->second;
 				if (facet->type == Facet::INNER) {
 					printf("  - vertex fns..."); fflush(stdout);
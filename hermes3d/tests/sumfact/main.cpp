@@ -0,0 +1,159 @@
+#define HERMES_REPORT_WARN
+#define HERMES_REPORT_INFO
+#define HERMES_REPORT_VERBOSE
+#include "config.h"
+#include <hermes3d.h>
+#include "problem.h"
+
+// Test of the sum factorization on hexahedra (SumFactHex).
+//
+// 1. The global matrix and the right-hand side of
+//
+//      -div(K grad u) + C u = f in \Omega, u = g on the boundary with marker 2 (1 for one element),
+//
+//    assembled with the diffusion form (WeakForm::add_matrix_form_diffusion(), i.e. by sum
+//    factorization) are compared with the ones assembled with the same user-defined form.
+//    The mesh is refined irregularly so that the elements with constrained functions (which
+//    are assembled the usual way) are tested too.
+// 2. SumFactHex::apply() is compared with the product with the local matrix on every element.
+//
+// Usage: test-sumfact <mesh file> <order x> [<order y> <order z>]
+
+// The error should be smaller than this epsilon.
+#define EPS								1e-10
+
+int max_order;
+
+// The sum factorization integrates all pairs of functions with the order of the pair of the highest
+// order, the user-defined form has to do the same on non-affine elements.
+Ord bilinear_form_ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v, Geom<Ord> *e,
+                      ExtData<Ord> *data)
+{
+	return Ord(2 * max_order);
+}
+
+// Assemble the problem with the user-defined (sum_fact == false) or the diffusion form.
+void assemble(Space *space, bool sum_fact, CSCMatrix *mat, UMFPackVector *rhs)
+{
+	WeakForm wf;
+	if (sum_fact) wf.add_matrix_form_diffusion(K, C);
+	else wf.add_matrix_form(bilinear_form<double, scalar>, bilinear_form_ord, HERMES_SYM);
+	wf.add_vector_form(callback(linear_form));
+
+	DiscreteProblem dp(&wf, space, true);
+	dp.assemble(mat, rhs);
+}
+
+bool test_assembling(Space *space)
+{
+	info("Comparing the assembled matrices.");
+	CSCMatrix mat, mat_sf;
+	UMFPackVector rhs, rhs_sf;
+	assemble(space, false, &mat, &rhs);
+	assemble(space, true, &mat_sf, &rhs_sf);
+
+	if (mat.get_nnz() != mat_sf.get_nnz()) {
+		info("Different sparse structure.");
+		return false;
+	}
+
+	double max = 0.0, diff = 0.0;
+	for (unsigned int i = 0; i < mat.get_nnz(); i++) {
+		max = std::max(max, std::abs(mat.get_Ax()[i]));
+		diff = std::max(diff, std::abs(mat.get_Ax()[i] - mat_sf.get_Ax()[i]));
+	}
+	info("Matrix: max. entry %g, max. difference %g.", max, diff);
+	if (diff > EPS * max) return false;
+
+	max = diff = 0.0;
+	for (unsigned int i = 0; i < rhs.length(); i++) {
+		max = std::max(max, std::abs(rhs.get(i)));
+		diff = std::max(diff, std::abs(rhs.get(i) - rhs_sf.get(i)));
+	}
+	info("Right-hand side: max. entry %g, max. difference %g.", max, diff);
+	if (diff > EPS * max) return false;
+
+	return true;
+}
+
+bool test_apply(Mesh *mesh, Space *space)
+{
+	info("Comparing the matrix-free products.");
+	SumFactHex sum_fact;
+	RefMap refmap(mesh);
+	AsmList al;
+	int n_sum_fact = 0;
+
+	for (ElementMap::iterator it = mesh->elements.begin(); it != mesh->elements.end(); it++) {
+		Element *e = it->second;
+		if (!e->active) continue;
+		unsigned int eid = it->first;
+		space->get_element_assembly_list(e, &al);
+		if (!sum_fact.set_functions(space->get_shapeset(), al.cnt, al.idx)) continue;
+		n_sum_fact++;
+
+		refmap.set_active_element(e);
+		Ord3 order = space->get_element_order(eid) * 2 + refmap.get_inv_ref_order();
+		sum_fact.set_geometry(&refmap, order, K, C);
+
+		scalar **mat = new_matrix<scalar>(al.cnt, al.cnt);
+		scalar *x = new scalar[al.cnt];
+		scalar *y = new scalar[al.cnt];
+		for (int i = 0; i < al.cnt; i++)
+			x[i] = sin(1.0 + i * 0.37);
+
+		sum_fact.calc_matrix(mat);
+		sum_fact.apply(x, y);
+
+		double max = 0.0, diff = 0.0;
+		for (int i = 0; i < al.cnt; i++) {
+			scalar mx = 0.0;
+			for (int j = 0; j < al.cnt; j++)
+				mx += mat[i][j] * x[j];
+			max = std::max(max, std::abs(mx));
+			diff = std::max(diff, std::abs(mx - y[i]));
+		}
+
+		delete [] mat;
+		delete [] x;
+		delete [] y;
+
+		if (diff > EPS * max) {
+			info("Element #%u: max. entry %g, max. difference %g.", eid, max, diff);
+			return false;
+		}
+	}
+	info("%d elements checked.", n_sum_fact);
+
+	return n_sum_fact > 0;
+}
+
+int main(int argc, char **args)
+{
+	if (argc < 3) error("Not enough parameters.");
+
+	int ox = atoi(args[2]);
+	int oy = (argc > 4) ? atoi(args[3]) : ox;
+	int oz = (argc > 4) ? atoi(args[4]) : ox;
+	max_order = std::max(ox, std::max(oy, oz));
+
+	Mesh mesh;
+	H3DReader mloader;
+	if (!mloader.load(args[1], &mesh)) error("Loading mesh file '%s'.", args[1]);
+	if (mesh.get_num_active_elements() == 1) bdy_marker = 1;
+
+	// Refine one element to get hanging nodes.
+	if (mesh.get_num_active_elements() > 1) mesh.refine_element(1, H3D_H3D_H3D_REFT_HEX_XYZ);
+
+	H1Space space(&mesh, bc_types, essential_bc_values, Ord3(ox, oy, oz));
+	info("Number of DOFs: %d.", space.get_num_dofs());
+
+	if (test_assembling(&space) && test_apply(&mesh, &space)) {
+		info("Success!");
+		return ERR_SUCCESS;
+	}
+	else {
+		info("Failure!");
+		return ERR_FAILURE;
+	}
+}
@@ -0,0 +1,42 @@
+// The problem shared by the tests of the sum factorization and of the matrix-free operator:
+//
+//      -div(K grad u) + C u = f in \Omega, u = g on the boundary with marker bdy_marker.
+
+#ifndef _TEST_SUMFACT_PROBLEM_H_
+#define _TEST_SUMFACT_PROBLEM_H_
+
+const double K = 1.5;
+const double C = 0.5;
+
+int bdy_marker = 2;
+
+BCType bc_types(int marker)
+{
+	return (marker == bdy_marker) ? H3D_BC_ESSENTIAL : H3D_BC_NATURAL;
+}
+
+scalar essential_bc_values(int ess_bdy_marker, double x, double y, double z)
+{
+	return x * x + y - z * y;
+}
+
+template<typename Real, typename Scalar>
+Scalar bilinear_form(int n, double *wt, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v, Geom<Real> *e,
+                     ExtData<Scalar> *data)
+{
+	return K * int_grad_u_grad_v<Real, Scalar>(n, wt, u, v, e) + C * int_u_v<Real, Scalar>(n, wt, u, v, e);
+}
+
+template<typename T>
+T f(T x, T y, T z)
+{
+	return x * y + z;
+}
+
+template<typename Real, typename Scalar>
+Scalar linear_form(int n, double *wt, Func<Scalar> *u_ext[], Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *data)
+{
+	return int_F_v<Real, Scalar>(n, wt, f, v, e);
+}
+
+#endif
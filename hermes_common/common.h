@@ -83,18 +83,22 @@ enum MatrixSolverType
    SOLVER_MUMPS,
    SOLVER_SUPERLU,
    SOLVER_AMESOS,
-   SOLVER_AZTECOO
+   SOLVER_AZTECOO,
+   SOLVER_KRYLOV,
+   SOLVER_KRYLOV_BSR
 };
 
 // Should be in the same order as MatrixSolverTypes above, so that the
 // names may be accessed by the same enumeration variable.
-const std::string MatrixSolverNames[6] = {
+const std::string MatrixSolverNames[8] = {
   "UMFPACK",
   "PETSc",
   "MUMPS",
   "SuperLU",
   "Trilinos/Amesos",
-  "Trilinos/AztecOO"
+  "Trilinos/AztecOO",
+  "Krylov (built-in)",
+  "Krylov (built-in, block sparse)"
 };
 
 #define UMFPACK_NOT_COMPILED  HERMES " was not built with UMFPACK support."
@@ -31,6 +31,8 @@
 #include "solver/mumps.h"
 #include "solver/nox.h"
 #include "solver/aztecoo.h"
+#include "solver/krylov.h"
+#include "solver/bsr.h"
 
 #define HERMES_TINY 1.0e-20
 
@@ -92,6 +94,12 @@ void ludcmp(double **a, int n, int *indx, double *d)
 // the book Numerical Recipes in C, adjusted to zero-based indexing
 
 void choldc(double **a, int n, double p[])
+{
+  _F_
+  if (!try_choldc(a, n, p)) EXIT("CHOLDC failed!");
+}
+
+bool try_choldc(double **a, int n, double p[])
 {
   _F_
   int i, j, k;
@@ -101,12 +109,13 @@ void choldc(double **a, int n, double p[])
       k = i;
       while (--k >= 0) sum -= a[i][k] * a[j][k];
       if (i == j) {
-	if (sum <= 0.0) EXIT("CHOLDC failed!");
+	if (sum <= 0.0) return false;
 	else p[i] = sqrt(sum);
       }
       else a[j][i] = sum / p[i];
     }
   }
+  return true;
 }
 
 // Simple dot product.
@@ -126,15 +135,134 @@ double vec_dot(Vector *r, Vector *s, int n_dof)
   return result;
 }
 
-// SparseMatrix ////////////////////////////////////////////////////////////////////////////////////
+// SparsityPattern /////////////////////////////////////////////////////////////////////////////////
+
+SparsityPattern::SparsityPattern()
+{
+  _F_
+  size = 0;
+  built = false;
+}
 
-void qsort_int(int* pbase, size_t total_elems); // defined in qsort.cpp
+void SparsityPattern::begin(unsigned int n)
+{
+  _F_
+  size = n;
+  built = false;
+  group_start.clear();
+  group_start.push_back(0);
+  group_dofs.clear();
+  blocks.clear();
+  entries.clear();
+  Ap.clear();
+  Ai.clear();
+}
+
+int SparsityPattern::add_dofs(const int *dofs, int num_dofs)
+{
+  for (int i = 0; i < num_dofs; i++)
+    if (dofs[i] >= 0) group_dofs.push_back(dofs[i]);
+  group_start.push_back(group_dofs.size());
+  return group_start.size() - 2;
+}
+
+void SparsityPattern::add_block(int row_group, int col_group)
+{
+  blocks.push_back(row_group);
+  blocks.push_back(col_group);
+}
+
+void SparsityPattern::add_block(const int *rows, int num_rows, const int *cols, int num_cols)
+{
+  int row_group = add_dofs(rows, num_rows);
+  int col_group = (cols == rows && num_cols == num_rows) ? row_group : add_dofs(cols, num_cols);
+  add_block(row_group, col_group);
+}
+
+void SparsityPattern::add(int row, int col)
+{
+  entries.push_back(row);
+  entries.push_back(col);
+}
+
+void SparsityPattern::build()
+{
+  _F_
+  int n = size;
+  int num_blocks = blocks.size() / 2, num_entries = entries.size() / 2;
+
+  // For every column, list the row groups coupled with it and the rows of single entries
+  // (counting sort by the column).
+  std::vector<int> col_start(n + 1, 0);
+  for (int b = 0; b < num_blocks; b++) {
+    int cg = blocks[2*b + 1];
+    for (int k = group_start[cg]; k < group_start[cg + 1]; k++) col_start[group_dofs[k] + 1]++;
+  }
+  for (int e = 0; e < num_entries; e++) col_start[entries[2*e + 1] + 1]++;
+  for (int j = 0; j < n; j++) col_start[j + 1] += col_start[j];
+
+  // Row groups are stored as they are, single rows as -1 - row.
+  std::vector<int> col_items(col_start[n] > 0 ? col_start[n] : 1);
+  std::vector<int> next(col_start.begin(), col_start.end() - 1);
+  for (int b = 0; b < num_blocks; b++) {
+    int rg = blocks[2*b], cg = blocks[2*b + 1];
+    for (int k = group_start[cg]; k < group_start[cg + 1]; k++) col_items[next[group_dofs[k]]++] = rg;
+  }
+  for (int e = 0; e < num_entries; e++) col_items[next[entries[2*e + 1]]++] = -1 - entries[2*e];
+  std::vector<int>().swap(next);
+  std::vector<int>().swap(blocks);
+  std::vector<int>().swap(entries);
+
+  // Count the distinct rows of every column, then fill and sort them. Each thread uses
+  // a marker array holding the last column in which a row was seen.
+  Ap.assign(n + 1, 0);
+  for (int pass = 0; pass < 2; pass++) {
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      std::vector<int> marker(n, -1);
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 256)
+#endif
+      for (int j = 0; j < n; j++) {
+        int cnt = 0, *out = (pass == 1) ? &Ai[0] + Ap[j] : NULL;
+        for (int k = col_start[j]; k < col_start[j + 1]; k++) {
+          int item = col_items[k];
+          if (item < 0) {
+            int row = -1 - item;
+            if (marker[row] != j) { marker[row] = j; if (out) out[cnt] = row; cnt++; }
+            continue;
+          }
+          for (int l = group_start[item]; l < group_start[item + 1]; l++) {
+            int row = group_dofs[l];
+            if (marker[row] != j) { marker[row] = j; if (out) out[cnt] = row; cnt++; }
+          }
+        }
+        if (pass == 0) Ap[j + 1] = cnt;
+        else std::sort(out, out + cnt);
+      }
+    }
+
+    if (pass == 0) {
+      for (int j = 0; j < n; j++) Ap[j + 1] += Ap[j];
+      Ai.resize(Ap[n] > 0 ? Ap[n] : 1);
+    }
+  }
+
+  std::vector<int>().swap(group_start);
+  std::vector<int>().swap(group_dofs);
+  built = true;
+}
+
+// SparseMatrix ////////////////////////////////////////////////////////////////////////////////////
 
 SparseMatrix::SparseMatrix()
 {
   _F_
   size = 0;
-  pages = NULL;
+  pattern = NULL;
+  own_pattern = false;
 
   row_storage = false;
   col_storage = false;
@@ -144,7 +272,8 @@ SparseMatrix::SparseMatrix(unsigned int size)
 {
   _F_
   this->size = size;
-  pages = NULL;
+  pattern = NULL;
+  own_pattern = false;
 
   row_storage = false;
   col_storage = false;
@@ -153,7 +282,7 @@ SparseMatrix::SparseMatrix(unsigned int size)
 SparseMatrix::~SparseMatrix()
 {
   _F_
-  delete [] pages;
+  release_pattern();
 }
 
 void SparseMatrix::prealloc(unsigned int n)
@@ -161,54 +290,47 @@ void SparseMatrix::prealloc(unsigned int n)
   _F_
   this->size = n;
 
-  pages = new Page *[n];
-  MEM_CHECK(pages);
-  memset(pages, 0, n * sizeof(Page *));
+  release_pattern();
+  pattern = new SparsityPattern;
+  MEM_CHECK(pattern);
+  own_pattern = true;
+  pattern->begin(n);
 }
 
 void SparseMatrix::pre_add_ij(unsigned int row, unsigned int col)
 {
   _F_
-  if (pages[col] == NULL || pages[col]->count >= PAGE_SIZE) {
-    Page *new_page = new Page;
-    MEM_CHECK(new_page);
-    new_page->count = 0;
-    new_page->next = pages[col];
-    pages[col] = new_page;
-  }
-  pages[col]->idx[pages[col]->count++] = row;
+  pattern->add(row, col);
 }
 
-int SparseMatrix::sort_and_store_indices(Page *page, int *buffer, int *max)
+void SparseMatrix::pre_add_block(const int *rows, int num_rows, const int *cols, int num_cols)
 {
   _F_
-  // gather all pages in the buffer, deleting them along the way
-  int *end = buffer;
-  while (page != NULL) {
-    memcpy(end, page->idx, sizeof(int) * page->count);
-    end += page->count;
-    Page *tmp = page;
-    page = page->next;
-    delete tmp;
-  }
-
-  // sort the indices and remove duplicities
-  qsort_int(buffer, end - buffer);
-  int *q = buffer;
-  for (int *p = buffer, last = -1; p < end; p++) if (*p != last) *q++ = last = *p;
+  pattern->add_block(rows, num_rows, cols, num_cols);
+}
 
-  return q - buffer;
+void SparseMatrix::set_pattern(SparsityPattern *pattern)
+{
+  _F_
+  release_pattern();
+  this->pattern = pattern;
+  this->size = pattern->get_size();
 }
 
-int SparseMatrix::get_num_indices()
+SparsityPattern *SparseMatrix::get_pattern()
 {
   _F_
-  int total = 0;
-  for (unsigned int i = 0; i < size; i++)
-    for (Page *page = pages[i]; page != NULL; page = page->next)
-      total += page->count;
+  assert(pattern != NULL);
+  if (!pattern->is_built()) pattern->build();
+  return pattern;
+}
 
-  return total;
+void SparseMatrix::release_pattern()
+{
+  _F_
+  if (own_pattern) delete pattern;
+  pattern = NULL;
+  own_pattern = false;
 }
 
 SparseMatrix* create_matrix(MatrixSolverType matrix_solver)
@@ -242,6 +364,16 @@ SparseMatrix* create_matrix(MatrixSolverType matrix_solver)
       return new SuperLUMatrix;
       break;
     }
+    case SOLVER_KRYLOV: 
+    {
+      return new CSCMatrix;
+      break;
+    }
+    case SOLVER_KRYLOV_BSR: 
+    {
+      return new BSRMatrix;
+      break;
+    }
     default: 
       error("Unknown matrix solver requested.");
   }
@@ -296,6 +428,20 @@ Solver* create_linear_solver(MatrixSolverType matrix_solver, Matrix* matrix, Vec
       else return new SuperLUSolver(static_cast<SuperLUMatrix*>(matrix), static_cast<SuperLUVector*>(rhs_dummy)); 
       break;
     }
+    case SOLVER_KRYLOV: 
+    {
+      info("Using the built-in Krylov solver.");
+      if (rhs != NULL) return new KrylovSolver(static_cast<CSCMatrix*>(matrix), static_cast<UMFPackVector*>(rhs)); 
+      else return new KrylovSolver(static_cast<CSCMatrix*>(matrix), static_cast<UMFPackVector*>(rhs_dummy)); 
+      break;
+    }
+    case SOLVER_KRYLOV_BSR: 
+    {
+      info("Using the built-in Krylov solver with block sparse matrix.");
+      if (rhs != NULL) return new BSRKrylovSolver(static_cast<BSRMatrix*>(matrix), static_cast<UMFPackVector*>(rhs)); 
+      else return new BSRKrylovSolver(static_cast<BSRMatrix*>(matrix), static_cast<UMFPackVector*>(rhs_dummy)); 
+      break;
+    }
     default: 
       error("Unknown matrix solver requested.");
   }
@@ -333,6 +479,12 @@ Vector* create_vector(MatrixSolverType matrix_solver)
       return new SuperLUVector;
       break;
     }
+    case SOLVER_KRYLOV: 
+    case SOLVER_KRYLOV_BSR: 
+    {
+      return new UMFPackVector;
+      break;
+    }
     default: 
       error("Unknown matrix solver requested.");
   }
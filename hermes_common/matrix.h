@@ -200,6 +200,11 @@ double HERMES_API vec_dot(Vector *r, Vector *s, int ndof);
 /// elements which are returned in p[n].
 void HERMES_API choldc(double **a, int n, double p[]);
 
+/// Same as choldc(), but returns false instead of exiting if the matrix is not positive definite
+/// (also due to round-off errors in an ill-conditioned matrix). The upper triangle of a is not
+/// modified in this case either, the lower triangle and p[n] are undefined.
+bool HERMES_API try_choldc(double **a, int n, double p[]);
+
 /// Solves the set of n linear equations A*x = b, where a is a positive-definite symmetric matrix.
 /// a[n][n] and p[n] are input as the output of the routine choldc. Only the lower
 /// subdiagonal portion of a is accessed. b[n] is input as the right-hand side vector. The
@@ -293,6 +298,57 @@ protected:
   unsigned int size;  // matrix size
 };
 
+/// Sparsity pattern of a square matrix, built from the couplings of groups of DOFs
+/// (typically the DOFs of one element) and stored in the CSC format.
+///
+/// The couplings are only recorded by add_dofs()/add_block()/add(), which takes memory
+/// proportional to the number of DOFs of the elements rather than to the number of nonzeros
+/// of the element matrices. build() then turns them into sorted column index lists using
+/// counting and prefix sums, processing the columns in parallel if Hermes was built with
+/// OpenMP. The built pattern can be passed to any number of matrices (of any type) by
+/// SparseMatrix::set_pattern().
+class HERMES_API SparsityPattern {
+public:
+  SparsityPattern();
+
+  /// Starts a new pattern of a matrix of the size n, drops the previous one.
+  void begin(unsigned int n);
+
+  /// Records a group of DOFs, negative DOFs are skipped.
+  /// @return the id of the group for add_block()
+  int add_dofs(const int *dofs, int num_dofs);
+  /// Records the coupling of all rows of the group 'row_group' with all columns of the
+  /// group 'col_group' (the nonzeros of an element matrix).
+  void add_block(int row_group, int col_group);
+  /// Records the coupling of the DOFs 'rows' with the DOFs 'cols'.
+  void add_block(const int *rows, int num_rows, const int *cols, int num_cols);
+  /// Records a single nonzero entry.
+  void add(int row, int col);
+
+  /// Builds the CSC structure from the recorded couplings and drops them.
+  void build();
+
+  bool is_built() const { return built; }
+  unsigned int get_size() const { return size; }
+  unsigned int get_nnz() const { return built ? Ap[size] : 0; }
+  /// Index to Ai where each column starts (size + 1 entries).
+  const int *get_Ap() const { return &Ap[0]; }
+  /// Row indices of the nonzeros, sorted in each column.
+  const int *get_Ai() const { return Ai.empty() ? NULL : &Ai[0]; }
+
+protected:
+  unsigned int size;
+  bool built;
+
+  std::vector<int> group_start;   ///< Start of each group of DOFs in group_dofs.
+  std::vector<int> group_dofs;
+  std::vector<int> blocks;        ///< Pairs (row group, column group).
+  std::vector<int> entries;       ///< Pairs (row, column) of single entries.
+
+  std::vector<int> Ap;
+  std::vector<int> Ai;
+};
+
 class HERMES_API SparseMatrix : public Matrix {
 public:
   SparseMatrix();
@@ -310,6 +366,22 @@ public:
   /// @param[in] col  - column index
   virtual void pre_add_ij(unsigned int row, unsigned int col);
 
+  /// add indices of all nonzero elements of a dense block (e.g. of an element matrix),
+  /// negative indices are skipped
+  ///
+  /// @param[in] rows      - array with row indices
+  /// @param[in] num_rows  - number of rows
+  /// @param[in] cols      - array with column indices
+  /// @param[in] num_cols  - number of columns
+  virtual void pre_add_block(const int *rows, int num_rows, const int *cols, int num_cols);
+
+  /// use a sparsity pattern built elsewhere instead of prealloc() and pre_add_*(); the
+  /// next alloc() creates the structure of the matrix from it. The pattern is not copied,
+  /// it has to exist until alloc() is called.
+  ///
+  /// @param[in] pattern - the pattern
+  virtual void set_pattern(SparsityPattern *pattern);
+
   virtual void finish() { }
 
   virtual unsigned int get_size() { return size; }
@@ -369,18 +441,13 @@ public:
   unsigned col_storage:1;
 
 protected:
-  static const int PAGE_SIZE = 62;
-
-  struct Page {
-    int count;
-    int idx[PAGE_SIZE];
-    Page *next;
-  };
-
-  Page **pages;
+  SparsityPattern *pattern;   // pattern for the next alloc()
+  bool own_pattern;           // whether the pattern was created by prealloc()
 
-  int sort_and_store_indices(Page *page, int *buffer, int *max);
-  int get_num_indices();
+  /// Returns the pattern for alloc(), builds it if needed.
+  SparsityPattern *get_pattern();
+  /// Drops the pattern once alloc() has copied the structure.
+  void release_pattern();
 
   // mem stat
   int mem_size;
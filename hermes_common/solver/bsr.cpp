@@ -0,0 +1,603 @@
+// This file is part of Hermes
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "bsr.h"
+#include "../trace.h"
+#include "../error.h"
+#include "../utils.h"
+#include "../callstack.h"
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+// Below this number of stored entries, the product is not worth running in parallel.
+static const unsigned int PARALLEL_SPMV_MIN_NNZ = 20000;
+
+// Dense block helpers (blocks of the size n x n stored row by row) ////////////////////////////////
+
+// y -= A x
+static inline void block_mult_sub(const scalar *A, const scalar *x, scalar *y, int n)
+{
+  for (int r = 0; r < n; r++, A += n) {
+    scalar s = 0;
+    for (int c = 0; c < n; c++) s += A[c] * x[c];
+    y[r] -= s;
+  }
+}
+
+// y = A x
+static inline void block_mult(const scalar *A, const scalar *x, scalar *y, int n)
+{
+  for (int r = 0; r < n; r++, A += n) {
+    scalar s = 0;
+    for (int c = 0; c < n; c++) s += A[c] * x[c];
+    y[r] = s;
+  }
+}
+
+// C = A B
+static void block_mult_mat(const scalar *A, const scalar *B, scalar *C, int n)
+{
+  for (int r = 0; r < n; r++)
+    for (int c = 0; c < n; c++) {
+      scalar s = 0;
+      for (int k = 0; k < n; k++) s += A[r * n + k] * B[k * n + c];
+      C[r * n + c] = s;
+    }
+}
+
+// C -= A B
+static void block_mult_mat_sub(const scalar *A, const scalar *B, scalar *C, int n)
+{
+  for (int r = 0; r < n; r++)
+    for (int k = 0; k < n; k++) {
+      scalar a = A[r * n + k];
+      if (a == 0.0) continue;
+      for (int c = 0; c < n; c++) C[r * n + c] -= a * B[k * n + c];
+    }
+}
+
+// inv = A^{-1} by the Gauss-Jordan elimination with partial pivoting. The (zero) rows of
+// missing positions (pos_dof < 0) are set to the identity first. A zero pivot is replaced
+// by one; returns false in that case.
+static bool block_invert(const scalar *A, scalar *inv, const int *pos_dof, int n, scalar *work)
+{
+  memcpy(work, A, n * n * sizeof(scalar));
+  memset(inv, 0, n * n * sizeof(scalar));
+  for (int r = 0; r < n; r++) {
+    inv[r * n + r] = 1.0;
+    if (pos_dof[r] < 0) work[r * n + r] = 1.0;
+  }
+
+  bool ok = true;
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    for (int r = k + 1; r < n; r++)
+      if (magn(work[r * n + k]) > magn(work[p * n + k])) p = r;
+    if (p != k)
+      for (int c = 0; c < n; c++) {
+        std::swap(work[k * n + c], work[p * n + c]);
+        std::swap(inv[k * n + c], inv[p * n + c]);
+      }
+    if (work[k * n + k] == 0.0) {
+      work[k * n + k] = 1.0;
+      ok = false;
+    }
+    scalar d = 1.0 / work[k * n + k];
+    for (int c = 0; c < n; c++) {
+      work[k * n + c] *= d;
+      inv[k * n + c] *= d;
+    }
+    for (int r = 0; r < n; r++) {
+      if (r == k || work[r * n + k] == 0.0) continue;
+      scalar f = work[r * n + k];
+      for (int c = 0; c < n; c++) {
+        work[r * n + c] -= f * work[k * n + c];
+        inv[r * n + c] -= f * inv[k * n + c];
+      }
+    }
+  }
+  return ok;
+}
+
+// BSRMatrix ///////////////////////////////////////////////////////////////////////////////////////
+
+BSRMatrix::BSRMatrix()
+{
+  _F_
+  bs = 1;
+  nb = nnzb = 0;
+  Bp = Bj = Bdiag = NULL;
+  Bx = NULL;
+  dof_pos = pos_dof = NULL;
+  xb = yb = NULL;
+}
+
+BSRMatrix::~BSRMatrix()
+{
+  _F_
+  free();
+}
+
+void BSRMatrix::set_block_map(unsigned int block_size, unsigned int num_blocks,
+                              const int *block_of_dof, const int *comp_of_dof)
+{
+  _F_
+  assert(block_size > 0);
+  delete [] dof_pos;
+  delete [] pos_dof;
+  pos_dof = NULL;
+
+  bs = block_size;
+  nb = num_blocks;
+  dof_pos = new int[size];
+  MEM_CHECK(dof_pos);
+  std::vector<bool> used(nb * bs, false);
+  for (unsigned int i = 0; i < size; i++) {
+    if (block_of_dof[i] < 0 || block_of_dof[i] >= (int) nb || comp_of_dof[i] < 0 || comp_of_dof[i] >= (int) bs)
+      error("Invalid block of the DOF %d.", i);
+    int pos = block_of_dof[i] * bs + comp_of_dof[i];
+    if (used[pos])
+      error("Two DOFs at the same position of the block %d.", block_of_dof[i]);
+    used[pos] = true;
+    dof_pos[i] = pos;
+  }
+}
+
+void BSRMatrix::alloc()
+{
+  _F_
+  SparsityPattern *pat = get_pattern();
+  const int *Ap = pat->get_Ap(), *Ai = pat->get_Ai();
+
+  // Without a block map every DOF makes its own block.
+  if (dof_pos == NULL) {
+    bs = 1;
+    nb = size;
+    dof_pos = new int[size];
+    MEM_CHECK(dof_pos);
+    for (unsigned int i = 0; i < size; i++) dof_pos[i] = i;
+  }
+  pos_dof = new int[nb * bs];
+  MEM_CHECK(pos_dof);
+  for (unsigned int k = 0; k < nb * bs; k++) pos_dof[k] = -1;
+  for (unsigned int i = 0; i < size; i++) pos_dof[dof_pos[i]] = i;
+
+  // Block rows coupled with each block column (always including the diagonal one).
+  std::vector<int> marker(nb, -1), col_start(nb + 1, 0), col_rows;
+  col_rows.reserve(Ap[size] / (bs * bs) + nb);
+  for (unsigned int J = 0; J < nb; J++) {
+    marker[J] = J;
+    col_rows.push_back(J);
+    for (unsigned int c = 0; c < bs; c++) {
+      int j = pos_dof[J * bs + c];
+      if (j < 0) continue;
+      for (int k = Ap[j]; k < Ap[j + 1]; k++) {
+        int I = dof_pos[Ai[k]] / bs;
+        if (marker[I] != (int) J) {
+          marker[I] = J;
+          col_rows.push_back(I);
+        }
+      }
+    }
+    col_start[J + 1] = col_rows.size();
+  }
+  release_pattern();
+
+  // Transpose to block rows; going through the columns in order sorts the rows.
+  nnzb = col_rows.size();
+  Bp = new int[nb + 1];
+  Bj = new int[nnzb];
+  Bdiag = new int[nb];
+  MEM_CHECK(Bp);
+  MEM_CHECK(Bj);
+  MEM_CHECK(Bdiag);
+  memset(Bp, 0, (nb + 1) * sizeof(int));
+  for (unsigned int k = 0; k < nnzb; k++) Bp[col_rows[k] + 1]++;
+  for (unsigned int I = 0; I < nb; I++) Bp[I + 1] += Bp[I];
+  std::vector<int> next(Bp, Bp + nb);
+  for (unsigned int J = 0; J < nb; J++)
+    for (int k = col_start[J]; k < col_start[J + 1]; k++) {
+      int I = col_rows[k];
+      if (I == (int) J) Bdiag[I] = next[I];
+      Bj[next[I]++] = J;
+    }
+
+  Bx = new scalar[nnzb * bs * bs];
+  MEM_CHECK(Bx);
+  memset(Bx, 0, nnzb * bs * bs * sizeof(scalar));
+  xb = new scalar[nb * bs];
+  yb = new scalar[nb * bs];
+  MEM_CHECK(xb);
+  MEM_CHECK(yb);
+}
+
+void BSRMatrix::free()
+{
+  _F_
+  delete [] Bp; Bp = NULL;
+  delete [] Bj; Bj = NULL;
+  delete [] Bdiag; Bdiag = NULL;
+  delete [] Bx; Bx = NULL;
+  delete [] dof_pos; dof_pos = NULL;
+  delete [] pos_dof; pos_dof = NULL;
+  delete [] xb; xb = NULL;
+  delete [] yb; yb = NULL;
+  bs = 1;
+  nb = nnzb = 0;
+}
+
+int BSRMatrix::find_block(int I, int J)
+{
+  int *first = Bj + Bp[I], *last = Bj + Bp[I + 1];
+  int *p = std::lower_bound(first, last, J);
+  return (p != last && *p == J) ? p - Bj : -1;
+}
+
+scalar BSRMatrix::get(unsigned int m, unsigned int n)
+{
+  _F_
+  int pm = dof_pos[m], pn = dof_pos[n];
+  int p = find_block(pm / bs, pn / bs);
+  if (p < 0) return 0.0;
+  return Bx[(p * bs + pm % bs) * bs + pn % bs];
+}
+
+void BSRMatrix::zero()
+{
+  _F_
+  memset(Bx, 0, nnzb * bs * bs * sizeof(scalar));
+}
+
+void BSRMatrix::add(unsigned int m, unsigned int n, scalar v)
+{
+  _F_
+  if (v != 0.0)   // ignore zero values.
+  {
+    int pm = dof_pos[m], pn = dof_pos[n];
+    int p = find_block(pm / bs, pn / bs);
+    if (p < 0) {
+      info("BSRMatrix::add(): i = %d, j = %d.", m, n);
+      error("Sparse matrix entry not found");
+    }
+    Bx[(p * bs + pm % bs) * bs + pn % bs] += v;
+  }
+}
+
+void BSRMatrix::add_to_diagonal(scalar v)
+{
+  _F_
+  for (unsigned int i = 0; i < size; i++) add(i, i, v);
+}
+
+void BSRMatrix::add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols)
+{
+  _F_
+  // Sort the columns by their blocks, then every row is merged with its block row.
+  std::pair<int, int> buffer[64];
+  std::pair<int, int> *sorted = (n <= 64) ? buffer : new std::pair<int, int>[n];
+  unsigned int num_cols = 0;
+  for (unsigned int j = 0; j < n; j++)
+    if (cols[j] >= 0) sorted[num_cols++] = std::make_pair(dof_pos[cols[j]], (int) j);
+  std::sort(sorted, sorted + num_cols);
+
+  for (unsigned int i = 0; i < m; i++) {
+    if (rows[i] < 0) continue;
+    int pm = dof_pos[rows[i]];
+    int I = pm / bs, p = Bp[I], last = Bp[I + 1];
+    scalar *row = mat[i];
+    for (unsigned int k = 0; k < num_cols; k++) {
+      int J = sorted[k].first / bs;
+      while (p < last && Bj[p] < J) p++;
+      if (p == last || Bj[p] != J) {
+        info("BSRMatrix::add(): i = %d, j = %d.", rows[i], cols[sorted[k].second]);
+        error("Sparse matrix entry not found");
+      }
+      Bx[(p * bs + pm % bs) * bs + sorted[k].first % bs] += row[sorted[k].second];
+    }
+  }
+
+  if (sorted != buffer) delete [] sorted;
+}
+
+bool BSRMatrix::dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt)
+{
+  _F_
+  unsigned int bs2 = bs * bs;
+  switch (fmt)
+  {
+    case DF_MATLAB_SPARSE:
+    case DF_MATRIX_MARKET:
+    {
+      // Only the entries of existing DOFs are written.
+      unsigned int nnz = 0;
+      for (unsigned int I = 0; I < nb; I++)
+        for (int p = Bp[I]; p < Bp[I + 1]; p++)
+          for (unsigned int k = 0; k < bs2; k++)
+            if (pos_dof[I * bs + k / bs] >= 0 && pos_dof[Bj[p] * bs + k % bs] >= 0) nnz++;
+
+      if (fmt == DF_MATLAB_SPARSE)
+        fprintf(file, "%% Size: %dx%d\n%% Nonzeros: %d\ntemp = zeros(%d, 3);\ntemp = [\n",
+                size, size, nnz, nnz);
+      else
+        fprintf(file, "%%%%MatrixMarket matrix coordinate real general\n%d %d %d\n", size, size, nnz);
+      for (unsigned int I = 0; I < nb; I++)
+        for (int p = Bp[I]; p < Bp[I + 1]; p++)
+          for (unsigned int k = 0; k < bs2; k++) {
+            int row = pos_dof[I * bs + k / bs], col = pos_dof[Bj[p] * bs + k % bs];
+            if (row >= 0 && col >= 0)
+              fprintf(file, "%d %d " SCALAR_FMT "\n", row + 1, col + 1, SCALAR(Bx[p * bs2 + k]));
+          }
+      if (fmt == DF_MATLAB_SPARSE)
+        fprintf(file, "];\n%s = spconvert(temp);\n", var_name);
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+unsigned int BSRMatrix::get_matrix_size() const
+{
+  return size;
+}
+
+double BSRMatrix::get_fill_in() const
+{
+  _F_
+  return nnzb * bs * bs / ((double) size * size);
+}
+
+void BSRMatrix::gather(const scalar *v, scalar *vb)
+{
+  for (unsigned int k = 0; k < nb * bs; k++)
+    vb[k] = (pos_dof[k] >= 0) ? v[pos_dof[k]] : 0.0;
+}
+
+void BSRMatrix::scatter(const scalar *vb, scalar *v)
+{
+  for (unsigned int i = 0; i < size; i++) v[i] = vb[dof_pos[i]];
+}
+
+// Product of the block rows first..last-1 with a blocked vector, the block size is known
+// at compile time for the usual sizes so that the inner loops get unrolled.
+template<int BS>
+static void multiply_block_rows(int first, int last, const int *Bp, const int *Bj, const scalar *Bx,
+                                const scalar *x, scalar *y)
+{
+  for (int I = first; I < last; I++) {
+    scalar sum[BS];
+    for (int r = 0; r < BS; r++) sum[r] = 0;
+    for (int p = Bp[I]; p < Bp[I + 1]; p++) {
+      const scalar *A = Bx + p * BS * BS, *xj = x + Bj[p] * BS;
+      for (int r = 0; r < BS; r++) {
+        scalar s = 0;
+        for (int c = 0; c < BS; c++) s += A[r * BS + c] * xj[c];
+        sum[r] += s;
+      }
+    }
+    for (int r = 0; r < BS; r++) y[I * BS + r] = sum[r];
+  }
+}
+
+static void multiply_block_rows(int first, int last, const int *Bp, const int *Bj, const scalar *Bx,
+                                const scalar *x, scalar *y, int bs)
+{
+  int bs2 = bs * bs;
+  for (int I = first; I < last; I++) {
+    scalar *yi = y + I * bs;
+    for (int r = 0; r < bs; r++) yi[r] = 0;
+    for (int p = Bp[I]; p < Bp[I + 1]; p++) {
+      const scalar *A = Bx + p * bs2, *xj = x + Bj[p] * bs;
+      for (int r = 0; r < bs; r++, A += bs) {
+        scalar s = 0;
+        for (int c = 0; c < bs; c++) s += A[c] * xj[c];
+        yi[r] += s;
+      }
+    }
+  }
+}
+
+void BSRMatrix::multiply_blocks(const scalar *vb_in, scalar *vb_out)
+{
+  int n = nb;
+
+  // Every thread takes a range of block rows with about the same number of blocks.
+#ifdef _OPENMP
+  #pragma omp parallel if (nnzb * bs * bs >= PARALLEL_SPMV_MIN_NNZ)
+#endif
+  {
+    int first = 0, last = n;
+#ifdef _OPENMP
+    int num_threads = omp_get_num_threads(), thread = omp_get_thread_num();
+    first = std::lower_bound(Bp, Bp + n, (int) ((double) nnzb * thread / num_threads)) - Bp;
+    last = std::lower_bound(Bp, Bp + n, (int) ((double) nnzb * (thread + 1) / num_threads)) - Bp;
+    if (thread == num_threads - 1) last = n;
+#endif
+    switch (bs) {
+      case 1: multiply_block_rows<1>(first, last, Bp, Bj, Bx, vb_in, vb_out); break;
+      case 2: multiply_block_rows<2>(first, last, Bp, Bj, Bx, vb_in, vb_out); break;
+      case 3: multiply_block_rows<3>(first, last, Bp, Bj, Bx, vb_in, vb_out); break;
+      case 4: multiply_block_rows<4>(first, last, Bp, Bj, Bx, vb_in, vb_out); break;
+      default: multiply_block_rows(first, last, Bp, Bj, Bx, vb_in, vb_out, bs);
+    }
+  }
+}
+
+void BSRMatrix::multiply_with_vector(scalar *vector_in, scalar *vector_out)
+{
+  gather(vector_in, xb);
+  multiply_blocks(xb, yb);
+  scatter(yb, vector_out);
+}
+
+void BSRMatrix::multiply_with_scalar(scalar value)
+{
+  for (unsigned int k = 0; k < nnzb * bs * bs; k++) Bx[k] *= value;
+}
+
+// BSRKrylovSolver /////////////////////////////////////////////////////////////////////////////////
+
+BSRKrylovSolver::BSRKrylovSolver(BSRMatrix *m, UMFPackVector *rhs)
+  : KrylovSolver(NULL, rhs), bm(m)
+{
+  _F_
+  bs = nb = 0;
+  Bp = Bj = Bdiag = NULL;
+  Bx = NULL;
+  rb = zb = NULL;
+}
+
+BSRKrylovSolver::~BSRKrylovSolver()
+{
+  _F_
+  free_matrix();
+}
+
+size_t BSRKrylovSolver::get_memory_usage() const
+{
+  _F_
+  size_t bs2 = bs * bs, mem = 2 * nb * bs * sizeof(scalar);
+  if (pc_diag != NULL) mem += nb * bs2 * sizeof(scalar);
+  if (pc_lu != NULL) mem += Bp[nb] * bs2 * sizeof(scalar);
+  return mem;
+}
+
+void BSRKrylovSolver::free_matrix()
+{
+  _F_
+  delete [] rb; rb = NULL;
+  delete [] zb; zb = NULL;
+  Bp = Bj = Bdiag = NULL;
+  Bx = NULL;
+  bs = nb = 0;
+  n = 0;
+}
+
+void BSRKrylovSolver::setup_matrix()
+{
+  _F_
+  assert(bm != NULL);
+  int *bp = bm->get_Bp(), *bj = bm->get_Bj();
+  bool rebuild = (rb == NULL || bm->get_size() != n || bm->get_block_size() != bs || bm->get_num_blocks() != nb
+                  || bp != Bp || bj != Bj || factorization_scheme == HERMES_FACTORIZE_FROM_SCRATCH);
+  if (rebuild) {
+    free_matrix();
+    pc_valid = false;
+    n = bm->get_size();
+    bs = bm->get_block_size();
+    nb = bm->get_num_blocks();
+    rb = new scalar[nb * bs];
+    zb = new scalar[nb * bs];
+    MEM_CHECK(rb);
+    MEM_CHECK(zb);
+  }
+  Bp = bp;
+  Bj = bj;
+  Bdiag = bm->get_Bdiag();
+  Bx = bm->get_Bx();
+}
+
+void BSRKrylovSolver::setup_precond()
+{
+  _F_
+  if (pc_valid && factorization_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY && pc_type != KRYLOV_PC_NONE)
+    return;
+
+  free_precond();
+  pc_type = precond;
+  if (pc_type == KRYLOV_PC_BLOCK_JACOBI) pc_type = KRYLOV_PC_JACOBI;
+  if (pc_type == KRYLOV_PC_NONE) {
+    pc_valid = true;
+    return;
+  }
+
+  unsigned int bs2 = bs * bs;
+  const int *pos_dof = bm->get_pos_dof();
+  scalar *work = new scalar[bs2];
+  pc_diag = new scalar[nb * bs2];
+  MEM_CHECK(pc_diag);
+  bool ok = true;
+
+  if (pc_type == KRYLOV_PC_JACOBI) {
+    for (unsigned int I = 0; I < nb; I++)
+      ok &= block_invert(Bx + Bdiag[I] * bs2, pc_diag + I * bs2, pos_dof + I * bs, bs, work);
+  }
+  else {
+    // Block version of the IKJ incomplete factorization: the strictly lower blocks hold
+    // L_IK = A_IK U_KK^{-1}, the diagonal ones U_II, and pc_diag the inverses U_II^{-1}.
+    unsigned int nnzb = Bp[nb];
+    pc_lu = new scalar[nnzb * bs2];
+    MEM_CHECK(pc_lu);
+    memcpy(pc_lu, Bx, nnzb * bs2 * sizeof(scalar));
+    int *marker = new int[nb];
+    for (unsigned int I = 0; I < nb; I++) marker[I] = -1;
+    for (unsigned int I = 0; I < nb; I++) {
+      for (int p = Bp[I]; p < Bp[I + 1]; p++) marker[Bj[p]] = p;
+      for (int p = Bp[I]; p < Bdiag[I]; p++) {
+        int K = Bj[p];
+        memcpy(work, pc_lu + p * bs2, bs2 * sizeof(scalar));
+        block_mult_mat(work, pc_diag + K * bs2, pc_lu + p * bs2, bs);
+        for (int q = Bdiag[K] + 1; q < Bp[K + 1]; q++)
+          if (marker[Bj[q]] >= 0) block_mult_mat_sub(pc_lu + p * bs2, pc_lu + q * bs2, pc_lu + marker[Bj[q]] * bs2, bs);
+      }
+      for (int p = Bp[I]; p < Bp[I + 1]; p++) marker[Bj[p]] = -1;
+      ok &= block_invert(pc_lu + Bdiag[I] * bs2, pc_diag + I * bs2, pos_dof + I * bs, bs, work);
+    }
+    delete [] marker;
+  }
+  delete [] work;
+
+  if (!ok) warning("Singular diagonal block in the block preconditioner, its zero pivots were replaced by one.");
+  pc_valid = true;
+}
+
+void BSRKrylovSolver::multiply(const scalar *x, scalar *y)
+{
+  bm->multiply_with_vector(const_cast<scalar *>(x), y);
+}
+
+void BSRKrylovSolver::apply_precond(const scalar *r, scalar *z)
+{
+  if (pc_type == KRYLOV_PC_NONE) {
+    memcpy(z, r, n * sizeof(scalar));
+    return;
+  }
+
+  unsigned int bs2 = bs * bs;
+  bm->gather(r, rb);
+  if (pc_type == KRYLOV_PC_JACOBI) {
+    for (unsigned int I = 0; I < nb; I++)
+      block_mult(pc_diag + I * bs2, rb + I * bs, zb + I * bs, bs);
+  }
+  else {
+    // Forward substitution with the unit lower triangle, then backward with the upper one.
+    for (unsigned int I = 0; I < nb; I++) {
+      for (int p = Bp[I]; p < Bdiag[I]; p++)
+        block_mult_sub(pc_lu + p * bs2, rb + Bj[p] * bs, rb + I * bs, bs);
+    }
+    for (int I = nb - 1; I >= 0; I--) {
+      for (int p = Bdiag[I] + 1; p < Bp[I + 1]; p++)
+        block_mult_sub(pc_lu + p * bs2, zb + Bj[p] * bs, rb + I * bs, bs);
+      block_mult(pc_diag + I * bs2, rb + I * bs, zb + I * bs, bs);
+    }
+  }
+  bm->scatter(zb, z);
+}
@@ -0,0 +1,142 @@
+// This file is part of Hermes
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef __HERMES_COMMON_BSR_H_
+#define __HERMES_COMMON_BSR_H_
+
+#include "krylov.h"
+
+/// Block sparse row (BSR) matrix: the matrix is stored as a sparse matrix of dense
+/// blocks of the size block_size x block_size, each block stored row by row.
+///
+/// It suits systems where the DOFs come in small groups that are coupled with the same
+/// DOFs, e.g. the DOFs of several equations belonging to one node of a shared mesh. One
+/// column index is then stored per block instead of per entry, and the matrix-vector
+/// product reads the values contiguously.
+///
+/// The DOFs are mapped to the blocks by set_block_map(); a block does not have to contain
+/// a DOF at every position, missing positions are kept at zero. Without a block map the
+/// block size is one, i.e. the matrix is a plain CSR matrix.
+///
+/// @ingroup solvers
+class HERMES_API BSRMatrix : public SparseMatrix {
+public:
+  BSRMatrix();
+  virtual ~BSRMatrix();
+
+  /// Sets the grouping of the DOFs into blocks used by the next alloc(), to be called after
+  /// prealloc() or set_pattern(). The DOF i is stored at the position comp_of_dof[i] of the
+  /// block block_of_dof[i]; no two DOFs may share a position. free() drops the map.
+  ///
+  /// @param[in] block_size   - size of the blocks
+  /// @param[in] num_blocks   - number of blocks
+  /// @param[in] block_of_dof - block of every DOF
+  /// @param[in] comp_of_dof  - position of every DOF in its block
+  void set_block_map(unsigned int block_size, unsigned int num_blocks,
+                     const int *block_of_dof, const int *comp_of_dof);
+
+  virtual void alloc();
+  virtual void free();
+  virtual scalar get(unsigned int m, unsigned int n);
+  virtual void zero();
+  virtual void add(unsigned int m, unsigned int n, scalar v);
+  virtual void add_to_diagonal(scalar v);
+  /// Adds a local matrix; the position of each block is searched only once per row.
+  virtual void add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols);
+  virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE);
+  virtual unsigned int get_matrix_size() const;
+  /// Returns the number of stored entries (including the zeros inside of the blocks).
+  unsigned int get_nnz() { return nnzb * bs * bs; }
+  virtual double get_fill_in() const;
+
+  /// Applies the matrix to vector_in (both in the numbering of the DOFs), in parallel
+  /// over the block rows if Hermes was built with OpenMP.
+  void multiply_with_vector(scalar *vector_in, scalar *vector_out);
+  void multiply_with_scalar(scalar value);
+
+  unsigned int get_block_size() { return bs; }
+  unsigned int get_num_blocks() { return nb; }
+  unsigned int get_num_nonzero_blocks() { return nnzb; }
+  /// Index to Bj/Bx where each block row starts.
+  int *get_Bp() { return Bp; }
+  /// Block column indices, sorted in each block row.
+  int *get_Bj() { return Bj; }
+  /// Values of the blocks (block_size^2 values per block, row by row).
+  scalar *get_Bx() { return Bx; }
+  /// Positions of the diagonal blocks in Bj (every diagonal block is stored).
+  int *get_Bdiag() { return Bdiag; }
+  /// DOF stored at each position of the blocks, -1 for a missing one.
+  int *get_pos_dof() { return pos_dof; }
+
+  /// Copies a vector in the numbering of the DOFs into a blocked one (num_blocks *
+  /// block_size entries, zeros at the missing positions) and back.
+  void gather(const scalar *v, scalar *vb);
+  void scatter(const scalar *vb, scalar *v);
+  /// Applies the matrix to a blocked vector.
+  void multiply_blocks(const scalar *vb_in, scalar *vb_out);
+
+protected:
+  unsigned int bs;       // Block size.
+  unsigned int nb;       // Number of block rows (= block columns).
+  unsigned int nnzb;     // Number of stored blocks (= Bp[nb]).
+  int *Bp;               // Index to Bj/Bx where each block row starts.
+  int *Bj;               // Block column indices.
+  scalar *Bx;            // Block values.
+  int *Bdiag;            // Positions of the diagonal blocks.
+
+  int *dof_pos;          // Position of every DOF in a blocked vector (block * bs + comp).
+  int *pos_dof;          // Inverse of dof_pos, -1 for missing positions.
+
+  scalar *xb, *yb;       // Blocked vectors for multiply_with_vector().
+
+  /// Returns the position of the block (I, J) in Bj, or -1.
+  int find_block(int I, int J);
+};
+
+/// Built-in Krylov solver (see KrylovSolver) for BSRMatrix. The preconditioners work
+/// with the blocks of the matrix:
+///   - jacobi, block-jacobi ... the inverse of the diagonal blocks,
+///   - ilu0 ... block ILU(0), i.e. incomplete LU without fill-in of blocks.
+/// set_block_size() is ignored, the blocks of the matrix are used.
+///
+/// @ingroup solvers
+class HERMES_API BSRKrylovSolver : public KrylovSolver {
+public:
+  BSRKrylovSolver(BSRMatrix *m, UMFPackVector *rhs);
+  virtual ~BSRKrylovSolver();
+
+  virtual size_t get_memory_usage() const;
+
+protected:
+  BSRMatrix *bm;
+
+  unsigned int bs, nb;
+  int *Bp, *Bj, *Bdiag;
+  scalar *Bx;
+  scalar *rb, *zb;              ///< Blocked vectors for apply_precond().
+
+  virtual void setup_matrix();
+  virtual void setup_precond();
+  virtual void free_matrix();
+
+  virtual void multiply(const scalar *x, scalar *y);
+  virtual void apply_precond(const scalar *r, scalar *z);
+};
+
+#endif
@@ -42,7 +42,15 @@ public:
              bool force_diagonal_blocks = false, bool add_dir_lift = true, Table* block_weights = NULL) = 0; 
                 
   virtual void invalidate_matrix() = 0;
-  
+
+  /// Matrix-free application of the operator (for linear problems).
+  /// coeff_out = A coeff_in, where A is the matrix that assemble() would create.
+  virtual void apply(scalar* coeff_in, scalar* coeff_out) = 0;
+
+  /// Diagonal of the matrix that assemble() would create, without creating it
+  /// (e.g. for the Jacobi preconditioner of a matrix-free solver).
+  virtual void get_diagonal(scalar* diag) = 0;
+
 };
 
 #endif // DPINTERFACE_H
@@ -1,5 +1,6 @@
 #include "eigensolver.h"
 #include "umfpack_solver.h"
+#include "krylov.h"
 
 namespace Hermes {
 
@@ -10,56 +11,357 @@ using Teuchos::ptr;
 using Teuchos::null;
 using Teuchos::rcp_dynamic_cast;
 
-PyMODINIT_FUNC initeigen(void); /*proto*/
+// Vector operations are run in parallel for vectors at least this long.
+static const int PARALLEL_MIN_SIZE = 20000;
+
+static double dot(int n, const double *x, const double *y)
+{
+    double s = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:s) if(n >= PARALLEL_MIN_SIZE)
+#endif
+    for (int i = 0; i < n; i++)
+        s += x[i] * y[i];
+    return s;
+}
+
+// y += a * x
+static void axpy(int n, double a, const double *x, double *y)
+{
+#ifdef _OPENMP
+#pragma omp parallel for if(n >= PARALLEL_MIN_SIZE)
+#endif
+    for (int i = 0; i < n; i++)
+        y[i] += a * x[i];
+}
+
+// x *= a
+static void scale(int n, double a, double *x)
+{
+    for (int i = 0; i < n; i++)
+        x[i] *= a;
+}
+
+// Y = X * C, where X has k columns of the length n and C is k x l (row-major,
+// leading dimension ldc).
+static void combine(int n, int k, int l, const double *X, const double *C,
+        int ldc, double *Y)
+{
+#ifdef _OPENMP
+#pragma omp parallel for if(n >= PARALLEL_MIN_SIZE)
+#endif
+    for (int i = 0; i < n; i++) {
+        for (int c = 0; c < l; c++) {
+            double s = 0.0;
+            for (int r = 0; r < k; r++)
+                s += X[(size_t) r * n + i] * C[r * ldc + c];
+            Y[(size_t) c * n + i] = s;
+        }
+    }
+}
+
+// Eigenvalues w and eigenvectors Y (stored by columns, Y[i * m + k] is the i-th
+// component of the k-th vector) of the symmetric m x m matrix T (row-major), by
+// the cyclic Jacobi method. T is destroyed.
+static void symmetric_eigen(int m, std::vector<double> &T, std::vector<double> &w,
+        std::vector<double> &Y)
+{
+    Y.assign(m * m, 0.0);
+    for (int i = 0; i < m; i++) Y[i * m + i] = 1.0;
+
+    for (int sweep = 0; sweep < 100; sweep++) {
+        double off = 0.0, diag = 0.0;
+        for (int p = 0; p < m; p++) {
+            diag += T[p * m + p] * T[p * m + p];
+            for (int q = p + 1; q < m; q++) off += T[p * m + q] * T[p * m + q];
+        }
+        if (off <= 1e-32 * diag) break;
+
+        for (int p = 0; p < m; p++) {
+            for (int q = p + 1; q < m; q++) {
+                double apq = T[p * m + q];
+                if (apq == 0.0) continue;
+                double theta = (T[q * m + q] - T[p * m + p]) / (2.0 * apq);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0), s = t * c;
+                for (int k = 0; k < m; k++) {
+                    double tkp = T[k * m + p], tkq = T[k * m + q];
+                    T[k * m + p] = c * tkp - s * tkq;
+                    T[k * m + q] = s * tkp + c * tkq;
+                }
+                for (int k = 0; k < m; k++) {
+                    double tpk = T[p * m + k], tqk = T[q * m + k];
+                    T[p * m + k] = c * tpk - s * tqk;
+                    T[q * m + k] = s * tpk + c * tqk;
+                }
+                for (int k = 0; k < m; k++) {
+                    double ykp = Y[k * m + p], ykq = Y[k * m + q];
+                    Y[k * m + p] = c * ykp - s * ykq;
+                    Y[k * m + q] = s * ykp + c * ykq;
+                }
+            }
+        }
+    }
+
+    w.resize(m);
+    for (int i = 0; i < m; i++) w[i] = T[i * m + i];
+}
+
+// Sorts the Ritz values by the distance of the eigenvalues from the target (i.e. by
+// the magnitude of the Ritz values of the shift-invert operator, descending).
+struct RitzOrder {
+    const std::vector<double> &theta;
+    RitzOrder(const std::vector<double> &theta) : theta(theta) { }
+    bool operator()(int a, int b) const { return fabs(theta[a]) > fabs(theta[b]); }
+};
 
 EigenSolver::EigenSolver(const RCP<Matrix> &A, const RCP<Matrix> &B) {
     this->A = A;
     this->B = B;
-    this->n_eigs=0;
+    this->n_eigs = 0;
+    this->num_iters = 0;
+    this->shifted = NULL;
+    this->shifted_rhs = NULL;
+    this->shifted_solver = NULL;
+}
 
-    initeigen();
+EigenSolver::~EigenSolver() {
+    free_shifted_solver();
 }
 
-void wrap_CSC(const Ptr<Python> p, const std::string name,
-        const RCP<CSCMatrix> A)
+void EigenSolver::free_shifted_solver()
 {
-    p->push_numpy_int_inplace("_IA", A->get_Ai(), A->get_nnz());
-    p->push_numpy_int_inplace("_JA", A->get_Ap(), A->get_size()+1);
-#ifdef HERMES_COMMON_COMPLEX
-    throw std::runtime_error("Eigenproblem with complex numbers is not supported.");
+    delete this->shifted_solver;
+    delete this->shifted;
+    delete this->shifted_rhs;
+    this->shifted_solver = NULL;
+    this->shifted = NULL;
+    this->shifted_rhs = NULL;
+}
+
+void EigenSolver::setup_shifted_solver(CSCMatrix *A, CSCMatrix *B, double sigma)
+{
+    free_shifted_solver();
+
+    // A - sigma B on the union of the sparsity patterns (the row indices of both
+    // matrices are sorted in each column, so are the merged ones).
+    int n = A->get_size();
+    int *Ap = A->get_Ap(), *Ai = A->get_Ai(), *Bp = B->get_Ap(), *Bi = B->get_Ai();
+    scalar *Ax = A->get_Ax(), *Bx = B->get_Ax();
+    std::vector<int> Kp(n + 1), Ki;
+    std::vector<scalar> Kx;
+    Ki.reserve(A->get_nnz());
+    Kx.reserve(A->get_nnz());
+    for (int j = 0; j < n; j++) {
+        Kp[j] = Ki.size();
+        int pa = Ap[j], pb = Bp[j];
+        while (pa < Ap[j + 1] || pb < Bp[j + 1]) {
+            int ia = (pa < Ap[j + 1]) ? Ai[pa] : n, ib = (pb < Bp[j + 1]) ? Bi[pb] : n;
+            int i = std::min(ia, ib);
+            scalar v = 0.0;
+            if (ia == i) v += Ax[pa++];
+            if (ib == i) v -= sigma * Bx[pb++];
+            Ki.push_back(i);
+            Kx.push_back(v);
+        }
+    }
+    Kp[n] = Ki.size();
+
+    this->shifted_rhs = new UMFPackVector(n);
+#ifdef WITH_UMFPACK
+    UMFPackMatrix *K = new UMFPackMatrix;
+    K->create(n, Kp[n], &Kp[0], &Ki[0], &Kx[0]);
+    this->shifted = K;
+    this->shifted_solver = new UMFPackLinearSolver(K, this->shifted_rhs);
 #else
-    p->push_numpy_double_inplace("_A", A->get_Ax(), A->get_nnz());
+    warning("EigenSolver: UMFPACK is not available, the shifted systems are solved by KrylovSolver.");
+    this->shifted = new CSCMatrix;
+    this->shifted->create(n, Kp[n], &Kp[0], &Ki[0], &Kx[0]);
+    KrylovSolver *solver = new KrylovSolver(this->shifted, this->shifted_rhs);
+    solver->set_tolerance(1e-12);
+    this->shifted_solver = solver;
 #endif
-    p->push_int("n", A->get_size());
-    p->exec("from scipy.sparse import csc_matrix\n");
-    p->exec(name + " = csc_matrix((_A, _IA, _JA), shape=(n, n))");
+    // Factorize (or compute the preconditioner) once, reuse it for all solves.
+    this->shifted_solver->set_factorization_scheme(HERMES_REUSE_FACTORIZATION_COMPLETELY);
+}
+
+void EigenSolver::apply_shift_invert(const double *x, double *y)
+{
+    int n = this->shifted->get_size();
+    memcpy(this->shifted_rhs->get_c_array(), x, n * sizeof(double));
+    if (!this->shifted_solver->solve())
+        throw std::runtime_error("EigenSolver: the shifted system could not be solved.");
+    memcpy(y, this->shifted_solver->get_solution(), n * sizeof(double));
 }
 
 void EigenSolver::solve(int n_eigs, double target_value, double tol,
         int max_iter) {
+#ifdef HERMES_COMMON_COMPLEX
+    throw std::runtime_error("Eigenproblem with complex numbers is not supported.");
+#else
     // Support CSCMatrix only for now:
     RCP<CSCMatrix> A = rcp_dynamic_cast<CSCMatrix>(this->A, true);
     RCP<CSCMatrix> B = rcp_dynamic_cast<CSCMatrix>(this->B, true);
-    wrap_CSC(ptr(&p), "A", A);
-    wrap_CSC(ptr(&p), "B", B);
-    this->p.exec("from eigen import solve_eig_pysparse");
-    this->p.push_double("target_value", target_value);
-    this->p.push_int("n_eigs", n_eigs);
-    this->p.push_double("jdtol", tol);
-    this->p.push_int("max_iter", max_iter);
+    int n = A->get_size();
+    if ((int) B->get_size() != n)
+        throw std::runtime_error("EigenSolver: A and B must have the same size.");
+
+    this->n_eigs = 0;
+    this->num_iters = 0;
+    this->eigenvalues.clear();
+    this->eigenvectors.clear();
+    int nev = std::min(n_eigs, n);
+    if (nev <= 0) return;
 
     printf("Solving the system A * x = lambda * B * x\n");
-    this->p.exec("eigs = solve_eig_pysparse(A, B, target_value=target_value, n_eigs=n_eigs, jdtol=jdtol, max_iter=max_iter)");
-    this->p.exec("n_eigs = len(eigs)");
-    this->n_eigs = this->p.pull_int("n_eigs");
+    double sigma = target_value;
+    setup_shifted_solver(A.get(), B.get(), sigma);
+
+    // Size of the Lanczos basis and the number of vectors kept at restarts.
+    int m = std::min(n, std::max(2 * nev + 1, nev + 20));
+    int keep = std::min(m - 1, nev + (m - nev) / 2);
+
+    // B-orthonormal Lanczos vectors V (m + 1 columns) and B V.
+    std::vector<double> V((size_t) (m + 1) * n), BV((size_t) (m + 1) * n);
+    int ldt = m;
+    std::vector<double> T(ldt * ldt, 0.0), theta, Y, coef(m + 1);
+    std::vector<double> w(n);
+    std::vector<int> order(m);
+    double beta = 0.0;
+
+    // Starting vector.
+    for (int i = 0; i < n; i++) V[i] = 1.0 + 0.5 * sin((double) i);
+    B->multiply_with_vector(&V[0], &BV[0]);
+    double nrm = sqrt(dot(n, &V[0], &BV[0]));
+    scale(n, 1.0 / nrm, &V[0]);
+    scale(n, 1.0 / nrm, &BV[0]);
+
+    // Size of the current basis, smaller than m only if the whole space is exhausted.
+    int mm = m;
+    int k = 0, nconv = 0;
+    for (int restart = 0; restart < max_iter; restart++) {
+        // Extend the basis to m vectors.
+        bool exhausted = false;
+        for (int j = k; j < m; j++) {
+            apply_shift_invert(&BV[(size_t) j * n], &w[0]);
+            this->num_iters++;
+
+            // Full reorthogonalization (classical Gram-Schmidt, twice).
+            for (int i = 0; i <= j; i++) coef[i] = 0.0;
+            for (int pass = 0; pass < 2; pass++) {
+                for (int i = 0; i <= j; i++) {
+                    double c = dot(n, &BV[(size_t) i * n], &w[0]);
+                    coef[i] += c;
+                    axpy(n, -c, &V[(size_t) i * n], &w[0]);
+                }
+            }
+            for (int i = 0; i < j; i++) T[i * ldt + j] = T[j * ldt + i] = coef[i];
+            T[j * ldt + j] = coef[j];
+
+            double *v_next = &V[(size_t) (j + 1) * n], *bv_next = &BV[(size_t) (j + 1) * n];
+            memcpy(v_next, &w[0], n * sizeof(double));
+            B->multiply_with_vector(v_next, bv_next);
+            beta = sqrt(std::max(dot(n, v_next, bv_next), 0.0));
+
+            if (beta <= 1e-12 * fabs(coef[j])) {
+                // Invariant subspace found; continue with a new vector if there is room.
+                beta = 0.0;
+                if (j + 1 == m) break;
+                for (int i = 0; i < n; i++) v_next[i] = sin(3.7 * (i + 1) * (j + 2));
+                B->multiply_with_vector(v_next, bv_next);
+                double nrm_new = sqrt(std::max(dot(n, v_next, bv_next), 0.0));
+                for (int pass = 0; pass < 2; pass++) {
+                    B->multiply_with_vector(v_next, bv_next);
+                    for (int i = 0; i <= j; i++)
+                        axpy(n, -dot(n, &BV[(size_t) i * n], v_next), &V[(size_t) i * n], v_next);
+                }
+                B->multiply_with_vector(v_next, bv_next);
+                nrm = sqrt(std::max(dot(n, v_next, bv_next), 0.0));
+                if (nrm <= 1e-10 * nrm_new) {
+                    // The new vector lies in the span of the basis, the Ritz pairs are exact.
+                    mm = j + 1;
+                    exhausted = true;
+                    break;
+                }
+                scale(n, 1.0 / nrm, v_next);
+                scale(n, 1.0 / nrm, bv_next);
+            }
+            else {
+                scale(n, 1.0 / beta, v_next);
+                scale(n, 1.0 / beta, bv_next);
+            }
+            if (j + 1 < m) T[(j + 1) * ldt + j] = T[j * ldt + j + 1] = beta;
+        }
+
+        // Ritz values and vectors (the Ritz values of the shift-invert operator are
+        // 1 / (lambda - sigma)).
+        std::vector<double> Tm(mm * mm);
+        for (int r = 0; r < mm; r++)
+            for (int c = 0; c < mm; c++) Tm[r * mm + c] = T[r * ldt + c];
+        symmetric_eigen(mm, Tm, theta, Y);
+        order.resize(mm);
+        for (int i = 0; i < mm; i++) order[i] = i;
+        std::sort(order.begin(), order.end(), RitzOrder(theta));
+
+        // Residual of the Ritz pair i is |beta * Y[mm-1][i]|.
+        nconv = 0;
+        for (int i = 0; i < std::min(nev, mm); i++) {
+            int r = order[i];
+            if (fabs(beta * Y[(mm - 1) * mm + r]) <= tol * fabs(theta[r])) nconv++;
+            else break;
+        }
+        // An exhausted space cannot be extended by restarting.
+        if (nconv >= nev || exhausted || restart == max_iter - 1) break;
+
+        // Thick restart: keep the best 'keep' Ritz vectors and the last Lanczos vector.
+        std::vector<double> C(m * keep);
+        for (int r = 0; r < m; r++)
+            for (int c = 0; c < keep; c++) C[r * keep + c] = Y[r * m + order[c]];
+        std::vector<double> tmp((size_t) keep * n);
+        combine(n, m, keep, &V[0], &C[0], keep, &tmp[0]);
+        memcpy(&V[0], &tmp[0], (size_t) keep * n * sizeof(double));
+        combine(n, m, keep, &BV[0], &C[0], keep, &tmp[0]);
+        memcpy(&BV[0], &tmp[0], (size_t) keep * n * sizeof(double));
+        memcpy(&V[(size_t) keep * n], &V[(size_t) m * n], n * sizeof(double));
+        memcpy(&BV[(size_t) keep * n], &BV[(size_t) m * n], n * sizeof(double));
+
+        T.assign(T.size(), 0.0);
+        for (int c = 0; c < keep; c++) {
+            T[c * ldt + c] = theta[order[c]];
+            T[c * ldt + keep] = T[keep * ldt + c] = beta * Y[(m - 1) * m + order[c]];
+        }
+        k = keep;
+    }
+
+    if (nconv < nev)
+        warning("EigenSolver: only %d of %d eigenvalues converged.", nconv, nev);
+
+    // Converged eigenpairs sorted by the eigenvalues.
+    std::vector<std::pair<double, int> > eigs;
+    for (int i = 0; i < nconv; i++)
+        if (theta[order[i]] != 0.0)
+            eigs.push_back(std::pair<double, int>(sigma + 1.0 / theta[order[i]], order[i]));
+    std::sort(eigs.begin(), eigs.end());
+
+    this->n_eigs = eigs.size();
+    this->eigenvalues.resize(this->n_eigs);
+    this->eigenvectors.resize((size_t) this->n_eigs * n);
+    std::vector<double> C(mm * this->n_eigs);
+    for (int c = 0; c < this->n_eigs; c++) {
+        this->eigenvalues[c] = eigs[c].first;
+        for (int r = 0; r < mm; r++) C[r * this->n_eigs + c] = Y[r * mm + eigs[c].second];
+    }
+    if (this->n_eigs > 0)
+        combine(n, mm, this->n_eigs, &V[0], &C[0], this->n_eigs, &this->eigenvectors[0]);
+
+    free_shifted_solver();
+#endif
 }
 
 double EigenSolver::get_eigenvalue(int i)
 {
     if (i >= 0 && i < this->n_eigs) {
-        this->p.push_int("i", i);
-        this->p.exec("E = eigs[i][0]");
-        return this->p.pull_double("E");
+        return this->eigenvalues[i];
     } else
         throw std::runtime_error("'i' must obey 0 <= i < n_eigs");
 }
@@ -67,11 +369,10 @@ double EigenSolver::get_eigenvalue(int i)
 void EigenSolver::get_eigenvector(int i, double **vec, int *n)
 {
     if (i >= 0 && i < this->n_eigs) {
-        this->p.push_int("i", i);
-        this->p.exec("vec = eigs[i][1]");
-        this->p.pull_numpy_double_inplace("vec", vec, n);
+        *n = this->eigenvectors.size() / this->n_eigs;
+        *vec = &this->eigenvectors[(size_t) i * *n];
     } else
         throw std::runtime_error("'i' must obey 0 <= i < n_eigs");
 }
 
-} // namespace Schroedinger
+} // namespace Hermes
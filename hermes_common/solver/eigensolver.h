@@ -3,8 +3,6 @@
 
 #include "../matrix.h"
 
-#include "../python/python_api.h"
-
 #include "../config.h"
 // RCP
 #ifndef WITH_TRILINOS
@@ -13,6 +11,10 @@
 #include "Teuchos_RCP.hpp"
 #endif
 
+class CSCMatrix;
+class UMFPackVector;
+class Solver;
+
 namespace Hermes {
 
 using Teuchos::RCP;
@@ -20,14 +22,22 @@ using Teuchos::Ptr;
 using Teuchos::rcp;
 using Teuchos::null;
 
+// Solves the generalized eigenproblem A x = lambda B x with symmetric A and symmetric
+// positive definite B (both CSCMatrix) for the eigenvalues closest to a target value.
+//
+// The solver uses the thick-restart Lanczos method applied to the shift-invert operator
+// (A - target B)^{-1} B in the B-inner product. The shifted matrix is factorized once by
+// UMFPackLinearSolver and the factorization is reused for all iterations (without UMFPACK,
+// the built-in KrylovSolver is used instead). The eigenvectors are B-orthonormal.
 class HERMES_API EigenSolver {
 public:
     EigenSolver(const RCP<Matrix> &A, const RCP<Matrix> &B);
-
+    ~EigenSolver();
 
     // Solves for 'n_eigs' eigenvectors, around the 'target_value'. Use
     // 'get_eigenvalue' and 'get_eigenvector' to retrieve the
-    // eigenvalues/eigenvectors:
+    // eigenvalues/eigenvectors (sorted by the eigenvalues). 'tol' is the relative
+    // tolerance of the residuals, 'max_iter' the maximal number of restarts:
     void solve(int n_eigs=4, double target_value=-1, double tol=1e-6,
                int max_iter=150);
 
@@ -43,6 +53,11 @@ public:
     // deleted. You need to make a copy of it if you want to store it
     // permanently.
     void get_eigenvector(int i, double **vec, int *n);
+    // Returns the number of applications of the shift-invert operator
+    // in the last solve().
+    int get_num_iters() {
+        return this->num_iters;
+    }
 
     void print_eigenvalues() {
         printf("Eigenvalues:\n");
@@ -53,7 +68,19 @@ public:
 private:
     RCP<Matrix> A, B;
     int n_eigs;
-    Python p;
+    int num_iters;
+    std::vector<double> eigenvalues;
+    std::vector<double> eigenvectors;   // n_eigs vectors of the size of the matrix.
+
+    // Shifted matrix A - target B and its solver.
+    CSCMatrix *shifted;
+    UMFPackVector *shifted_rhs;
+    Solver *shifted_solver;
+
+    void setup_shifted_solver(CSCMatrix *A, CSCMatrix *B, double sigma);
+    void free_shifted_solver();
+    // y = (A - sigma B)^{-1} x
+    void apply_shift_invert(const double *x, double *y);
 };
 
 }
@@ -90,6 +90,45 @@ void EpetraMatrix::pre_add_ij(unsigned int row, unsigned int col)
 #endif
 }
 
+void EpetraMatrix::pre_add_block(const int *rows, int num_rows, const int *cols, int num_cols)
+{
+  _F_
+#ifdef HAVE_EPETRA
+  std::vector<int> valid_cols;
+  for (int j = 0; j < num_cols; j++)
+    if (cols[j] >= 0) valid_cols.push_back(cols[j]);
+  if (valid_cols.empty()) return;
+  for (int i = 0; i < num_rows; i++)
+    if (rows[i] >= 0) grph->InsertGlobalIndices(rows[i], valid_cols.size(), &valid_cols[0]);
+#endif
+}
+
+void EpetraMatrix::set_pattern(SparsityPattern *pattern)
+{
+  _F_
+#ifdef HAVE_EPETRA
+  assert(pattern != NULL && pattern->is_built());
+  unsigned int n = pattern->get_size();
+  prealloc(n);
+
+  // the graph is stored by rows, transpose the (column-wise) pattern
+  const int *Ap = pattern->get_Ap();
+  const int *Ai = pattern->get_Ai();
+  std::vector<int> row_start(n + 1, 0);
+  for (int k = 0; k < Ap[n]; k++) row_start[Ai[k] + 1]++;
+  for (unsigned int i = 0; i < n; i++) row_start[i + 1] += row_start[i];
+  std::vector<int> row_cols(Ap[n]);
+  std::vector<int> pos(row_start.begin(), row_start.end() - 1);
+  for (unsigned int j = 0; j < n; j++)
+    for (int k = Ap[j]; k < Ap[j + 1]; k++)
+      row_cols[pos[Ai[k]]++] = j;
+
+  for (unsigned int i = 0; i < n; i++)
+    if (row_start[i + 1] > row_start[i])
+      grph->InsertGlobalIndices(i, row_start[i + 1] - row_start[i], &row_cols[row_start[i]]);
+#endif
+}
+
 void EpetraMatrix::finish()
 {
   _F_
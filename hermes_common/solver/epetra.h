@@ -46,6 +46,9 @@ public:
 
   virtual void prealloc(unsigned int n);
   virtual void pre_add_ij(unsigned int row, unsigned int col);
+  virtual void pre_add_block(const int *rows, int num_rows, const int *cols, int num_cols);
+  /// The pattern is copied into the Epetra graph right away.
+  virtual void set_pattern(SparsityPattern *pattern);
   virtual void finish();
 
   virtual void alloc();
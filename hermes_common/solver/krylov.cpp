@@ -0,0 +1,569 @@
+// This file is part of Hermes
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "krylov.h"
+#include "../trace.h"
+#include "../error.h"
+#include "../utils.h"
+#include "../callstack.h"
+
+// Helpers /////////////////////////////////////////////////////////////////////////////////////////
+
+static scalar dot(const scalar *x, const scalar *y, unsigned int n)
+{
+  scalar s = 0;
+  for (unsigned int i = 0; i < n; i++) s += CONJ(x[i]) * y[i];
+  return s;
+}
+
+static double norm(const scalar *x, unsigned int n)
+{
+  double s = 0;
+  for (unsigned int i = 0; i < n; i++) s += magn(x[i]) * magn(x[i]);
+  return sqrt(s);
+}
+
+// Krylov solver ///////////////////////////////////////////////////////////////////////////////////
+
+KrylovSolver::KrylovSolver(CSCMatrix *m, UMFPackVector *rhs)
+  : IterSolver(), m(m), rhs(rhs)
+{
+  _F_
+  method = KRYLOV_GMRES;
+  precond = KRYLOV_PC_ILU0;
+  precond_yes = true;
+  restart = 30;
+  block_size = 8;
+  factorization_scheme = HERMES_FACTORIZE_FROM_SCRATCH;
+  num_iters = 0;
+  residual = 0.0;
+
+  n = 0;
+  Rp = Ri = Rdiag = NULL;
+  Rx = NULL;
+
+  pc_type = KRYLOV_PC_NONE;
+  pc_valid = false;
+  pc_diag = pc_lu = NULL;
+  pc_piv = NULL;
+}
+
+KrylovSolver::~KrylovSolver()
+{
+  _F_
+  free_precond();
+  free_matrix();
+}
+
+void KrylovSolver::set_solver(const char *name)
+{
+  _F_
+  if (strcasecmp(name, "gmres") == 0) method = KRYLOV_GMRES;
+  else if (strcasecmp(name, "cg") == 0) method = KRYLOV_CG;
+  else if (strcasecmp(name, "bicgstab") == 0) method = KRYLOV_BICGSTAB;
+  else {
+    warning("Unknown Krylov method '%s', using GMRES.", name);
+    method = KRYLOV_GMRES;
+  }
+}
+
+void KrylovSolver::set_precond(const char *name)
+{
+  _F_
+  KrylovPrecond pc;
+  if (strcasecmp(name, "none") == 0) pc = KRYLOV_PC_NONE;
+  else if (strcasecmp(name, "jacobi") == 0) pc = KRYLOV_PC_JACOBI;
+  else if (strcasecmp(name, "ilu0") == 0 || strcasecmp(name, "ilu") == 0) pc = KRYLOV_PC_ILU0;
+  else if (strcasecmp(name, "block-jacobi") == 0) pc = KRYLOV_PC_BLOCK_JACOBI;
+  else {
+    warning("Unknown preconditioner '%s', using none.", name);
+    pc = KRYLOV_PC_NONE;
+  }
+
+  if (pc != precond) pc_valid = false;
+  precond = pc;
+  precond_yes = (pc != KRYLOV_PC_NONE);
+}
+
+#ifdef HAVE_TEUCHOS
+void KrylovSolver::set_precond(Teuchos::RCP<Precond> &pc)
+#else
+void KrylovSolver::set_precond(Precond *pc)
+#endif
+{
+  _F_
+  warning("KrylovSolver supports only its built-in preconditioners, the supplied one is ignored.");
+}
+
+int KrylovSolver::get_num_iters()
+{
+  _F_
+  return num_iters;
+}
+
+double KrylovSolver::get_residual()
+{
+  _F_
+  return residual;
+}
+
+size_t KrylovSolver::get_memory_usage() const
+{
+  _F_
+  size_t mem = 0;
+  if (Rdiag != NULL) mem += n * sizeof(int);
+  if (pc_diag != NULL) mem += n * sizeof(scalar);
+  if (pc_lu != NULL) {
+    if (pc_type == KRYLOV_PC_ILU0) mem += Rp[n] * sizeof(scalar);
+    else {
+      size_t nb = (n + block_size - 1) / block_size;
+      mem += nb * block_size * block_size * sizeof(scalar) + n * sizeof(int);
+    }
+  }
+  return mem;
+}
+
+void KrylovSolver::free_matrix()
+{
+  _F_
+  delete [] Rdiag; Rdiag = NULL;
+  Rp = Ri = NULL;
+  Rx = NULL;
+  n = 0;
+}
+
+void KrylovSolver::free_precond()
+{
+  _F_
+  delete [] pc_diag; pc_diag = NULL;
+  delete [] pc_lu; pc_lu = NULL;
+  delete [] pc_piv; pc_piv = NULL;
+  pc_valid = false;
+}
+
+void KrylovSolver::setup_matrix()
+{
+  _F_
+  assert(m != NULL);
+  unsigned int size = m->get_size();
+  unsigned int nnz = m->get_nnz();
+  // The row-wise copy is needed here anyway, so let the products use it as well.
+  m->set_row_storage(true);
+  int *rp = m->get_Rp(), *ri = m->get_Ri();
+
+  // The positions of the diagonal are found again unless the scheme says the sparsity
+  // pattern is kept.
+  bool rebuild = (Rdiag == NULL || size != n || rp != Rp || ri != Ri || nnz != (unsigned int) Rp[n]
+                  || factorization_scheme == HERMES_FACTORIZE_FROM_SCRATCH);
+  if (rebuild) {
+    free_matrix();
+    pc_valid = false;
+    n = size;
+    Rdiag = new int[n];
+    MEM_CHECK(Rdiag);
+    for (unsigned int i = 0; i < n; i++) {
+      Rdiag[i] = -1;
+      for (int p = rp[i]; p < rp[i + 1]; p++)
+        if (ri[p] == (int) i) Rdiag[i] = p;
+    }
+  }
+  Rp = rp;
+  Ri = ri;
+  Rx = m->get_Rx();
+}
+
+void KrylovSolver::setup_precond()
+{
+  _F_
+  if (pc_valid && factorization_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY && pc_type != KRYLOV_PC_NONE)
+    return;
+
+  free_precond();
+  pc_type = precond;
+
+  if (pc_type == KRYLOV_PC_ILU0) {
+    unsigned int nnz = Rp[n];
+    pc_lu = new scalar[nnz];
+    MEM_CHECK(pc_lu);
+    memcpy(pc_lu, Rx, nnz * sizeof(scalar));
+
+    // IKJ variant of the incomplete factorization restricted to the pattern of the matrix.
+    int *marker = new int[n];
+    for (unsigned int i = 0; i < n; i++) marker[i] = -1;
+    bool ok = true;
+    for (unsigned int i = 0; i < n && ok; i++) {
+      for (int p = Rp[i]; p < Rp[i + 1]; p++) marker[Ri[p]] = p;
+      for (int p = Rp[i]; p < Rp[i + 1] && Ri[p] < (int) i; p++) {
+        int k = Ri[p];
+        pc_lu[p] /= pc_lu[Rdiag[k]];
+        for (int q = Rdiag[k] + 1; q < Rp[k + 1]; q++)
+          if (marker[Ri[q]] >= 0) pc_lu[marker[Ri[q]]] -= pc_lu[p] * pc_lu[q];
+      }
+      for (int p = Rp[i]; p < Rp[i + 1]; p++) marker[Ri[p]] = -1;
+      if (Rdiag[i] < 0 || pc_lu[Rdiag[i]] == 0.0) ok = false;
+    }
+    delete [] marker;
+
+    if (!ok) {
+      warning("Zero pivot in ILU(0), falling back to the Jacobi preconditioner.");
+      delete [] pc_lu;
+      pc_lu = NULL;
+      pc_type = KRYLOV_PC_JACOBI;
+    }
+  }
+
+  if (pc_type == KRYLOV_PC_JACOBI) {
+    pc_diag = new scalar[n];
+    MEM_CHECK(pc_diag);
+    for (unsigned int i = 0; i < n; i++) {
+      scalar d = 0.0;
+      if (Rdiag[i] >= 0) d = Rx[Rdiag[i]];
+      pc_diag[i] = 1.0;
+      if (d != 0.0) pc_diag[i] /= d;
+    }
+  }
+  else if (pc_type == KRYLOV_PC_BLOCK_JACOBI) {
+    if (block_size < 1) block_size = 1;
+    unsigned int bs = block_size;
+    unsigned int nb = (n + bs - 1) / bs;
+    pc_lu = new scalar[nb * bs * bs];
+    pc_piv = new int[n];
+    MEM_CHECK(pc_lu);
+    memset(pc_lu, 0, nb * bs * bs * sizeof(scalar));
+
+    bool singular = false;
+    for (unsigned int b = 0; b < nb; b++) {
+      unsigned int first = b * bs, sz = std::min(bs, n - first);
+      scalar *blk = pc_lu + b * bs * bs;
+      for (unsigned int i = 0; i < sz; i++)
+        for (int p = Rp[first + i]; p < Rp[first + i + 1]; p++)
+          if (Ri[p] >= (int) first && Ri[p] < (int) (first + sz))
+            blk[i * sz + Ri[p] - first] = Rx[p];
+
+      // Dense LU with partial pivoting, a zero pivot is replaced by one.
+      int *piv = pc_piv + first;
+      for (unsigned int k = 0; k < sz; k++) {
+        unsigned int r = k;
+        for (unsigned int i = k + 1; i < sz; i++)
+          if (magn(blk[i * sz + k]) > magn(blk[r * sz + k])) r = i;
+        piv[k] = r;
+        if (r != k)
+          for (unsigned int j = 0; j < sz; j++) std::swap(blk[k * sz + j], blk[r * sz + j]);
+        if (blk[k * sz + k] == 0.0) {
+          blk[k * sz + k] = 1.0;
+          singular = true;
+        }
+        for (unsigned int i = k + 1; i < sz; i++) {
+          blk[i * sz + k] /= blk[k * sz + k];
+          for (unsigned int j = k + 1; j < sz; j++) blk[i * sz + j] -= blk[i * sz + k] * blk[k * sz + j];
+        }
+      }
+    }
+    if (singular) warning("Singular diagonal block in the block Jacobi preconditioner.");
+  }
+
+  pc_valid = true;
+}
+
+void KrylovSolver::multiply(const scalar *x, scalar *y)
+{
+  m->multiply_with_vector(const_cast<scalar *>(x), y);
+}
+
+void KrylovSolver::apply_precond(const scalar *r, scalar *z)
+{
+  switch (pc_type) {
+    case KRYLOV_PC_NONE:
+      memcpy(z, r, n * sizeof(scalar));
+      break;
+
+    case KRYLOV_PC_JACOBI:
+      for (unsigned int i = 0; i < n; i++) z[i] = pc_diag[i] * r[i];
+      break;
+
+    case KRYLOV_PC_ILU0:
+      // Forward substitution with the unit lower triangle, then backward with the upper one.
+      for (unsigned int i = 0; i < n; i++) {
+        scalar s = r[i];
+        for (int p = Rp[i]; p < Rdiag[i]; p++) s -= pc_lu[p] * z[Ri[p]];
+        z[i] = s;
+      }
+      for (int i = n - 1; i >= 0; i--) {
+        scalar s = z[i];
+        for (int p = Rdiag[i] + 1; p < Rp[i + 1]; p++) s -= pc_lu[p] * z[Ri[p]];
+        z[i] = s / pc_lu[Rdiag[i]];
+      }
+      break;
+
+    case KRYLOV_PC_BLOCK_JACOBI: {
+      unsigned int bs = block_size;
+      for (unsigned int first = 0; first < n; first += bs) {
+        unsigned int sz = std::min(bs, n - first);
+        scalar *blk = pc_lu + (first / bs) * bs * bs, *zb = z + first;
+        int *piv = pc_piv + first;
+        memcpy(zb, r + first, sz * sizeof(scalar));
+        for (unsigned int k = 0; k < sz; k++)
+          if (piv[k] != (int) k) std::swap(zb[k], zb[piv[k]]);
+        for (unsigned int i = 1; i < sz; i++)
+          for (unsigned int j = 0; j < i; j++) zb[i] -= blk[i * sz + j] * zb[j];
+        for (int i = sz - 1; i >= 0; i--) {
+          for (unsigned int j = i + 1; j < sz; j++) zb[i] -= blk[i * sz + j] * zb[j];
+          zb[i] /= blk[i * sz + i];
+        }
+      }
+      break;
+    }
+  }
+}
+
+bool KrylovSolver::solve()
+{
+  _F_
+  assert(rhs != NULL);
+
+  TimePeriod tmr;
+
+  setup_matrix();
+  assert(n == rhs->length());
+  setup_precond();
+
+  delete [] sln;
+  sln = new scalar[n];
+  MEM_CHECK(sln);
+  memset(sln, 0, n * sizeof(scalar));
+
+  const scalar *b = rhs->get_c_array();
+  double b_norm = norm(b, n);
+  num_iters = 0;
+  residual = 0.0;
+
+  bool converged = true;
+  if (b_norm > 0) {
+    switch (method) {
+      case KRYLOV_CG:       converged = solve_cg(b, sln, b_norm); break;
+      case KRYLOV_BICGSTAB: converged = solve_bicgstab(b, sln, b_norm); break;
+      case KRYLOV_GMRES:    converged = solve_gmres(b, sln, b_norm); break;
+    }
+
+    // Report the true residual rather than the recurrence estimate.
+    scalar *r = new scalar[n];
+    multiply(sln, r);
+    for (unsigned int i = 0; i < n; i++) r[i] = b[i] - r[i];
+    residual = norm(r, n) / b_norm;
+    delete [] r;
+  }
+
+  tmr.tick();
+  time = tmr.accumulated();
+
+  if (!converged) {
+    warning("Krylov solver did not converge in %d iterations (relative residual %g).", num_iters, residual);
+    return false;
+  }
+  return true;
+}
+
+bool KrylovSolver::solve_cg(const scalar *b, scalar *x, double b_norm)
+{
+  _F_
+  scalar *r = new scalar[n], *z = new scalar[n], *p = new scalar[n], *q = new scalar[n];
+  memcpy(r, b, n * sizeof(scalar));
+  apply_precond(r, z);
+  memcpy(p, z, n * sizeof(scalar));
+  scalar rz = dot(r, z, n);
+
+  bool converged = false;
+  while (num_iters < max_iters) {
+    multiply(p, q);
+    scalar pq = dot(p, q, n);
+    if (pq == 0.0) break;
+    scalar alpha = rz / pq;
+    for (unsigned int i = 0; i < n; i++) {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * q[i];
+    }
+    num_iters++;
+    if (norm(r, n) <= tolerance * b_norm) {
+      converged = true;
+      break;
+    }
+
+    apply_precond(r, z);
+    scalar rz_new = dot(r, z, n);
+    scalar beta = rz_new / rz;
+    rz = rz_new;
+    for (unsigned int i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+  }
+
+  delete [] r;
+  delete [] z;
+  delete [] p;
+  delete [] q;
+  return converged;
+}
+
+bool KrylovSolver::solve_bicgstab(const scalar *b, scalar *x, double b_norm)
+{
+  _F_
+  scalar *r = new scalar[n], *r0 = new scalar[n], *p = new scalar[n], *v = new scalar[n];
+  scalar *ph = new scalar[n], *s = new scalar[n], *sh = new scalar[n], *t = new scalar[n];
+  memcpy(r, b, n * sizeof(scalar));
+  memcpy(r0, b, n * sizeof(scalar));
+  memset(p, 0, n * sizeof(scalar));
+  memset(v, 0, n * sizeof(scalar));
+  scalar rho = 1.0, alpha = 1.0, omega = 1.0;
+
+  // Right preconditioning, so that the recurrence residual is the true one.
+  bool converged = false;
+  while (num_iters < max_iters) {
+    scalar rho_new = dot(r0, r, n);
+    if (rho_new == 0.0) break;
+    scalar beta = (rho_new / rho) * (alpha / omega);
+    rho = rho_new;
+    for (unsigned int i = 0; i < n; i++) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+    apply_precond(p, ph);
+    multiply(ph, v);
+    scalar r0v = dot(r0, v, n);
+    if (r0v == 0.0) break;
+    alpha = rho / r0v;
+    for (unsigned int i = 0; i < n; i++) s[i] = r[i] - alpha * v[i];
+    num_iters++;
+    if (norm(s, n) <= tolerance * b_norm) {
+      for (unsigned int i = 0; i < n; i++) x[i] += alpha * ph[i];
+      converged = true;
+      break;
+    }
+
+    apply_precond(s, sh);
+    multiply(sh, t);
+    scalar tt = dot(t, t, n);
+    if (tt == 0.0) break;
+    omega = dot(t, s, n) / tt;
+    for (unsigned int i = 0; i < n; i++) {
+      x[i] += alpha * ph[i] + omega * sh[i];
+      r[i] = s[i] - omega * t[i];
+    }
+    if (norm(r, n) <= tolerance * b_norm) {
+      converged = true;
+      break;
+    }
+    if (omega == 0.0) break;
+  }
+
+  delete [] r;
+  delete [] r0;
+  delete [] p;
+  delete [] v;
+  delete [] ph;
+  delete [] s;
+  delete [] sh;
+  delete [] t;
+  return converged;
+}
+
+bool KrylovSolver::solve_gmres(const scalar *b, scalar *x, double b_norm)
+{
+  _F_
+  int mr = std::max(restart, 1);
+  scalar **v = new_matrix<scalar>(mr + 1, n);
+  scalar **h = new_matrix<scalar>(mr + 1, mr);
+  scalar *g = new scalar[mr + 1], *sn = new scalar[mr + 1];
+  double *cs = new double[mr + 1];
+  scalar *r = new scalar[n], *z = new scalar[n];
+
+  // Restarted GMRES with right preconditioning (x = M^{-1} V y).
+  bool converged = false;
+  while (!converged && num_iters < max_iters) {
+    multiply(x, r);
+    for (unsigned int i = 0; i < n; i++) r[i] = b[i] - r[i];
+    double beta = norm(r, n);
+    if (beta <= tolerance * b_norm) {
+      converged = true;
+      break;
+    }
+    for (unsigned int i = 0; i < n; i++) v[0][i] = r[i] / beta;
+    memset(g, 0, (mr + 1) * sizeof(scalar));
+    g[0] = beta;
+
+    int k = 0;
+    for (; k < mr && num_iters < max_iters; k++) {
+      apply_precond(v[k], z);
+      multiply(z, v[k + 1]);
+      num_iters++;
+
+      // Modified Gram-Schmidt.
+      for (int j = 0; j <= k; j++) {
+        scalar d = dot(v[j], v[k + 1], n);
+        h[j][k] = d;
+        for (unsigned int i = 0; i < n; i++) v[k + 1][i] -= d * v[j][i];
+      }
+      double w_norm = norm(v[k + 1], n);
+      h[k + 1][k] = w_norm;
+      if (w_norm != 0)
+        for (unsigned int i = 0; i < n; i++) v[k + 1][i] /= w_norm;
+
+      // Apply the previous Givens rotations to the new column and compute a new one.
+      for (int j = 0; j < k; j++) {
+        scalar t = cs[j] * h[j][k] + sn[j] * h[j + 1][k];
+        h[j + 1][k] = -conj(sn[j]) * h[j][k] + cs[j] * h[j + 1][k];
+        h[j][k] = t;
+      }
+      double a = magn(h[k][k]), nrm = sqrt(a * a + w_norm * w_norm);
+      if (a == 0) {
+        cs[k] = 0;
+        sn[k] = 1;
+      }
+      else {
+        cs[k] = a / nrm;
+        sn[k] = (h[k][k] / a) * w_norm / nrm;
+      }
+      h[k][k] = cs[k] * h[k][k] + sn[k] * w_norm;
+      h[k + 1][k] = 0;
+      g[k + 1] = -conj(sn[k]) * g[k];
+      g[k] = cs[k] * g[k];
+
+      if (magn(g[k + 1]) <= tolerance * b_norm) {
+        converged = true;
+        k++;
+        break;
+      }
+    }
+
+    // Solve the upper triangular system and update x += M^{-1} V y.
+    for (int j = k - 1; j >= 0; j--) {
+      for (int l = j + 1; l < k; l++) g[j] -= h[j][l] * g[l];
+      g[j] /= h[j][j];
+    }
+    memset(r, 0, n * sizeof(scalar));
+    for (int j = 0; j < k; j++)
+      for (unsigned int i = 0; i < n; i++) r[i] += g[j] * v[j][i];
+    apply_precond(r, z);
+    for (unsigned int i = 0; i < n; i++) x[i] += z[i];
+  }
+
+  delete [] v;
+  delete [] h;
+  delete [] g;
+  delete [] sn;
+  delete [] cs;
+  delete [] r;
+  delete [] z;
+  return converged;
+}
@@ -0,0 +1,119 @@
+// This file is part of Hermes
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef __HERMES_COMMON_KRYLOV_SOLVER_H_
+#define __HERMES_COMMON_KRYLOV_SOLVER_H_
+
+#include "solver.h"
+#include "umfpack_solver.h"
+
+/// Built-in preconditioned Krylov solver (CG, BiCGStab, GMRES) for matrices in the CSC
+/// format. It does not need any external library, and its memory footprint is a small
+/// multiple of the matrix size (no fill-in), which makes it usable for problems where
+/// a direct factorization does not fit into the memory.
+///
+/// Available preconditioners: none, Jacobi, ILU(0) (incomplete LU without fill-in) and
+/// block Jacobi (exact LU of diagonal blocks of consecutive unknowns). The default is
+/// GMRES(30) with ILU(0). The preconditioner is kept between calls to solve() if the
+/// factorization scheme allows it (see set_factorization_scheme()).
+///
+/// @ingroup solvers
+class HERMES_API KrylovSolver : public IterSolver {
+public:
+  KrylovSolver(CSCMatrix *m, UMFPackVector *rhs);
+  virtual ~KrylovSolver();
+
+  virtual bool solve();
+
+  virtual int get_num_iters();
+  /// Returns the relative residual ||b - Ax|| / ||b|| reached by the last solve().
+  virtual double get_residual();
+
+  /// Set the type of the solver
+  /// @param[in] name - name of the solver [ gmres | cg | bicgstab ]
+  void set_solver(const char *name);
+  /// Set the number of iterations after which GMRES is restarted.
+  void set_restart(int restart) { this->restart = restart; }
+
+  /// Set the built-in preconditioner
+  /// @param[in] name - name of the preconditioner [ none | jacobi | ilu0 | block-jacobi ]
+  virtual void set_precond(const char *name);
+  /// Set the size of the diagonal blocks used by the block-jacobi preconditioner.
+  void set_block_size(int size) { this->block_size = size; }
+
+  /// External preconditioners are not supported; use set_precond(const char *).
+#ifdef HAVE_TEUCHOS
+  virtual void set_precond(Teuchos::RCP<Precond> &pc);
+#else
+  virtual void set_precond(Precond *pc);
+#endif
+
+  /// HERMES_REUSE_FACTORIZATION_COMPLETELY keeps the preconditioner computed for an earlier
+  /// matrix, the other schemes recompute it (keeping the sparsity structure if possible).
+  virtual void set_factorization_scheme(FactorizationScheme reuse_scheme) { factorization_scheme = reuse_scheme; }
+
+  /// Returns the number of bytes used by the preconditioner and the auxiliary arrays
+  /// (not counting the matrix and its row-wise copy, see CSCMatrix::get_Rp()).
+  virtual size_t get_memory_usage() const;
+
+protected:
+  enum KrylovMethod { KRYLOV_CG, KRYLOV_BICGSTAB, KRYLOV_GMRES };
+  enum KrylovPrecond { KRYLOV_PC_NONE, KRYLOV_PC_JACOBI, KRYLOV_PC_ILU0, KRYLOV_PC_BLOCK_JACOBI };
+
+  CSCMatrix *m;
+  UMFPackVector *rhs;
+
+  KrylovMethod method;
+  KrylovPrecond precond;
+  int restart;                  ///< GMRES restart length.
+  int block_size;               ///< Block size for KRYLOV_PC_BLOCK_JACOBI.
+  unsigned int factorization_scheme;
+
+  int num_iters;
+  double residual;
+
+  // Row-wise (CSR) copy of the matrix owned by the matrix, used by the preconditioners.
+  unsigned int n;
+  int *Rp, *Ri;                 ///< Row starts, column indices.
+  scalar *Rx;
+  int *Rdiag;                   ///< Positions of the diagonal entries in Rx (-1 if missing).
+
+  // Preconditioner data.
+  KrylovPrecond pc_type;        ///< Preconditioner actually in use (after fall-backs).
+  bool pc_valid;
+  scalar *pc_diag;              ///< Inverse diagonal (Jacobi).
+  scalar *pc_lu;                ///< ILU(0) factors (structure of Rx), or dense LU of the blocks.
+  int *pc_piv;                  ///< Pivots of the block LU factorizations.
+
+  virtual void setup_matrix();
+  virtual void setup_precond();
+  virtual void free_matrix();
+  void free_precond();
+
+  /// y = A x
+  virtual void multiply(const scalar *x, scalar *y);
+  /// z = M^{-1} r
+  virtual void apply_precond(const scalar *r, scalar *z);
+
+  bool solve_cg(const scalar *b, scalar *x, double b_norm);
+  bool solve_bicgstab(const scalar *b, scalar *x, double b_norm);
+  bool solve_gmres(const scalar *b, scalar *x, double b_norm);
+};
+
+#endif
@@ -0,0 +1,154 @@
+// This file is part of Hermes
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "matrix_free.h"
+#include "../trace.h"
+#include "../error.h"
+#include "../callstack.h"
+
+// Matrix-free operator ////////////////////////////////////////////////////////////////////////////
+
+MatrixFreeOperator::MatrixFreeOperator()
+  : SparseMatrix(), in(NULL), out(NULL), diag(NULL)
+{
+  _F_
+}
+
+MatrixFreeOperator::~MatrixFreeOperator()
+{
+  _F_
+}
+
+void MatrixFreeOperator::set_vectors(const scalar *in, scalar *out, scalar *diag)
+{
+  _F_
+  this->in = in;
+  this->out = out;
+  this->diag = diag;
+}
+
+scalar MatrixFreeOperator::get(unsigned int m, unsigned int n)
+{
+  _F_
+  error("MatrixFreeOperator does not store the matrix entries.");
+  return 0.0;
+}
+
+void MatrixFreeOperator::add(unsigned int m, unsigned int n, scalar v)
+{
+  if (out != NULL) out[m] += v * in[n];
+  if (diag != NULL && m == n) diag[m] += v;
+}
+
+void MatrixFreeOperator::add_to_diagonal(scalar v)
+{
+  _F_
+  for (unsigned int i = 0; i < size; i++) add(i, i, v);
+}
+
+void MatrixFreeOperator::add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols)
+{
+  for (unsigned int i = 0; i < m; i++) {
+    if (rows[i] < 0) continue;
+    scalar *row = mat[i];
+    if (out != NULL) {
+      scalar s = 0.0;
+      for (unsigned int j = 0; j < n; j++)
+        if (cols[j] >= 0) s += row[j] * in[cols[j]];
+      out[rows[i]] += s;
+    }
+    // A DOF may appear several times in the local matrix (constrained functions).
+    if (diag != NULL)
+      for (unsigned int j = 0; j < n; j++)
+        if (cols[j] == rows[i]) diag[rows[i]] += row[j];
+  }
+}
+
+bool MatrixFreeOperator::dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt)
+{
+  _F_
+  warning("MatrixFreeOperator can not be dumped, it does not store the matrix.");
+  return false;
+}
+
+// Matrix-free Krylov solver ///////////////////////////////////////////////////////////////////////
+
+MatrixFreeKrylovSolver::MatrixFreeKrylovSolver(DiscreteProblemInterface *dp, UMFPackVector *rhs)
+  : KrylovSolver(NULL, rhs), dp(dp)
+{
+  _F_
+  precond = KRYLOV_PC_JACOBI;
+}
+
+MatrixFreeKrylovSolver::~MatrixFreeKrylovSolver()
+{
+  _F_
+  free_precond();
+  free_matrix();
+}
+
+void MatrixFreeKrylovSolver::set_precond(const char *name)
+{
+  _F_
+  KrylovSolver::set_precond(name);
+  if (precond != KRYLOV_PC_NONE && precond != KRYLOV_PC_JACOBI) {
+    warning("Preconditioner '%s' needs the matrix, using the Jacobi preconditioner.", name);
+    precond = KRYLOV_PC_JACOBI;
+  }
+}
+
+void MatrixFreeKrylovSolver::free_matrix()
+{
+  _F_
+  n = 0;
+}
+
+void MatrixFreeKrylovSolver::setup_matrix()
+{
+  _F_
+  assert(dp != NULL);
+  unsigned int size = dp->get_num_dofs();
+  if (size != n || factorization_scheme == HERMES_FACTORIZE_FROM_SCRATCH) pc_valid = false;
+  n = size;
+}
+
+void MatrixFreeKrylovSolver::setup_precond()
+{
+  _F_
+  if (pc_valid && factorization_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY && pc_type != KRYLOV_PC_NONE)
+    return;
+
+  free_precond();
+  pc_type = precond;
+
+  if (pc_type == KRYLOV_PC_JACOBI) {
+    pc_diag = new scalar[n];
+    MEM_CHECK(pc_diag);
+    dp->get_diagonal(pc_diag);
+    for (unsigned int i = 0; i < n; i++)
+      pc_diag[i] = (pc_diag[i] != 0.0) ? 1.0 / pc_diag[i] : 1.0;
+  }
+
+  pc_valid = true;
+}
+
+void MatrixFreeKrylovSolver::multiply(const scalar *x, scalar *y)
+{
+  dp->apply(const_cast<scalar *>(x), y);
+}
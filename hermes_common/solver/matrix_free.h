@@ -0,0 +1,102 @@
+// This file is part of Hermes
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef __HERMES_COMMON_MATRIX_FREE_H_
+#define __HERMES_COMMON_MATRIX_FREE_H_
+
+#include "krylov.h"
+#include "dpinterface.h"
+
+/// Matrix-free operator: a SparseMatrix that does not store anything. The local matrices
+/// added by the assembling are multiplied by the input vector right away and the products
+/// are accumulated in the output vector, i.e. assembling into it computes out += A in
+/// without forming A. Optionally, the diagonal of A is accumulated too.
+///
+/// It is used by DiscreteProblem::apply() and DiscreteProblem::get_diagonal(), the
+/// assembling does not create any sparse structure for it.
+///
+/// @ingroup solvers
+class HERMES_API MatrixFreeOperator : public SparseMatrix {
+public:
+  MatrixFreeOperator();
+  virtual ~MatrixFreeOperator();
+
+  /// Sets the vectors used by the following additions.
+  /// @param[in] in    - the input vector (may be NULL if only the diagonal is wanted)
+  /// @param[in] out   - the output vector (may be NULL), it is not zeroed
+  /// @param[in] diag  - the vector accumulating the diagonal (may be NULL), it is not zeroed
+  void set_vectors(const scalar *in, scalar *out, scalar *diag = NULL);
+
+  const scalar *get_input() const { return in; }
+  scalar *get_output() const { return out; }
+  scalar *get_diagonal() const { return diag; }
+
+  virtual void prealloc(unsigned int n) { this->size = n; }
+  virtual void pre_add_ij(unsigned int row, unsigned int col) { }
+  virtual void pre_add_block(const int *rows, int num_rows, const int *cols, int num_cols) { }
+  virtual void set_pattern(SparsityPattern *pattern) { this->size = pattern->get_size(); }
+
+  virtual void alloc() { }
+  virtual void free() { }
+  virtual scalar get(unsigned int m, unsigned int n);
+  virtual void zero() { }
+  virtual void add(unsigned int m, unsigned int n, scalar v);
+  virtual void add_to_diagonal(scalar v);
+  virtual void add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols);
+  virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE);
+  virtual unsigned int get_matrix_size() const { return 0; }
+  virtual double get_fill_in() const { return 0.0; }
+
+protected:
+  const scalar *in;
+  scalar *out;
+  scalar *diag;
+};
+
+/// Built-in Krylov solver (see KrylovSolver) for matrix-free problems: the matrix is
+/// replaced by DiscreteProblemInterface::apply(), so the global matrix is never stored.
+/// Only the preconditioners that do not need the matrix entries are available:
+///   - none,
+///   - jacobi ... the diagonal is obtained by DiscreteProblemInterface::get_diagonal().
+/// The default is GMRES(30) with the Jacobi preconditioner.
+///
+/// @ingroup solvers
+class HERMES_API MatrixFreeKrylovSolver : public KrylovSolver {
+public:
+  MatrixFreeKrylovSolver(DiscreteProblemInterface *dp, UMFPackVector *rhs);
+  virtual ~MatrixFreeKrylovSolver();
+
+  virtual void set_precond(const char *name);
+#ifdef HAVE_TEUCHOS
+  virtual void set_precond(Teuchos::RCP<Precond> &pc) { KrylovSolver::set_precond(pc); }
+#else
+  virtual void set_precond(Precond *pc) { KrylovSolver::set_precond(pc); }
+#endif
+
+protected:
+  DiscreteProblemInterface *dp;
+
+  virtual void setup_matrix();
+  virtual void setup_precond();
+  virtual void free_matrix();
+
+  virtual void multiply(const scalar *x, scalar *y);
+};
+
+#endif
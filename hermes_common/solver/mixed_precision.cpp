@@ -0,0 +1,412 @@
+// This file is part of Hermes
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "mixed_precision.h"
+#include "../trace.h"
+#include "../error.h"
+#include "../callstack.h"
+
+#ifdef SLU_SINGLE
+  #ifndef HERMES_COMMON_COMPLEX
+    #include <slu_sdefs.h>
+
+    #define SLU_LP_DTYPE                SLU_S
+    #define SLU_LP_CREATE_CSC_MATRIX    sCreate_CompCol_Matrix
+    #define SLU_LP_CREATE_DENSE_MATRIX  sCreate_Dense_Matrix
+    #define SLU_LP_GSTRF                sgstrf
+    #define SLU_LP_GSTRS                sgstrs
+    #define SLU_LP_QUERY_SPACE          sQuerySpace
+
+    typedef float slu_lp_scalar;
+  #else
+    #include <slu_cdefs.h>
+
+    #define SLU_LP_DTYPE                SLU_C
+    #define SLU_LP_CREATE_CSC_MATRIX    cCreate_CompCol_Matrix
+    #define SLU_LP_CREATE_DENSE_MATRIX  cCreate_Dense_Matrix
+    #define SLU_LP_GSTRF                cgstrf
+    #define SLU_LP_GSTRS                cgstrs
+    #define SLU_LP_QUERY_SPACE          cQuerySpace
+
+    // Same layout as std::complex<float>.
+    typedef complex slu_lp_scalar;
+  #endif
+
+struct SinglePrecisionLU::SuperLUFactors {
+  SuperMatrix L, U;
+  std::vector<int> perm_c;      ///< Column permutation (the column i of A is the column perm_c[i] of A Pc).
+  std::vector<int> perm_r;      ///< Row permutation.
+};
+#endif
+
+// Pivots within this fraction of the largest entry of the column are accepted if they lie
+// on the diagonal.
+static const double PIVOT_TOLERANCE = 0.001;
+
+static inline bool is_finite(double x) { return x == x && x <= DBL_MAX && x >= -DBL_MAX; }
+
+// SinglePrecisionLU ///////////////////////////////////////////////////////////////////////////////
+
+SinglePrecisionLU::SinglePrecisionLU() : n(0)
+{
+  _F_
+#ifdef SLU_SINGLE
+  slu = NULL;
+#endif
+}
+
+SinglePrecisionLU::~SinglePrecisionLU()
+{
+  _F_
+  free();
+}
+
+void SinglePrecisionLU::free()
+{
+  _F_
+  n = 0;
+  std::vector<double>().swap(rs);
+  std::vector<lp_scalar>().swap(work);
+#ifdef SLU_SINGLE
+  if (slu != NULL) {
+    Destroy_SuperNode_Matrix(&slu->L);
+    Destroy_CompCol_Matrix(&slu->U);
+    delete slu;
+    slu = NULL;
+  }
+#else
+  std::vector<int>().swap(Lp); std::vector<int>().swap(Li); std::vector<lp_scalar>().swap(Lx);
+  std::vector<int>().swap(Up); std::vector<int>().swap(Ui); std::vector<lp_scalar>().swap(Ux);
+  std::vector<int>().swap(pinv);
+  std::vector<int>().swap(q);
+#endif
+}
+
+unsigned int SinglePrecisionLU::get_nnz() const
+{
+#ifdef SLU_SINGLE
+  if (slu == NULL) return 0;
+  return ((SCformat *) slu->L.Store)->nnz + ((NCformat *) slu->U.Store)->nnz;
+#else
+  return Lp.empty() ? 0 : Lp[n] + Up[n];
+#endif
+}
+
+size_t SinglePrecisionLU::get_memory_usage() const
+{
+  size_t mem = work.capacity() * sizeof(lp_scalar) + rs.capacity() * sizeof(double);
+#ifdef SLU_SINGLE
+  if (slu != NULL) {
+    mem_usage_t mem_usage;
+    SLU_LP_QUERY_SPACE(&slu->L, &slu->U, &mem_usage);
+    mem += (size_t) mem_usage.for_lu + (slu->perm_c.capacity() + slu->perm_r.capacity()) * sizeof(int);
+  }
+#else
+  mem += (Li.capacity() + Ui.capacity() + Lp.capacity() + Up.capacity() + pinv.capacity() + q.capacity()) * sizeof(int)
+         + (Lx.capacity() + Ux.capacity()) * sizeof(lp_scalar);
+#endif
+  return mem;
+}
+
+bool SinglePrecisionLU::factorize(unsigned int n, const int *Ap, const int *Ai, const scalar *Ax, const int *q)
+{
+  _F_
+  free();
+  this->n = n;
+
+  // Row scaling.
+  rs.assign(n, 0.0);
+  for (unsigned int j = 0; j < n; j++)
+    for (int p = Ap[j]; p < Ap[j + 1]; p++)
+      rs[Ai[p]] = std::max(rs[Ai[p]], (double) std::abs(Ax[p]));
+  for (unsigned int i = 0; i < n; i++) {
+    if (rs[i] == 0.0 || !is_finite(rs[i])) return false;
+    rs[i] = 1.0 / rs[i];
+  }
+
+#ifdef SLU_SINGLE
+  // The scaled matrix in single precision.
+  std::vector<lp_scalar> Ax_lp(Ap[n]);
+  for (unsigned int j = 0; j < n; j++)
+    for (int p = Ap[j]; p < Ap[j + 1]; p++) Ax_lp[p] = (lp_scalar) (Ax[p] * rs[Ai[p]]);
+
+  slu = new SuperLUFactors;
+  slu->perm_c.resize(n);
+  slu->perm_r.resize(n);
+  for (unsigned int k = 0; k < n; k++) slu->perm_c[q[k]] = k;
+
+  superlu_options_t options;
+  set_default_options(&options);
+  options.ColPerm = MY_PERMC;
+  options.DiagPivotThresh = PIVOT_TOLERANCE;
+
+  SuperLUStat_t stat;
+  StatInit(&stat);
+
+  // SuperLU only reads the structure of A (the arguments are not declared const).
+  SuperMatrix A, AC;
+  SLU_LP_CREATE_CSC_MATRIX(&A, n, n, Ap[n], (slu_lp_scalar *) &Ax_lp[0], (int *) Ai, (int *) Ap,
+                           SLU_NC, SLU_LP_DTYPE, SLU_GE);
+  std::vector<int> etree(n);
+  sp_preorder(&options, &A, &slu->perm_c[0], &etree[0], &AC);
+
+  int info;
+  SLU_LP_GSTRF(&options, &AC, sp_ienv(2), sp_ienv(1), &etree[0], NULL, 0, &slu->perm_c[0], 
+               &slu->perm_r[0], &slu->L, &slu->U, &stat, &info);
+
+  Destroy_CompCol_Permuted(&AC);
+  Destroy_SuperMatrix_Store(&A);
+  StatFree(&stat);
+
+  // info > 0 means a zero pivot (info <= n) or an allocation failure; the factors are not
+  // allocated in the latter case.
+  if (info != 0) {
+    if (info > 0 && info <= (int) n) {
+      Destroy_SuperNode_Matrix(&slu->L);
+      Destroy_CompCol_Matrix(&slu->U);
+    }
+    delete slu;
+    slu = NULL;
+    return false;
+  }
+#else
+  this->q.assign(q, q + n);
+
+  // The factors of a FE matrix are typically a few times larger than the matrix.
+  size_t est = 2 * (size_t) Ap[n] + n;
+  Lp.resize(n + 1); Li.reserve(est); Lx.reserve(est);
+  Up.resize(n + 1); Ui.reserve(est); Ux.reserve(est);
+  pinv.assign(n, -1);
+
+  std::vector<lp_scalar> x(n, lp_scalar(0));  // Dense work column.
+  std::vector<int> xi(n);                     // Nonzero pattern of x (in xi[top..n-1]).
+  std::vector<int> stack(n), pstack(n);       // DFS stacks.
+  std::vector<char> mark(n, 0);
+
+  for (unsigned int k = 0; k < n; k++) {
+    Lp[k] = Li.size();
+    Up[k] = Ui.size();
+    int col = q[k];
+
+    // Nonzero pattern of L \ A(:, col): the nodes reachable from the entries of A(:, col) in the
+    // graph of the columns of L computed so far, in topological order.
+    int top = n;
+    for (int p = Ap[col]; p < Ap[col + 1]; p++) {
+      if (mark[Ai[p]]) continue;
+      int head = 0;
+      stack[0] = Ai[p];
+      while (head >= 0) {
+        int j = stack[head];
+        int J = pinv[j];
+        if (!mark[j]) {
+          mark[j] = 1;
+          pstack[head] = (J < 0) ? 0 : Lp[J];
+        }
+        bool done = true;
+        int p2 = (J < 0) ? 0 : Lp[J + 1];
+        for (int pp = pstack[head]; pp < p2; pp++) {
+          int i = Li[pp];
+          if (mark[i]) continue;
+          pstack[head] = pp;
+          stack[++head] = i;
+          done = false;
+          break;
+        }
+        if (done) {
+          head--;
+          xi[--top] = j;
+        }
+      }
+    }
+    for (unsigned int p = top; p < n; p++) mark[xi[p]] = 0;
+
+    // Sparse triangular solve.
+    for (int p = Ap[col]; p < Ap[col + 1]; p++) x[Ai[p]] = (lp_scalar) (Ax[p] * rs[Ai[p]]);
+    for (unsigned int px = top; px < n; px++) {
+      int j = xi[px];
+      int J = pinv[j];
+      if (J < 0) continue;
+      lp_scalar xj = x[j];
+      for (int p = Lp[J] + 1; p < Lp[J + 1]; p++) x[Li[p]] -= Lx[p] * xj;
+    }
+
+    // Choose the pivot, store the column of U.
+    int ipiv = -1;
+    float amax = -1.0f;
+    for (unsigned int px = top; px < n; px++) {
+      int i = xi[px];
+      if (pinv[i] < 0) {
+        float a = std::abs(x[i]);
+        if (a > amax) { amax = a; ipiv = i; }
+      }
+      else {
+        Ui.push_back(pinv[i]);
+        Ux.push_back(x[i]);
+      }
+    }
+    if (ipiv < 0 || !(amax > 0.0f) || !is_finite(amax)) return false;
+    if (pinv[col] < 0 && std::abs(x[col]) >= PIVOT_TOLERANCE * amax) ipiv = col;
+
+    lp_scalar pivot = x[ipiv];
+    Ui.push_back(k);
+    Ux.push_back(pivot);
+    pinv[ipiv] = k;
+
+    // Store the column of L (the unit diagonal first).
+    Li.push_back(ipiv);
+    Lx.push_back(lp_scalar(1));
+    for (unsigned int px = top; px < n; px++) {
+      int i = xi[px];
+      if (pinv[i] < 0) {
+        Li.push_back(i);
+        Lx.push_back(x[i] / pivot);
+      }
+      x[i] = 0;
+    }
+  }
+  Lp[n] = Li.size();
+  Up[n] = Ui.size();
+
+  // Renumber the rows of L by the pivoting.
+  for (unsigned int p = 0; p < Li.size(); p++) Li[p] = pinv[Li[p]];
+#endif
+
+  work.resize(n);
+  return true;
+}
+
+void SinglePrecisionLU::solve(scalar *x)
+{
+  _F_
+#ifdef SLU_SINGLE
+  lp_scalar *y = &work[0];
+  for (unsigned int i = 0; i < n; i++) y[i] = (lp_scalar) (x[i] * rs[i]);
+
+  SuperMatrix B;
+  SLU_LP_CREATE_DENSE_MATRIX(&B, n, 1, (slu_lp_scalar *) y, n, SLU_DN, SLU_LP_DTYPE, SLU_GE);
+  SuperLUStat_t stat;
+  StatInit(&stat);
+  int info;
+  SLU_LP_GSTRS(NOTRANS, &slu->L, &slu->U, &slu->perm_c[0], &slu->perm_r[0], &B, &stat, &info);
+  StatFree(&stat);
+  Destroy_SuperMatrix_Store(&B);
+
+  for (unsigned int i = 0; i < n; i++) x[i] = (scalar) y[i];
+#else
+  lp_scalar *y = &work[0];
+  for (unsigned int i = 0; i < n; i++) y[pinv[i]] = (lp_scalar) (x[i] * rs[i]);
+
+  for (unsigned int j = 0; j < n; j++) {
+    lp_scalar yj = y[j];
+    for (int p = Lp[j] + 1; p < Lp[j + 1]; p++) y[Li[p]] -= Lx[p] * yj;
+  }
+  for (int j = n - 1; j >= 0; j--) {
+    lp_scalar yj = (y[j] /= Ux[Up[j + 1] - 1]);
+    for (int p = Up[j]; p < Up[j + 1] - 1; p++) y[Ui[p]] -= Ux[p] * yj;
+  }
+
+  for (unsigned int k = 0; k < n; k++) x[q[k]] = (scalar) y[k];
+#endif
+}
+
+// Mixed-precision mode of LinearSolver /////////////////////////////////////////////////////////////
+
+LinearSolver::~LinearSolver()
+{
+  _F_
+  delete lp_lu;
+}
+
+bool LinearSolver::single_factorization_needed(unsigned int n)
+{
+  _F_
+  return lp_lu == NULL || lp_lu->get_size() != n
+         || factorization_scheme != HERMES_REUSE_FACTORIZATION_COMPLETELY;
+}
+
+bool LinearSolver::factorize_single(unsigned int n, const int *Ap, const int *Ai, const scalar *Ax, const int *q)
+{
+  _F_
+  if (lp_lu == NULL) lp_lu = new SinglePrecisionLU;
+  if (lp_lu->factorize(n, Ap, Ai, Ax, q)) return true;
+
+  lp_lu->free();
+  return false;
+}
+
+bool LinearSolver::solve_refined(const int *Ap, const int *Ai, const scalar *Ax, const scalar *b, scalar *x)
+{
+  _F_
+  unsigned int n = lp_lu->get_size();
+
+  // Norms in the maximum norm.
+  std::vector<double> row_sum(n, 0.0);
+  for (unsigned int j = 0; j < n; j++)
+    for (int p = Ap[j]; p < Ap[j + 1]; p++) row_sum[Ai[p]] += std::abs(Ax[p]);
+  double a_norm = 0.0, b_norm = 0.0;
+  for (unsigned int i = 0; i < n; i++) {
+    a_norm = std::max(a_norm, row_sum[i]);
+    b_norm = std::max(b_norm, (double) std::abs(b[i]));
+  }
+  double tol = (mp_tol > 0.0) ? mp_tol : sqrt((double) n) * DBL_EPSILON;
+
+  memset(x, 0, n * sizeof(scalar));
+  if (b_norm == 0.0) return true;
+
+  scalar *r = new scalar[n];
+  MEM_CHECK(r);
+  memcpy(r, b, n * sizeof(scalar));
+
+  bool converged = false;
+  for (int step = 0; step < mp_max_steps; step++) {
+    // Correction (the first one is the solution itself).
+    lp_lu->solve(r);
+    for (unsigned int i = 0; i < n; i++) x[i] += r[i];
+
+    // Residual in double precision.
+    memcpy(r, b, n * sizeof(scalar));
+    double x_norm = 0.0;
+    for (unsigned int j = 0; j < n; j++) {
+      scalar xj = x[j];
+      x_norm = std::max(x_norm, (double) std::abs(xj));
+      for (int p = Ap[j]; p < Ap[j + 1]; p++) r[Ai[p]] -= Ax[p] * xj;
+    }
+    double r_norm = 0.0;
+    for (unsigned int i = 0; i < n; i++) r_norm = std::max(r_norm, (double) std::abs(r[i]));
+
+    double berr = r_norm / (a_norm * x_norm + b_norm);
+    mp_residuals.push_back(berr);
+    if (!is_finite(berr)) break;
+    if (berr <= tol) { converged = true; break; }
+    if (step > 0 && berr > 0.5 * mp_residuals[step - 1]) break;
+  }
+
+  delete [] r;
+  return converged;
+}
+
+void LinearSolver::fall_back_to_double(const char *reason)
+{
+  _F_
+  warning("Mixed precision: %s, falling back to the factorization in double precision.", reason);
+  mp_fallback = true;
+  mp_used = false;
+  delete lp_lu;
+  lp_lu = NULL;
+}
@@ -0,0 +1,88 @@
+// This file is part of Hermes
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef __HERMES_COMMON_MIXED_PRECISION_H_
+#define __HERMES_COMMON_MIXED_PRECISION_H_
+
+#include "solver.h"
+
+#ifndef HERMES_COMMON_COMPLEX
+  typedef float lp_scalar;
+#else
+  typedef std::complex<float> lp_scalar;
+#endif
+
+// The single precision routines of the serial SuperLU are used if it is available (SuperLU_MT
+// has a different interface).
+#if defined(WITH_SUPERLU) && !defined(SLU_MT)
+  #define SLU_SINGLE
+#endif
+
+/// Sparse LU factorization in single precision used by the mixed-precision mode of the direct
+/// solvers (see LinearSolver::set_mixed_precision()).
+///
+/// It factorizes A(:, q) for a fill-reducing column ordering q supplied by the direct solver, with
+/// threshold partial pivoting that prefers the "diagonal" pivot (the row q[k] in the step k) to
+/// preserve the fill-reducing properties of q for matrices with a symmetric pattern. The rows are
+/// scaled by their maximal entries before the conversion to single precision, so that the entries
+/// fit into its range.
+///
+/// With SuperLU the factorization is done by its supernodal single precision routines (sgstrf,
+/// cgstrf). UMFPACK has no single precision routines, so without SuperLU a built-in left-looking
+/// (Gilbert-Peierls) factorization is used.
+///
+/// @ingroup solvers
+class HERMES_API SinglePrecisionLU {
+public:
+  SinglePrecisionLU();
+  ~SinglePrecisionLU();
+
+  /// Factorizes the CSC matrix (Ap, Ai, Ax) of the size n with the column ordering q.
+  /// Returns false if the matrix is singular in single precision.
+  bool factorize(unsigned int n, const int *Ap, const int *Ai, const scalar *Ax, const int *q);
+  /// Overwrites x with the solution of A y = x, computed in single precision.
+  void solve(scalar *x);
+  void free();
+
+  unsigned int get_size() const { return n; }
+  /// Returns the number of entries of the factors L and U.
+  unsigned int get_nnz() const;
+  /// Returns the number of bytes used by the factors.
+  size_t get_memory_usage() const;
+
+protected:
+  unsigned int n;
+  std::vector<double> rs;       ///< Row scaling factors.
+  std::vector<lp_scalar> work;
+#ifdef SLU_SINGLE
+  /// SuperLU factors, defined in mixed_precision.cpp so that the single precision SuperLU 
+  /// headers are not included together with the double precision ones (see superlu.h).
+  struct SuperLUFactors;
+  SuperLUFactors *slu;
+#else
+  std::vector<int> Lp, Li;      ///< L (unit lower triangular, CSC, diagonal first).
+  std::vector<lp_scalar> Lx;
+  std::vector<int> Up, Ui;      ///< U (upper triangular, CSC, diagonal last).
+  std::vector<lp_scalar> Ux;
+  std::vector<int> pinv;        ///< Row permutation (the row i is the row pinv[i] of L U).
+  std::vector<int> q;           ///< Column permutation.
+#endif
+};
+
+#endif
@@ -88,27 +88,19 @@ MumpsMatrix::~MumpsMatrix()
 void MumpsMatrix::alloc()
 {
   _F_
-  assert(pages != NULL);
+  SparsityPattern *pat = get_pattern();
 
   // initialize the arrays Ap and Ai
+  nnz = pat->get_nnz();
   Ap = new unsigned int [size + 1];
   MEM_CHECK(Ap);
-  int aisize = get_num_indices();
-  Ai = new int [aisize];
+  const int *pat_Ap = pat->get_Ap();
+  for (unsigned int i = 0; i <= size; i++) Ap[i] = pat_Ap[i];
+  Ai = new int [nnz];
   MEM_CHECK(Ai);
+  memcpy(Ai, pat->get_Ai(), sizeof(int) * nnz);
 
-  // sort the indices and remove duplicities, insert into Ai
-  unsigned int i, pos = 0;
-  for (i = 0; i < size; i++) {
-    Ap[i] = pos;
-    pos += sort_and_store_indices(pages[i], Ai + pos, Ai + aisize);
-  }
-  Ap[i] = pos;
-
-  delete [] pages;
-  pages = NULL;
-
-  nnz = Ap[size];
+  release_pattern();
 
   Ax = new mumps_scalar[nnz];
   memset(Ax, 0, sizeof(mumps_scalar) * nnz);
@@ -104,27 +104,19 @@ PetscMatrix::~PetscMatrix() {
 void PetscMatrix::alloc() {
   _F_
 #ifdef WITH_PETSC
-  assert(pages != NULL);
+  SparsityPattern *pat = get_pattern();
 
   // calc nnz
   int *nnz_array = new int[size];
   MEM_CHECK(nnz_array);
 
   // fill in nnz_array
-  int aisize = get_num_indices();
-  int *ai = new int[aisize];
-  MEM_CHECK(ai);
-
-  // sort the indices and remove duplicities, insert into ai
-  int pos = 0;
-  for (unsigned int i = 0; i < size; i++) {
-    nnz_array[i] = sort_and_store_indices(pages[i], ai + pos, ai + aisize);
-    pos += nnz_array[i];
-  }
-  // stote the number of nonzeros
-  nnz = pos;
-  delete [] pages; pages = NULL;
-  delete [] ai;
+  const int *pat_Ap = pat->get_Ap();
+  for (unsigned int i = 0; i < size; i++)
+    nnz_array[i] = pat_Ap[i + 1] - pat_Ap[i];
+  // store the number of nonzeros
+  nnz = pat->get_nnz();
+  release_pattern();
 
   //
   MatCreateSeqAIJ(PETSC_COMM_SELF, size, size, 0, nnz_array, &matrix);
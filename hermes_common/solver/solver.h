@@ -108,13 +108,44 @@ protected:
 };
 
 
+class SinglePrecisionLU;
+
 /// Abstract class for defining interface for linear solvers.
 ///
-class LinearSolver : public Solver 
+class HERMES_API LinearSolver : public Solver 
 {
   public:
     LinearSolver(unsigned int factorization_scheme = HERMES_FACTORIZE_FROM_SCRATCH) 
-      : Solver(), factorization_scheme(factorization_scheme) {};
+      : Solver(), factorization_scheme(factorization_scheme), mp_enabled(false), 
+        mp_max_steps(30), mp_tol(0.0), mp_fallback(false), mp_used(false), lp_lu(NULL) {};
+    virtual ~LinearSolver();
+    
+    /// Enables the mixed-precision mode (supported by UMFPack and SuperLU, ignored by the
+    /// other solvers). The matrix is factorized in single precision, which needs about half 
+    /// of the memory of the factors, and the solution is recovered to double accuracy by 
+    /// iterative refinement: the residual is computed in double precision and the correction
+    /// is solved with the single precision factors.
+    ///
+    /// The refinement stops when the normwise backward error ||b - Ax|| / (||A|| ||x|| + ||b||)
+    /// (in the maximum norm) drops below tol. If the matrix cannot be factorized in single 
+    /// precision, or the refinement does not converge within max_steps steps or stagnates 
+    /// (the error is reduced less than twice in one step, i.e. the matrix is too ill-conditioned),
+    /// the solver falls back to the factorization in double precision and keeps using it 
+    /// until this function is called again.
+    ///
+    /// @param[in] enable    - use the mixed-precision mode
+    /// @param[in] max_steps - maximal number of refinement steps
+    /// @param[in] tol       - tolerance of the backward error, 0 means sqrt(n) * DBL_EPSILON
+    void set_mixed_precision(bool enable = true, int max_steps = 30, double tol = 0.0) {
+      mp_enabled = enable; mp_max_steps = max_steps; mp_tol = tol; mp_fallback = false;
+    }
+    /// Returns true if the last solve() was done by the single precision factorization, false
+    /// if the mixed-precision mode is disabled, not supported or has fallen back to double.
+    bool is_mixed_precision_used() { return mp_used; }
+    /// Returns true if the mixed-precision mode has fallen back to double precision.
+    bool get_mixed_precision_fallback() { return mp_fallback; }
+    /// Backward errors after the refinement steps of the last solve() in mixed precision.
+    const std::vector<double>& get_refinement_residuals() { return mp_residuals; }
     
   protected:
     virtual void set_factorization_scheme(FactorizationScheme reuse_scheme) { 
@@ -122,6 +153,29 @@ class LinearSolver : public Solver
     }
         
     unsigned int factorization_scheme;
+
+    // Mixed-precision mode (see set_mixed_precision(), implemented in mixed_precision.cpp).
+    bool mp_enabled;
+    int mp_max_steps;
+    double mp_tol;
+    bool mp_fallback;                 ///< The mode has fallen back to double precision.
+    bool mp_used;                     ///< The last solve() was done in mixed precision.
+    std::vector<double> mp_residuals;
+    SinglePrecisionLU *lp_lu;         ///< Single precision factors.
+    
+    /// Returns true if the mixed-precision mode is to be used for this solve.
+    bool use_mixed_precision() { return mp_enabled && !mp_fallback; }
+    /// Returns true if the single precision factors have to be (re)computed, i.e. unless they
+    /// exist for a matrix of the size n and the factorization is to be reused completely.
+    bool single_factorization_needed(unsigned int n);
+    /// Factorizes the CSC matrix (Ap, Ai, Ax) in single precision using the fill-reducing column
+    /// ordering q.
+    bool factorize_single(unsigned int n, const int *Ap, const int *Ai, const scalar *Ax, const int *q);
+    /// Solves the system with the CSC matrix (Ap, Ai, Ax) using the single precision factors
+    /// and iterative refinement; returns false if the refinement failed.
+    bool solve_refined(const int *Ap, const int *Ai, const scalar *Ax, const scalar *b, scalar *x);
+    /// Switches to double precision, reporting the reason.
+    void fall_back_to_double(const char *reason);
 };
 
 /// Abstract class for defining interface for nonlinear solvers.
@@ -18,6 +18,7 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "superlu.h"
+#include "mixed_precision.h"
 #include "../trace.h"
 #include "../error.h"
 #include "../utils.h"
@@ -69,27 +70,19 @@ SuperLUMatrix::~SuperLUMatrix()
 void SuperLUMatrix::alloc()
 {
   _F_
-  assert(pages != NULL);
+  SparsityPattern *pat = get_pattern();
   
   // Initialize the arrays Ap and Ai.
+  nnz = pat->get_nnz();
   Ap = new unsigned int [size + 1];
   MEM_CHECK(Ap);
-  int aisize = get_num_indices();
-  Ai = new int [aisize];
+  const int *pat_Ap = pat->get_Ap();
+  for (unsigned int i = 0; i <= size; i++) Ap[i] = pat_Ap[i];
+  Ai = new int [nnz];
   MEM_CHECK(Ai);
+  memcpy(Ai, pat->get_Ai(), sizeof(int) * nnz);
   
-  // sort the indices and remove duplicities, insert into Ai
-  unsigned int i, pos = 0;
-  for (i = 0; i < size; i++) {
-    Ap[i] = pos;
-    pos += sort_and_store_indices(pages[i], Ai + pos, Ai + aisize);
-  }
-  Ap[i] = pos;
-  
-  delete [] pages;
-  pages = NULL;
-  
-  nnz = Ap[size];
+  release_pattern();
 
   Ax = new slu_scalar [nnz];
   memset(Ax, 0, sizeof(slu_scalar) * nnz);
@@ -594,6 +587,16 @@ bool SuperLUSolver::solve()
   options.lwork = lwork;
 #endif
 
+  mp_used = false;
+  mp_residuals.clear();
+  if (use_mixed_precision() && solve_mixed_precision())
+  {
+    StatFree(&stat);
+    tmr.tick();
+    time = tmr.accumulated();
+    return true;
+  }
+
   if ( !setup_factorization() )
   {
     warning("LU factorization could not be completed.");
@@ -742,6 +745,54 @@ bool SuperLUSolver::solve()
 #endif
 }
 
+bool SuperLUSolver::solve_mixed_precision()
+{
+  _F_
+#ifdef WITH_SUPERLU
+  // SuperLUMatrix stores Ap as unsigned and the complex values as doublecomplex, which have the
+  // same layout as int and cplx.
+  const int *Ap = (const int *) m->Ap;
+  const scalar *Ax = (const scalar *) m->Ax;
+  
+  if (single_factorization_needed(m->size))
+  {
+    // Fill-reducing column ordering (minimum degree on A' + A, which suits the diagonal pivoting
+    // preferred by the single precision factorization).
+    SuperMatrix AA;
+    SLU_CREATE_CSC_MATRIX(&AA, m->size, m->size, m->nnz, m->Ax, m->Ai, (int *) m->Ap, SLU_NC, SLU_DTYPE, SLU_GE);
+    int *perm;
+    if ( !(perm = intMalloc(m->size)) ) 
+      error("Malloc fails for perm[].");
+    get_perm_c(2, &AA, perm);
+    Destroy_SuperMatrix_Store(&AA);
+    
+    // get_perm_c gives the position of each column, factorize_single() expects the column 
+    // factorized in each step.
+    int *q = new int[m->size];
+    for (unsigned int i = 0; i < m->size; i++) q[perm[i]] = i;
+    SUPERLU_FREE(perm);
+    
+    bool factorized = factorize_single(m->size, Ap, m->Ai, Ax, q);
+    delete [] q;
+    if (!factorized) {
+      fall_back_to_double("the matrix is singular in single precision");
+      return false;
+    }
+  }
+  
+  delete [] sln;
+  sln = new scalar[m->size];
+  if (!solve_refined(Ap, m->Ai, Ax, (const scalar *) rhs->v, sln)) {
+    fall_back_to_double("iterative refinement did not converge");
+    return false;
+  }
+  mp_used = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool SuperLUSolver::setup_factorization()
 {
   _F_
@@ -238,6 +238,9 @@ protected:
   
   bool setup_factorization();
   void free_factorization_data();
+  /// Solves the system in the mixed-precision mode (see LinearSolver::set_mixed_precision()),
+  /// returns false if the solution has to be computed in double precision.
+  bool solve_mixed_precision();
   void free_matrix();
   void free_rhs();
   
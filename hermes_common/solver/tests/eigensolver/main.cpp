@@ -0,0 +1,89 @@
+#define HERMES_REPORT_WARN
+#define HERMES_REPORT_INFO
+
+#include "common.h"
+#include "config.h"
+
+#include "solver/umfpack_solver.h"
+#include "solver/eigensolver.h"
+
+#include <math.h>
+
+using namespace Hermes;
+
+// Test of the eigensolver on an operator with small invariant subspaces.
+// A is block diagonal with the blocks [2 -1; -1 2], B = 2 I, so the only
+// eigenvalues are 0.5 and 1.5 (both with multiplicity N / 2) and every Krylov
+// space has dimension at most 2. The Lanczos process breaks down after every
+// second vector and has to continue with new vectors; the eigenpairs closest to
+// zero must still be found with B-orthonormal eigenvectors.
+
+const int N = 40;                     // Size of the matrices.
+const int NEV = 4;                    // Number of requested eigenvalues.
+const double EPS = 1e-8;              // Tolerance of the checks.
+
+CSCMatrix *create_matrix(double diag, double offdiag) {
+  std::vector<int> Ap(N + 1), Ai;
+  std::vector<double> Ax;
+  for (int c = 0; c < N; c++) {
+    Ap[c] = Ai.size();
+    int first = c - c % 2;
+    for (int r = first; r < first + 2; r++) {
+      double v = (r == c) ? diag : offdiag;
+      if (v == 0.0) continue;
+      Ai.push_back(r);
+      Ax.push_back(v);
+    }
+  }
+  Ap[N] = Ai.size();
+
+  CSCMatrix *mat = new CSCMatrix;
+  mat->create(N, Ai.size(), &Ap[0], &Ai[0], &Ax[0]);
+  return mat;
+}
+
+int main(int argc, char *argv[]) {
+  CSCMatrix *A = create_matrix(2.0, -1.0);
+  CSCMatrix *B = create_matrix(2.0, 0.0);
+  RCP<Matrix> rA = rcp(A), rB = rcp(B);
+
+  EigenSolver es(rA, rB);
+  es.solve(NEV, 0.0, 1e-10);
+
+  bool success = (es.get_n_eigs() == NEV);
+  std::vector<double> x(N), bx(N);
+  for (int i = 0; i < es.get_n_eigs() && success; i++) {
+    double lambda = es.get_eigenvalue(i);
+    info("Eigenvalue %d: %g", i, lambda);
+    if (fabs(lambda - 0.5) > EPS) success = false;
+
+    // Residual |A x - lambda B x|.
+    double *vec;
+    int n;
+    es.get_eigenvector(i, &vec, &n);
+    if (n != N) { success = false; break; }
+    A->multiply_with_vector(vec, &x[0]);
+    B->multiply_with_vector(vec, &bx[0]);
+    double res = 0.0;
+    for (int k = 0; k < N; k++) res += sqr(x[k] - lambda * bx[k]);
+    if (sqrt(res) > EPS) success = false;
+
+    // B-orthonormality against the eigenvectors found so far.
+    for (int j = 0; j <= i; j++) {
+      double *vec_j;
+      es.get_eigenvector(j, &vec_j, &n);
+      double prod = 0.0;
+      for (int k = 0; k < N; k++) prod += vec_j[k] * bx[k];
+      if (fabs(prod - (i == j ? 1.0 : 0.0)) > EPS) success = false;
+    }
+  }
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -13,6 +13,8 @@
 #include "solver/epetra.h"
 #include "solver/amesos.h"
 #include "solver/aztecoo.h"
+#include "solver/krylov.h"
+#include "solver/bsr.h"
 #include "solver/mumps.h"
 
 #include <iostream>
@@ -371,6 +373,64 @@ int main(int argc, char *argv[]) {
     solve(solver, n);
 #endif
   }
+  else if (strcasecmp(argv[1], "umfpack-mp") == 0) {
+#ifdef WITH_UMFPACK
+    UMFPackMatrix mat;
+    UMFPackVector rhs;
+    build_matrix(n, ar_mat, ar_rhs, &mat, &rhs);
+
+    UMFPackLinearSolver solver(&mat, &rhs);
+    solver.set_mixed_precision();
+    solve(solver, n);
+    if (!solver.is_mixed_precision_used()) ret = ERR_FAILURE;
+#endif
+  }
+  else if (strcasecmp(argv[1], "krylov") == 0) {
+    CSCMatrix mat;
+    UMFPackVector rhs;
+    build_matrix(n, ar_mat, ar_rhs, &mat, &rhs);
+
+    KrylovSolver solver(&mat, &rhs);
+    solver.set_tolerance(1e-12);
+    solve(solver, n);
+  }
+  else if (strcasecmp(argv[1], "krylov-block") == 0) {
+    CSCMatrix mat;
+    UMFPackVector rhs;
+    build_matrix_block(n, ar_mat, ar_rhs, &mat, &rhs);
+
+    KrylovSolver solver(&mat, &rhs);
+    solver.set_tolerance(1e-12);
+    solve(solver, n);
+  }
+  else if (strcasecmp(argv[1], "bsr") == 0) {
+    BSRMatrix mat;
+    UMFPackVector rhs;
+    build_matrix(n, ar_mat, ar_rhs, &mat, &rhs);
+
+    BSRKrylovSolver solver(&mat, &rhs);
+    solver.set_tolerance(1e-12);
+    solve(solver, n);
+  }
+  else if (strcasecmp(argv[1], "bsr-block") == 0) {
+    // Pairs of consecutive unknowns make the blocks, the last one is incomplete for odd n.
+    BSRMatrix mat;
+    UMFPackVector rhs;
+    int *block_of_dof = new int[n], *comp_of_dof = new int[n];
+    for (int i = 0; i < n; i++) {
+      block_of_dof[i] = i / 2;
+      comp_of_dof[i] = i % 2;
+    }
+    mat.prealloc(n);
+    mat.set_block_map(2, (n + 1) / 2, block_of_dof, comp_of_dof);
+    build_matrix_block(n, ar_mat, ar_rhs, &mat, &rhs);
+    delete [] block_of_dof;
+    delete [] comp_of_dof;
+
+    BSRKrylovSolver solver(&mat, &rhs);
+    solver.set_tolerance(1e-12);
+    solve(solver, n);
+  }
   else if (strcasecmp(argv[1], "aztecoo") == 0) {
 #ifdef WITH_TRILINOS
     EpetraMatrix mat;
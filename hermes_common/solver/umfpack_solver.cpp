@@ -20,6 +20,7 @@
 #define HERMES_REPORT_INFO
 
 #include "umfpack_solver.h"
+#include "mixed_precision.h"
 
 #ifdef WITH_UMFPACK
   extern "C" {
@@ -31,6 +32,9 @@
 #include "../error.h"
 #include "../utils.h"
 #include "../callstack.h"
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
 
 static int find_position(int *Ai, int Alen, int idx) {
   _F_
@@ -65,11 +69,21 @@ CSCMatrix::CSCMatrix() {
   Ap = NULL;
   Ai = NULL;
   Ax = NULL;
+  Rp = NULL;
+  Ri = NULL;
+  Rx = NULL;
+  rows_valid = false;
+  use_rows = false;
 }
 
 CSCMatrix::CSCMatrix(unsigned int size) {
   _F_
   this->size = size;
+  Rp = NULL;
+  Ri = NULL;
+  Rx = NULL;
+  rows_valid = false;
+  use_rows = false;
   this->alloc();
 }
 
@@ -78,50 +92,140 @@ CSCMatrix::~CSCMatrix() {
   free();
 }
 
+// Below this number of nonzeros, the products are not worth running in parallel.
+static const unsigned int PARALLEL_SPMV_MIN_NNZ = 20000;
+
+void CSCMatrix::finish()
+{
+  _F_
+  // The row-wise copy is created by the first product, so that the matrices which are
+  // only factorized do not take the additional memory. add() does not invalidate the
+  // copy (it may be called concurrently), so refresh it here.
+  if (use_rows && Rp != NULL) {
+    rows_valid = false;
+    update_rows();
+  }
+}
+
+void CSCMatrix::set_row_storage(bool enable)
+{
+  _F_
+  use_rows = enable;
+  if (!use_rows) free_rows();
+}
+
+void CSCMatrix::free_rows()
+{
+  _F_
+  if (Rp != NULL) {delete [] Rp; Rp = NULL;}
+  if (Ri != NULL) {delete [] Ri; Ri = NULL;}
+  if (Rx != NULL) {delete [] Rx; Rx = NULL;}
+  rows_valid = false;
+}
+
+void CSCMatrix::update_rows()
+{
+  _F_
+  if (Ap == NULL || (Rp != NULL && rows_valid)) return;
+
+  // Scanning the columns in order leaves the column indices of each row sorted.
+  int *next = new int[size];
+  MEM_CHECK(next);
+  if (Rp == NULL) {
+    Rp = new int[size + 1];
+    Ri = new int[nnz];
+    Rx = new scalar[nnz];
+    MEM_CHECK(Rx);
+    memset(Rp, 0, (size + 1) * sizeof(int));
+    for (unsigned int k = 0; k < nnz; k++) Rp[Ai[k] + 1]++;
+    for (unsigned int i = 0; i < size; i++) Rp[i + 1] += Rp[i];
+
+    memcpy(next, Rp, size * sizeof(int));
+    for (unsigned int j = 0; j < size; j++)
+      for (int k = Ap[j]; k < Ap[j + 1]; k++) Ri[next[Ai[k]]++] = j;
+  }
+
+  memcpy(next, Rp, size * sizeof(int));
+  for (unsigned int j = 0; j < size; j++)
+    for (int k = Ap[j]; k < Ap[j + 1]; k++) Rx[next[Ai[k]]++] = Ax[k];
+  delete [] next;
+  rows_valid = true;
+}
+
 void CSCMatrix::multiply_with_vector(scalar* vector_in, scalar* vector_out) 
 {
   int n = this->size;
-  for (int j=0; j<n; j++) vector_out[j] = 0;
-  for (int j=0; j<n; j++) {
-    for (int i = Ap[j]; i < Ap[j + 1]; i++) {
-      vector_out[Ai[i]] += vector_in[j]*Ax[i];
+  if (!use_rows) {
+    for (int j=0; j<n; j++) vector_out[j] = 0;
+    for (int j=0; j<n; j++) {
+      for (int i = Ap[j]; i < Ap[j + 1]; i++) {
+        vector_out[Ai[i]] += vector_in[j]*Ax[i];
+      }
+    }
+    return;
+  }
+
+  update_rows();
+
+  // Every thread takes a range of rows with about the same number of nonzeros.
+#ifdef _OPENMP
+  #pragma omp parallel if (nnz >= PARALLEL_SPMV_MIN_NNZ)
+#endif
+  {
+    int first = 0, last = n;
+#ifdef _OPENMP
+    int num_threads = omp_get_num_threads(), thread = omp_get_thread_num();
+    first = std::lower_bound(Rp, Rp + n, (int) ((double) nnz * thread / num_threads)) - Rp;
+    last = std::lower_bound(Rp, Rp + n, (int) ((double) nnz * (thread + 1) / num_threads)) - Rp;
+    if (thread == num_threads - 1) last = n;
+#endif
+    for (int i = first; i < last; i++) {
+      scalar sum = 0;
+      for (int k = Rp[i]; k < Rp[i + 1]; k++) sum += Rx[k] * vector_in[Ri[k]];
+      vector_out[i] = sum;
     }
   }
 }
 
+void CSCMatrix::multiply_with_vector_transposed(scalar* vector_in, scalar* vector_out) 
+{
+  // The columns of the matrix are the rows of its transposition.
+  int n = this->size;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static, 256) if (nnz >= PARALLEL_SPMV_MIN_NNZ)
+#endif
+  for (int j = 0; j < n; j++) {
+    scalar sum = 0;
+    for (int k = Ap[j]; k < Ap[j + 1]; k++) sum += Ax[k] * vector_in[Ai[k]];
+    vector_out[j] = sum;
+  }
+}
+
 void CSCMatrix::multiply_with_scalar(scalar value) 
 {
   for (unsigned int i = 0; i < this->nnz; i++) Ax[i] *= value;
+  rows_valid = false;
 }
 
 void CSCMatrix::alloc() {
   _F_
-  assert(pages != NULL);
+  SparsityPattern *pat = get_pattern();
 
   // initialize the arrays Ap and Ai
+  nnz = pat->get_nnz();
   Ap = new int [size + 1];
   MEM_CHECK(Ap);
-  int aisize = get_num_indices();
-  Ai = new int [aisize];
+  memcpy(Ap, pat->get_Ap(), sizeof(int) * (size + 1));
+  Ai = new int [nnz];
   MEM_CHECK(Ai);
+  memcpy(Ai, pat->get_Ai(), sizeof(int) * nnz);
 
-  // sort the indices and remove duplicities, insert into Ai
-  unsigned int i;
-  int pos = 0;
-  for (i = 0; i < size; i++) {
-    Ap[i] = pos;
-    pos += sort_and_store_indices(pages[i], Ai + pos, Ai + aisize);
-  }
-  Ap[i] = pos;
-
-  delete [] pages;
-  pages = NULL;
+  release_pattern();
 
-  nnz = Ap[size];
-  
   Ax = new scalar [nnz];
   MEM_CHECK(Ax);
   memset(Ax, 0, sizeof(scalar) * nnz);
+  free_rows();
 }
 
 void CSCMatrix::free() {
@@ -130,6 +234,7 @@ void CSCMatrix::free() {
   if (Ap != NULL) {delete [] Ap; Ap = NULL;}
   if (Ai != NULL) {delete [] Ai; Ai = NULL;}
   if (Ax != NULL) {delete [] Ax; Ax = NULL;}
+  free_rows();
 }
 
 scalar CSCMatrix::get(unsigned int m, unsigned int n)
@@ -147,6 +252,7 @@ scalar CSCMatrix::get(unsigned int m, unsigned int n)
 void CSCMatrix::zero() {
   _F_
   memset(Ax, 0, sizeof(scalar) * nnz);
+  rows_valid = false;
 }
 
 void CSCMatrix::add(unsigned int m, unsigned int n, scalar v) {
@@ -165,6 +271,13 @@ void CSCMatrix::add(unsigned int m, unsigned int n, scalar v) {
   }
 }
 
+int CSCMatrix::get_position(unsigned int m, unsigned int n) {
+  _F_
+  // Find m-th row in the n-th column.
+  int pos = find_position(Ai + Ap[n], Ap[n + 1] - Ap[n], m);
+  return (pos < 0) ? -1 : Ap[n] + pos;
+}
+
 // NOTE: Corresponding nonzero entries in the matrix "this" must be existing.
 void CSCMatrix::add_to_diagonal_blocks(int num_stages, CSCMatrix* mat_block)
 {
@@ -245,6 +358,7 @@ void CSCMatrix::add_to_diagonal(scalar v)
   for (unsigned int i = 0; i<size; i++) {
     add(i, i, v);
   }
+  rows_valid = false;
 };
 
 void CSCMatrix::add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols) {
@@ -376,6 +490,7 @@ double CSCMatrix::get_fill_in() const {
 void CSCMatrix::create(unsigned int size, unsigned int nnz, int* ap, int* ai, scalar* ax) 
 {
   _F_
+  free_rows();
   this->nnz = nnz;
   this->size = size;
   this->Ap = new int[size+1]; assert(this->Ap != NULL);
@@ -509,6 +624,8 @@ bool UMFPackVector::dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt
   #define umfpack_free_symbolic                         umfpack_di_free_symbolic
   #define umfpack_free_numeric                          umfpack_di_free_numeric
   #define umfpack_defaults                              umfpack_di_defaults
+  #define umfpack_get_symbolic                          umfpack_di_get_symbolic
+  #define umfpack_get_lunz                              umfpack_di_get_lunz
 #else
   // macros for calling complex UMFPACK in packed-complex mode
   #define umfpack_symbolic(m, n, Ap, Ai, Ax, S, C, I)   umfpack_zi_symbolic(m, n, Ap, Ai, (double *) (Ax), NULL, S, C, I)
@@ -517,6 +634,8 @@ bool UMFPackVector::dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt
   #define umfpack_free_symbolic                         umfpack_di_free_symbolic
   #define umfpack_free_numeric                          umfpack_zi_free_numeric
   #define umfpack_defaults                              umfpack_zi_defaults
+  #define umfpack_get_symbolic                          umfpack_zi_get_symbolic
+  #define umfpack_get_lunz                              umfpack_zi_get_lunz
 #endif
 
 
@@ -570,18 +689,31 @@ bool UMFPackLinearSolver::solve() {
 
   int status;
 
-  if ( !setup_factorization() )
-  {
-    warning("LU factorization could not be completed.");
-    return false;
-  }
-
   if(sln)
     delete [] sln;
   sln = new scalar[m->size];
   MEM_CHECK(sln);
   memset(sln, 0, m->size * sizeof(scalar));
 
+  mp_used = false;
+  mp_residuals.clear();
+  if (use_mixed_precision())
+  {
+    if (solve_mixed_precision())
+    {
+      tmr.tick();
+      time = tmr.accumulated();
+      return true;
+    }
+    memset(sln, 0, m->size * sizeof(scalar));
+  }
+
+  if ( !setup_factorization() )
+  {
+    warning("LU factorization could not be completed.");
+    return false;
+  }
+
   status = umfpack_solve(UMFPACK_A, m->Ap, m->Ai, m->Ax, sln, rhs->v, numeric, NULL, NULL);
   if (status != UMFPACK_OK) {
     check_status("umfpack_di_solve", status);
@@ -601,10 +733,13 @@ bool UMFPackLinearSolver::setup_factorization()
 {
   _F_
 #ifdef WITH_UMFPACK
-  // Perform both factorization phases for the first time.
+  // Perform both factorization phases for the first time (the numerical one also after
+  // the mixed-precision mode has fallen back to double precision).
   int eff_fact_scheme;
-  if (factorization_scheme != HERMES_FACTORIZE_FROM_SCRATCH && symbolic == NULL && numeric == NULL)
+  if (factorization_scheme != HERMES_FACTORIZE_FROM_SCRATCH && symbolic == NULL)
     eff_fact_scheme = HERMES_FACTORIZE_FROM_SCRATCH;
+  else if (factorization_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY && numeric == NULL)
+    eff_fact_scheme = HERMES_REUSE_MATRIX_REORDERING;
   else
     eff_fact_scheme = factorization_scheme;
   
@@ -641,6 +776,80 @@ bool UMFPackLinearSolver::setup_factorization()
 #endif
 }
 
+int UMFPackLinearSolver::get_lu_nnz()
+{
+  _F_
+#ifdef WITH_UMFPACK
+  if (numeric == NULL) return -1;
+  int lnz, unz, n_row, n_col, nz_udiag;
+  int status = umfpack_get_lunz(&lnz, &unz, &n_row, &n_col, &nz_udiag, numeric);
+  if (status != UMFPACK_OK) {
+    check_status("umfpack_di_get_lunz", status);
+    return -1;
+  }
+  // The unit diagonal of L is counted in lnz.
+  return lnz + unz - n_row;
+#else
+  return -1;
+#endif
+}
+
+bool UMFPackLinearSolver::solve_mixed_precision()
+{
+  _F_
+#ifdef WITH_UMFPACK
+  if (single_factorization_needed(m->size))
+  {
+    // The symbolic analysis of UMFPACK provides the fill-reducing column ordering.
+    if (symbolic == NULL || factorization_scheme == HERMES_FACTORIZE_FROM_SCRATCH)
+    {
+      if (symbolic != NULL) umfpack_free_symbolic(&symbolic);
+      int status = umfpack_symbolic(m->size, m->size, m->Ap, m->Ai, m->Ax, &symbolic, NULL, NULL);
+      if (status != UMFPACK_OK) {
+        check_status("umfpack_di_symbolic", status);
+        return false;
+      }
+    }
+    // The double precision factors of a previous matrix are not needed any more.
+    if (numeric != NULL) umfpack_free_numeric(&numeric);
+    
+    int n_row, n_col, n1, nz, nfr, nchains;
+    int *P = new int[m->size];
+    int *Q = new int[m->size];
+    int *front = new int[4 * (m->size + 1)];
+    int *chain = new int[3 * (m->size + 1)];
+    int status = umfpack_get_symbolic(&n_row, &n_col, &n1, &nz, &nfr, &nchains, P, Q,
+                                      front, front + m->size + 1, front + 2 * (m->size + 1), 
+                                      front + 3 * (m->size + 1), chain, chain + m->size + 1, 
+                                      chain + 2 * (m->size + 1), symbolic);
+    bool factorized = (status == UMFPACK_OK) && factorize_single(m->size, m->Ap, m->Ai, m->Ax, Q);
+    delete [] P;
+    delete [] Q;
+    delete [] front;
+    delete [] chain;
+
+    if (status != UMFPACK_OK) {
+      check_status("umfpack_di_get_symbolic", status);
+      fall_back_to_double("the column ordering is not available");
+      return false;
+    }
+    if (!factorized) {
+      fall_back_to_double("the matrix is singular in single precision");
+      return false;
+    }
+  }
+
+  if (!solve_refined(m->Ap, m->Ai, m->Ax, rhs->v, sln)) {
+    fall_back_to_double("iterative refinement did not converge");
+    return false;
+  }
+  mp_used = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
 void UMFPackLinearSolver::free_factorization_data()
 { 
   _F_
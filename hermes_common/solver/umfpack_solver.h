@@ -37,6 +37,9 @@ public:
   virtual scalar get(unsigned int m, unsigned int n);
   virtual void zero();
   virtual void add(unsigned int m, unsigned int n, scalar v);
+  // Returns the index of the entry (m, n) in the array of values (see get_Ax()),
+  // or -1 if the entry is not in the sparse structure.
+  int get_position(unsigned int m, unsigned int n);
   virtual void add_to_diagonal(scalar v);
   // TODO: implement this for other matrix types.
   virtual void add_matrix(CSCMatrix* mat);
@@ -50,8 +53,15 @@ public:
   unsigned int get_nnz() {return this->nnz;}
   virtual double get_fill_in() const;
 
+  // Refreshes the row-wise copy of the matrix (see get_Rp()) if it has been created.
+  virtual void finish();
+
   // Applies the matrix to vector_in and saves result to vector_out.
+  // Uses the row-wise copy of the matrix (if enabled by set_row_storage()), which allows
+  // to run in parallel.
   void multiply_with_vector(scalar* vector_in, scalar* vector_out);
+  // Applies the transposed matrix to vector_in and saves result to vector_out.
+  void multiply_with_vector_transposed(scalar* vector_in, scalar* vector_out);
   // Multiplies matrix with a scalar.
   void multiply_with_scalar(scalar value);
   // Creates matrix in CSC format using size, nnz, and the three arrays.
@@ -65,10 +75,25 @@ public:
   int *get_Ai() {
       return this->Ai;
   }
+  // Values changed through the pointer appear in the row-wise copy after finish(), as
+  // those added by add(m, n, v).
   scalar *get_Ax() {
       return this->Ax;
   }
 
+  // Exposes the row-wise (CSR) copy of the matrix, column indices in each row are sorted.
+  // The copy is built or refreshed when needed. It is invalidated by zero() and the other
+  // methods of this class, but not by add(m, n, v) or writes through get_Ax(), which are
+  // done concurrently by the assembling; values added after the last zero() appear in the
+  // copy after finish().
+  int *get_Rp() { update_rows(); return this->Rp; }
+  int *get_Ri() { update_rows(); return this->Ri; }
+  scalar *get_Rx() { update_rows(); return this->Rx; }
+  // Enables or disables the use of the row-wise copy in multiply_with_vector() (disabled
+  // by default). The copy takes about as much memory as the matrix itself, but the
+  // product then runs in parallel. Disabling frees the copy.
+  void set_row_storage(bool enable);
+
 protected:
   // UMFPack specific data structures for storing the system matrix (CSC format).
   scalar *Ax;            // Matrix entries (column-wise).
@@ -76,6 +101,15 @@ protected:
   int *Ap;               // Index to Ax/Ai, where each column starts.
   unsigned int nnz;      // Number of non-zero entries (= Ap[size]).
 
+  // Row-wise copy of the matrix (CSR format) for the parallel matrix-vector product.
+  scalar *Rx;            // Matrix entries (row-wise).
+  int *Ri;               // Column indices of values in Rx.
+  int *Rp;               // Index to Rx/Ri, where each row starts.
+  bool rows_valid;       // Whether Rx holds the current values of Ax.
+  bool use_rows;         // Whether the row-wise copy is used at all.
+
+  void update_rows();
+  void free_rows();
 };
 
 // This class is to be used with UMFPack solver only:
@@ -127,6 +161,10 @@ public:
   virtual ~UMFPackLinearSolver();
 
   virtual bool solve();
+
+  /// Number of nonzeros of the LU factors (L + U - I) of the last double precision
+  /// factorization, -1 if there is none.
+  int get_lu_nnz();
     
 protected:
   UMFPackMatrix *m;
@@ -138,6 +176,9 @@ protected:
   
   bool setup_factorization();
   void free_factorization_data();
+  /// Solves the system in the mixed-precision mode (see LinearSolver::set_mixed_precision()),
+  /// returns false if the solution has to be computed in double precision.
+  bool solve_mixed_precision();
 };
 
 